@@ -6,16 +6,36 @@
 
 #include "testbinhelper.h"
 
+#include "binfilehelper.h"
+#include "kspaths.h"
+#include "skycomponents/deepstarcomponent.h"
+#include "skycomponents/starblock.h"
+#include "skycomponents/starblockfactory.h"
+#include "skycomponents/starblocklist.h"
+#include "skyobjects/deepstardata.h"
+
+#include <QDataStream>
+#include <QFile>
+
+#include <memory>
+#include <vector>
+
 TestBinHelper::TestBinHelper(QObject *parent) : QObject(parent)
 {
 }
 
 void TestBinHelper::initTestCase()
 {
+    QStandardPaths::setTestModeEnabled(true);
+    QDir().mkpath(KSPaths::writableLocation(QStandardPaths::AppLocalDataLocation));
+
+    // 512 trixels, as in an HTM level 3 catalog, with enough stars to make the benchmark meaningful
+    QVERIFY(writeCatalog(m_CatalogName, 512, 2000));
 }
 
 void TestBinHelper::cleanupTestCase()
 {
+    QFile::remove(QDir(KSPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath(m_CatalogName));
 }
 
 void TestBinHelper::init()
@@ -26,13 +46,200 @@ void TestBinHelper::cleanup()
 {
 }
 
+bool TestBinHelper::writeCatalog(const QString &fileName, quint32 trixels, quint32 starsPerTrixel)
+{
+    QFile file(QDir(KSPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath(fileName));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+
+    // Preamble
+    QByteArray preamble("KStars Star Data v1.0. Synthetic deep star catalog for the BinFileHelper tests");
+    preamble.resize(124);
+    out.writeRawData(preamble.constData(), 124);
+    out << quint16(0x4B53) << quint8(1);
+
+    // Field descriptor, 16 bytes per field, matching DeepStarData
+    struct
+    {
+        const char *name;
+        qint8 size;
+        quint8 type;
+        qint32 scale;
+    } const fields[] = { { "RA", 4, 3, 1000000 }, { "Dec", 4, 3, 100000 }, { "dRA", 2, 1, 1000 },
+        { "dDec", 2, 1, 1000 },       { "B", 2, 1, 1000 },        { "V", 2, 1, 1000 }
+    };
+    out << qint16(6);
+    for (auto const &field : fields)
+    {
+        char name[10] = "";
+        qstrncpy(name, field.name, sizeof(name));
+        out.writeRawData(name, sizeof(name));
+        out << field.size << field.type << field.scale;
+    }
+
+    // Index table, then the 5-byte deep star catalog header (faint mag, HTM level, max stars per trixel)
+    out << trixels;
+    quint32 const dataStart = file.pos() + trixels * 12 + 5;
+    for (quint32 i = 0; i < trixels; ++i)
+        out << i << quint32(dataStart + i * starsPerTrixel * sizeof(DeepStarData)) << starsPerTrixel;
+    out << qint16(16000) << quint8(3) << quint16(starsPerTrixel);
+
+    // Records, sorted by magnitude within each trixel as the real catalogs are
+    for (quint32 i = 0; i < trixels; ++i)
+        for (quint32 j = 0; j < starsPerTrixel; ++j)
+            out << qint32(i * 1000 + j) << qint32(j) << qint16(1) << qint16(-1) << qint16(12000 + j % 4000)
+                << qint16(12000 + j * 4000 / starsPerTrixel);
+
+    return out.status() == QDataStream::Ok;
+}
+
 void TestBinHelper::testLoadBinary_data()
 {
+    QTest::addColumn<bool>("MAPPED");
+
+    QTest::addRow("fread") << false;
+    QTest::addRow("mmap") << true;
 }
 
 void TestBinHelper::testLoadBinary()
 {
-    QSKIP("Not implemented yet.");
+    QFETCH(bool, MAPPED);
+
+    BinFileHelper reader;
+    QVERIFY(reader.openFile(m_CatalogName) != nullptr);
+    QVERIFY(reader.readHeader());
+    QCOMPARE(reader.getByteSwap(), false);
+    QCOMPARE(reader.getFieldCount(), 6);
+    QCOMPARE(reader.guessRecordSize(), static_cast<int>(sizeof(DeepStarData)));
+    QCOMPARE(reader.getRecordCount(), 512ul * 2000ul);
+    QVERIFY(reader.isField("RA"));
+    QVERIFY(!reader.isField("HD"));
+
+    if (MAPPED)
+        QVERIFY(reader.mapFile());
+    QCOMPARE(reader.isMapped(), MAPPED);
+
+    // Both backends must return the same records for a trixel
+    for (int const trixel : { 0, 17, 511 })
+    {
+        RecordSpan const span = reader.getRecords(trixel);
+        QCOMPARE(span.isEmpty(), !MAPPED);
+
+        if (!MAPPED)
+            BinFileHelper::unsigned_KDE_fseek(reader.getFileHandle(), reader.getOffset(trixel), SEEK_SET);
+
+        for (quint32 j = 0; j < reader.getRecordCount(trixel); j += 97)
+        {
+            DeepStarData scratch, data;
+            if (MAPPED)
+            {
+                data = *DeepStarComponent::mappedRecord(span.record(j), reader.getByteSwap(), scratch);
+            }
+            else
+            {
+                BinFileHelper::unsigned_KDE_fseek(reader.getFileHandle(), reader.getOffset(trixel) + j * sizeof(DeepStarData),
+                                                  SEEK_SET);
+                QVERIFY(fread(&data, sizeof(DeepStarData), 1, reader.getFileHandle()));
+            }
+            QCOMPARE(data.RA, static_cast<qint32>(trixel * 1000 + j));
+            QCOMPARE(data.Dec, static_cast<qint32>(j));
+        }
+    }
+
+    // Out of range index entries must yield empty spans
+    QVERIFY(reader.getRecords(-1).isEmpty());
+    QVERIFY(reader.getRecords(512).isEmpty());
+
+    reader.unmapFile();
+    QVERIFY(!reader.isMapped());
+    QVERIFY(reader.getRecords(0).isEmpty());
+    reader.closeFile();
+}
+
+void TestBinHelper::testBlockRecycling()
+{
+    DeepStarComponent component(nullptr, m_CatalogName, 0);
+    QVERIFY(component.fileOpen());
+
+    StarBlockFactory *factory = StarBlockFactory::Instance();
+    factory->freeAll();
+    factory->resetStatistics();
+    factory->drawID = 1;
+
+    // 2000 stars need 20 blocks, more than the cache holds. None of them may be recycled while the
+    // trixel is being filled, since they were all handed out in this draw cycle.
+    StarBlockList first(0, &component);
+    first.fillToMag(20);
+    QCOMPARE(first.getStarCount(), 2000L);
+    QCOMPARE(first.getBlockCount(), 20);
+    QCOMPARE(factory->statistics().evictions, 0ull);
+    QCOMPARE(factory->getBlockCount(), 20);
+
+    // A block handed out in this cycle is not returned by getBlock() either
+    for (int i = 0; i < 5; ++i)
+    {
+        std::shared_ptr<StarBlock> block = factory->getBlock();
+        for (const auto &used : first.contents())
+            QVERIFY(block != used);
+    }
+    QCOMPARE(first.getBlockCount(), 20);
+
+    // In the next cycle, the blocks of the first trixel can be recycled from its end
+    factory->drawID = 2;
+    StarBlockList second(1, &component);
+    second.fillToMag(20);
+    QCOMPARE(second.getStarCount(), 2000L);
+    QVERIFY(factory->statistics().evictions > 0);
+    QVERIFY(first.getBlockCount() < 20);
+    QCOMPARE(first.getStarCount(), first.getBlockCount() * 100L);
+
+    factory->freeAll();
+    factory->drawID = 0;
+}
+
+void TestBinHelper::testFillBenchmark_data()
+{
+    testLoadBinary_data();
+}
+
+void TestBinHelper::testFillBenchmark()
+{
+    QFETCH(bool, MAPPED);
+
+    // The component opens the catalog, maps it and creates the HTM level 3 mesh it was written for
+    DeepStarComponent component(nullptr, m_CatalogName, 0);
+    QVERIFY(component.fileOpen());
+    if (!MAPPED)
+        component.getStarReader()->unmapFile();
+    QCOMPARE(component.getStarReader()->isMapped(), MAPPED);
+
+    // A scattered set of trixels, as when panning over the sky
+    std::vector<std::unique_ptr<StarBlockList>> lists;
+    for (Trixel trixel = 0; trixel < 512; trixel += 7)
+        lists.emplace_back(new StarBlockList(trixel, &component));
+
+    StarBlockFactory *factory = StarBlockFactory::Instance();
+    long stars = 0;
+
+    QBENCHMARK
+    {
+        stars = 0;
+        for (auto &list : lists)
+        {
+            // Magnitude 20 is fainter than all the synthetic stars, so every trixel is read to its end
+            list->fillToMag(20);
+            stars += list->getStarCount();
+        }
+
+        // Detach the blocks from the lists, so that the next iteration reads the trixels again
+        factory->freeAll();
+    }
+
+    QCOMPARE(stars, static_cast<long>(lists.size()) * 2000);
+    QCOMPARE(factory->getBlockCount(), 0);
 }
 
 QTEST_GUILESS_MAIN(TestBinHelper)
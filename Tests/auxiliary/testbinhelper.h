@@ -25,6 +25,17 @@ private slots:
 
     void testLoadBinary_data();
     void testLoadBinary();
+
+    void testBlockRecycling();
+
+    void testFillBenchmark_data();
+    void testFillBenchmark();
+
+private:
+    /** @short Write a synthetic deep star catalog of @p trixels trixels holding @p starsPerTrixel stars each */
+    bool writeCatalog(const QString &fileName, quint32 trixels, quint32 starsPerTrixel);
+
+    QString m_CatalogName { "testbinhelper-deepstars.dat" };
 };
 
 #endif // TESTBINHELPER_H
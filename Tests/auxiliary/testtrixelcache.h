@@ -59,6 +59,20 @@ class TestTrixelCache : public QObject
         QVERIFY(m_cache[2].is_set());
     };
 
+    void contains()
+    {
+        QVERIFY(!m_cache.contains(3));
+
+        m_cache[3] = { 1, 2, 3 };
+        m_cache[4] = { 4, 5, 6 };
+        QVERIFY(m_cache.contains(3));
+        QVERIFY(m_cache.contains(4));
+
+        // looking up an element must not mark it as used
+        m_cache.contains(3);
+        QCOMPARE(m_cache.primed_indices(), (std::list<size_t>{ 4, 3 }));
+    };
+
     void pruning()
     {
         m_cache    = { 10, 1 };
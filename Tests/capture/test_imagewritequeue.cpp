@@ -0,0 +1,126 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_imagewritequeue.h"
+
+#include "fitsviewer/fitsblob.h"
+#include "indi/imagewritequeue.h"
+
+TestImageWriteQueue::TestImageWriteQueue() : QObject()
+{
+}
+
+void TestImageWriteQueue::testWriteInOrder_data()
+{
+    QTest::addColumn<int>("CAPACITY");
+    QTest::addColumn<int>("SYNC_INTERVAL");
+
+    QTest::newRow("no sync") << 4 << 0;
+    QTest::newRow("sync each") << 2 << 1;
+    QTest::newRow("sync batches") << 3 << 3;
+}
+
+void TestImageWriteQueue::testWriteInOrder()
+{
+    QFETCH(int, CAPACITY);
+    QFETCH(int, SYNC_INTERVAL);
+    QVERIFY(m_Directory.isValid());
+
+    ISD::ImageWriteQueue queue;
+    queue.setCapacity(CAPACITY);
+    queue.setSyncInterval(SYNC_INTERVAL);
+    QCOMPARE(queue.capacity(), CAPACITY);
+
+    // Emitted from both threads
+    QMutex mutex;
+    int maxDepth = 0;
+    connect(&queue, &ISD::ImageWriteQueue::statusChanged, this, [&](int depth, int, double)
+    {
+        QMutexLocker locker(&mutex);
+        maxDepth = std::max(maxDepth, depth);
+    }, Qt::DirectConnection);
+
+    const int count = 10;
+    QStringList filenames;
+    for (int i = 0; i < count; ++i)
+    {
+        const QString filename = m_Directory.filePath(QString("%1_%2.dat").arg(QTest::currentDataTag()).arg(i));
+        filenames << filename;
+
+        // Capture waits when the queue is full
+        while (queue.isFull())
+            QThread::msleep(1);
+        queue.enqueue(filename, QByteArray(64 * 1024 + i, static_cast<char>('a' + i)));
+    }
+
+    queue.waitForDone();
+    QCOMPARE(queue.depth(), 0);
+
+    const ISD::ImageWriteQueue::Statistics statistics = queue.statistics();
+    QCOMPARE(statistics.written, quint64(count));
+    QCOMPARE(statistics.failed, quint64(0));
+    QVERIFY(statistics.meanLatency() > 0);
+
+    QDateTime previous;
+    for (int i = 0; i < count; ++i)
+    {
+        QFile file(filenames[i]);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.readAll(), QByteArray(64 * 1024 + i, static_cast<char>('a' + i)));
+        QVERIFY(!QFile::exists(filenames[i] + ".part"));
+
+        const QDateTime modified = QFileInfo(file).lastModified();
+        QVERIFY(!previous.isValid() || previous <= modified);
+        previous = modified;
+    }
+
+    QMutexLocker locker(&mutex);
+    QVERIFY(maxDepth > 0);
+    QVERIFY(maxDepth <= CAPACITY);
+}
+
+void TestImageWriteQueue::testBlob()
+{
+    QVERIFY(m_Directory.isValid());
+
+    const QByteArray data(2880 * 3, 'k');
+    QSharedPointer<FITSBlob> blob(new FITSBlob(data.constData(), data.size()));
+    const QString filename = m_Directory.filePath("blob.fits");
+
+    // The file replaces whatever is there, such as the placeholder created when checking the filename
+    QFile placeholder(filename);
+    QVERIFY(placeholder.open(QIODevice::WriteOnly));
+    placeholder.close();
+
+    {
+        ISD::ImageWriteQueue queue;
+        queue.enqueue(filename, blob);
+        // Waits for the write, pixels may be changed afterwards
+        blob->waitForWrite();
+        QVERIFY(QFile::exists(filename));
+    }
+
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), data);
+}
+
+void TestImageWriteQueue::testFailure()
+{
+    ISD::ImageWriteQueue queue;
+    QSignalSpy failed(&queue, &ISD::ImageWriteQueue::writeFailed);
+
+    const QString filename = m_Directory.filePath("missing/directory/file.dat");
+    queue.enqueue(filename, QByteArray(16, 'x'));
+    queue.waitForDone();
+
+    QVERIFY(failed.count() == 1 || failed.wait());
+    QCOMPARE(failed.first().first().toString(), filename);
+    QCOMPARE(queue.statistics().failed, quint64(1));
+    QVERIFY(!QFile::exists(filename + ".part"));
+}
+
+QTEST_GUILESS_MAIN(TestImageWriteQueue)
@@ -0,0 +1,33 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+/**
+ * @class TestImageWriteQueue
+ * @short Writes files through the capture write queue and checks order, renaming and back-pressure
+ */
+class TestImageWriteQueue : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestImageWriteQueue();
+        ~TestImageWriteQueue() override = default;
+
+    private slots:
+        void testWriteInOrder_data();
+        void testWriteInOrder();
+
+        void testBlob();
+        void testFailure();
+
+    private:
+        QTemporaryDir m_Directory;
+};
@@ -8,7 +8,9 @@
 #include <QtConcurrent/QtConcurrentRun>
 #include <qtestcase.h>
 #include "catalogsdb.h"
+#include "catalogstrixelloader.h"
 #include "skymesh.h"
+#include <numeric>
 
 using namespace CatalogsDB;
 class TestCatalogsDB_DBManager : public QObject
@@ -83,6 +85,35 @@ class TestCatalogsDB_DBManager : public QObject
         QVERIFY(num_obj > 0);
     }
 
+    void prefetch_trixels()
+    {
+        const int num_trixels = SkyMesh::Create(m_manager.htmesh_level())->size();
+        std::vector<int> trixels(num_trixels);
+        std::iota(trixels.begin(), trixels.end(), 0);
+
+        CatalogsTrixelLoader loader{ m_manager.db_file_name() };
+        loader.request(trixels);
+
+        std::unordered_map<int, size_t> loaded;
+        QTRY_VERIFY_WITH_TIMEOUT(
+            [&]() {
+                for (auto &trixel : loader.takeLoaded())
+                    loaded[trixel.first] = trixel.second.size();
+                return loaded.size() == size_t(num_trixels);
+            }(),
+            30000);
+
+        QVERIFY(!loader.hasFailed());
+        QVERIFY(loader.takeFailed().empty());
+
+        for (int trixel = 0; trixel < num_trixels; trixel++)
+            QCOMPARE(loaded[trixel], m_manager.get_objects_in_trixel(trixel).size());
+
+        const auto &stats = loader.statistics();
+        QCOMPARE(stats.loaded, quint64(num_trixels));
+        QVERIFY(stats.max_latency >= stats.meanLatency());
+    }
+
     void find_by_name()
     {
         const auto &obj  = some_object();
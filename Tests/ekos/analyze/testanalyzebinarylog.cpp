@@ -0,0 +1,358 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtTest>
+
+#include <QObject>
+#include <QTemporaryDir>
+#include "ekos/analyze/analyzebinarylog.h"
+#include "ekos/analyze/analyzeloader.h"
+
+using Ekos::AnalyzeBinaryReader;
+using Ekos::AnalyzeBinaryWriter;
+using Ekos::AnalyzeLoader;
+
+class TestAnalyzeBinaryLog : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestAnalyzeBinaryLog();
+        ~TestAnalyzeBinaryLog() override = default;
+
+    private slots:
+        void initTestCase();
+
+        void roundTripTest();
+        void windowTest();
+        void chunkTest();
+        void unclosedLogTest();
+        void appendTest();
+        void appendDuringLoadTest();
+
+        void benchmarkRead_data();
+        void benchmarkRead();
+
+    private:
+        // Writes a synthetic log of numLines lines, with all message types, mostly guider samples.
+        static void writeLog(const QString &filename, int numLines);
+        static QVector<AnalyzeLoader::Line> readCsv(const QString &filename);
+        static void compareLines(const QVector<AnalyzeLoader::Line> &actual,
+                                 const QVector<AnalyzeLoader::Line> &expected);
+
+        QTemporaryDir dir;
+        QString csvFilename;
+        QString binaryFilename;
+        QVector<AnalyzeLoader::Line> csvLines;
+};
+
+#include "testanalyzebinarylog.moc"
+
+TestAnalyzeBinaryLog::TestAnalyzeBinaryLog() : QObject()
+{
+}
+
+void TestAnalyzeBinaryLog::initTestCase()
+{
+    QVERIFY(dir.isValid());
+    csvFilename = dir.filePath("synthetic.analyze");
+    binaryFilename = dir.filePath("synthetic.analyzeb");
+    writeLog(csvFilename, 200000);
+    csvLines = readCsv(csvFilename);
+    QVERIFY(csvLines.size() > 200000);
+    QVERIFY(AnalyzeBinaryWriter::fromCsv(csvFilename, binaryFilename));
+}
+
+void TestAnalyzeBinaryLog::writeLog(const QString &filename, int numLines)
+{
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    QTextStream out(&file);
+    out << "#KStars version 3.5.7. Analyze log version 1.0.\n\n";
+    out << "AnalyzeStartTime,2026-01-01 20:00:00.000,CET\n";
+    out << "SchedulerJobStart,0.500,M42\n";
+    out << "GuideState,0.600,Guiding\n";
+    out << "MountState,0.700,Tracking\n";
+    out << "AlignState,0.800,Complete\n";
+
+    double time = 1;
+    for (int i = 0; i < numLines; ++i, time += 0.03)
+    {
+        const QString t = QString::number(time, 'f', 3);
+        if (i % 100 == 0)
+            out << "CaptureStarting," << t << ",60.000,Red\n";
+        else if (i % 100 == 50)
+            out << "CaptureComplete," << t << ",60.000,Red,2.345,/home/user/M42/Light/M42_Light_" << i << ".fits,"
+                << 120 << "," << 512 << ",0.421\n";
+        else if (i % 1000 == 7)
+            out << "MountCoords," << t << ",83.822,-5.391,180.123,45.678,0,23.456\n";
+        else if (i % 1000 == 9)
+            out << "Temperature," << t << ",-3.5\n";
+        else if (i % 5000 == 11)
+            out << "AutofocusStarting," << t << ",-3.5,Red\n";
+        else if (i % 5000 == 13)
+            out << "AutofocusComplete," << t << ",Red,3|2.1|4|1.8|5|2.2\n";
+        else if (i % 5000 == 17)
+            out << "MeridianFlipState," << t << ",MOUNT_FLIP_NONE\n";
+        else
+            out << "GuideStats," << t << "," << QString::number((i % 17 - 8) * 0.11, 'f', 2) << ","
+                << QString::number((i % 13 - 6) * 0.07, 'f', 2) << "," << (i % 200) << "," << -(i % 150) << ","
+                << QString::number(40.29 + (i % 7) * 1.234567, 'g', 10) << ",1520.5," << (i % 5) << "\n";
+    }
+    out << "SchedulerJobEnd," << QString::number(time, 'f', 3) << ",M42,Job completed\n";
+}
+
+QVector<AnalyzeLoader::Line> TestAnalyzeBinaryLog::readCsv(const QString &filename)
+{
+    QVector<AnalyzeLoader::Line> lines;
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return lines;
+    AnalyzeLoader::readLines(&file, 10000, [&lines](QVector<AnalyzeLoader::Line> &&chunk, int)
+    {
+        lines += chunk;
+        return true;
+    });
+    return lines;
+}
+
+void TestAnalyzeBinaryLog::compareLines(const QVector<AnalyzeLoader::Line> &actual,
+                                        const QVector<AnalyzeLoader::Line> &expected)
+{
+    QCOMPARE(actual.size(), expected.size());
+    for (int i = 0; i < actual.size(); ++i)
+    {
+        const auto &a = actual[i];
+        const auto &e = expected[i];
+        QCOMPARE(a.type, e.type);
+        QCOMPARE(a.time, e.time);
+        for (int v = 0; v < AnalyzeLoader::valueCount(e.type); ++v)
+            QCOMPARE(a.values[v], e.values[v]);
+        for (int t = 0; t < AnalyzeLoader::textCount(e.type); ++t)
+            QCOMPARE(a.text[t], e.text[t]);
+    }
+}
+
+void TestAnalyzeBinaryLog::roundTripTest()
+{
+    AnalyzeBinaryReader reader;
+    QVERIFY(reader.open(binaryFilename));
+    compareLines(reader.read(), csvLines);
+
+    // Most numbers are stored as 32 bit integers, the log should be smaller than the text.
+    QVERIFY(QFileInfo(binaryFilename).size() < QFileInfo(csvFilename).size());
+
+    // Both readers of Analyze accept the binary log.
+    QVector<AnalyzeLoader::Line> loaded;
+    AnalyzeLoader loader;
+    connect(&loader, &AnalyzeLoader::linesRead, this, [&loaded](const QVector<AnalyzeLoader::Line> &lines, int)
+    {
+        loaded += lines;
+    });
+    QSignalSpy finished(&loader, &AnalyzeLoader::finished);
+    loader.load(binaryFilename);
+    QVERIFY(finished.wait(30000));
+    QCOMPARE(finished.first().first().toBool(), true);
+    compareLines(loaded, csvLines);
+
+    const QString exported = dir.filePath("exported.analyze");
+    QVERIFY(AnalyzeBinaryReader::toCsv(binaryFilename, exported));
+    compareLines(readCsv(exported), csvLines);
+}
+
+void TestAnalyzeBinaryLog::windowTest()
+{
+    AnalyzeBinaryReader reader;
+    QVERIFY(reader.open(binaryFilename));
+    QVERIFY(reader.blocks().size() > 10);
+    QCOMPARE(reader.lastTime(), csvLines.last().time);
+
+    const double start = 1000, end = 1300;
+    QVector<AnalyzeLoader::Line> expected;
+    for (const auto &line : csvLines)
+    {
+        if (line.time >= start && line.time <= end)
+            expected.append(line);
+    }
+    QVERIFY(!expected.isEmpty());
+    compareLines(reader.read(start, end), expected);
+    QVERIFY(reader.blocksRead() < reader.blocks().size() / 2);
+
+    QVERIFY(reader.read(1e9, 2e9).isEmpty());
+    QCOMPARE(reader.blocksRead(), 0);
+}
+
+void TestAnalyzeBinaryLog::chunkTest()
+{
+    AnalyzeBinaryReader reader;
+    QVERIFY(reader.open(binaryFilename));
+
+    // Chunks come as the blocks are decoded, in order.
+    QVector<AnalyzeLoader::Line> lines;
+    QVector<int> percents;
+    QVERIFY(reader.read(10000, [&](QVector<AnalyzeLoader::Line> &&chunk, int percent)
+    {
+        lines += chunk;
+        percents.append(percent);
+        return true;
+    }));
+    QVERIFY(percents.size() > 10);
+    QVERIFY(std::is_sorted(percents.cbegin(), percents.cend()));
+    QCOMPARE(percents.last(), 100);
+    compareLines(lines, csvLines);
+
+    // Stopping after the first chunk leaves most blocks undecoded.
+    QVERIFY(!reader.read(10000, [](QVector<AnalyzeLoader::Line> &&, int)
+    {
+        return false;
+    }));
+    QVERIFY(reader.blocksRead() < reader.blocks().size() / 4);
+}
+
+void TestAnalyzeBinaryLog::unclosedLogTest()
+{
+    const QString filename = dir.filePath("unclosed.analyzeb");
+    const QString crashedFilename = dir.filePath("crashed.analyzeb");
+    const QVector<AnalyzeLoader::Line> lines = csvLines.mid(0, 20000);
+    {
+        AnalyzeBinaryWriter writer;
+        QVERIFY(writer.open(filename));
+        for (const auto &line : lines)
+            writer.append(line);
+        QVERIFY(writer.flush());
+
+        // The log being written can be read up to the last flush.
+        AnalyzeBinaryReader reader;
+        QVERIFY(reader.open(filename));
+        compareLines(reader.read(), lines);
+
+        // A copy stands for a log whose writer stopped while writing a block.
+        QVERIFY(QFile::copy(filename, crashedFilename));
+    }
+    QFile file(crashedFilename);
+    QVERIFY(file.open(QIODevice::Append));
+    QCOMPARE(file.write(QByteArray("CBLK\x08\0\0\0", 8)), qint64(8));
+    file.close();
+    QVERIFY(AnalyzeBinaryReader::isBinaryLog(crashedFilename));
+    {
+        AnalyzeBinaryReader reader;
+        QVERIFY(reader.open(crashedFilename));
+        compareLines(reader.read(), lines);
+    }
+
+    // Reopening drops the incomplete block and appends after the complete ones.
+    AnalyzeBinaryWriter writer;
+    QVERIFY(writer.open(crashedFilename));
+    const QVector<AnalyzeLoader::Line> more = csvLines.mid(30000, 100);
+    for (const auto &line : more)
+        writer.append(line);
+    QVERIFY(writer.close());
+
+    AnalyzeBinaryReader reader;
+    QVERIFY(reader.open(crashedFilename));
+    compareLines(reader.read(), lines + more);
+    QCOMPARE(reader.read(0, lines.last().time).size(), lines.size());
+}
+
+void TestAnalyzeBinaryLog::appendTest()
+{
+    const QString filename = dir.filePath("append.analyzeb");
+    const QVector<AnalyzeLoader::Line> first = csvLines.mid(0, 10000);
+    const QVector<AnalyzeLoader::Line> second = csvLines.mid(10000, 10000);
+    {
+        AnalyzeBinaryWriter writer;
+        QVERIFY(writer.open(filename));
+        for (const auto &line : first)
+            writer.append(line);
+        QVERIFY(writer.close());
+    }
+    int firstBlocks = 0;
+    {
+        AnalyzeBinaryReader reader;
+        QVERIFY(reader.open(filename));
+        firstBlocks = reader.blocks().size();
+    }
+
+    AnalyzeBinaryWriter writer;
+    QVERIFY(writer.open(filename));
+    for (const auto &line : second)
+        writer.append(line);
+    QVERIFY(writer.close());
+
+    // The old index was replaced, the index lists the blocks of both sessions.
+    AnalyzeBinaryReader reader;
+    QVERIFY(reader.open(filename));
+    QVERIFY(reader.blocks().size() > firstBlocks);
+    compareLines(reader.read(), first + second);
+
+    // A text log is not overwritten.
+    AnalyzeBinaryWriter textWriter;
+    QVERIFY(!textWriter.open(csvFilename));
+}
+
+void TestAnalyzeBinaryLog::appendDuringLoadTest()
+{
+    // The log of the current session, flushed when its reload starts, then written to while it is read.
+    const QString filename = dir.filePath("growing.analyzeb");
+    const QVector<AnalyzeLoader::Line> before = csvLines.mid(0, 100000);
+    const QVector<AnalyzeLoader::Line> during = csvLines.mid(100000, 50000);
+    AnalyzeBinaryWriter writer;
+    QVERIFY(writer.open(filename));
+    for (const auto &line : before)
+        writer.append(line);
+    QVERIFY(writer.flush());
+    const qint64 length = QFileInfo(filename).size();
+
+    QVector<AnalyzeLoader::Line> loaded;
+    int appended = 0;
+    AnalyzeLoader loader;
+    connect(&loader, &AnalyzeLoader::linesRead, this, [&](const QVector<AnalyzeLoader::Line> &lines, int)
+    {
+        loaded += lines;
+        // Blocks written while the loader is still reading are past the length it was given.
+        for (int i = 0; i < 5000 && appended < during.size(); ++i)
+            writer.append(during[appended++]);
+        writer.flush();
+    });
+    QSignalSpy finished(&loader, &AnalyzeLoader::finished);
+    loader.load(filename, length);
+    QVERIFY(finished.wait(30000));
+    QCOMPARE(finished.first().first().toBool(), true);
+
+    QVERIFY(appended > 0);
+    QVERIFY(QFileInfo(filename).size() > length);
+    compareLines(loaded, before);
+}
+
+void TestAnalyzeBinaryLog::benchmarkRead_data()
+{
+    QTest::addColumn<QString>("format");
+
+    QTest::newRow("text") << "text";
+    QTest::newRow("binary") << "binary";
+    QTest::newRow("binary, 5 minute window") << "window";
+}
+
+void TestAnalyzeBinaryLog::benchmarkRead()
+{
+    QFETCH(QString, format);
+
+    int lines = 0;
+    QBENCHMARK
+    {
+        if (format == "text")
+            lines = readCsv(csvFilename).size();
+        else
+        {
+            AnalyzeBinaryReader reader;
+            QVERIFY(reader.open(binaryFilename));
+            lines = format == "binary" ? reader.read().size() : reader.read(3000, 3300).size();
+        }
+    }
+    QVERIFY(lines > 0);
+}
+
+QTEST_GUILESS_MAIN(TestAnalyzeBinaryLog)
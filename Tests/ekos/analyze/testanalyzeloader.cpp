@@ -0,0 +1,364 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtTest>
+
+#include <QObject>
+#include <QTemporaryDir>
+#include "ekos/analyze/analyzeloader.h"
+#include "ekos/analyze/intervalfinder.h"
+
+using Ekos::AnalyzeLoader;
+
+class TestAnalyzeLoader : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestAnalyzeLoader();
+        ~TestAnalyzeLoader() override = default;
+
+    private slots:
+        void initTestCase();
+
+        void intervalFinderTest();
+        void parseLineTest_data();
+        void parseLineTest();
+        void readLinesTest();
+        void appendDuringLoadTest();
+
+        void benchmarkLoad_data();
+        void benchmarkLoad();
+
+    private:
+        // Writes a synthetic log of numLines lines, mostly guider samples as in a long session.
+        // Returns the number of valid lines written.
+        static int writeLog(const QString &filename, int numLines);
+        static bool parse(const QByteArray &text, AnalyzeLoader::Line *line);
+
+        QTemporaryDir dir;
+        QString logFilename;
+        int logValidLines { 0 };
+};
+
+#include "testanalyzeloader.moc"
+
+namespace
+{
+struct Interval
+{
+    double start, end;
+    int id;
+};
+}
+
+TestAnalyzeLoader::TestAnalyzeLoader() : QObject()
+{
+}
+
+void TestAnalyzeLoader::initTestCase()
+{
+    QVERIFY(dir.isValid());
+    logFilename = dir.filePath("synthetic.analyze");
+    logValidLines = writeLog(logFilename, 1000000);
+}
+
+int TestAnalyzeLoader::writeLog(const QString &filename, int numLines)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return 0;
+    QTextStream out(&file);
+    out << "#KStars version 3.5.7. Analyze log version 1.0.\n\n";
+    out << "AnalyzeStartTime,2026-01-01 20:00:00.000,CET\n";
+
+    int valid = 1;
+    double time = 1;
+    for (int i = 0; i < numLines; ++i, time += 0.03)
+    {
+        const QString t = QString::number(time, 'f', 3);
+        if (i % 100 == 0)
+            out << "CaptureStarting," << t << ",60.000,Red\n";
+        else if (i % 100 == 50)
+            out << "CaptureComplete," << t << ",60.000,Red,2.345,/home/user/M42/Light/M42_Light_" << i << ".fits,"
+                << 120 << "," << 512 << ",0.421\n";
+        else if (i % 1000 == 7)
+            out << "MountCoords," << t << ",83.822,-5.391,180.123,45.678,0,23.456\n";
+        else
+            out << "GuideStats," << t << "," << QString::number((i % 17 - 8) * 0.11, 'f', 2) << ","
+                << QString::number((i % 13 - 6) * 0.07, 'f', 2) << "," << (i % 200) << "," << -(i % 150) << ",40.29,1520.5,"
+                << (i % 5) << "\n";
+        valid++;
+    }
+    return valid;
+}
+
+bool TestAnalyzeLoader::parse(const QByteArray &text, AnalyzeLoader::Line *line)
+{
+    return AnalyzeLoader::parseLine(text.constData(), text.constData() + text.size(), line);
+}
+
+void TestAnalyzeLoader::intervalFinderTest()
+{
+    QRandomGenerator random(42);
+    Ekos::IntervalFinder<Interval> finder;
+    QList<Interval> all;
+
+    // Mostly in order, with some overlaps and some out of order sessions.
+    double time = 0;
+    for (int i = 0; i < 2000; ++i)
+    {
+        const double start = (i % 50 == 0) ? random.bounded(time + 1) : time + random.bounded(10.0);
+        const double end = start + random.bounded(100.0);
+        time = std::max(time, start);
+        const Interval interval { start, end, i };
+        finder.add(interval);
+        all.append(interval);
+
+        // Finds interleaved with adds, as with live data.
+        if (i % 97 == 0)
+        {
+            const double t = random.bounded(time + 50);
+            int expected = 0;
+            for (const auto &j : all)
+                expected += (t >= j.start && t <= j.end);
+            QCOMPARE(finder.find(t).size(), expected);
+        }
+    }
+    QCOMPARE(finder.size(), 2000);
+
+    for (int i = 0; i < 500; ++i)
+    {
+        const double t = random.bounded(time + 150);
+        QList<int> expected;
+        for (const auto &j : all)
+        {
+            if (t >= j.start && t <= j.end)
+                expected.append(j.id);
+        }
+        const QList<Interval> found = finder.find(t);
+        QList<int> foundIds;
+        for (int j = 0; j < found.size(); ++j)
+        {
+            foundIds.append(found[j].id);
+            if (j > 0)
+                QVERIFY(found[j - 1].start <= found[j].start);
+        }
+        std::sort(expected.begin(), expected.end());
+        std::sort(foundIds.begin(), foundIds.end());
+        QCOMPARE(foundIds, expected);
+    }
+
+    // Intervals touching at the time are both found, earliest first.
+    Ekos::IntervalFinder<Interval> touching;
+    touching.add({10, 20, 1});
+    touching.add({0, 10, 0});
+    const QList<Interval> found = touching.find(10);
+    QCOMPARE(found.size(), 2);
+    QCOMPARE(found[0].id, 0);
+    QCOMPARE(found[1].id, 1);
+
+    touching.clear();
+    QVERIFY(touching.find(10).isEmpty());
+}
+
+void TestAnalyzeLoader::parseLineTest_data()
+{
+    QTest::addColumn<QByteArray>("text");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<int>("type");
+    QTest::addColumn<double>("time");
+    QTest::addColumn<QList<double>>("values");
+    QTest::addColumn<QStringList>("texts");
+
+    QTest::newRow("comment") << QByteArray("#KStars version 3.5.7,x") << false << 0 << 0.0 << QList<double>() << QStringList();
+    QTest::newRow("empty") << QByteArray("") << false << 0 << 0.0 << QList<double>() << QStringList();
+    QTest::newRow("unknown") << QByteArray("Unknown,1.0,2") << false << 0 << 0.0 << QList<double>() << QStringList();
+    QTest::newRow("start") << QByteArray("AnalyzeStartTime,2026-01-01 20:00:00.000,CET") << true
+                           << int(AnalyzeLoader::ANALYZE_START_TIME) << 0.0 << QList<double>()
+                           << QStringList({"2026-01-01 20:00:00.000", "CET"});
+    QTest::newRow("negative time") << QByteArray("Temperature,-1.000,10.5") << false << 0 << 0.0 << QList<double>() <<
+                                   QStringList();
+    QTest::newRow("bad time") << QByteArray("Temperature,abc,10.5") << false << 0 << 0.0 << QList<double>() << QStringList();
+    QTest::newRow("temperature") << QByteArray("Temperature,12.500,-3.25\r") << true << int(AnalyzeLoader::TEMPERATURE)
+                                 << 12.5 << QList<double>({-3.25}) << QStringList();
+    QTest::newRow("capture starting") << QByteArray("CaptureStarting,1.000,60.000,Ha") << true
+                                      << int(AnalyzeLoader::CAPTURE_STARTING) << 1.0 << QList<double>({60})
+                                      << QStringList({"Ha"});
+    QTest::newRow("capture complete v1") << QByteArray("CaptureComplete,61.000,60.000,Ha,2.500,/tmp/a.fits") << true
+                                         << int(AnalyzeLoader::CAPTURE_COMPLETE) << 61.0 << QList<double>({60, 2.5, 0, 0, 0})
+                                         << QStringList({"Ha", "/tmp/a.fits"});
+    QTest::newRow("capture complete") << QByteArray("CaptureComplete,61.000,60.000,Ha,2.500,/tmp/a.fits,120,512,0.421") << true
+                                      << int(AnalyzeLoader::CAPTURE_COMPLETE) << 61.0 << QList<double>({60, 2.5, 120, 512, 0.421})
+                                      << QStringList({"Ha", "/tmp/a.fits"});
+    QTest::newRow("capture complete comma") << QByteArray("CaptureComplete,61.000,60.000,Ha,2.500,/tmp/a,b.fits,120,512,0.4,x")
+                                            << false << 0 << 0.0 << QList<double>() << QStringList();
+    QTest::newRow("bad stars") << QByteArray("CaptureComplete,61.000,60.000,Ha,2.500,/tmp/a.fits,12.5") << false << 0
+                               << 0.0 << QList<double>() << QStringList();
+    QTest::newRow("guide stats") << QByteArray("GuideStats,3.250,-0.33,0.07,120,-45,40.29,1520.5,3") << true
+                                 << int(AnalyzeLoader::GUIDE_STATS) << 3.25
+                                 << QList<double>({-0.33, 0.07, 120, -45, 40.29, 1520.5, 3}) << QStringList();
+    QTest::newRow("guide stats exponent") << QByteArray("GuideStats,3.250,1e-05,2.5E+2,0,0,1.0e300,0,3") << true
+                                          << int(AnalyzeLoader::GUIDE_STATS) << 3.25
+                                          << QList<double>({1e-05, 250, 0, 0, 1.0e300, 0, 3}) << QStringList();
+    QTest::newRow("guide stats long") << QByteArray("GuideStats,3.250,0.12345678901234567890,0,0,0,0,0,3") << true
+                                      << int(AnalyzeLoader::GUIDE_STATS) << 3.25
+                                      << QList<double>({0.12345678901234567890, 0, 0, 0, 0, 0, 3}) << QStringList();
+    QTest::newRow("guide stats count") << QByteArray("GuideStats,3.250,-0.33,0.07,120,-45,40.29,1520.5") << false << 0
+                                       << 0.0 << QList<double>() << QStringList();
+    QTest::newRow("mount coords") << QByteArray("MountCoords,5.000,83.822,-5.391,180.123,45.678,1") << true
+                                  << int(AnalyzeLoader::MOUNT_COORDS) << 5.0
+                                  << QList<double>({83.822, -5.391, 180.123, 45.678, 1, 0}) << QStringList();
+    QTest::newRow("scheduler end") << QByteArray("SchedulerJobEnd,9.000,M 42,Aborted") << true
+                                   << int(AnalyzeLoader::SCHEDULER_JOB_END) << 9.0 << QList<double>()
+                                   << QStringList({"M 42", "Aborted"});
+}
+
+void TestAnalyzeLoader::parseLineTest()
+{
+    QFETCH(QByteArray, text);
+    QFETCH(bool, valid);
+    QFETCH(int, type);
+    QFETCH(double, time);
+    QFETCH(QList<double>, values);
+    QFETCH(QStringList, texts);
+
+    AnalyzeLoader::Line line;
+    QCOMPARE(parse(text, &line), valid);
+    if (!valid)
+        return;
+
+    QCOMPARE(int(line.type), type);
+    QCOMPARE(line.time, time);
+    // Numbers are converted exactly as QString::toDouble() would.
+    for (int i = 0; i < values.size(); ++i)
+        QCOMPARE(line.values[i], values[i]);
+    for (int i = 0; i < 2; ++i)
+        QCOMPARE(line.text[i], i < texts.size() ? texts[i] : QString());
+}
+
+void TestAnalyzeLoader::readLinesTest()
+{
+    QFile file(logFilename);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    int lines = 0, chunks = 0, lastPercent = 0;
+    bool ordered = true;
+    double lastTime = 0;
+    const bool done = AnalyzeLoader::readLines(&file, 10000, [&](QVector<AnalyzeLoader::Line> &&chunk, int percent)
+    {
+        chunks++;
+        lines += chunk.size();
+        ordered = ordered && percent >= lastPercent;
+        lastPercent = percent;
+        for (const auto &line : chunk)
+        {
+            // Lines crossing read blocks are not damaged.
+            if (line.type != AnalyzeLoader::ANALYZE_START_TIME)
+            {
+                ordered = ordered && line.time > lastTime;
+                lastTime = line.time;
+            }
+        }
+        return true;
+    });
+    QVERIFY(done);
+    QCOMPARE(lines, logValidLines);
+    QCOMPARE(chunks, (logValidLines + 9999) / 10000);
+    QCOMPARE(lastPercent, 100);
+    QVERIFY(ordered);
+
+    // Stopping early.
+    file.seek(0);
+    chunks = 0;
+    QVERIFY(!AnalyzeLoader::readLines(&file, 10000, [&](QVector<AnalyzeLoader::Line> &&, int)
+    {
+        return ++chunks < 3;
+    }));
+    QCOMPARE(chunks, 3);
+}
+
+void TestAnalyzeLoader::appendDuringLoadTest()
+{
+    // The log of the current session, which Analyze keeps writing while it is read back.
+    const QString filename = dir.filePath("growing.analyze");
+    QFile::remove(filename);
+    QVERIFY(QFile::copy(logFilename, filename));
+    const qint64 length = QFileInfo(filename).size();
+
+    QFile log(filename);
+    QVERIFY(log.open(QIODevice::Append | QIODevice::Text));
+    int lines = 0, appended = 0;
+    double lastTime = 0;
+    AnalyzeLoader loader;
+    connect(&loader, &AnalyzeLoader::linesRead, this, [&](const QVector<AnalyzeLoader::Line> &chunk, int)
+    {
+        lines += chunk.size();
+        lastTime = chunk.last().time;
+        // Lines logged while the loader is still reading are past the length it was given.
+        for (int i = 0; i < 100; ++i, ++appended)
+            log.write(QString("GuideStats,%1,0.1,0.2,0,0,40.0,1520.5,3
+").arg(1e6 + appended, 0, 'f', 3).toLatin1());
+        log.flush();
+    });
+    QSignalSpy finished(&loader, &AnalyzeLoader::finished);
+    loader.load(filename, length);
+    QVERIFY(finished.wait(60000));
+    QCOMPARE(finished.first().first().toBool(), true);
+
+    QVERIFY(appended > 0);
+    QCOMPARE(lines, logValidLines);
+    QVERIFY(lastTime < 1e6);
+}
+
+void TestAnalyzeLoader::benchmarkLoad_data()
+{
+    QTest::addColumn<bool>("split");
+
+    QTest::newRow("QString split") << true;
+    QTest::newRow("AnalyzeLoader") << false;
+}
+
+void TestAnalyzeLoader::benchmarkLoad()
+{
+    QFETCH(bool, split);
+
+    int lines = 0;
+    QBENCHMARK_ONCE
+    {
+        QFile file(logFilename);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        if (split)
+        {
+            // As Analyze used to read logs, converting all the fields of guider samples.
+            QTextStream in(&file);
+            while (!in.atEnd())
+            {
+                const QStringList list = in.readLine().split(QLatin1Char(','));
+                if (list.size() < 2 || list[0].startsWith('#'))
+                    continue;
+                bool ok = true;
+                if (list[0] == "GuideStats")
+                {
+                    for (int i = 1; i < list.size() && ok; ++i)
+                        list[i].toDouble(&ok);
+                }
+                lines++;
+            }
+        }
+        else
+        {
+            AnalyzeLoader::readLines(&file, 10000, [&](QVector<AnalyzeLoader::Line> &&chunk, int)
+            {
+                lines += chunk.size();
+                return true;
+            });
+        }
+    }
+    QCOMPARE(lines, logValidLines);
+}
+
+QTEST_GUILESS_MAIN(TestAnalyzeLoader)
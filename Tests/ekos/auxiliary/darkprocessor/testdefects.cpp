@@ -28,6 +28,9 @@ class TestDefects : public QObject
 
     private slots:
         void basicTest();
+
+        void benchmarkDefects_data();
+        void benchmarkDefects();
 };
 
 #include "testdefects.moc"
@@ -96,4 +99,42 @@ void TestDefects::basicTest()
     }
 }
 
+void TestDefects::benchmarkDefects_data()
+{
+    QTest::addColumn<QString>("filename");
+
+    QTest::newRow("M47") << "../Tests/fitsviewer/m47_sim_stars.fits";
+    QTest::newRow("NGC4535") << "../Tests/fitsviewer/ngc4535-autofocus1.fits";
+    QTest::newRow("Bahtinov") << "../Tests/fitsviewer/bahtinov-focus.fits";
+}
+
+void TestDefects::benchmarkDefects()
+{
+    QFETCH(QString, filename);
+    if (!QFileInfo::exists(filename))
+        QSKIP(QString("Failed to locate file %1, skipping test.").arg(filename).toLatin1());
+
+    QSharedPointer<FITSData> lightData(new FITSData()), darkData(new FITSData());
+    QFuture<bool> lightResult = lightData->loadFromFile(filename);
+    QFuture<bool> darkResult = darkData->loadFromFile(filename);
+    lightResult.waitForFinished();
+    darkResult.waitForFinished();
+
+    if (lightResult.result() == false || darkResult.result() == false)
+        QSKIP("Failed to load image, skipping test.");
+
+    // Stars of the frame stand in for hot pixels, the most aggressive setting keeps many of them
+    QSharedPointer<DefectMap> map(new DefectMap());
+    map->setProperty("HotPixelAggressiveness", 100);
+    map->setProperty("ColdPixelAggressiveness", 100);
+    map->setDarkData(darkData);
+    map->filterPixels();
+
+    QPointer<Ekos::DarkProcessor> processor = new Ekos::DarkProcessor();
+    QBENCHMARK
+    {
+        processor->normalizeDefects(map, lightData, 0, 0);
+    }
+}
+
 QTEST_GUILESS_MAIN(TestDefects)
@@ -0,0 +1,131 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtTest>
+
+#include <QObject>
+#include "ekos/auxiliary/framestacker.h"
+
+#include <fitsio.h>
+
+#include <vector>
+
+class TestStacking : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestStacking();
+        ~TestStacking() override = default;
+
+    private slots:
+        void combineTest_data();
+        void combineTest();
+        void tilingTest();
+        void mismatchTest();
+
+    private:
+        // Frames of constant value, except for the first pixel of the last frame which is an outlier
+        static void addFrames(Ekos::FrameStacker &stacker, const std::vector<uint16_t> &values, uint32_t samples);
+};
+
+#include "teststacking.moc"
+
+TestStacking::TestStacking() : QObject()
+{
+}
+
+void TestStacking::addFrames(Ekos::FrameStacker &stacker, const std::vector<uint16_t> &values, uint32_t samples)
+{
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        std::vector<uint16_t> frame(samples, values[i]);
+        if (i == values.size() - 1)
+            frame[0] = 60000;
+        QVERIFY(stacker.addFrame(reinterpret_cast<uint8_t const *>(frame.data()), samples, TUSHORT));
+    }
+}
+
+void TestStacking::combineTest_data()
+{
+    QTest::addColumn<int>("method");
+    QTest::addColumn<int>("outlier");
+    QTest::addColumn<int>("others");
+
+    // Frames of 100, 102, 98, 100, 101, 99, 100 and a last one of 100 with an outlier.
+    // The mean is pulled by the outlier, the median and sigma clipping are not.
+    QTest::newRow("Mean") << static_cast<int>(Ekos::FrameStacker::STACK_MEAN) << 7588 << 100;
+    QTest::newRow("Median") << static_cast<int>(Ekos::FrameStacker::STACK_MEDIAN) << 100 << 100;
+    QTest::newRow("Kappa-Sigma") << static_cast<int>(Ekos::FrameStacker::STACK_KAPPA_SIGMA) << 100 << 100;
+    QTest::newRow("Winsorized") << static_cast<int>(Ekos::FrameStacker::STACK_WINSORIZED_SIGMA) << 100 << 100;
+}
+
+void TestStacking::combineTest()
+{
+    QFETCH(int, method);
+    QFETCH(int, outlier);
+    QFETCH(int, others);
+
+    constexpr uint32_t samples = 1000;
+    Ekos::FrameStacker stacker;
+    addFrames(stacker, {100, 102, 98, 100, 101, 99, 100, 100}, samples);
+    QCOMPARE(stacker.frameCount(), 8);
+
+    Ekos::FrameStacker::Parameters parameters;
+    parameters.method = static_cast<Ekos::FrameStacker::Method>(method);
+    std::vector<uint16_t> master(samples);
+    QVERIFY(stacker.combine(reinterpret_cast<uint8_t *>(master.data()), parameters));
+
+    QCOMPARE(static_cast<int>(master[0]), outlier);
+    for (uint32_t i = 1; i < samples; i++)
+        QCOMPARE(static_cast<int>(master[i]), others);
+}
+
+void TestStacking::tilingTest()
+{
+    // A budget this small splits the frames in many tiles, the last one partial
+    constexpr uint32_t samples = 100003;
+    Ekos::FrameStacker stacker;
+    for (uint16_t f = 0; f < 5; f++)
+    {
+        std::vector<uint16_t> frame(samples);
+        for (uint32_t i = 0; i < samples; i++)
+            frame[i] = (i + f) % 1000;
+        QVERIFY(stacker.addFrame(reinterpret_cast<uint8_t const *>(frame.data()), samples, TUSHORT));
+    }
+
+    Ekos::FrameStacker::Parameters parameters;
+    parameters.method = Ekos::FrameStacker::STACK_MEDIAN;
+    parameters.memoryBudget = 1024;
+    std::vector<uint16_t> master(samples);
+    QVERIFY(stacker.combine(reinterpret_cast<uint8_t *>(master.data()), parameters));
+
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        std::vector<uint16_t> stack;
+        for (uint16_t f = 0; f < 5; f++)
+            stack.push_back((i + f) % 1000);
+        std::sort(stack.begin(), stack.end());
+        QCOMPARE(master[i], stack[2]);
+    }
+}
+
+void TestStacking::mismatchTest()
+{
+    Ekos::FrameStacker stacker;
+    std::vector<uint16_t> frame(100, 1);
+    QVERIFY(stacker.addFrame(reinterpret_cast<uint8_t const *>(frame.data()), 100, TUSHORT));
+    QVERIFY(!stacker.addFrame(reinterpret_cast<uint8_t const *>(frame.data()), 50, TUSHORT));
+    QVERIFY(!stacker.addFrame(reinterpret_cast<uint8_t const *>(frame.data()), 50, TBYTE));
+    QCOMPARE(stacker.frameCount(), 1);
+
+    stacker.clear();
+    QCOMPARE(stacker.frameCount(), 0);
+    std::vector<uint16_t> master(100);
+    QVERIFY(!stacker.combine(reinterpret_cast<uint8_t *>(master.data()), Ekos::FrameStacker::Parameters()));
+}
+
+QTEST_GUILESS_MAIN(TestStacking)
@@ -5,7 +5,10 @@
 */
 
 #include <QtTest>
+#include <QRandomGenerator>
+#include <limits>
 #include <memory>
+#include <vector>
 
 #include <QObject>
 #include "fitsviewer/fitsdata.h"
@@ -21,10 +24,71 @@ class TestSubtraction : public QObject
 
     private slots:
         void basicTest();
+        void saturationTest();
+
+        void benchmarkSubtraction_data();
+        void benchmarkSubtraction();
 };
 
 #include "testsubtraction.moc"
 
+namespace
+{
+// Rows that are not a multiple of the vector width, so that both the vector and the scalar
+// parts of each row are exercised.
+constexpr uint32_t kWidth = 45;
+constexpr uint32_t kHeight = 70;
+
+template <typename T>
+QSharedPointer<FITSData> makeFrame(int dataType, const std::vector<T> &pixels)
+{
+    FITSImage::Statistic stats;
+    stats.width = kWidth;
+    stats.height = kHeight;
+    stats.channels = 1;
+    stats.dataType = dataType;
+    stats.bytesPerPixel = sizeof(T);
+    stats.samples_per_channel = kWidth * kHeight;
+
+    QSharedPointer<FITSData> frame(new FITSData());
+    frame->restoreStatistics(stats);
+    uint8_t *buffer = new uint8_t[pixels.size() * sizeof(T)];
+    memcpy(buffer, pixels.data(), pixels.size() * sizeof(T));
+    frame->setImageBuffer(buffer);
+    return frame;
+}
+
+// Subtracts random darks from lights close to the largest and smallest values of the type,
+// and compares every pixel with light - dark clamped to [0, max].
+template <typename T>
+void compareSaturated(int dataType)
+{
+    const qint64 low = std::numeric_limits<T>::min(), high = std::numeric_limits<T>::max();
+    QRandomGenerator generator(dataType);
+    std::vector<T> light(kWidth * kHeight), dark(kWidth * kHeight);
+    for (size_t i = 0; i < light.size(); i++)
+    {
+        const qint64 margin = generator.bounded(300);
+        light[i] = static_cast<T>(i % 3 == 0 ? low + margin : high - margin);
+        dark[i] = static_cast<T>(i % 2 == 0 ? low + generator.bounded(300) : high - generator.bounded(600));
+    }
+
+    QSharedPointer<FITSData> lightData = makeFrame(dataType, light);
+    QSharedPointer<FITSData> darkData = makeFrame(dataType, dark);
+    QPointer<Ekos::DarkProcessor> processor = new Ekos::DarkProcessor();
+    processor->subtractDarkData(darkData, lightData, 0, 0);
+
+    T const *result = reinterpret_cast<T const *>(lightData->getImageBuffer());
+    for (size_t i = 0; i < light.size(); i++)
+    {
+        const qint64 expected = qBound<qint64>(0, qint64(light[i]) - qint64(dark[i]), high);
+        if (qint64(result[i]) != expected)
+            QFAIL(qPrintable(QString("Pixel %1: %2 - %3 gave %4 instead of %5").arg(i).arg(qint64(light[i]))
+                             .arg(qint64(dark[i])).arg(qint64(result[i])).arg(expected)));
+    }
+}
+}
+
 TestSubtraction::TestSubtraction() : QObject()
 {
 }
@@ -56,5 +120,48 @@ void TestSubtraction::basicTest()
         QCOMPARE(buffer[i], 0);
 }
 
+void TestSubtraction::saturationTest()
+{
+    // 8 and 16-bit frames take the SSE2 kernels where available, the others the generic one
+    compareSaturated<uint8_t>(TBYTE);
+    compareSaturated<int16_t>(TSHORT);
+    compareSaturated<uint16_t>(TUSHORT);
+    compareSaturated<int32_t>(TLONG);
+    compareSaturated<uint32_t>(TULONG);
+}
+
+void TestSubtraction::benchmarkSubtraction_data()
+{
+    QTest::addColumn<QString>("filename");
+
+    QTest::newRow("M47") << "../Tests/fitsviewer/m47_sim_stars.fits";
+    QTest::newRow("NGC4535") << "../Tests/fitsviewer/ngc4535-autofocus1.fits";
+    QTest::newRow("Bahtinov") << "../Tests/fitsviewer/bahtinov-focus.fits";
+}
+
+void TestSubtraction::benchmarkSubtraction()
+{
+    QFETCH(QString, filename);
+    if (!QFileInfo::exists(filename))
+        QSKIP(QString("Failed to locate file %1, skipping test.").arg(filename).toLatin1());
+
+    // The same frame as light and dark, loaded twice so that they don't share pixels
+    QSharedPointer<FITSData> lightData(new FITSData()), darkData(new FITSData());
+    QFuture<bool> lightResult = lightData->loadFromFile(filename);
+    QFuture<bool> darkResult = darkData->loadFromFile(filename);
+    lightResult.waitForFinished();
+    darkResult.waitForFinished();
+
+    if (lightResult.result() == false || darkResult.result() == false)
+        QSKIP("Failed to load image, skipping test.");
+
+    QPointer<Ekos::DarkProcessor> processor = new Ekos::DarkProcessor();
+    QBENCHMARK
+    {
+        processor->subtractDarkData(darkData, lightData, 0, 0);
+    }
+
+    QCOMPARE(lightData->getMax(), 0.0);
+}
 
 QTEST_GUILESS_MAIN(TestSubtraction)
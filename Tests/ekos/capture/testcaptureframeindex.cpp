@@ -0,0 +1,186 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QtTest>
+
+#include <QObject>
+#include <QTemporaryDir>
+#include "ekos/capture/captureframeindex.h"
+
+class TestCaptureFrameIndex : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestCaptureFrameIndex();
+        ~TestCaptureFrameIndex() override = default;
+
+    private slots:
+        void countTest();
+        void addFileTest();
+        void reconcileTest();
+        void externalChangeTest();
+        void persistenceTest();
+
+    private:
+        static void touch(const QString &filename);
+        // Writes a file and adds it to the index, as the capture does
+        static void write(Ekos::CaptureFrameIndex &index, const QString &filename);
+        // File system time stamps may be as coarse as a second
+        static void waitForNewTimestamp();
+};
+
+#include "testcaptureframeindex.moc"
+
+TestCaptureFrameIndex::TestCaptureFrameIndex() : QObject()
+{
+}
+
+void TestCaptureFrameIndex::touch(const QString &filename)
+{
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("x");
+}
+
+void TestCaptureFrameIndex::write(Ekos::CaptureFrameIndex &index, const QString &filename)
+{
+    const QString directory = QFileInfo(filename).absolutePath();
+    const qint64 before = Ekos::CaptureFrameIndex::modificationTime(directory);
+    touch(filename);
+    index.addFile(filename, before, Ekos::CaptureFrameIndex::modificationTime(directory));
+}
+
+void TestCaptureFrameIndex::waitForNewTimestamp()
+{
+    QTest::qSleep(1100);
+}
+
+void TestCaptureFrameIndex::countTest()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString frames = dir.filePath("frames");
+    QVERIFY(QDir().mkpath(frames));
+    for (const QString &name :
+            {
+                "M42_Light_R_001.fits", "M42_Light_R_002.fits", "M42_Light_R_003.fits.fz", "M42_Light_G_001.fits",
+                "M42_Light_R_004.fits.part", "M31_Light_R_001.fits"
+            })
+        touch(QDir(frames).filePath(name));
+
+    Ekos::CaptureFrameIndex index(dir.filePath("index.sqlite"));
+
+    // The file being written is not counted, the compressed one is
+    QCOMPARE(index.count(frames, "M42_Light_R"), 3);
+    QCOMPARE(index.count(frames, "M42_Light"), 4);
+    QCOMPARE(index.count(frames, "M42"), 4);
+    QCOMPARE(index.count(frames, "M31_Light_R"), 1);
+    QCOMPARE(index.count(frames, "M33"), 0);
+    // Cached
+    QCOMPARE(index.count(frames, "M42_Light_R"), 3);
+
+    QCOMPARE(index.files(frames).size(), 5);
+    QCOMPARE(index.files(frames).first(), QString("M31_Light_R_001.fits"));
+
+    QCOMPARE(index.count(dir.filePath("missing"), "M42"), 0);
+}
+
+void TestCaptureFrameIndex::addFileTest()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString frames = dir.filePath("frames");
+    QVERIFY(QDir().mkpath(frames));
+    touch(QDir(frames).filePath("M42_Light_R_001.fits"));
+
+    Ekos::CaptureFrameIndex index(dir.filePath("index.sqlite"));
+    QCOMPARE(index.count(frames, "M42_Light_R"), 1);
+
+    waitForNewTimestamp();
+    write(index, QDir(frames).filePath("M42_Light_R_002.fits"));
+    write(index, QDir(frames).filePath("M42_Light_R_003.fits.part"));
+    QCOMPARE(index.count(frames, "M42_Light_R"), 2);
+    QCOMPARE(index.files(frames), QStringList({"M42_Light_R_001.fits", "M42_Light_R_002.fits"}));
+}
+
+void TestCaptureFrameIndex::reconcileTest()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString frames = dir.filePath("frames");
+    QVERIFY(QDir().mkpath(frames));
+    touch(QDir(frames).filePath("M42_Light_R_001.fits"));
+
+    Ekos::CaptureFrameIndex index(dir.filePath("index.sqlite"));
+    QCOMPARE(index.count(frames, "M42_Light_R"), 1);
+
+    // Files added and removed by another program are found on the next query
+    waitForNewTimestamp();
+    touch(QDir(frames).filePath("M42_Light_R_002.fits"));
+    QCOMPARE(index.count(frames, "M42_Light_R"), 2);
+
+    waitForNewTimestamp();
+    QVERIFY(QFile::remove(QDir(frames).filePath("M42_Light_R_001.fits")));
+    QCOMPARE(index.count(frames, "M42_Light_R"), 1);
+}
+
+void TestCaptureFrameIndex::externalChangeTest()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString frames = dir.filePath("frames");
+    QVERIFY(QDir().mkpath(frames));
+    touch(QDir(frames).filePath("M42_Light_R_001.fits"));
+    touch(QDir(frames).filePath("M42_Light_R_002.fits"));
+
+    Ekos::CaptureFrameIndex index(dir.filePath("index.sqlite"));
+    QCOMPARE(index.count(frames, "M42_Light_R"), 2);
+
+    // A file deleted by another program before the capture writes the next one is not counted any more
+    waitForNewTimestamp();
+    QVERIFY(QFile::remove(QDir(frames).filePath("M42_Light_R_001.fits")));
+    waitForNewTimestamp();
+    write(index, QDir(frames).filePath("M42_Light_R_003.fits"));
+    QCOMPARE(index.count(frames, "M42_Light_R"), 2);
+    QCOMPARE(index.files(frames), QStringList({"M42_Light_R_002.fits", "M42_Light_R_003.fits"}));
+
+    // The next write, with no other change, keeps the index current
+    waitForNewTimestamp();
+    write(index, QDir(frames).filePath("M42_Light_R_004.fits"));
+    QCOMPARE(index.count(frames, "M42_Light_R"), 3);
+}
+
+void TestCaptureFrameIndex::persistenceTest()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString frames = dir.filePath("frames");
+    QVERIFY(QDir().mkpath(frames));
+    touch(QDir(frames).filePath("M42_Light_R_001.fits"));
+    touch(QDir(frames).filePath("M42_Light_R_002.fits"));
+
+    {
+        Ekos::CaptureFrameIndex index(dir.filePath("index.sqlite"));
+        QCOMPARE(index.count(frames, "M42_Light_R"), 2);
+    }
+
+    {
+        Ekos::CaptureFrameIndex index(dir.filePath("index.sqlite"));
+        QCOMPARE(index.count(frames, "M42_Light_R"), 2);
+        QCOMPARE(index.files(frames), QStringList({"M42_Light_R_001.fits", "M42_Light_R_002.fits"}));
+    }
+
+    // A file added while no index was open is found by the next one
+    waitForNewTimestamp();
+    touch(QDir(frames).filePath("M42_Light_R_003.fits"));
+    {
+        Ekos::CaptureFrameIndex index(dir.filePath("index.sqlite"));
+        QCOMPARE(index.count(frames, "M42_Light_R"), 3);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestCaptureFrameIndex)
@@ -0,0 +1,172 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "testdebayerengine.h"
+
+#include "fitsviewer/debayerengine.h"
+
+#include <QRandomGenerator>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+// Tall enough for several bands of rows
+constexpr uint32_t kWidth = 120;
+constexpr uint32_t kHeight = 338;
+
+template <typename T>
+std::vector<T> mosaic(quint32 seed)
+{
+    QRandomGenerator generator(seed);
+    std::vector<T> bayer(kWidth * kHeight);
+    for (T &sample : bayer)
+        sample = static_cast<T>(generator.generate());
+    return bayer;
+}
+
+dc1394error_t reference(const uint8_t *bayer, uint8_t *rgb, dc1394color_filter_t filter, dc1394bayer_method_t method)
+{
+    return dc1394_bayer_decoding_8bit(bayer, rgb, kWidth, kHeight, filter, method);
+}
+
+dc1394error_t reference(const uint16_t *bayer, uint16_t *rgb, dc1394color_filter_t filter, dc1394bayer_method_t method)
+{
+    return dc1394_bayer_decoding_16bit(bayer, rgb, kWidth, kHeight, filter, method, 16);
+}
+
+template <typename T>
+void compare(dc1394color_filter_t filter, dc1394bayer_method_t method)
+{
+    const std::vector<T> bayer = mosaic<T>(filter * 8 + method);
+    const size_t pixels = kWidth * kHeight;
+    std::vector<T> expected(pixels * 3, 0), interleaved(pixels * 3, 0), planar(pixels * 3, 0);
+
+    QCOMPARE(reference(bayer.data(), expected.data(), filter, method), DC1394_SUCCESS);
+    QCOMPARE(DebayerEngine::decode(bayer.data(), interleaved.data(), kWidth, kHeight, filter, method,
+                                   DebayerEngine::INTERLEAVED), DC1394_SUCCESS);
+    QCOMPARE(DebayerEngine::decode(bayer.data(), planar.data(), kWidth, kHeight, filter, method,
+                                   DebayerEngine::PLANAR), DC1394_SUCCESS);
+
+    // Downsampled pixels fill only part of the output
+    const size_t count = method == DC1394_BAYER_METHOD_DOWNSAMPLE ? pixels / 4 : pixels;
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (size_t c = 0; c < 3; ++c)
+        {
+            if (interleaved[i * 3 + c] != expected[i * 3 + c] || planar[c * pixels + i] != expected[i * 3 + c])
+                QFAIL(qPrintable(QString("Pixel %1,%2 channel %3 differs").arg(i % kWidth).arg(i / kWidth).arg(c)));
+        }
+    }
+}
+}
+
+void TestDebayerEngine::testMatchesBayer_data()
+{
+    QTest::addColumn<int>("filter");
+    QTest::addColumn<int>("method");
+
+    const char *filters[] = { "RGGB", "GBRG", "GRBG", "BGGR" };
+    const char *methods[] = { "Nearest", "Simple", "Bilinear", "HQLinear", "Downsample", "EdgeSense", "VNG", "AHD" };
+
+    for (int filter = DC1394_COLOR_FILTER_MIN; filter <= DC1394_COLOR_FILTER_MAX; filter++)
+    {
+        for (int method = DC1394_BAYER_METHOD_MIN; method <= DC1394_BAYER_METHOD_MAX; method++)
+            QTest::newRow(qPrintable(QString("%1 %2").arg(filters[filter - DC1394_COLOR_FILTER_MIN], methods[method])))
+                    << filter << method;
+    }
+}
+
+void TestDebayerEngine::testMatchesBayer()
+{
+    QFETCH(int, filter);
+    QFETCH(int, method);
+
+    compare<uint8_t>(static_cast<dc1394color_filter_t>(filter), static_cast<dc1394bayer_method_t>(method));
+    compare<uint16_t>(static_cast<dc1394color_filter_t>(filter), static_cast<dc1394bayer_method_t>(method));
+}
+
+void TestDebayerEngine::testConcurrentVNG()
+{
+    // VNG walks static tables of bayer.c. With many bands decoded at once, each band must still
+    // come out as the serial decoder makes it, which a shared scan pointer used to break.
+    const uint32_t width = 640, height = 1280;
+    QRandomGenerator generator(3);
+    std::vector<uint16_t> bayer16(width * height);
+    std::vector<uint8_t> bayer8(width * height);
+    for (size_t i = 0; i < bayer16.size(); ++i)
+    {
+        bayer16[i] = static_cast<uint16_t>(generator.generate());
+        bayer8[i] = static_cast<uint8_t>(bayer16[i] >> 8);
+    }
+
+    const size_t pixels = width * height;
+    std::vector<uint8_t> expected8(pixels * 3), planar8(pixels * 3);
+    std::vector<uint16_t> expected16(pixels * 3), planar16(pixels * 3);
+    QCOMPARE(dc1394_bayer_decoding_8bit(bayer8.data(), expected8.data(), width, height, DC1394_COLOR_FILTER_GRBG,
+                                        DC1394_BAYER_METHOD_VNG), DC1394_SUCCESS);
+    QCOMPARE(dc1394_bayer_decoding_16bit(bayer16.data(), expected16.data(), width, height, DC1394_COLOR_FILTER_GRBG,
+                                         DC1394_BAYER_METHOD_VNG, 16), DC1394_SUCCESS);
+
+    for (int run = 0; run < 4; ++run)
+    {
+        QCOMPARE(DebayerEngine::decode(bayer8.data(), planar8.data(), width, height, DC1394_COLOR_FILTER_GRBG,
+                                       DC1394_BAYER_METHOD_VNG, DebayerEngine::PLANAR), DC1394_SUCCESS);
+        QCOMPARE(DebayerEngine::decode(bayer16.data(), planar16.data(), width, height, DC1394_COLOR_FILTER_GRBG,
+                                       DC1394_BAYER_METHOD_VNG, DebayerEngine::PLANAR), DC1394_SUCCESS);
+
+        for (size_t i = 0; i < pixels; ++i)
+        {
+            for (size_t c = 0; c < 3; ++c)
+            {
+                if (planar8[c * pixels + i] != expected8[i * 3 + c] || planar16[c * pixels + i] != expected16[i * 3 + c])
+                    QFAIL(qPrintable(QString("Run %1, pixel %2,%3 channel %4 differs").arg(run).arg(i % width)
+                                     .arg(i / width).arg(c)));
+            }
+        }
+    }
+}
+
+void TestDebayerEngine::testPlaneSize()
+{
+    // FITSData decodes one row less than its planes hold when the mosaic is shifted up
+    const std::vector<uint16_t> bayer = mosaic<uint16_t>(1);
+    const size_t planeSize = kWidth * kHeight;
+    std::vector<uint16_t> planar(planeSize * 3, 0), expected(planeSize * 3, 0);
+
+    QCOMPARE(DebayerEngine::decode(bayer.data(), planar.data(), kWidth, kHeight - 1, DC1394_COLOR_FILTER_RGGB,
+                                   DC1394_BAYER_METHOD_BILINEAR, DebayerEngine::PLANAR, planeSize), DC1394_SUCCESS);
+    QCOMPARE(DebayerEngine::decode(bayer.data(), expected.data(), kWidth, kHeight - 1, DC1394_COLOR_FILTER_RGGB,
+                                   DC1394_BAYER_METHOD_BILINEAR, DebayerEngine::PLANAR), DC1394_SUCCESS);
+
+    const size_t decoded = kWidth * (kHeight - 1);
+    for (size_t c = 0; c < 3; ++c)
+    {
+        QVERIFY(std::equal(planar.begin() + c * planeSize, planar.begin() + c * planeSize + decoded,
+                           expected.begin() + c * decoded));
+        // The spare row is left alone
+        QVERIFY(std::all_of(planar.begin() + c * planeSize + decoded, planar.begin() + (c + 1) * planeSize,
+                            [](uint16_t sample)
+        {
+            return sample == 0;
+        }));
+    }
+}
+
+void TestDebayerEngine::testInvalidArguments()
+{
+    std::vector<uint8_t> bayer(16, 0), rgb(48, 0);
+
+    QCOMPARE(DebayerEngine::decode(bayer.data(), rgb.data(), 4, 4, static_cast<dc1394color_filter_t>(0),
+                                   DC1394_BAYER_METHOD_BILINEAR, DebayerEngine::PLANAR), DC1394_INVALID_COLOR_FILTER);
+    QCOMPARE(DebayerEngine::decode(bayer.data(), rgb.data(), 4, 4, DC1394_COLOR_FILTER_RGGB,
+                                   static_cast<dc1394bayer_method_t>(42), DebayerEngine::PLANAR), DC1394_INVALID_BAYER_METHOD);
+    QCOMPARE(DebayerEngine::decode(bayer.data(), nullptr, 4, 4, DC1394_COLOR_FILTER_RGGB,
+                                   DC1394_BAYER_METHOD_BILINEAR, DebayerEngine::PLANAR), DC1394_INVALID_ARGUMENT_VALUE);
+}
+
+QTEST_GUILESS_MAIN(TestDebayerEngine)
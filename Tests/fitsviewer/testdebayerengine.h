@@ -0,0 +1,29 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+/**
+ * @class TestDebayerEngine
+ * @short Debayers in parallel bands exactly as bayer.c does on the whole mosaic
+ */
+class TestDebayerEngine : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestDebayerEngine() = default;
+        ~TestDebayerEngine() override = default;
+
+    private slots:
+        void testMatchesBayer_data();
+        void testMatchesBayer();
+        void testConcurrentVNG();
+        void testPlaneSize();
+        void testInvalidArguments();
+};
@@ -0,0 +1,162 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "testfitsblob.h"
+
+#include "fitsviewer/fitsblob.h"
+
+#include <QBuffer>
+#include <QtConcurrent>
+
+#include <fitsio.h>
+
+namespace
+{
+constexpr long kWidth  = 37;
+constexpr long kHeight = 23;
+
+// Writes a kWidth x kHeight image of the given BITPIX with values spanning the range of dataType,
+// and returns the file.
+QByteArray makeFITS(const QString &filename, int bitpix, int dataType)
+{
+    fitsfile *fptr = nullptr;
+    int status = 0;
+    long naxes[2] = { kWidth, kHeight };
+    const long count = kWidth * kHeight;
+
+    QVector<double> values(count);
+    for (long i = 0; i < count; ++i)
+    {
+        switch (dataType)
+        {
+            case TBYTE:
+                values[i] = i % 256;
+                break;
+            case TUSHORT:
+                values[i] = (i * 977) % 65536;
+                break;
+            case TULONG:
+                values[i] = (i * 4294967.0) + 1;
+                break;
+            case TLONGLONG:
+                values[i] = (i - count / 2) * 1234567.0;
+                break;
+            default:
+                values[i] = (i - count / 2) * 0.37;
+                break;
+        }
+    }
+
+    fits_create_file(&fptr, QString("!%1").arg(filename).toLocal8Bit().constData(), &status);
+    fits_create_img(fptr, bitpix, 2, naxes, &status);
+    fits_write_img(fptr, TDOUBLE, 1, count, values.data(), &status);
+    fits_close_file(fptr, &status);
+    if (status != 0)
+        return QByteArray();
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll();
+}
+}
+
+TestFITSBlob::TestFITSBlob() : QObject()
+{
+}
+
+void TestFITSBlob::testAdoptAndWrite_data()
+{
+    QTest::addColumn<int>("BITPIX");
+    QTest::addColumn<int>("TYPE");
+    QTest::addColumn<int>("BYTES");
+    QTest::addColumn<bool>("SIGN_FLIP");
+
+    QTest::newRow("byte") << int(BYTE_IMG) << int(TBYTE) << 1 << false;
+    QTest::newRow("ushort") << int(USHORT_IMG) << int(TUSHORT) << 2 << true;
+    QTest::newRow("ulong") << int(ULONG_IMG) << int(TULONG) << 4 << true;
+    QTest::newRow("longlong") << int(LONGLONG_IMG) << int(TLONGLONG) << 8 << false;
+    QTest::newRow("float") << int(FLOAT_IMG) << int(TFLOAT) << 4 << false;
+    QTest::newRow("double") << int(DOUBLE_IMG) << int(TDOUBLE) << 8 << false;
+}
+
+void TestFITSBlob::testAdoptAndWrite()
+{
+    QFETCH(int, BITPIX);
+    QFETCH(int, TYPE);
+    QFETCH(int, BYTES);
+    QFETCH(bool, SIGN_FLIP);
+
+    QVERIFY(m_Directory.isValid());
+    const QByteArray original = makeFITS(m_Directory.filePath(QString("bitpix%1.fits").arg(BITPIX)), BITPIX, TYPE);
+    QVERIFY(!original.isEmpty());
+
+    FITSBlob blob(original.constData(), original.size());
+    QVERIFY(!blob.isAdopted());
+
+    // Expected pixels and their offset, read by cfitsio
+    fitsfile *fptr = nullptr;
+    int status = 0, anynull = 0;
+    void *memory = const_cast<char *>(blob.data().constData());
+    size_t size = blob.size();
+    QVERIFY(fits_open_memfile(&fptr, "blob", READONLY, &memory, &size, 0, nullptr, &status) == 0);
+
+    const long count = kWidth * kHeight;
+    QByteArray expected(count * BYTES, 0);
+    LONGLONG headStart = 0, dataStart = 0, dataEnd = 0;
+    // Unsigned 32-bit pixels are native uint32_t, which TULONG is not on LP64
+    fits_read_img(fptr, TYPE == TULONG ? TUINT : TYPE, 1, count, nullptr, expected.data(), &anynull, &status);
+    fits_get_hduaddrll(fptr, &headStart, &dataStart, &dataEnd, &status);
+    fits_close_file(fptr, &status);
+    QCOMPARE(status, 0);
+
+    const uint8_t *pixels = blob.adoptPixels(dataStart, count, BYTES, SIGN_FLIP);
+    QVERIFY(pixels != nullptr);
+    QVERIFY(blob.isAdopted());
+    QCOMPARE(blob.pixels(), pixels);
+    QCOMPARE(memcmp(pixels, expected.constData(), expected.size()), 0);
+
+    // Adopted once only
+    QVERIFY(blob.adoptPixels(dataStart, count, BYTES, SIGN_FLIP) == nullptr);
+
+    QBuffer written;
+    QVERIFY(written.open(QIODevice::WriteOnly));
+    QVERIFY(blob.write(&written));
+    QCOMPARE(written.data(), original);
+
+    // Pixels may only change once pending writes are done
+    QAtomicInt ended(0);
+    blob.beginWrite();
+    QFuture<void> writer = QtConcurrent::run([&blob, &ended]()
+    {
+        QThread::msleep(50);
+        ended.storeRelease(1);
+        blob.endWrite();
+    });
+    blob.waitForWrite();
+    QCOMPARE(ended.loadAcquire(), 1);
+    writer.waitForFinished();
+}
+
+void TestFITSBlob::testInvalidRange()
+{
+    const QByteArray data(2880 * 2, 'x');
+    FITSBlob blob(data.constData(), data.size());
+
+    QVERIFY(blob.adoptPixels(2880, 2881, 1, false) == nullptr);
+    QVERIFY(blob.adoptPixels(-2, 4, 2, false) == nullptr);
+    QVERIFY(blob.adoptPixels(2880, 16, 3, false) == nullptr);
+    QVERIFY(!blob.isAdopted());
+    QVERIFY(blob.pixels() == nullptr);
+
+    // Nothing adopted, written as received
+    QBuffer written;
+    QVERIFY(written.open(QIODevice::WriteOnly));
+    QVERIFY(blob.write(&written));
+    QCOMPARE(written.data(), data);
+}
+
+QTEST_GUILESS_MAIN(TestFITSBlob)
@@ -0,0 +1,32 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+/**
+ * @class TestFITSBlob
+ * @short Adopts the pixels of FITS files of every BITPIX in place and writes them back
+ */
+class TestFITSBlob : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestFITSBlob();
+        ~TestFITSBlob() override = default;
+
+    private slots:
+        void testAdoptAndWrite_data();
+        void testAdoptAndWrite();
+
+        void testInvalidRange();
+
+    private:
+        QTemporaryDir m_Directory;
+};
@@ -5,6 +5,7 @@
 */
 
 #include <QtTest>
+#include <cmath>
 #include <memory>
 #include "testfitsdata.h"
 #include "Options.h"
@@ -131,6 +132,8 @@ void TestFitsData::testBahtinovFocusHFR()
     // The bahtinov algorithm depends on which star is selected and number of average rows - not sure how to fiddle with that yet
     const QRect trackingBox(204, 240, 128, 128);
 
+    // Expected HFR is the one of the rotation search
+    Options::setFocusFastBahtinov(false);
     d->findStars(ALGORITHM_BAHTINOV, trackingBox).waitForFinished();
     QCOMPARE(d->getDetectedStars(), NSTARS);
     QCOMPARE(d->getStarCenters().count(), 1);
@@ -138,6 +141,84 @@ void TestFitsData::testBahtinovFocusHFR()
 #endif
 }
 
+void TestFitsData::testBahtinovFastDetection_data()
+{
+#if QT_VERSION < 0x050900
+    QSKIP("Skipping fixture-based test on old QT version.");
+#else
+    QTest::addColumn<QString>("NAME");
+    QTest::addColumn<QRect>("BOX");
+    QTest::addColumn<double>("HFR");
+
+    // The same star in tracking boxes shifted by a few pixels
+    QTest::newRow("BAHTINOV-CENTERED") << "bahtinov-focus.fits" << QRect(204, 240, 128, 128) << 2.07;
+    QTest::newRow("BAHTINOV-TOP-LEFT") << "bahtinov-focus.fits" << QRect(200, 236, 128, 128) << 2.07;
+    QTest::newRow("BAHTINOV-BOTTOM-RIGHT") << "bahtinov-focus.fits" << QRect(208, 244, 128, 128) << 2.07;
+    QTest::newRow("BAHTINOV-LEFT") << "bahtinov-focus.fits" << QRect(196, 240, 128, 128) << 2.07;
+    QTest::newRow("BAHTINOV-TOP-RIGHT") << "bahtinov-focus.fits" << QRect(210, 234, 128, 128) << 2.07;
+#endif
+}
+
+void TestFitsData::testBahtinovFastDetection()
+{
+#if QT_VERSION < 0x050900
+    QSKIP("Skipping fixture-based test on old QT version.");
+#else
+    QFETCH(QString, NAME);
+    QFETCH(QRect, BOX);
+    QFETCH(double, HFR);
+
+    if(!QFile::exists(NAME))
+        QSKIP("Skipping load test because of missing fixture");
+
+    std::unique_ptr<FITSData> d(new FITSData(FITS_FOCUS));
+    QVERIFY(d != nullptr);
+
+    QFuture<bool> worker = d->loadFromFile(NAME);
+    QTRY_VERIFY_WITH_TIMEOUT(worker.isFinished(), 10000);
+    QVERIFY(worker.result());
+
+    // Angles of the spikes found by the rotation search, good to a degree
+    Options::setFocusFastBahtinov(false);
+    d->findStars(ALGORITHM_BAHTINOV, BOX).waitForFinished();
+    QCOMPARE(d->getStarCenters().count(), 1);
+    auto const * reference = dynamic_cast<BahtinovEdge *>(d->getStarCenters().first());
+    QVERIFY(reference != nullptr);
+    QVector<double> referenceAngles;
+    for (const auto &line : reference->line)
+        referenceAngles.append(fmod(line.angle(), 180.0));
+
+    QElapsedTimer timer;
+    timer.start();
+    Options::setFocusFastBahtinov(true);
+    d->findStars(ALGORITHM_BAHTINOV, BOX).waitForFinished();
+    qDebug() << "Gradient oriented Hough transform took" << timer.elapsed() << "milliseconds";
+
+    QCOMPARE(d->getDetectedStars(), 1);
+    QCOMPARE(d->getStarCenters().count(), 1);
+    auto const * star = dynamic_cast<BahtinovEdge *>(d->getStarCenters().first());
+    QVERIFY(star != nullptr);
+    QCOMPARE(star->line.count(), 3);
+
+    // Each spike is within the step of the rotation search of one of its spikes
+    for (const auto &line : star->line)
+    {
+        double closest = 180;
+        for (double angle : referenceAngles)
+        {
+            const double difference = fabs(fmod(line.angle(), 180.0) - angle);
+            closest = std::min(closest, std::min(difference, 180 - difference));
+        }
+        QVERIFY2(closest < 3, qPrintable(QString("Spike at %1 degrees, %2 degrees away from the rotation search")
+                                         .arg(line.angle()).arg(closest)));
+    }
+
+    // Sub-degree angles keep the focus offset steady whatever the position of the tracking box
+    qDebug() << "Expected HFR:" << HFR << "Calculated:" << d->getHFR();
+    QVERIFY(abs(d->getHFR() - HFR) < 0.1);
+#endif
+}
+
 void TestFitsData::initGenericDataFixture()
 {
 #if QT_VERSION < 0x050900
@@ -410,6 +491,69 @@ void TestFitsData::testSEPAlgorithmBenchmark()
 #endif
 }
 
+void TestFitsData::testSEPTiledExtraction_data()
+{
+#if QT_VERSION < 0x050900
+    QSKIP("Skipping fixture-based test on old QT version.");
+#else
+    initGenericDataFixture();
+#endif
+}
+
+void TestFitsData::testSEPTiledExtraction()
+{
+#if QT_VERSION < 0x050900
+    QSKIP("Skipping fixture-based test on old QT version.");
+#else
+    QFETCH(QString, NAME);
+    QFETCH(FITSMode, MODE);
+
+    if(!QFile::exists(NAME))
+        QSKIP("Skipping load test because of missing fixture");
+
+    std::unique_ptr<FITSData> d(new FITSData(MODE));
+    QVERIFY(d != nullptr);
+
+    QFuture<bool> worker = d->loadFromFile(NAME);
+    QTRY_VERIFY_WITH_TIMEOUT(worker.isFinished(), 10000);
+    QVERIFY(worker.result());
+
+    // Full frame at once
+    d->setSourceExtractorSettings({{"tiledExtraction", false}});
+    worker = d->findStars(ALGORITHM_SEP);
+    QTRY_VERIFY_WITH_TIMEOUT(worker.isFinished(), 10000);
+    QVERIFY(worker.result());
+    QList<QPointF> reference;
+    for (const auto &center : d->getStarCenters())
+        reference.append(QPointF(center->x, center->y));
+
+    // Tiles small enough for the fixture to be split
+    d->setSourceExtractorSettings({{"tiledExtraction", true}, {"minTileSide", 256}});
+    worker = d->findStars(ALGORITHM_SEP);
+    QTRY_VERIFY_WITH_TIMEOUT(worker.isFinished(), 10000);
+    QVERIFY(worker.result());
+
+    // Duplicates in the overlaps are merged, so about the same stars are found at about the same place
+    const QList<Edge *> &tiled = d->getStarCenters();
+    qDebug() << "Stars found at once:" << reference.count() << "in tiles:" << tiled.count();
+    QVERIFY(abs(tiled.count() - reference.count()) <= std::max(2, reference.count() / 20));
+
+    int matched = 0;
+    for (const auto &center : tiled)
+    {
+        for (const auto &point : reference)
+        {
+            if (std::hypot(center->x - point.x(), center->y - point.y()) < 1)
+            {
+                matched++;
+                break;
+            }
+        }
+    }
+    QVERIFY(matched >= tiled.count() * 9 / 10);
+#endif
+}
+
 SolverLoop::SolverLoop(const QVector<QString> &files, const QString &dir, bool isDetecting, int numReps)
 {
     filenames = files;
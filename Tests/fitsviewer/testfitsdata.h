@@ -44,12 +44,18 @@ class TestFitsData : public QObject
         void testSEPAlgorithmBenchmark_data();
         void testSEPAlgorithmBenchmark();
 
+        void testSEPTiledExtraction_data();
+        void testSEPTiledExtraction();
+
         void testComputeHFR_data();
         void testComputeHFR();
 
         void testBahtinovFocusHFR_data();
         void testBahtinovFocusHFR();
 
+        void testBahtinovFastDetection_data();
+        void testBahtinovFastDetection();
+
         void testParallelSolvers();
     private:
         void startGuideDetect(const QString &filename);
@@ -0,0 +1,121 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "testfitspixelbuffer.h"
+
+#include "fitsviewer/fitspixelbuffer.h"
+
+#include <cstring>
+
+namespace
+{
+constexpr qint64 kFrameSize = 3 * 1024 * 1024 + 17;
+}
+
+void TestFITSPixelBuffer::init()
+{
+    FITSBufferPool::Instance()->setRetainLimit(FITSBufferPool::DEFAULT_RETAIN_LIMIT);
+    FITSBufferPool::Instance()->clear();
+}
+
+void TestFITSPixelBuffer::testCopyOnWrite()
+{
+    FITSPixelBuffer original = FITSPixelBuffer::allocate(kFrameSize);
+    QVERIFY(!original.isNull());
+    QCOMPARE(original.size(), kFrameSize);
+    memset(original.data(), 7, kFrameSize);
+
+    // Copies share the pixels
+    FITSPixelBuffer copy = original;
+    QVERIFY(original.isShared());
+    QVERIFY(copy.isShared());
+    QCOMPARE(copy.constData(), original.constData());
+
+    // Writing to a copy detaches it and leaves the original alone
+    uint8_t *pixels = copy.data();
+    QVERIFY(pixels != original.constData());
+    QVERIFY(!copy.isShared());
+    QVERIFY(!original.isShared());
+    QCOMPARE(pixels[kFrameSize - 1], uint8_t(7));
+    pixels[0] = 42;
+    QCOMPARE(original.constData()[0], uint8_t(7));
+
+    // An unshared buffer is written in place
+    const uint8_t *before = original.constData();
+    QVERIFY(original.data() == before);
+
+    original.reset();
+    QVERIFY(original.isNull());
+    QCOMPARE(original.size(), qint64(0));
+    QVERIFY(original.constData() == nullptr);
+    QVERIFY(original.data() == nullptr);
+
+    // Arrays allocated with new[] are adopted
+    FITSPixelBuffer array = FITSPixelBuffer::fromArray(new uint8_t[16], 16);
+    QCOMPARE(array.size(), qint64(16));
+    QVERIFY(array.data() != nullptr);
+}
+
+void TestFITSPixelBuffer::testSizeClasses()
+{
+    // Small buffers are not rounded
+    QCOMPARE(FITSBufferPool::sizeClass(1000), qint64(1000));
+
+    for (qint64 size : { FITSBufferPool::MIN_POOLED_SIZE, kFrameSize, qint64(8000000), qint64(123456789) })
+    {
+        const qint64 capacity = FITSBufferPool::sizeClass(size);
+        QVERIFY(capacity >= size);
+        QVERIFY(capacity <= size + size / 8);
+        // Every size of a class maps to the class itself
+        QCOMPARE(FITSBufferPool::sizeClass(capacity), capacity);
+    }
+}
+
+void TestFITSPixelBuffer::testPoolReuse()
+{
+    FITSBufferPool *pool = FITSBufferPool::Instance();
+    const FITSBufferPool::Statistics start = pool->statistics();
+    QCOMPARE(start.retained, qint64(0));
+
+    const uint8_t *first = nullptr;
+    {
+        FITSPixelBuffer frame = FITSPixelBuffer::allocate(kFrameSize);
+        first = frame.constData();
+    }
+    QCOMPARE(pool->statistics().retained, FITSBufferPool::sizeClass(kFrameSize));
+
+    // A frame of the same size class gets the same buffer back
+    FITSPixelBuffer next = FITSPixelBuffer::allocate(kFrameSize - 5);
+    QCOMPARE(next.constData(), first);
+    QCOMPARE(pool->statistics().hits, start.hits + 1);
+    QCOMPARE(pool->statistics().retained, qint64(0));
+
+    // One of another class does not
+    FITSPixelBuffer other = FITSPixelBuffer::allocate(2 * kFrameSize);
+    QCOMPARE(pool->statistics().misses, start.misses + 2);
+}
+
+void TestFITSPixelBuffer::testRetainLimit()
+{
+    FITSBufferPool *pool = FITSBufferPool::Instance();
+    const qint64 capacity = FITSBufferPool::sizeClass(kFrameSize);
+    pool->setRetainLimit(2 * capacity);
+
+    {
+        FITSPixelBuffer a = FITSPixelBuffer::allocate(kFrameSize);
+        FITSPixelBuffer b = FITSPixelBuffer::allocate(kFrameSize);
+        FITSPixelBuffer c = FITSPixelBuffer::allocate(kFrameSize);
+    }
+    QCOMPARE(pool->statistics().retained, 2 * capacity);
+
+    pool->setRetainLimit(capacity);
+    QCOMPARE(pool->statistics().retained, capacity);
+
+    pool->clear();
+    QCOMPARE(pool->statistics().retained, qint64(0));
+}
+
+QTEST_GUILESS_MAIN(TestFITSPixelBuffer)
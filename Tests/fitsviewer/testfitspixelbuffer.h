@@ -0,0 +1,30 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+/**
+ * @class TestFITSPixelBuffer
+ * @short Shares pixel buffers until written to and recycles them through the pool
+ */
+class TestFITSPixelBuffer : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestFITSPixelBuffer() = default;
+        ~TestFITSPixelBuffer() override = default;
+
+    private slots:
+        void init();
+
+        void testCopyOnWrite();
+        void testSizeClasses();
+        void testPoolReuse();
+        void testRetainLimit();
+};
@@ -0,0 +1,197 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "testimagepyramid.h"
+
+#include "fitsviewer/imagepyramid.h"
+
+#include <cstdlib>
+
+namespace
+{
+// A grey image as FITSView displays it, with pixel values from a function of their position
+template <typename F>
+QImage greyImage(int width, int height, F value)
+{
+    QImage image(width, height, QImage::Format_Indexed8);
+    image.setColorCount(256);
+    for (int i = 0; i < 256; i++)
+        image.setColor(i, qRgb(i, i, i));
+    for (int y = 0; y < height; y++)
+    {
+        uchar *row = image.scanLine(y);
+        for (int x = 0; x < width; x++)
+            row[x] = value(x, y);
+    }
+    return image;
+}
+}
+
+void TestImagePyramid::testLevels()
+{
+    ImagePyramid pyramid;
+    QCOMPARE(pyramid.levelCount(), 0);
+    QVERIFY(pyramid.level(0).isNull());
+
+    // Halved with rounding up until no side is larger than 256
+    pyramid.setImage(greyImage(1001, 300, [](int, int)
+    {
+        return 0;
+    }));
+    QCOMPARE(pyramid.levelCount(), 3);
+    QCOMPARE(pyramid.level(0).size(), QSize(1001, 300));
+    QCOMPARE(pyramid.level(1).size(), QSize(501, 150));
+    QCOMPARE(pyramid.level(2).size(), QSize(251, 75));
+    // Past the last level
+    QCOMPARE(pyramid.level(10).size(), QSize(251, 75));
+
+    pyramid.clear();
+    QCOMPARE(pyramid.levelCount(), 0);
+}
+
+void TestImagePyramid::testGreyLevel()
+{
+    constexpr int width = 515, height = 301;
+    const QImage image = greyImage(width, height, [](int x, int y)
+    {
+        return (x * 7 + y * 13) % 256;
+    });
+
+    ImagePyramid pyramid;
+    pyramid.setImage(image);
+    const QImage level = pyramid.level(1);
+    QCOMPARE(level.format(), QImage::Format_Indexed8);
+    QCOMPARE(level.colorTable(), image.colorTable());
+
+    // Mean of each 2x2 block, odd last rows and columns are repeated
+    for (int y = 0; y < level.height(); y++)
+    {
+        for (int x = 0; x < level.width(); x++)
+        {
+            const int x1 = std::min(2 * x + 1, width - 1), y1 = std::min(2 * y + 1, height - 1);
+            const int sum = image.pixelIndex(2 * x, 2 * y) + image.pixelIndex(x1, 2 * y) +
+                            image.pixelIndex(2 * x, y1) + image.pixelIndex(x1, y1);
+            QCOMPARE(level.pixelIndex(x, y), (sum + 2) / 4);
+        }
+    }
+}
+
+void TestImagePyramid::testColorLevel()
+{
+    QImage image(600, 400, QImage::Format_RGB32);
+    for (int y = 0; y < image.height(); y++)
+        for (int x = 0; x < image.width(); x++)
+            image.setPixel(x, y, qRgb(x % 256, y % 256, (x + y) % 2 ? 255 : 0));
+
+    ImagePyramid pyramid;
+    pyramid.setImage(image);
+    const QImage level = pyramid.level(1);
+    QCOMPARE(level.format(), QImage::Format_RGB32);
+    QCOMPARE(level.size(), QSize(300, 200));
+
+    for (int y = 0; y < level.height(); y += 7)
+    {
+        for (int x = 0; x < level.width(); x += 5)
+        {
+            const QRgb pixel = level.pixel(x, y);
+            QCOMPARE(qRed(pixel), ((2 * x) % 256 * 2 + (2 * x + 1) % 256 * 2 + 2) / 4);
+            QCOMPARE(qGreen(pixel), ((2 * y) % 256 * 2 + (2 * y + 1) % 256 * 2 + 2) / 4);
+            // Checkerboard
+            QCOMPARE(qBlue(pixel), 128);
+        }
+    }
+}
+
+void TestImagePyramid::testLevelFor()
+{
+    ImagePyramid pyramid;
+    pyramid.setImage(greyImage(4000, 3000, [](int, int)
+    {
+        return 0;
+    }));
+    QCOMPARE(pyramid.levelCount(), 5);
+
+    QCOMPARE(pyramid.levelFor(2), 0);
+    QCOMPARE(pyramid.levelFor(1), 0);
+    QCOMPARE(pyramid.levelFor(0.6), 0);
+    QCOMPARE(pyramid.levelFor(0.5), 1);
+    QCOMPARE(pyramid.levelFor(0.3), 1);
+    QCOMPARE(pyramid.levelFor(0.25), 2);
+    QCOMPARE(pyramid.levelFor(0.01), 4);
+}
+
+void TestImagePyramid::testScaled()
+{
+    ImagePyramid pyramid;
+    pyramid.setImage(greyImage(2048, 1024, [](int x, int)
+    {
+        return x / 8;
+    }));
+
+    // Exactly a level
+    const QImage half = pyramid.scaled(QSize(1024, 1024));
+    QCOMPARE(half.size(), QSize(1024, 512));
+    QCOMPARE(half, pyramid.level(1));
+
+    // Between levels, the aspect ratio is kept
+    const QImage preview = pyramid.scaled(QSize(640, 480));
+    QCOMPARE(preview.size(), QSize(640, 320));
+    QVERIFY(std::abs(qGray(preview.pixel(320, 160)) - 128) <= 2);
+}
+
+void TestImagePyramid::testSetImage()
+{
+    ImagePyramid pyramid;
+    pyramid.setImage(greyImage(1000, 1000, [](int, int)
+    {
+        return 10;
+    }));
+    QCOMPARE(pyramid.level(2).pixelIndex(0, 0), 10);
+
+    // The levels of the previous image are dropped, even while they are being built
+    for (int value = 20; value < 30; value++)
+    {
+        pyramid.setImage(greyImage(1000, 1000, [value](int, int)
+        {
+            return value;
+        }));
+    }
+    QCOMPARE(pyramid.level(2).pixelIndex(0, 0), 29);
+    QCOMPARE(pyramid.level(1).pixelIndex(499, 499), 29);
+}
+
+void TestImagePyramid::benchmarkScaled_data()
+{
+    QTest::addColumn<bool>("PYRAMID");
+
+    QTest::newRow("QImage::scaled") << false;
+    QTest::newRow("ImagePyramid::scaled") << true;
+}
+
+void TestImagePyramid::benchmarkScaled()
+{
+    QFETCH(bool, PYRAMID);
+
+    // A 50 MP frame previewed in a window
+    const QImage image = greyImage(8192, 6144, [](int x, int y)
+    {
+        return (x ^ y) & 0xFF;
+    });
+    const QSize window(1280, 960);
+
+    ImagePyramid pyramid;
+    pyramid.setImage(image);
+    pyramid.level(pyramid.levelCount() - 1);
+
+    QBENCHMARK
+    {
+        const QImage preview = PYRAMID ? pyramid.scaled(window) :
+                               image.scaled(window, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        QCOMPARE(preview.size(), window);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestImagePyramid)
@@ -0,0 +1,33 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+/**
+ * @class TestImagePyramid
+ * @short Checks the levels of the display image pyramid and benchmarks scaling from it
+ */
+class TestImagePyramid : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestImagePyramid() = default;
+        ~TestImagePyramid() override = default;
+
+    private slots:
+        void testLevels();
+        void testGreyLevel();
+        void testColorLevel();
+        void testLevelFor();
+        void testScaled();
+        void testSetImage();
+
+        void benchmarkScaled_data();
+        void benchmarkScaled();
+};
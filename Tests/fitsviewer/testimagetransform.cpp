@@ -0,0 +1,221 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "testimagetransform.h"
+
+#include "fitsviewer/imagetransform.h"
+
+#include <vector>
+
+namespace
+{
+// Odd sizes, so that tiles and row pairs don't divide them
+constexpr uint32_t kWidth = 203;
+constexpr uint32_t kHeight = 141;
+constexpr uint32_t kChannels = 3;
+
+enum SampleType
+{
+    UINT8,
+    UINT16,
+    FLOAT32,
+    FLOAT64
+};
+
+// Destination of each source pixel, as the loops FITSData::rotFITS() used to have
+void reference(int rotate, int mirror, uint32_t x, uint32_t y, uint32_t nx, uint32_t ny, uint32_t &x2, uint32_t &y2)
+{
+    x2 = x;
+    y2 = y;
+    if (rotate == 0)
+    {
+        if (mirror == 1)
+            x2 = nx - x - 1;
+        else if (mirror == 2)
+            y2 = ny - y - 1;
+    }
+    else if (rotate == 90)
+    {
+        x2 = mirror == 2 ? y : ny - y - 1;
+        y2 = mirror == 1 ? nx - x - 1 : x;
+    }
+    else if (rotate == 180)
+    {
+        x2 = mirror == 1 ? x : nx - x - 1;
+        y2 = mirror == 2 ? y : ny - y - 1;
+    }
+    else if (rotate == 270)
+    {
+        x2 = mirror == 2 ? ny - y - 1 : y;
+        y2 = mirror == 1 ? x : nx - x - 1;
+    }
+}
+
+template <typename T>
+void check(int rotate, int mirror, bool inPlace)
+{
+    const ImageTransform transform = ImageTransform::fromRotation(rotate, mirror);
+    const size_t planeSize = kWidth * kHeight;
+    std::vector<T> source(planeSize * kChannels);
+    for (size_t i = 0; i < source.size(); ++i)
+        source[i] = static_cast<T>(i % 251);
+
+    std::vector<T> destination(source.size(), 0);
+    if (inPlace)
+    {
+        destination = source;
+        QVERIFY(transform.applyInPlace(destination.data(), kWidth, kHeight, kChannels, planeSize));
+    }
+    else
+        transform.apply(source.data(), destination.data(), kWidth, kHeight, kChannels, planeSize);
+
+    const uint32_t width = transform.transposes() ? kHeight : kWidth;
+    for (uint32_t c = 0; c < kChannels; ++c)
+        for (uint32_t y = 0; y < kHeight; ++y)
+            for (uint32_t x = 0; x < kWidth; ++x)
+            {
+                uint32_t x2, y2;
+                reference(rotate, mirror, x, y, kWidth, kHeight, x2, y2);
+                if (destination[c * planeSize + y2 * width + x2] != source[c * planeSize + y * kWidth + x])
+                    QFAIL(qPrintable(QString("Pixel %1,%2 channel %3 misplaced").arg(x).arg(y).arg(c)));
+            }
+}
+
+template <typename T>
+void benchmark(const ImageTransform &transform, uint32_t width, uint32_t height)
+{
+    const size_t planeSize = size_t(width) * height;
+    std::vector<T> source(planeSize, T(1)), destination(planeSize);
+
+    if (transform.transposes())
+    {
+        QBENCHMARK
+        {
+            transform.apply(source.data(), destination.data(), width, height, 1, planeSize);
+        }
+    }
+    else
+    {
+        QBENCHMARK
+        {
+            transform.applyInPlace(source.data(), width, height, 1, planeSize);
+        }
+    }
+}
+}
+
+void TestImageTransform::testFromRotation_data()
+{
+    QTest::addColumn<int>("rotate");
+    QTest::addColumn<int>("mirror");
+    QTest::addColumn<bool>("transpose");
+    QTest::addColumn<bool>("flipX");
+    QTest::addColumn<bool>("flipY");
+
+    QTest::newRow("identity") << 0 << 0 << false << false << false;
+    QTest::newRow("flip H") << 0 << 1 << false << true << false;
+    QTest::newRow("flip V") << 0 << 2 << false << false << true;
+    QTest::newRow("90") << 90 << 0 << true << true << false;
+    QTest::newRow("90 by index") << 1 << 0 << true << true << false;
+    QTest::newRow("180") << 180 << 0 << false << true << true;
+    QTest::newRow("270") << 270 << 0 << true << false << true;
+    QTest::newRow("-90") << -90 << 0 << true << false << true;
+    QTest::newRow("diagonal") << 330 << 1 << true << false << false;
+}
+
+void TestImageTransform::testFromRotation()
+{
+    QFETCH(int, rotate);
+    QFETCH(int, mirror);
+    QFETCH(bool, transpose);
+    QFETCH(bool, flipX);
+    QFETCH(bool, flipY);
+
+    const ImageTransform transform = ImageTransform::fromRotation(rotate, mirror);
+    QCOMPARE(transform.transposes(), transpose);
+    QCOMPARE(transform.flipsX(), flipX);
+    QCOMPARE(transform.flipsY(), flipY);
+}
+
+void TestImageTransform::testApply_data()
+{
+    QTest::addColumn<int>("rotate");
+    QTest::addColumn<int>("mirror");
+
+    for (int rotate : { 0, 90, 180, 270 })
+        for (int mirror : { 0, 1, 2 })
+            QTest::newRow(qPrintable(QString("%1 mirror %2").arg(rotate).arg(mirror))) << rotate << mirror;
+}
+
+void TestImageTransform::testApply()
+{
+    QFETCH(int, rotate);
+    QFETCH(int, mirror);
+
+    const bool inPlace = !ImageTransform::fromRotation(rotate, mirror).transposes();
+    for (bool place : { false, inPlace })
+    {
+        check<uint8_t>(rotate, mirror, place);
+        check<uint16_t>(rotate, mirror, place);
+        check<float>(rotate, mirror, place);
+        check<double>(rotate, mirror, place);
+    }
+}
+
+void TestImageTransform::testMapPoint()
+{
+    // Matches the CRPIX updates of FITSData::rotWCSFITS()
+    const QPointF crpix(10, 20);
+    QCOMPARE(ImageTransform::fromRotation(90, 0).mapPoint(crpix, 100, 50), QPointF(30, 10));
+    QCOMPARE(ImageTransform::fromRotation(180, 0).mapPoint(crpix, 100, 50), QPointF(90, 30));
+    QCOMPARE(ImageTransform::fromRotation(270, 0).mapPoint(crpix, 100, 50), QPointF(20, 90));
+    QCOMPARE(ImageTransform::fromRotation(0, 1).mapPoint(crpix, 100, 50), QPointF(90, 20));
+    QCOMPARE(ImageTransform::fromRotation(270, 1).mapPoint(crpix, 100, 50), QPointF(20, 10));
+}
+
+void TestImageTransform::benchmarkTransform_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("rotate");
+
+    const char *types[] = { "uint8", "uint16", "float", "double" };
+    for (int type : { UINT8, UINT16, FLOAT32, FLOAT64 })
+        for (int size : { 1024, 4096 })
+            for (int rotate : { 90, 180 })
+                QTest::newRow(qPrintable(QString("%1 %2x%2 %3").arg(types[type]).arg(size).arg(rotate)))
+                        << type << size << rotate;
+}
+
+void TestImageTransform::benchmarkTransform()
+{
+    QFETCH(int, type);
+    QFETCH(int, size);
+    QFETCH(int, rotate);
+
+    // A wide frame, as cameras have
+    const ImageTransform transform = ImageTransform::fromRotation(rotate, 0);
+    const uint32_t width = size * 3 / 2;
+    const uint32_t height = size;
+
+    switch (type)
+    {
+        case UINT8:
+            benchmark<uint8_t>(transform, width, height);
+            break;
+        case UINT16:
+            benchmark<uint16_t>(transform, width, height);
+            break;
+        case FLOAT32:
+            benchmark<float>(transform, width, height);
+            break;
+        default:
+            benchmark<double>(transform, width, height);
+            break;
+    }
+}
+
+QTEST_GUILESS_MAIN(TestImageTransform)
@@ -0,0 +1,34 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+/**
+ * @class TestImageTransform
+ * @short Checks rotations and mirrors against a per-pixel reference and benchmarks them
+ */
+class TestImageTransform : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestImageTransform() = default;
+        ~TestImageTransform() override = default;
+
+    private slots:
+        void testFromRotation_data();
+        void testFromRotation();
+
+        void testApply_data();
+        void testApply();
+
+        void testMapPoint();
+
+        void benchmarkTransform_data();
+        void benchmarkTransform();
+};
@@ -0,0 +1,197 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "testsamplehistogram.h"
+
+#include "fitsviewer/samplehistogram.h"
+
+#include <QRandomGenerator>
+
+namespace
+{
+enum SampleType { UINT8, INT16, UINT16, INT32, UINT32, FLOAT, INT64, DOUBLE };
+
+// A sky background with a few saturated stars, shifted and scaled for each type.
+template <typename T>
+std::vector<T> makeSamples(uint32_t count, double offset, double scale)
+{
+    QRandomGenerator rng(7);
+    std::vector<T> samples(count);
+    for (auto &sample : samples)
+    {
+        double value = offset + scale * (rng.generateDouble() + rng.generateDouble() + rng.generateDouble());
+        if (rng.bounded(1000) == 0)
+            value = offset + 50 * scale * rng.generateDouble();
+        sample = static_cast<T>(std::min<double>(value, std::numeric_limits<T>::max()));
+    }
+    return samples;
+}
+
+template <typename T>
+void compareWithSort(uint32_t count, double offset, double scale, bool exact)
+{
+    const std::vector<T> samples = makeSamples<T>(count, offset, scale);
+    const SampleHistogram histogram = SampleHistogram::compute(samples.data(), count);
+    QVERIFY(histogram.isValid());
+    QCOMPARE(histogram.isExact(), exact);
+    QCOMPARE(histogram.count(), static_cast<uint64_t>(count));
+
+    std::vector<T> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    const double median = sorted[count / 2];
+
+    std::vector<double> deviations(count);
+    double mean = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        deviations[i] = std::fabs(samples[i] - median);
+        mean += samples[i];
+    }
+    mean /= count;
+    double variance = 0;
+    for (const T sample : samples)
+        variance += (sample - mean) * (sample - mean);
+    std::nth_element(deviations.begin(), deviations.begin() + count / 2, deviations.end());
+
+    // Whatever the type, min, max, median and MAD are exact, the percentiles are within a bin
+    const double tolerance = histogram.isExact() ? 0 : histogram.binWidth();
+    QCOMPARE(histogram.min(), static_cast<double>(sorted.front()));
+    QCOMPARE(histogram.max(), static_cast<double>(sorted.back()));
+    QCOMPARE(histogram.median(), median);
+    QCOMPARE(histogram.mad(), deviations[count / 2]);
+    QVERIFY(std::fabs(histogram.percentile(0.9) - sorted[static_cast<uint32_t>(0.9 * (count - 1))]) <= tolerance);
+    QVERIFY(std::fabs(histogram.mean() - mean) <= 1e-9 * std::fabs(mean) + 1e-12);
+    QVERIFY(std::fabs(histogram.stddev() - std::sqrt(variance / count)) <= 1e-6 * std::sqrt(variance / count));
+
+    uint64_t total = 0;
+    for (int i = 0; i < histogram.binCount(); i++)
+        total += histogram.binFrequency(i);
+    QCOMPARE(total, static_cast<uint64_t>(count));
+}
+}
+
+TestSampleHistogram::TestSampleHistogram() : QObject()
+{
+}
+
+void TestSampleHistogram::testStatistics_data()
+{
+    QTest::addColumn<int>("TYPE");
+    QTest::addColumn<int>("COUNT");
+    QTest::addColumn<double>("OFFSET");
+    QTest::addColumn<double>("SCALE");
+    QTest::addColumn<bool>("EXACT");
+
+    QTest::newRow("uint8") << static_cast<int>(UINT8) << 1000001 << 5.0 << 4.0 << true;
+    QTest::newRow("int16") << static_cast<int>(INT16) << 1000000 << -2000.0 << 300.0 << true;
+    QTest::newRow("uint16") << static_cast<int>(UINT16) << 2000000 << 1000.0 << 500.0 << true;
+    QTest::newRow("uint16 few") << static_cast<int>(UINT16) << 7 << 1000.0 << 500.0 << true;
+    QTest::newRow("int32 narrow") << static_cast<int>(INT32) << 1000000 << 1000.0 << 300.0 << true;
+    QTest::newRow("int32 wide") << static_cast<int>(INT32) << 1000000 << 1000.0 << 300000.0 << false;
+    QTest::newRow("uint32") << static_cast<int>(UINT32) << 1000000 << 1000.0 << 300000.0 << false;
+    QTest::newRow("float") << static_cast<int>(FLOAT) << 1000000 << 0.05 << 0.01 << false;
+    QTest::newRow("int64") << static_cast<int>(INT64) << 1000000 << 0.0 << 300000.0 << false;
+    QTest::newRow("double") << static_cast<int>(DOUBLE) << 1000000 << 0.0 << 300.0 << false;
+}
+
+void TestSampleHistogram::testStatistics()
+{
+    QFETCH(int, TYPE);
+    QFETCH(int, COUNT);
+    QFETCH(double, OFFSET);
+    QFETCH(double, SCALE);
+    QFETCH(bool, EXACT);
+
+    switch (TYPE)
+    {
+        case UINT8:
+            compareWithSort<uint8_t>(COUNT, OFFSET, SCALE, EXACT);
+            break;
+        case INT16:
+            compareWithSort<int16_t>(COUNT, OFFSET, SCALE, EXACT);
+            break;
+        case UINT16:
+            compareWithSort<uint16_t>(COUNT, OFFSET, SCALE, EXACT);
+            break;
+        case INT32:
+            compareWithSort<int32_t>(COUNT, OFFSET, SCALE, EXACT);
+            break;
+        case UINT32:
+            compareWithSort<uint32_t>(COUNT, OFFSET, SCALE, EXACT);
+            break;
+        case FLOAT:
+            compareWithSort<float>(COUNT, OFFSET, SCALE, EXACT);
+            break;
+        case INT64:
+            compareWithSort<int64_t>(COUNT, OFFSET, SCALE, EXACT);
+            break;
+        case DOUBLE:
+            compareWithSort<double>(COUNT, OFFSET, SCALE, EXACT);
+            break;
+    }
+}
+
+void TestSampleHistogram::testNaN()
+{
+    std::vector<float> samples = { 3, NAN, 1, 2, NAN, 5, 4 };
+    const SampleHistogram histogram = SampleHistogram::compute(samples.data(), samples.size());
+    QCOMPARE(histogram.count(), static_cast<uint64_t>(5));
+    QCOMPARE(histogram.min(), 1.0);
+    QCOMPARE(histogram.max(), 5.0);
+    QCOMPARE(histogram.median(), 3.0);
+
+    std::vector<double> allNaN(16, NAN);
+    QVERIFY(!SampleHistogram::compute(allNaN.data(), allNaN.size()).isValid());
+}
+
+void TestSampleHistogram::testEmpty()
+{
+    QVERIFY(!SampleHistogram().isValid());
+    QVERIFY(!SampleHistogram::compute(static_cast<const uint16_t *>(nullptr), 100).isValid());
+
+    const uint16_t constant[4] = { 42, 42, 42, 42 };
+    const SampleHistogram histogram = SampleHistogram::compute(constant, 4);
+    QVERIFY(histogram.isExact());
+    QCOMPARE(histogram.binCount(), 1);
+    QCOMPARE(histogram.median(), 42.0);
+    QCOMPARE(histogram.mad(), 0.0);
+    QCOMPARE(histogram.stddev(), 0.0);
+}
+
+void TestSampleHistogram::benchmarkHistogram_data()
+{
+    QTest::addColumn<bool>("FLOAT");
+
+    QTest::newRow("uint16") << false;
+    QTest::newRow("float") << true;
+}
+
+void TestSampleHistogram::benchmarkHistogram()
+{
+    QFETCH(bool, FLOAT);
+
+    // A full IMX455 frame
+    const uint32_t count = 9576 * 6388;
+
+    if (FLOAT)
+    {
+        const std::vector<float> samples = makeSamples<float>(count, 0.05, 0.01);
+        QBENCHMARK
+        {
+            SampleHistogram::compute(samples.data(), count);
+        }
+    }
+    else
+    {
+        const std::vector<uint16_t> samples = makeSamples<uint16_t>(count, 1000, 500);
+        QBENCHMARK
+        {
+            SampleHistogram::compute(samples.data(), count);
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestSampleHistogram)
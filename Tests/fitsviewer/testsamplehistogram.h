@@ -0,0 +1,32 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+/**
+ * @class TestSampleHistogram
+ * @short Checks the statistics of SampleHistogram against sorting the samples
+ */
+class TestSampleHistogram : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestSampleHistogram();
+        ~TestSampleHistogram() override = default;
+
+    private slots:
+        void testStatistics_data();
+        void testStatistics();
+
+        void testNaN();
+        void testEmpty();
+
+        void benchmarkHistogram_data();
+        void benchmarkHistogram();
+};
@@ -0,0 +1,198 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "teststretch.h"
+
+#include "fitsviewer/stretch.h"
+
+#include <QRandomGenerator>
+
+#include <fitsio.h>
+
+namespace
+{
+// A full IMX455 frame is 9576x6388, a quarter of it keeps the benchmark of 64-bit color images in memory.
+constexpr int kBenchmarkWidth  = 4788;
+constexpr int kBenchmarkHeight = 3194;
+
+struct DataType
+{
+    const char *name;
+    int type;
+    // 8 and 16-bit samples go through a lookup table and are stretched exactly alike
+    int tolerance;
+};
+
+const DataType kDataTypes[] =
+{
+    { "TBYTE", TBYTE, 0 },
+    { "TSHORT", TSHORT, 0 },
+    { "TUSHORT", TUSHORT, 0 },
+    { "TLONG", TLONG, 1 },
+    { "TFLOAT", TFLOAT, 1 },
+    { "TLONGLONG", TLONGLONG, 1 },
+    { "TDOUBLE", TDOUBLE, 1 },
+};
+
+template <typename T>
+void fill(QByteArray *buffer, int count, double scale, double maximum)
+{
+    QRandomGenerator rng(42);
+    buffer->resize(count * static_cast<int>(sizeof(T)));
+    T *samples = reinterpret_cast<T *>(buffer->data());
+
+    // A sky background with a few saturated stars
+    for (int i = 0; i < count; ++i)
+    {
+        double value = scale * (0.05 + 0.02 * rng.generateDouble() + 0.02 * rng.generateDouble());
+        if (rng.bounded(1000) == 0)
+            value = maximum * rng.generateDouble();
+        samples[i] = static_cast<T>(std::min(value, maximum));
+    }
+}
+}
+
+TestStretch::TestStretch() : QObject()
+{
+}
+
+QByteArray TestStretch::makeImage(int dataType, int width, int height, int channels, bool normalized)
+{
+    QByteArray buffer;
+    const int count = width * height * channels;
+    switch (dataType)
+    {
+        case TBYTE:
+            fill<uint8_t>(&buffer, count, 255, 255);
+            break;
+        case TSHORT:
+            fill<short>(&buffer, count, 32767, 32767);
+            break;
+        case TUSHORT:
+            fill<unsigned short>(&buffer, count, 65535, 65535);
+            break;
+        case TLONG:
+            fill<long>(&buffer, count, 65535, 65535);
+            break;
+        case TFLOAT:
+            fill<float>(&buffer, count, normalized ? 1 : 65535, normalized ? 1 : 65535);
+            break;
+        case TLONGLONG:
+            fill<long long>(&buffer, count, 65535, 65535);
+            break;
+        case TDOUBLE:
+            fill<double>(&buffer, count, normalized ? 1 : 65535, normalized ? 1 : 65535);
+            break;
+    }
+    return buffer;
+}
+
+void TestStretch::testEnginesMatch_data()
+{
+    QTest::addColumn<int>("DATATYPE");
+    QTest::addColumn<int>("TOLERANCE");
+    QTest::addColumn<int>("CHANNELS");
+    QTest::addColumn<int>("SAMPLING");
+    QTest::addColumn<bool>("NORMALIZED");
+
+    for (const auto &dataType : kDataTypes)
+    {
+        for (int channels : { 1, 3 })
+        {
+            for (int sampling : { 1, 2, 3 })
+            {
+                QTest::newRow(qPrintable(QString("%1 %2ch 1/%3").arg(dataType.name).arg(channels).arg(sampling)))
+                        << dataType.type << dataType.tolerance << channels << sampling << false;
+            }
+        }
+
+        if (dataType.type == TFLOAT || dataType.type == TDOUBLE)
+            QTest::newRow(qPrintable(QString("%1 normalized").arg(dataType.name)))
+                    << dataType.type << dataType.tolerance << 1 << 1 << true;
+    }
+}
+
+void TestStretch::testEnginesMatch()
+{
+    QFETCH(int, DATATYPE);
+    QFETCH(int, TOLERANCE);
+    QFETCH(int, CHANNELS);
+    QFETCH(int, SAMPLING);
+    QFETCH(bool, NORMALIZED);
+
+    // Odd sizes, so that the sampled rows and the bands do not line up
+    const int width = 517, height = 311;
+    const QByteArray buffer = makeImage(DATATYPE, width, height, CHANNELS, NORMALIZED);
+    const auto input = reinterpret_cast<const uint8_t *>(buffer.constData());
+
+    Stretch stretch(width, height, CHANNELS, DATATYPE);
+    StretchParams params = stretch.computeParams(input);
+    if (CHANNELS == 3)
+    {
+        params.green.midtones = 0.3f;
+        params.blue.shadows = std::min(params.blue.shadows + 0.01f, 1.0f);
+    }
+    stretch.setParams(params);
+
+    const QImage::Format format = CHANNELS == 1 ? QImage::Format_Indexed8 : QImage::Format_RGB32;
+    QImage rows((width + SAMPLING - 1) / SAMPLING, (height + SAMPLING - 1) / SAMPLING, format);
+    QImage bands(rows.size(), format);
+
+    stretch.run(input, &rows, SAMPLING, STRETCH_ROW_FUTURES);
+    stretch.run(input, &bands, SAMPLING, STRETCH_BANDS);
+
+    const int bytesPerRow = rows.width() * (CHANNELS == 1 ? 1 : 4);
+    for (int y = 0; y < rows.height(); ++y)
+    {
+        const uchar *a = rows.constScanLine(y);
+        const uchar *b = bands.constScanLine(y);
+        for (int x = 0; x < bytesPerRow; ++x)
+        {
+            if (std::abs(a[x] - b[x]) > TOLERANCE)
+                QFAIL(qPrintable(QString("Byte %1 of row %2 is %3 instead of %4").arg(x).arg(y).arg(b[x]).arg(a[x])));
+        }
+    }
+}
+
+void TestStretch::benchmarkStretch_data()
+{
+    QTest::addColumn<int>("DATATYPE");
+    QTest::addColumn<int>("CHANNELS");
+    QTest::addColumn<int>("ENGINE");
+
+    for (const auto &dataType : kDataTypes)
+    {
+        for (int channels : { 1, 3 })
+        {
+            QTest::newRow(qPrintable(QString("%1 %2ch rows").arg(dataType.name).arg(channels)))
+                    << dataType.type << channels << static_cast<int>(STRETCH_ROW_FUTURES);
+            QTest::newRow(qPrintable(QString("%1 %2ch bands").arg(dataType.name).arg(channels)))
+                    << dataType.type << channels << static_cast<int>(STRETCH_BANDS);
+        }
+    }
+}
+
+void TestStretch::benchmarkStretch()
+{
+    QFETCH(int, DATATYPE);
+    QFETCH(int, CHANNELS);
+    QFETCH(int, ENGINE);
+
+    const QByteArray buffer = makeImage(DATATYPE, kBenchmarkWidth, kBenchmarkHeight, CHANNELS, false);
+    const auto input = reinterpret_cast<const uint8_t *>(buffer.constData());
+
+    Stretch stretch(kBenchmarkWidth, kBenchmarkHeight, CHANNELS, DATATYPE);
+    stretch.setParams(stretch.computeParams(input));
+
+    QImage output(kBenchmarkWidth, kBenchmarkHeight, CHANNELS == 1 ? QImage::Format_Indexed8 : QImage::Format_RGB32);
+
+    QBENCHMARK
+    {
+        stretch.run(input, &output, 1, static_cast<StretchEngine>(ENGINE));
+    }
+}
+
+QTEST_GUILESS_MAIN(TestStretch)
@@ -0,0 +1,32 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+/**
+ * @class TestStretch
+ * @short Compares the stretch engines on every FITS data type and benchmarks them
+ */
+class TestStretch : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestStretch();
+        ~TestStretch() override = default;
+
+    private slots:
+        void testEnginesMatch_data();
+        void testEnginesMatch();
+
+        void benchmarkStretch_data();
+        void benchmarkStretch();
+
+    private:
+        static QByteArray makeImage(int dataType, int width, int height, int channels, bool normalized);
+};
@@ -0,0 +1,160 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_hipstilepack.h"
+
+#include "hipstilepack.h"
+
+namespace
+{
+constexpr int kOrder     = 3;
+constexpr int kTileWidth = 64;
+}
+
+TestHIPSTilePack::TestHIPSTilePack() : QObject()
+{
+}
+
+QImage TestHIPSTilePack::makeTile(int pix, bool grayscale)
+{
+    QImage tile(kTileWidth, kTileWidth, grayscale ? QImage::Format_Grayscale8 : QImage::Format_RGB32);
+    for (int y = 0; y < kTileWidth; ++y)
+    {
+        for (int x = 0; x < kTileWidth; ++x)
+            tile.setPixel(x, y, grayscale ? (x + y + pix) & 0xff : qRgb(x * 4, y * 4, pix & 0xff));
+    }
+    return tile;
+}
+
+void TestHIPSTilePack::initTestCase()
+{
+    QVERIFY(m_Directory.isValid());
+
+    // A sparse survey in the Norder/Dir/Npix layout, with the tiles as lossless PNG
+    m_Pixels = { 0, 1, 17, 400, 767 };
+    for (const QString &survey : { QString("color"), QString("gray") })
+    {
+        for (int pix : m_Pixels)
+        {
+            const QString dir = QString("%1/%2/Norder%3/Dir0").arg(m_Directory.path(), survey).arg(kOrder);
+            QVERIFY(QDir().mkpath(dir));
+            QVERIFY(makeTile(pix, survey == "gray").save(QString("%1/Npix%2.png").arg(dir).arg(pix)));
+        }
+    }
+}
+
+void TestHIPSTilePack::testRoundTrip_data()
+{
+    QTest::addColumn<QString>("SURVEY");
+    QTest::addColumn<bool>("DECODED");
+
+    QTest::newRow("color decoded") << "color" << true;
+    QTest::newRow("color encoded") << "color" << false;
+    QTest::newRow("gray decoded") << "gray" << true;
+    QTest::newRow("gray encoded") << "gray" << false;
+}
+
+void TestHIPSTilePack::testRoundTrip()
+{
+    QFETCH(QString, SURVEY);
+    QFETCH(bool, DECODED);
+
+    const QString source   = m_Directory.filePath(SURVEY);
+    const QString filename = HIPSTilePack::packFileName(m_Directory.filePath(SURVEY + (DECODED ? "-decoded" : "-encoded")), kOrder);
+    QVERIFY(QDir().mkpath(QFileInfo(filename).path()));
+
+    QVERIFY(HIPSTilePack::build(source, kOrder, filename, DECODED ? 1024 * 1024 * 1024 : 0));
+    QVERIFY(!QFile::exists(filename + ".part"));
+
+    HIPSTilePack pack(filename);
+    QVERIFY(pack.open());
+    QCOMPARE(pack.order(), kOrder);
+
+    for (int pix = 0; pix < 12 * 64; ++pix)
+    {
+        const bool present = m_Pixels.contains(pix);
+        QCOMPARE(pack.contains(pix), present);
+        if (!present)
+        {
+            QVERIFY(pack.tile(pix).isNull());
+            continue;
+        }
+
+        const QImage expected = makeTile(pix, SURVEY == "gray");
+        const QImage tile     = pack.tile(pix);
+        QCOMPARE(tile.size(), expected.size());
+        QCOMPARE(tile.convertToFormat(QImage::Format_RGB32), expected.convertToFormat(QImage::Format_RGB32));
+    }
+
+    QVERIFY(!pack.contains(-1));
+    QVERIFY(!pack.contains(12 * 64));
+}
+
+void TestHIPSTilePack::testDeepOrder()
+{
+    // A single tile of the deepest order, the index must not grow with the 12 * 4^13 pixels
+    const int order = 13;
+    const int pix   = 12 * (1 << 26) - 1;
+    const QString source = m_Directory.filePath("deep");
+    const QString dir = QString("%1/Norder%2/Dir%3").arg(source).arg(order).arg((pix / 10000) * 10000);
+    QVERIFY(QDir().mkpath(dir));
+    QVERIFY(makeTile(pix, false).save(QString("%1/Npix%2.png").arg(dir).arg(pix)));
+
+    const QString filename = HIPSTilePack::packFileName(source, order);
+    QVERIFY(HIPSTilePack::build(source, order, filename));
+    QVERIFY(QFileInfo(filename).size() < 2 * kTileWidth * kTileWidth * 4);
+
+    HIPSTilePack pack(filename);
+    QVERIFY(pack.open());
+    QCOMPARE(pack.order(), order);
+    QVERIFY(pack.contains(pix));
+    QVERIFY(!pack.contains(0));
+    QVERIFY(!pack.contains(pix - 1));
+    QCOMPARE(pack.tile(pix).convertToFormat(QImage::Format_RGB32), makeTile(pix, false));
+}
+
+void TestHIPSTilePack::testClose()
+{
+    const QString filename = HIPSTilePack::packFileName(m_Directory.filePath("closed"), kOrder);
+    QVERIFY(QDir().mkpath(QFileInfo(filename).path()));
+    QVERIFY(HIPSTilePack::build(m_Directory.filePath("color"), kOrder, filename));
+
+    HIPSTilePack pack(filename);
+    QVERIFY(pack.open());
+    QVERIFY(pack.contains(m_Pixels.first()));
+
+    // Once closed, the pack can be replaced and reads nothing
+    pack.close();
+    QVERIFY(!pack.isOpen());
+    QVERIFY(!pack.contains(m_Pixels.first()));
+    QVERIFY(pack.tile(m_Pixels.first()).isNull());
+    QVERIFY(HIPSTilePack::build(m_Directory.filePath("gray"), kOrder, filename));
+
+    QVERIFY(pack.open());
+    QVERIFY(pack.tile(m_Pixels.first()).isGrayscale());
+}
+
+void TestHIPSTilePack::testInvalidPack()
+{
+    const QString filename = m_Directory.filePath("invalid.hpk");
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QByteArray(4096, 'x'));
+    file.close();
+
+    HIPSTilePack pack(filename);
+    QVERIFY(!pack.open());
+    QVERIFY(!pack.isOpen());
+    QVERIFY(pack.tile(0).isNull());
+
+    HIPSTilePack missing(m_Directory.filePath("missing.hpk"));
+    QVERIFY(!missing.open());
+
+    // No tiles of that order
+    QVERIFY(!HIPSTilePack::build(m_Directory.filePath("color"), kOrder + 1, m_Directory.filePath("none.hpk")));
+}
+
+QTEST_GUILESS_MAIN(TestHIPSTilePack)
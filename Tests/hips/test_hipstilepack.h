@@ -0,0 +1,40 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+/**
+ * @class TestHIPSTilePack
+ * @short Builds tile packs from a small offline survey and reads them back
+ */
+class TestHIPSTilePack : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestHIPSTilePack();
+        ~TestHIPSTilePack() override = default;
+
+    private slots:
+        void initTestCase();
+
+        void testRoundTrip_data();
+        void testRoundTrip();
+
+        void testDeepOrder();
+        void testClose();
+
+        void testInvalidPack();
+
+    private:
+        static QImage makeTile(int pix, bool grayscale);
+
+        QTemporaryDir m_Directory;
+        QList<int> m_Pixels;
+};
@@ -0,0 +1,149 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_scanrender.h"
+
+#include "scanrender.h"
+
+#include <QRandomGenerator>
+
+#include <memory>
+
+namespace
+{
+constexpr int kWidth  = 1000;
+constexpr int kHeight = 700;
+constexpr int kPolygonCount = 400;
+}
+
+TestScanRender::TestScanRender() : QObject()
+{
+}
+
+void TestScanRender::initTestCase()
+{
+    QRandomGenerator rng(42);
+
+    // A noisy HiPS tile, so that any difference in sampling shows up in the output
+    m_Source = QImage(512, 512, QImage::Format_ARGB32);
+    for (int y = 0; y < m_Source.height(); ++y)
+    {
+        QRgb *line = reinterpret_cast<QRgb *>(m_Source.scanLine(y));
+        for (int x = 0; x < m_Source.width(); ++x)
+            line[x] = rng.generate() | 0xff000000;
+    }
+
+    // Overlapping, slightly skewed quads like the projected HEALPix pixels, some of them crossing the
+    // image borders. The corners run north, east, south, west as in HIPSRenderer::renderPix().
+    for (int i = 0; i < kPolygonCount; ++i)
+    {
+        const double cx   = -100 + (kWidth + 200) * rng.generateDouble();
+        const double cy   = -100 + (kHeight + 200) * rng.generateDouble();
+        const double size = 10 + 150 * rng.generateDouble();
+
+        Polygon polygon;
+        for (int j = 0; j < 4; ++j)
+        {
+            const double angle  = M_PI / 2 * j + 0.3 * rng.generateDouble();
+            const double radius = size * (0.7 + 0.3 * rng.generateDouble());
+            polygon.screen[j]   = QPointF(cx + radius * std::sin(angle), cy - radius * std::cos(angle));
+        }
+
+        const double u = 0.25 * rng.bounded(4), v = 0.25 * rng.bounded(4);
+        polygon.uv[0] = QPointF(u + .25, v + .25);
+        polygon.uv[1] = QPointF(u + .25, v);
+        polygon.uv[2] = QPointF(u, v);
+        polygon.uv[3] = QPointF(u, v + .25);
+
+        m_Polygons.append(polygon);
+    }
+}
+
+void TestScanRender::render(QImage *destination, bool bilinear, int tileSize)
+{
+    destination->fill(Qt::black);
+
+    if (tileSize == 0)
+    {
+        ScanRender scanRender;
+        scanRender.setBilinearInterpolationEnabled(bilinear);
+        for (auto &polygon : m_Polygons)
+            scanRender.renderPolygon(3, polygon.screen, destination, &m_Source, polygon.uv);
+        return;
+    }
+
+    // Every tile gets a fresh scan converter, like the worker threads of HIPSRenderer
+    for (int y = 0; y < destination->height(); y += tileSize)
+    {
+        for (int x = 0; x < destination->width(); x += tileSize)
+        {
+            auto scanRender = std::make_unique<ScanRender>();
+            scanRender->setBilinearInterpolationEnabled(bilinear);
+            scanRender->setClipRect(QRect(x, y, tileSize, tileSize).intersected(destination->rect()));
+
+            for (auto &polygon : m_Polygons)
+                scanRender->renderPolygon(3, polygon.screen, destination, &m_Source, polygon.uv);
+        }
+    }
+}
+
+void TestScanRender::testTilesMatchWholeImage_data()
+{
+    QTest::addColumn<bool>("BILINEAR");
+    QTest::addColumn<int>("TILE");
+
+    for (bool bilinear : { false, true })
+    {
+        for (int tile : { 37, 128, 256 })
+            QTest::newRow(qPrintable(QString("%1 %2px").arg(bilinear ? "bilinear" : "nearest").arg(tile)))
+                    << bilinear << tile;
+    }
+}
+
+void TestScanRender::testTilesMatchWholeImage()
+{
+    QFETCH(bool, BILINEAR);
+    QFETCH(int, TILE);
+
+    QImage whole(kWidth, kHeight, QImage::Format_ARGB32);
+    QImage tiled(kWidth, kHeight, QImage::Format_ARGB32);
+
+    render(&whole, BILINEAR, 0);
+    render(&tiled, BILINEAR, TILE);
+
+    for (int y = 0; y < kHeight; ++y)
+    {
+        const QRgb *a = reinterpret_cast<const QRgb *>(whole.constScanLine(y));
+        const QRgb *b = reinterpret_cast<const QRgb *>(tiled.constScanLine(y));
+        for (int x = 0; x < kWidth; ++x)
+        {
+            if (a[x] != b[x])
+                QFAIL(qPrintable(QString("Pixel (%1, %2) is %3 instead of %4").arg(x).arg(y).arg(b[x], 8, 16).arg(a[x], 8, 16)));
+        }
+    }
+}
+
+void TestScanRender::benchmarkRender_data()
+{
+    QTest::addColumn<bool>("BILINEAR");
+
+    QTest::newRow("nearest") << false;
+    QTest::newRow("bilinear") << true;
+}
+
+void TestScanRender::benchmarkRender()
+{
+    QFETCH(bool, BILINEAR);
+
+    QImage destination(kWidth, kHeight, QImage::Format_ARGB32);
+
+    QBENCHMARK
+    {
+        render(&destination, BILINEAR, 0);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestScanRender)
@@ -0,0 +1,45 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtTest/QtTest>
+#include <QImage>
+#include <QVector>
+
+/**
+ * @class TestScanRender
+ * @short Checks that rendering HiPS polygons tile by tile gives the same image as rendering them at once
+ */
+class TestScanRender : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestScanRender();
+        ~TestScanRender() override = default;
+
+    private slots:
+        void initTestCase();
+
+        void testTilesMatchWholeImage_data();
+        void testTilesMatchWholeImage();
+
+        void benchmarkRender_data();
+        void benchmarkRender();
+
+    private:
+        struct Polygon
+        {
+            QPointF screen[4];
+            QPointF uv[4];
+        };
+
+        void render(QImage *destination, bool bilinear, int tileSize);
+
+        QImage m_Source;
+        QVector<Polygon> m_Polygons;
+};
@@ -0,0 +1,207 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_projectors.h"
+
+#include "azimuthalequidistantprojector.h"
+#include "equirectangularprojector.h"
+#include "gnomonicprojector.h"
+#include "lambertprojector.h"
+#include "orthographicprojector.h"
+#include "stereographicprojector.h"
+#include "auxiliary/cachingdms.h"
+
+#include <QRandomGenerator>
+
+#include <vector>
+
+namespace
+{
+constexpr int kPointCount = 20000;
+}
+
+TestProjectors::TestProjectors() : QObject()
+{
+}
+
+void TestProjectors::initTestCase()
+{
+    // A focus that is off the equator and away from azimuth zero, so that all terms contribute
+    m_Focus.setRA(CachingDms(83.6));
+    m_Focus.setDec(dms(22.0));
+    m_Focus.setAz(dms(137.5));
+    m_Focus.setAlt(dms(41.2));
+
+    m_ViewParams.width         = 1920;
+    m_ViewParams.height        = 1080;
+    m_ViewParams.zoomFactor    = 1500;
+    m_ViewParams.useRefraction = true;
+    m_ViewParams.fillGround    = false;
+    m_ViewParams.focus         = &m_Focus;
+
+    // Points spread over the whole sphere, so that both hemispheres are exercised
+    QRandomGenerator rng(42);
+    m_Points.resize(kPointCount);
+    m_Alt.resize(kPointCount);
+    m_Az.resize(kPointCount);
+    m_Dec.resize(kPointCount);
+    m_RA.resize(kPointCount);
+    for (int i = 0; i < kPointCount; ++i)
+    {
+        const double lat = std::asin(2.0 * rng.generateDouble() - 1.0) / dms::DegToRad;
+        const double lon = 360.0 * rng.generateDouble();
+        const double alt = std::asin(2.0 * rng.generateDouble() - 1.0) / dms::DegToRad;
+        const double az  = 360.0 * rng.generateDouble();
+
+        SkyPoint &p = m_Points[i];
+        p.setRA(CachingDms(lon));
+        p.setDec(dms(lat));
+        p.setAlt(dms(alt));
+        p.setAz(dms(az));
+
+        m_RA[i]  = lon * dms::DegToRad;
+        m_Dec[i] = lat * dms::DegToRad;
+        m_Alt[i] = alt * dms::DegToRad;
+        m_Az[i]  = az * dms::DegToRad;
+    }
+}
+
+std::unique_ptr<Projector> TestProjectors::createProjector(Projector::Projection type, bool useAltAz)
+{
+    m_ViewParams.useAltAz = useAltAz;
+
+    switch (type)
+    {
+        case Projector::Lambert:
+            return std::make_unique<LambertProjector>(m_ViewParams);
+        case Projector::AzimuthalEquidistant:
+            return std::make_unique<AzimuthalEquidistantProjector>(m_ViewParams);
+        case Projector::Orthographic:
+            return std::make_unique<OrthographicProjector>(m_ViewParams);
+        case Projector::Equirectangular:
+            return std::make_unique<EquirectangularProjector>(m_ViewParams);
+        case Projector::Stereographic:
+            return std::make_unique<StereographicProjector>(m_ViewParams);
+        case Projector::Gnomonic:
+            return std::make_unique<GnomonicProjector>(m_ViewParams);
+        default:
+            return nullptr;
+    }
+}
+
+static void addProjectionRows(bool withBackends)
+{
+    static const QList<Projector::Projection> types = { Projector::Lambert, Projector::AzimuthalEquidistant,
+                                                        Projector::Orthographic, Projector::Equirectangular,
+                                                        Projector::Stereographic, Projector::Gnomonic
+                                                      };
+    const QMetaEnum projections = QMetaEnum::fromType<Projector::Projection>();
+
+    for (Projector::Projection type : types)
+    {
+        for (bool useAltAz : { false, true })
+        {
+            const QString name = QString("%1 %2").arg(projections.valueToKey(type), useAltAz ? "altaz" : "equatorial");
+            if (withBackends)
+            {
+                QTest::newRow(qPrintable(name + " scalar")) << static_cast<int>(type) << useAltAz << false;
+                QTest::newRow(qPrintable(name + " batch")) << static_cast<int>(type) << useAltAz << true;
+            }
+            else
+            {
+                QTest::newRow(qPrintable(name)) << static_cast<int>(type) << useAltAz;
+            }
+        }
+    }
+}
+
+void TestProjectors::testBatchMatchesScalar_data()
+{
+    QTest::addColumn<int>("TYPE");
+    QTest::addColumn<bool>("ALTAZ");
+
+    addProjectionRows(false);
+}
+
+void TestProjectors::testBatchMatchesScalar()
+{
+    QFETCH(int, TYPE);
+    QFETCH(bool, ALTAZ);
+
+    std::unique_ptr<Projector> projector = createProjector(static_cast<Projector::Projection>(TYPE), ALTAZ);
+    QVERIFY(projector);
+
+    std::vector<float> x(kPointCount), y(kPointCount);
+    std::vector<uint8_t> visible(kPointCount);
+    projector->toScreenBatch(ALTAZ ? m_Alt.constData() : m_Dec.constData(), ALTAZ ? m_Az.constData() : m_RA.constData(),
+                             kPointCount, x.data(), y.data(), visible.data());
+
+    int visibleCount = 0;
+    for (int i = 0; i < kPointCount; ++i)
+    {
+        bool onVisibleHemisphere = false;
+        const Eigen::Vector2f p = projector->toScreenVec(&m_Points[i], true, &onVisibleHemisphere);
+
+        QCOMPARE(bool(visible[i]), onVisibleHemisphere);
+        if (!onVisibleHemisphere)
+            continue;
+
+        ++visibleCount;
+        // Screen coordinates are floats, so allow for a few ulps of a coordinate far off the screen
+        const float tolerance = 1e-3f * std::max(1.0f, std::max(std::fabs(p.x()), std::fabs(p.y())) / 1000.0f);
+        QVERIFY2(std::fabs(x[i] - p.x()) < tolerance, qPrintable(QString("x %1 vs %2 at %3").arg(x[i]).arg(p.x()).arg(i)));
+        QVERIFY2(std::fabs(y[i] - p.y()) < tolerance, qPrintable(QString("y %1 vs %2 at %3").arg(y[i]).arg(p.y()).arg(i)));
+    }
+    QVERIFY(visibleCount > 0);
+}
+
+void TestProjectors::benchmarkProjection_data()
+{
+    QTest::addColumn<int>("TYPE");
+    QTest::addColumn<bool>("ALTAZ");
+    QTest::addColumn<bool>("BATCH");
+
+    addProjectionRows(true);
+}
+
+void TestProjectors::benchmarkProjection()
+{
+    QFETCH(int, TYPE);
+    QFETCH(bool, ALTAZ);
+    QFETCH(bool, BATCH);
+
+    std::unique_ptr<Projector> projector = createProjector(static_cast<Projector::Projection>(TYPE), ALTAZ);
+    QVERIFY(projector);
+
+    const double *lat = ALTAZ ? m_Alt.constData() : m_Dec.constData();
+    const double *lon = ALTAZ ? m_Az.constData() : m_RA.constData();
+    std::vector<float> x(kPointCount), y(kPointCount);
+    std::vector<uint8_t> visible(kPointCount);
+
+    if (BATCH)
+    {
+        QBENCHMARK
+        {
+            projector->toScreenBatch(lat, lon, kPointCount, x.data(), y.data(), visible.data());
+        }
+    }
+    else
+    {
+        QBENCHMARK
+        {
+            for (int i = 0; i < kPointCount; ++i)
+            {
+                bool onVisibleHemisphere = false;
+                const Eigen::Vector2f p = projector->toScreenVec(&m_Points[i], true, &onVisibleHemisphere);
+                x[i]       = p.x();
+                y[i]       = p.y();
+                visible[i] = onVisibleHemisphere;
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestProjectors)
@@ -0,0 +1,46 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtTest/QtTest>
+#include <QVector>
+
+#include "projector.h"
+
+#include <memory>
+
+/**
+ * @class TestProjectors
+ * @short Checks Projector::toScreenBatch() against toScreenVec() and benchmarks both
+ */
+class TestProjectors : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestProjectors();
+        ~TestProjectors() override = default;
+
+    private slots:
+        void initTestCase();
+
+        void testBatchMatchesScalar_data();
+        void testBatchMatchesScalar();
+
+        void benchmarkProjection_data();
+        void benchmarkProjection();
+
+    private:
+        std::unique_ptr<Projector> createProjector(Projector::Projection type, bool useAltAz);
+
+        SkyPoint m_Focus;
+        ViewParams m_ViewParams;
+
+        // Same points, as SkyPoints for toScreenVec() and as arrays in radians for toScreenBatch()
+        QVector<SkyPoint> m_Points;
+        QVector<double> m_Alt, m_Az, m_Dec, m_RA;
+};
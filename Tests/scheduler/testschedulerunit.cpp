@@ -11,12 +11,16 @@
 
 #include "ekos/scheduler/scheduler.h"
 #include "ekos/scheduler/schedulerjob.h"
+#include "ekos/scheduler/nightephemeris.h"
+#include "ekos/scheduler/greedyscheduler.h"
 #include "indi/indiproperty.h"
 #include "ekos/capture/sequencejob.h"
 #include "ekos/capture/placeholderpath.h"
 #include "Options.h"
 
 #include <QtTest>
+#include <QTimeZone>
+#include <QXmlStreamReader>
 #include <memory>
 
 #include <QObject>
@@ -43,6 +47,9 @@ class TestSchedulerUnit : public QObject
         void loadSequenceQueueTest();
         void estimateJobTimeTest();
         void calculateJobScoreTest();
+        void nightEphemerisTest();
+        void greedySchedulerBenchmark_data();
+        void greedySchedulerBenchmark();
         void evaluateJobsTest();
 
     private:
@@ -570,6 +577,180 @@ void TestSchedulerUnit::calculateJobScoreTest()
     }
 }
 
+// Test the target positions interpolated from the shared night ephemeris.
+void TestSchedulerUnit::nightEphemerisTest()
+{
+    SchedulerJob::setGeo(&siliconValley);
+    SkyPoint target(midnightRA, testDEC);
+    Ekos::NightEphemeris::clearCache();
+
+    // On the hours, positions are those of the slots.
+    Ekos::TargetTrack track;
+    for (int hours = -12; hours <= 12; hours++)
+    {
+        const QDateTime time = midNight.addSecs(hours * 3600);
+        const Ekos::TargetTrack::Position position = track.at(target, time, &siliconValley, 1, nullptr);
+        QVERIFY(compareFloat(position.altitude, svAltitudes[hours + 12], .1));
+        QVERIFY(compareFloat(position.altitude, SchedulerJob::findAltitude(target, time), .001));
+        QVERIFY(!position.hasMoon);
+
+        // Before culmination the target is rising, after it is setting.
+        if (hours < 0)
+            QVERIFY(position.hourAngle >= 12);
+        else if (hours > 0)
+            QVERIFY(position.hourAngle < 12);
+    }
+
+    // Between the slots, positions are interpolated, here off by a few seconds with 5-minute slots.
+    Ekos::TargetTrack coarseTrack;
+    for (int seconds = 0; seconds < 24 * 3600; seconds += 3600 + 97)
+    {
+        const QDateTime time = midNight.addSecs(seconds - 12 * 3600);
+        const Ekos::TargetTrack::Position position = coarseTrack.at(target, time, &siliconValley, 5, nullptr);
+        QVERIFY(compareFloat(position.altitude, SchedulerJob::findAltitude(target, time), .05));
+    }
+
+    // Nights are shared: a second track of the same night and step reuses the slots of the first.
+    QVERIFY(Ekos::NightEphemeris::get(&siliconValley, midNight, 1, nullptr) ==
+            Ekos::NightEphemeris::get(&siliconValley, midNight.addSecs(3600), 1, nullptr));
+    QVERIFY(Ekos::NightEphemeris::get(&siliconValley, midNight, 1, nullptr) !=
+            Ekos::NightEphemeris::get(&siliconValley, midNight.addDays(1), 1, nullptr));
+    QVERIFY(Ekos::NightEphemeris::get(&siliconValley, midNight, 1, nullptr) !=
+            Ekos::NightEphemeris::get(&siliconValley, midNight, 5, nullptr));
+
+    // The night daylight saving time ends is 25 hours long, its slots cover all of it.
+    const QTimeZone pacific("America/Los_Angeles");
+    if (pacific.isValid())
+    {
+        const QDateTime dstEnd(QDate(2021, 11, 6), QTime(12, 0), pacific);
+        const QDateTime lastMinute = dstEnd.addSecs(25 * 3600 - 60);
+        const auto night = Ekos::NightEphemeris::get(&siliconValley, dstEnd, 5, nullptr);
+        QCOMPARE(night->slotCount(), 25 * 12 + 1);
+        QVERIFY(night->matches(&siliconValley, lastMinute, 5, nullptr));
+        QVERIFY(night->slotPosition(lastMinute) <= night->slotCount() - 1);
+    }
+}
+
+// The targets and constraints of the jobs of a scheduler list (.esl) fixture.
+struct EslTarget
+{
+    QString name;
+    dms ra;
+    dms dec;
+    double minAltitude { 0 };
+    bool enforceTwilight { false };
+};
+
+QList<EslTarget> loadEslTargets(const QString &filename)
+{
+    QList<EslTarget> targets;
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return targets;
+
+    QXmlStreamReader xml(&file);
+    while (!xml.atEnd())
+    {
+        if (xml.readNext() != QXmlStreamReader::StartElement)
+            continue;
+        if (xml.name() == QLatin1String("Job"))
+            targets.append(EslTarget());
+        else if (targets.isEmpty())
+            continue;
+        else if (xml.name() == QLatin1String("Name"))
+            targets.last().name = xml.readElementText();
+        else if (xml.name() == QLatin1String("J2000RA"))
+            targets.last().ra.setH(xml.readElementText().toDouble());
+        else if (xml.name() == QLatin1String("J2000DE"))
+            targets.last().dec.setD(xml.readElementText().toDouble());
+        else if (xml.name() == QLatin1String("Constraint"))
+        {
+            const double value = xml.attributes().value("value").toDouble();
+            const QString constraint = xml.readElementText();
+            if (constraint == "MinimumAltitude")
+                targets.last().minAltitude = value;
+            else if (constraint == "EnforceTwilight")
+                targets.last().enforceTwilight = true;
+        }
+    }
+    return targets;
+}
+
+void TestSchedulerUnit::greedySchedulerBenchmark_data()
+{
+    QTest::addColumn<QString>("fixture");
+    QTest::addColumn<int>("jobCount");
+    QTest::addColumn<bool>("incremental");
+
+    for (const QString &fixture : QStringList({"simple_test.esl", "simple_test_no_twilight.esl"}))
+    {
+        for (int jobCount : { 100, 300 })
+        {
+            QTest::newRow(qPrintable(QString("%1 %2 jobs").arg(fixture).arg(jobCount))) << fixture << jobCount << false;
+            QTest::newRow(qPrintable(QString("%1 %2 jobs incremental").arg(fixture).arg(jobCount))) << fixture << jobCount << true;
+        }
+    }
+}
+
+// Benchmark the Greedy scheduler on the jobs of a fixture, repeated with shifted targets up to a few hundred jobs.
+void TestSchedulerUnit::greedySchedulerBenchmark()
+{
+    QFETCH(QString, fixture);
+    QFETCH(int, jobCount);
+    QFETCH(bool, incremental);
+
+    const QList<EslTarget> targets = loadEslTargets(fixture);
+    QVERIFY(!targets.isEmpty());
+
+    auto now = midNight.addSecs(-4 * 3600);
+    Scheduler::setLocalTime(&now);
+
+    std::vector<std::unique_ptr<SchedulerJob>> jobStorage;
+    QList<SchedulerJob *> jobs;
+    for (int i = 0; i < jobCount; ++i)
+    {
+        const EslTarget &target = targets[i % targets.size()];
+        const int copy = i / targets.size();
+        // The nullptr is moon pointer. Not currently tested.
+        jobStorage.emplace_back(new SchedulerJob(nullptr));
+        runSetupJob(*jobStorage.back(), &siliconValley, &now, QString("%1-%2").arg(target.name).arg(copy), 10,
+                    dms(target.ra.Degrees() + 7.0 * copy).reduce(), target.dec, 0.0,
+                    QUrl(QString("file:%1").arg(seqFile9Filters)), QUrl(""),
+                    SchedulerJob::START_ASAP, QDateTime(), 0,
+                    SchedulerJob::FINISH_SEQUENCE, QDateTime(), 1,
+                    target.minAltitude, 0, false, target.enforceTwilight);
+        jobs.append(jobStorage.back().get());
+    }
+
+    const QMap<QString, uint16_t> capturedFrames;
+
+    // The schedule computed from scratch, which incremental scheduling must reproduce.
+    Ekos::GreedyScheduler reference;
+    reference.scheduleJobs(jobs, now, capturedFrames, nullptr);
+    const QList<Ekos::GreedyScheduler::JobSchedule> expected = reference.getSchedule();
+    QVERIFY(!expected.isEmpty());
+
+    Ekos::GreedyScheduler scheduler;
+    scheduler.setIncremental(incremental);
+    if (incremental)
+        scheduler.scheduleJobs(jobs, now, capturedFrames, nullptr);
+
+    QBENCHMARK
+    {
+        scheduler.scheduleJobs(jobs, now, capturedFrames, nullptr);
+    }
+
+    const QList<Ekos::GreedyScheduler::JobSchedule> schedule = scheduler.getSchedule();
+    QCOMPARE(schedule.size(), expected.size());
+    for (int i = 0; i < schedule.size(); ++i)
+    {
+        QCOMPARE(schedule[i].job, expected[i].job);
+        QCOMPARE(schedule[i].startTime, expected[i].startTime);
+        QCOMPARE(schedule[i].stopTime, expected[i].stopTime);
+        QCOMPARE(schedule[i].stopReason, expected[i].stopReason);
+    }
+}
+
 // Test Scheduler::evaluateJobs().
 void TestSchedulerUnit::evaluateJobsTest()
 {
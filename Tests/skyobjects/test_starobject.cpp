@@ -9,6 +9,7 @@
 
 #include "skyobjects/skypoint.h"
 #include "skyobjects/starobject.h"
+#include "skycomponents/starblockkernel.h"
 #include "ksnumbers.h"
 #include "time/kstarsdatetime.h"
 #include "auxiliary/dms.h"
@@ -292,6 +293,66 @@ void TestStarObject::testUpdateCoords()
 
 }
 
+void TestStarObject::testBatchUpdateCoords()
+{
+    if (SkyPoint::implementationIsLibnova)
+        QSKIP("The batch kernel implements the Meeus expressions only.");
+
+    Options::setUseRelativistic(false);
+
+    // Compare the StarBlock batch kernel against the scalar StarObject path over a grid of stars
+    KStarsDateTime dt = KStarsDateTime::fromString("2028-11-13T04:33");
+    const KSNumbers num(dt.djd());
+    const CachingDms lst(123.456), lat(48.5);
+
+    QVector<StarObject> stars;
+    QVector<double> ra0, dec0;
+    QVector<float> pmRA, pmDec;
+    for (double ra = 0.5; ra < 360.0; ra += 17.3)
+    {
+        for (double dec = -78.0; dec <= 78.0; dec += 6.5)
+        {
+            StarObject star;
+            star.setRA0(CachingDms(ra));
+            star.setDec0(CachingDms(dec));
+            star.setProperMotion(100.0 * sin(ra), 50.0 * cos(dec));
+            stars.append(star);
+            ra0.append(star.ra0().radians());
+            dec0.append(star.dec0().radians());
+            pmRA.append(star.pmRA());
+            pmDec.append(star.pmDec());
+        }
+    }
+
+    const int n = stars.size();
+    QVector<double> ra(n), dec(n), alt(n), az(n);
+    QVector<quint8> fallback(n);
+
+    auto params = StarBlockKernel::Parameters::fromNumbers(&num, &lst, &lat);
+    StarBlockKernel::apparentCoords(params, ra0.constData(), dec0.constData(), pmRA.constData(), pmDec.constData(), n,
+                                    ra.data(), dec.data(), fallback.data());
+    StarBlockKernel::horizontalCoords(params, ra.constData(), dec.constData(), n, alt.data(), az.data());
+
+    // The kernel rotates the sines and cosines by small angles, so allow for a milliarcsecond
+    constexpr double tolerance = 0.001 / 3600.0;
+    for (int i = 0; i < n; ++i)
+    {
+        if (fallback[i])
+            continue;
+
+        StarObject &star = stars[i];
+        star.updateCoordsNow(&num);
+        star.EquatorialToHorizontal(&lst, &lat);
+
+        compare(QString("Apparent coordinates of star #%1").arg(i), ra[i] / dms::DegToRad, dec[i] / dms::DegToRad,
+                star.ra().Degrees(), star.dec().Degrees(), tolerance);
+        compare(QString("Altitude of star #%1").arg(i), alt[i] / dms::DegToRad, star.alt().Degrees(), tolerance);
+
+        double dAz = fabs(az[i] / dms::DegToRad - star.az().Degrees());
+        compare(QString("Azimuth of star #%1").arg(i), std::min(dAz, 360.0 - dAz), 0.0, tolerance / cos(alt[i]));
+    }
+}
+
 #ifdef HAVE_LIBERFA
 void TestStarObject::compareProperMotionAgainstErfa_data()
 {
@@ -36,6 +36,7 @@ class TestStarObject : public QObject
     private slots:
         void testUpdateCoordsStepByStep();
         void testUpdateCoords();
+        void testBatchUpdateCoords();
 #ifdef HAVE_LIBERFA
         void compareProperMotionAgainstErfa_data();
         void compareProperMotionAgainstErfa();
@@ -28,6 +28,7 @@ BinFileHelper::~BinFileHelper()
 
 void BinFileHelper::init()
 {
+    unmapFile();
     if (fileHandle)
         fclose(fileHandle);
 
@@ -73,6 +74,7 @@ FILE *BinFileHelper::openFile(const QString &fileName)
 {
     QString FilePath = KSPaths::locate(QStandardPaths::AppLocalDataLocation, fileName);
     init();
+    filePath             = FilePath;
     QByteArray b         = FilePath.toLatin1();
     const char *filepath = b.data();
 
@@ -275,10 +277,69 @@ bool BinFileHelper::readHeader()
 
 void BinFileHelper::closeFile()
 {
+    unmapFile();
     fclose(fileHandle);
     fileHandle = nullptr;
 }
 
+bool BinFileHelper::mapFile()
+{
+    if (mappedData)
+        return true;
+
+    if (!fileHandle || filePath.isEmpty())
+        return false;
+
+    mappedFile.reset(new QFile(filePath));
+    if (!mappedFile->open(QIODevice::ReadOnly))
+    {
+        mappedFile.reset();
+        return false;
+    }
+
+    mappedSize = mappedFile->size();
+    mappedData = (mappedSize > 0) ? mappedFile->map(0, mappedSize) : nullptr;
+
+    if (!mappedData)
+    {
+        mappedFile.reset();
+        mappedSize = 0;
+        return false;
+    }
+
+    return true;
+}
+
+void BinFileHelper::unmapFile()
+{
+    if (mappedFile && mappedData)
+        mappedFile->unmap(mappedData);
+
+    mappedFile.reset();
+    mappedData = nullptr;
+    mappedSize = 0;
+}
+
+RecordSpan BinFileHelper::getRecords(int id) const
+{
+    RecordSpan span;
+
+    if (!mappedData || !indexUpdated || id < 0 || id >= indexOffset.size())
+        return span;
+
+    const qint64 offset = indexOffset.at(id);
+    const qint64 length = static_cast<qint64>(indexCount.at(id)) * recordSize;
+
+    // Do not trust the index table blindly, a truncated file would otherwise make us read past the mapping
+    if (offset < 0 || offset + length > mappedSize)
+        return span;
+
+    span.data       = mappedData + offset;
+    span.count      = indexCount.at(id);
+    span.recordSize = recordSize;
+    return span;
+}
+
 int BinFileHelper::getErrorNumber()
 {
     int err = errnum;
@@ -6,10 +6,12 @@
 
 #pragma once
 
+#include <QFile>
 #include <QString>
 #include <QVector>
 
 #include <cstdio>
+#include <memory>
 
 class QString;
 
@@ -24,6 +26,25 @@ typedef struct dataElement
     qint32 scale { 0 }; /**< Field scale. The final field value = raw_value * scale */
 } dataElement;
 
+/**
+ * @short A read-only view over the records stored under one index entry of a memory-mapped file.
+ *
+ * The view does not own the memory it points to. It stays valid until the file is unmapped or closed.
+ * The records are exactly as they are on disk, so byte swapping (if required) is left to the caller.
+ */
+struct RecordSpan
+{
+    const uchar *data { nullptr }; /**< Pointer to the first record, nullptr if the span is empty */
+    quint32 count { 0 };           /**< Number of records in the span */
+    int recordSize { 0 };          /**< Size of each record in bytes */
+
+    /** @return true if the span holds no records */
+    inline bool isEmpty() const { return !data || count == 0; }
+
+    /** @return A pointer to the i-th record of the span. No bounds checking is done. */
+    inline const uchar *record(quint32 i) const { return data + static_cast<qint64>(i) * recordSize; }
+};
+
 /**
  * @class BinFileHelper
  *
@@ -66,9 +87,50 @@ class BinFileHelper
 
     /**
      * @short  Close the binary data file
+     * @note   This also unmaps the file if it was mapped into memory
      */
     void closeFile();
 
+    /**
+     * @short  Map the currently open file into memory
+     *
+     * Once mapped, the records can be accessed through getRecords() without any seek or read calls,
+     * which is much cheaper for the random, trixel-by-trixel access pattern of the star catalogs.
+     * The FILE handle stays open, so the stdio based readers keep working.
+     *
+     * @return true if the file is mapped, false if no file is open or the mapping failed (e.g. not
+     *         enough address space on 32-bit systems). Callers should fall back to fread() in that case.
+     */
+    bool mapFile();
+
+    /**
+     * @short  Release the memory mapping of the file, if any
+     */
+    void unmapFile();
+
+    /**
+     * @return true if the currently open file is mapped into memory
+     */
+    inline bool isMapped() const { return mappedData != nullptr; }
+
+    /**
+     * @short  Returns a pointer into the mapped file at the given offset
+     * @param  offset Offset from the start of the file, in bytes
+     * @return The pointer, or nullptr if the file is not mapped or the offset is out of bounds
+     */
+    inline const uchar *getMappedData(qint64 offset) const
+    {
+        return (mappedData && offset >= 0 && offset < mappedSize) ? mappedData + offset : nullptr;
+    }
+
+    /**
+     * @short  Returns the records stored under the given index ID as a zero-copy span
+     * @param  id  ID of the index entry
+     * @return The span of records, or an empty span if the file is not mapped, the index has not been
+     *         read or the index entry points outside of the file
+     */
+    RecordSpan getRecords(int id) const;
+
     /**
      * @short   Get error number
      * @return  A number corresponding to the error
@@ -229,6 +291,14 @@ class BinFileHelper
 
     /// Handle to the file.
     FILE *fileHandle { nullptr};
+    /// Full path of the currently open file
+    QString filePath;
+    /// File used for the memory mapping, if any
+    std::unique_ptr<QFile> mappedFile;
+    /// Start of the memory mapped file, nullptr if the file is not mapped
+    uchar *mappedData { nullptr };
+    /// Size of the memory mapped region in bytes
+    qint64 mappedSize { 0 };
     /// Stores offsets corresponding to each index table entry
     QVector<unsigned long> indexOffset;
     /// Stores number of records under each index table entry
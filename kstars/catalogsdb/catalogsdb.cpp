@@ -4,6 +4,7 @@
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 
+#include <atomic>
 #include <limits>
 #include <cmath>
 #include <QSqlDriver>
@@ -21,12 +22,18 @@
 using namespace CatalogsDB;
 QSet<QString> DBManager::m_db_paths{};
 
+/**
+ * Guards `DBManager::m_db_paths`, managers may be created on worker
+ * threads (see `CatalogsTrixelLoader`).
+ */
+static QMutex db_paths_mutex;
+
 /**
  * Get an increasing index for new connections.
  */
 int get_connection_index()
 {
-    static int connection_index = 0;
+    static std::atomic<int> connection_index{ 0 };
     return connection_index++;
 }
 
@@ -80,7 +87,10 @@ std::pair<bool, QString> migrate_db(const int version, QSqlDatabase &db,
 DBManager::DBManager(const QString &filename)
     : m_db{ QSqlDatabase::addDatabase(
           "QSQLITE", QString("cat_%1_%2").arg(filename).arg(get_connection_index())) },
-      m_db_file{ *m_db_paths.insert(filename) }
+      m_db_file{ [&]() -> const QString & {
+          QMutexLocker _{ &db_paths_mutex };
+          return *m_db_paths.insert(filename);
+      }() }
 
 {
     m_db.setDatabaseName(m_db_file);
@@ -5,9 +5,12 @@
 */
 
 #include "analyze.h"
+#include "analyzebinarylog.h"
+#include "intervalfinder.h"
 
 #include <KNotifications/KNotification>
 #include <QDateTime>
+#include <QFileInfo>
 #include <QShortcut>
 #include <QtGlobal>
 #include <QColor>
@@ -246,43 +249,13 @@ QString findFilename(const QString &filename, const QString &alternateDirectory)
     return "";
 }
 
-// This is an exhaustive search for now.
-// This is reasonable as the number of sessions should be limited.
-template <class T>
-class IntervalFinder
-{
-    public:
-        IntervalFinder() {}
-        ~IntervalFinder() {}
-        void add(T value)
-        {
-            intervals.append(value);
-        }
-        void clear()
-        {
-            intervals.clear();
-        }
-        QList<T> find(double t)
-        {
-            QList<T> result;
-            for (const auto i : intervals)
-            {
-                if (t >= i.start && t <= i.end)
-                    result.push_back(i);
-            }
-            return result;
-        }
-    private:
-        QList<T> intervals;
-};
-
-IntervalFinder<Ekos::Analyze::CaptureSession> captureSessions;
-IntervalFinder<Ekos::Analyze::FocusSession> focusSessions;
-IntervalFinder<Ekos::Analyze::GuideSession> guideSessions;
-IntervalFinder<Ekos::Analyze::MountSession> mountSessions;
-IntervalFinder<Ekos::Analyze::AlignSession> alignSessions;
-IntervalFinder<Ekos::Analyze::MountFlipSession> mountFlipSessions;
-IntervalFinder<Ekos::Analyze::SchedulerJobSession> schedulerJobSessions;
+Ekos::IntervalFinder<Ekos::Analyze::CaptureSession> captureSessions;
+Ekos::IntervalFinder<Ekos::Analyze::FocusSession> focusSessions;
+Ekos::IntervalFinder<Ekos::Analyze::GuideSession> guideSessions;
+Ekos::IntervalFinder<Ekos::Analyze::MountSession> mountSessions;
+Ekos::IntervalFinder<Ekos::Analyze::AlignSession> alignSessions;
+Ekos::IntervalFinder<Ekos::Analyze::MountFlipSession> mountFlipSessions;
+Ekos::IntervalFinder<Ekos::Analyze::SchedulerJobSession> schedulerJobSessions;
 
 }  // namespace
 
@@ -325,6 +298,11 @@ Analyze::Analyze()
 
     alternateFolder = QDir::homePath();
 
+    loader = new AnalyzeLoader(this);
+    connect(loader, &AnalyzeLoader::linesRead, this, &Ekos::Analyze::processInputLines);
+    connect(loader, &AnalyzeLoader::finished, this, &Ekos::Analyze::inputFileRead);
+    loadProgress->setVisible(false);
+
     initInputSelection();
     initTimelinePlot();
     initStatsPlot();
@@ -392,6 +370,8 @@ void Analyze::initInputSelection()
     inputCombo->addItem(i18n("Current Session"));
     inputCombo->addItem(i18n("Read from File"));
     inputCombo->addItem(i18n("Set alternative image-file base directory"));
+    inputCombo->addItem(i18n("Convert Text Log to Binary"));
+    inputCombo->addItem(i18n("Export Binary Log to Text"));
     inputValue->setText("");
     connect(inputCombo, static_cast<void (QComboBox::*)(int)>(&QComboBox::activated), this, [&](int index)
     {
@@ -402,8 +382,11 @@ void Analyze::initInputSelection()
             {
                 reset();
                 inputValue->setText(i18n("Current Session"));
-                maxXValue = readDataFromFile(logFilename);
-                runtimeDisplay = true;
+                // The log is read as it is now, including the lines a binary log still holds in memory.
+                // What is logged meanwhile is kept in liveLines and displayed once the log is read.
+                if (binaryLog)
+                    binaryLog->flush();
+                readDataFromFile(logFilename, true, QFileInfo(logFilename).size());
             }
             fullWidthCB->setChecked(true);
             fullWidthCB->setVisible(true);
@@ -414,7 +397,7 @@ void Analyze::initInputSelection()
         {
             // Input from a file.
             QUrl inputURL = QFileDialog::getOpenFileUrl(this, i18nc("@title:window", "Select input file"), dirPath,
-                            i18n("Analyze Log (*.analyze);;All Files (*)"));
+                            i18n("Analyze Log (*.analyze *.analyzeb);;All Files (*)"));
             if (inputURL.isEmpty())
                 return;
             dirPath = QUrl(inputURL.url(QUrl::RemoveFilename));
@@ -425,10 +408,7 @@ void Analyze::initInputSelection()
             // If we do this after the readData call below, it would animate the sequence.
             runtimeDisplay = false;
 
-            maxXValue = readDataFromFile(inputURL.toLocalFile());
-            plotStart = 0;
-            plotWidth = maxXValue + 5;
-            replot();
+            readDataFromFile(inputURL.toLocalFile(), false);
         }
         else if (index == 2)
         {
@@ -447,9 +427,46 @@ void Analyze::initInputSelection()
             else
                 inputCombo->setCurrentIndex(1);
         }
+        else if (index == 3 || index == 4)
+        {
+            convertLog(index == 3);
+            // Neither is a destination, reset to one of the above.
+            inputCombo->setCurrentIndex(runtimeDisplay ? 0 : 1);
+        }
     });
 }
 
+// Converts a log chosen by the user between the text and the binary formats.
+void Analyze::convertLog(bool toBinary)
+{
+    const QString textFilter = i18n("Analyze Log (*.analyze)");
+    const QString binaryFilter = i18n("Binary Analyze Log (*.analyzeb)");
+    const QString input = QFileDialog::getOpenFileName(this, i18nc("@title:window", "Select Log to Convert"),
+                          dirPath.toLocalFile(), toBinary ? textFilter : binaryFilter);
+    if (input.isEmpty())
+        return;
+
+    const QFileInfo info(input);
+    const QString suggested = info.dir().filePath(info.completeBaseName() + (toBinary ? ".analyzeb" : ".analyze"));
+    const QString output = QFileDialog::getSaveFileName(this, i18nc("@title:window", "Save Converted Log"), suggested,
+                           toBinary ? binaryFilter : textFilter);
+    if (output.isEmpty())
+        return;
+    // Neither the log converted nor the log of the current session may be overwritten.
+    if (QFileInfo(output) == info || QFileInfo(output) == QFileInfo(logFilename))
+    {
+        KSNotification::sorry(i18n("The converted log cannot replace %1.", output), i18n("Conversion Failed"));
+        return;
+    }
+
+    const bool ok = toBinary ? AnalyzeBinaryWriter::fromCsv(input, output) : AnalyzeBinaryReader::toCsv(input, output);
+
+    if (ok)
+        KSNotification::info(i18n("%1 was converted to %2.", info.fileName(), QFileInfo(output).fileName()));
+    else
+        KSNotification::sorry(i18n("%1 could not be converted.", input), i18n("Conversion Failed"));
+}
+
 void Analyze::setupKeyboardShortcuts(QCustomPlot *plot)
 {
     // Shortcuts defined: https://doc.qt.io/archives/qt-4.8/qkeysequence.html#standard-shortcuts
@@ -666,204 +683,126 @@ void Analyze::addMountCoords(double ra, double dec, double az,
     statsPlot->graph(PIER_SIDE_GRAPH)->addData(time, double(pierSide));
 }
 
-// Read a .analyze file, and setup all the graphics.
-double Analyze::readDataFromFile(const QString &filename)
+// Read a .analyze file in the background, and setup all the graphics as its lines arrive.
+void Analyze::readDataFromFile(const QString &filename, bool currentSession, qint64 length)
 {
-    double lastTime = 10;
-    QFile inputFile(filename);
-    if (inputFile.open(QIODevice::ReadOnly))
-    {
-        QTextStream in(&inputFile);
-        while (!in.atEnd())
-        {
-            QString line = in.readLine();
-            double time = processInputLine(line);
-            if (time > lastTime)
-                lastTime = time;
-        }
-        inputFile.close();
-    }
-    return lastTime;
+    loadingCurrentSession = currentSession;
+    liveLines.clear();
+    loadProgress->setValue(0);
+    loadProgress->setVisible(true);
+    loadReplotTimer.start();
+    loader->load(filename, length);
 }
 
-// Process an input line read from a .analyze file.
-double Analyze::processInputLine(const QString &line)
+// Process a chunk of lines read by the loader.
+void Analyze::processInputLines(const QVector<AnalyzeLoader::Line> &lines, int percent)
 {
-    bool ok;
-    // Break the line into comma-separated components
-    QStringList list = line.split(QLatin1Char(','));
-    // We need at least a command and a timestamp
-    if (list.size() < 2)
-        return 0;
-    if (list[0].at(0).toLatin1() == '#')
+    for (const auto &line : lines)
+        updateMaxX(processInputLine(line));
+    loadProgress->setValue(percent);
+
+    // Replotting the whole log is slow, only show progress now and then.
+    if (loadReplotTimer.elapsed() > 500)
     {
-        // Comment character # must be at start of line.
-        return 0;
+        inputFileProgress();
+        loadReplotTimer.start();
     }
+}
 
-    if ((list[0] == "AnalyzeStartTime") && list.size() == 3)
+void Analyze::inputFileRead(bool ok)
+{
+    Q_UNUSED(ok);
+    loadProgress->setVisible(false);
+    if (loadingCurrentSession)
     {
-        displayStartTime = QDateTime::fromString(list[1], timeFormat);
-        startTimeInitialized = true;
-        analyzeTimeZone = list[2];
-        return 0;
+        // Live again, then what was logged while reading, as it would have been displayed.
+        runtimeDisplay = true;
+        const QVector<AnalyzeLoader::Line> lines = liveLines;
+        liveLines.clear();
+        for (const auto &line : lines)
+            updateMaxX(processInputLine(line, false));
     }
+    inputFileProgress();
+}
 
-    // Except for comments and the above AnalyzeStartTime, the second item
-    // in the csv line is a double which represents seconds since start of the log.
-    const double time = QString(list[1]).toDouble(&ok);
-    if (!ok)
-        return 0;
-    if (time < 0 || time > 3600 * 24 * 10)
-        return 0;
+bool Analyze::reloadingSession() const
+{
+    return loadingCurrentSession && loader->isLoading();
+}
 
-    if ((list[0] == "CaptureStarting") && (list.size() == 4))
-    {
-        const double exposureSeconds = QString(list[2]).toDouble(&ok);
-        if (!ok)
-            return 0;
-        const QString filter = list[3];
-        processCaptureStarting(time, exposureSeconds, filter, true);
-    }
-    else if ((list[0] == "CaptureComplete") && (list.size() >= 6) && (list.size() <= 9))
-    {
-        const double exposureSeconds = QString(list[2]).toDouble(&ok);
-        if (!ok)
-            return 0;
-        const QString filter = list[3];
-        const double hfr = QString(list[4]).toDouble(&ok);
-        if (!ok)
-            return 0;
-        const QString filename = list[5];
-        const int numStars = (list.size() > 6) ? QString(list[6]).toInt(&ok) : 0;
-        if (!ok)
-            return 0;
-        const int median = (list.size() > 7) ? QString(list[7]).toInt(&ok) : 0;
-        if (!ok)
-            return 0;
-        const double eccentricity = (list.size() > 8) ? QString(list[8]).toDouble(&ok) : 0;
-        if (!ok)
-            return 0;
-        processCaptureComplete(time, filename, exposureSeconds, filter, hfr, numStars, median, eccentricity, true);
-    }
-    else if ((list[0] == "CaptureAborted") && (list.size() == 3))
-    {
-        const double exposureSeconds = QString(list[2]).toDouble(&ok);
-        if (!ok)
-            return 0;
-        processCaptureAborted(time, exposureSeconds, true);
-    }
-    else if ((list[0] == "AutofocusStarting") && (list.size() == 4))
-    {
-        QString filter = list[2];
-        double temperature = QString(list[3]).toDouble(&ok);
-        if (!ok)
-            return 0;
-        processAutofocusStarting(time, temperature, filter, true);
-    }
-    else if ((list[0] == "AutofocusComplete") && (list.size() == 4))
-    {
-        QString filter = list[2];
-        QString samples = list[3];
-        processAutofocusComplete(time, filter, samples, true);
-    }
-    else if ((list[0] == "AutofocusAborted") && (list.size() == 4))
-    {
-        QString filter = list[2];
-        QString samples = list[3];
-        processAutofocusAborted(time, filter, samples, true);
-    }
-    else if ((list[0] == "GuideState") && list.size() == 3)
-    {
-        processGuideState(time, list[2], true);
-    }
-    else if ((list[0] == "GuideStats") && list.size() == 9)
-    {
-        const double ra = QString(list[2]).toDouble(&ok);
-        if (!ok)
-            return 0;
-        const double dec = QString(list[3]).toDouble(&ok);
-        if (!ok)
-            return 0;
-        const double raPulse = QString(list[4]).toInt(&ok);
-        if (!ok)
-            return 0;
-        const double decPulse = QString(list[5]).toInt(&ok);
-        if (!ok)
-            return 0;
-        const double snr = QString(list[6]).toDouble(&ok);
-        if (!ok)
-            return 0;
-        const double skyBg = QString(list[7]).toDouble(&ok);
-        if (!ok)
-            return 0;
-        const double numStars = QString(list[8]).toInt(&ok);
-        if (!ok)
-            return 0;
-        processGuideStats(time, ra, dec, raPulse, decPulse, snr, skyBg, numStars, true);
-    }
-    else if ((list[0] == "Temperature") && list.size() == 3)
-    {
-        const double temperature = QString(list[2]).toDouble(&ok);
-        if (!ok)
-            return 0;
-        processTemperature(time, temperature, true);
-    }
-    else if ((list[0] == "TargetDistance") && list.size() == 3)
-    {
-        const double targetDistance = QString(list[2]).toDouble(&ok);
-        if (!ok)
-            return 0;
-        processTargetDistance(time, targetDistance, true);
-    }
-    else if ((list[0] == "MountState") && list.size() == 3)
+void Analyze::inputFileProgress()
+{
+    if (!loadingCurrentSession)
     {
-        processMountState(time, list[2], true);
+        plotStart = 0;
+        plotWidth = maxXValue + 5;
     }
-    else if ((list[0] == "MountCoords") && (list.size() == 7 || list.size() == 8))
+    replot();
+}
+
+// Process a line read from a .analyze file.
+double Analyze::processInputLine(const AnalyzeLoader::Line &line, bool batchMode)
+{
+    const double time = line.time;
+    const double *values = line.values;
+    switch (line.type)
     {
-        const double ra = QString(list[2]).toDouble(&ok);
-        if (!ok)
-            return 0;
-        const double dec = QString(list[3]).toDouble(&ok);
-        if (!ok)
-            return 0;
-        const double az = QString(list[4]).toDouble(&ok);
-        if (!ok)
-            return 0;
-        const double alt = QString(list[5]).toDouble(&ok);
-        if (!ok)
-            return 0;
-        const int side = QString(list[6]).toInt(&ok);
-        if (!ok)
-            return 0;
-        const double ha = (list.size() > 7) ? QString(list[7]).toDouble(&ok) : 0;
-        if (!ok)
+        case AnalyzeLoader::ANALYZE_START_TIME:
+            displayStartTime = QDateTime::fromString(line.text[0], timeFormat);
+            startTimeInitialized = true;
+            analyzeTimeZone = line.text[1];
             return 0;
-        processMountCoords(time, ra, dec, az, alt, side, ha, true);
-    }
-    else if ((list[0] == "AlignState") && list.size() == 3)
-    {
-        processAlignState(time, list[2], true);
-    }
-    else if ((list[0] == "MeridianFlipState") && list.size() == 3)
-    {
-        processMountFlipState(time, list[2], true);
-    }
-    else if ((list[0] == "SchedulerJobStart") && list.size() == 3)
-    {
-        QString jobName = list[2];
-        processSchedulerJobStarted(time, jobName, true);
-    }
-    else if ((list[0] == "SchedulerJobEnd") && list.size() == 4)
-    {
-        QString jobName = list[2];
-        QString reason = list[3];
-        processSchedulerJobEnded(time, jobName, reason, true);
-    }
-    else
-    {
-        return 0;
+        case AnalyzeLoader::CAPTURE_STARTING:
+            processCaptureStarting(time, values[0], line.text[0], batchMode);
+            break;
+        case AnalyzeLoader::CAPTURE_COMPLETE:
+            processCaptureComplete(time, line.text[1], values[0], line.text[0], values[1],
+                                   static_cast<int>(values[2]), static_cast<int>(values[3]), values[4], batchMode);
+            break;
+        case AnalyzeLoader::CAPTURE_ABORTED:
+            processCaptureAborted(time, values[0], batchMode);
+            break;
+        case AnalyzeLoader::AUTOFOCUS_STARTING:
+            processAutofocusStarting(time, values[0], line.text[0], batchMode);
+            break;
+        case AnalyzeLoader::AUTOFOCUS_COMPLETE:
+            processAutofocusComplete(time, line.text[0], line.text[1], batchMode);
+            break;
+        case AnalyzeLoader::AUTOFOCUS_ABORTED:
+            processAutofocusAborted(time, line.text[0], line.text[1], batchMode);
+            break;
+        case AnalyzeLoader::GUIDE_STATE:
+            processGuideState(time, line.text[0], batchMode);
+            break;
+        case AnalyzeLoader::GUIDE_STATS:
+            processGuideStats(time, values[0], values[1], static_cast<int>(values[2]), static_cast<int>(values[3]),
+                              values[4], values[5], static_cast<int>(values[6]), batchMode);
+            break;
+        case AnalyzeLoader::TEMPERATURE:
+            processTemperature(time, values[0], batchMode);
+            break;
+        case AnalyzeLoader::TARGET_DISTANCE:
+            processTargetDistance(time, values[0], batchMode);
+            break;
+        case AnalyzeLoader::MOUNT_STATE:
+            processMountState(time, line.text[0], batchMode);
+            break;
+        case AnalyzeLoader::MOUNT_COORDS:
+            processMountCoords(time, values[0], values[1], values[2], values[3], static_cast<int>(values[4]),
+                               values[5], batchMode);
+            break;
+        case AnalyzeLoader::ALIGN_STATE:
+            processAlignState(time, line.text[0], batchMode);
+            break;
+        case AnalyzeLoader::MERIDIAN_FLIP_STATE:
+            processMountFlipState(time, line.text[0], batchMode);
+            break;
+        case AnalyzeLoader::SCHEDULER_JOB_START:
+            processSchedulerJobStarted(time, line.text[0], batchMode);
+            break;
+        case AnalyzeLoader::SCHEDULER_JOB_END:
+            processSchedulerJobEnded(time, line.text[0], line.text[1], batchMode);
+            break;
     }
     return time;
 }
@@ -1851,6 +1790,9 @@ void Analyze::initStatsPlot()
 // Clear the graphics and state when changing input data.
 void Analyze::reset()
 {
+    loader->cancel();
+    loadProgress->setVisible(false);
+
     maxXValue = 10.0;
     plotStart = 0.0;
     plotWidth = 10.0;
@@ -1879,6 +1821,11 @@ void Analyze::reset()
     inputValue->clear();
     captureSessions.clear();
     focusSessions.clear();
+    guideSessions.clear();
+    mountSessions.clear();
+    alignSessions.clear();
+    mountFlipSessions.clear();
+    schedulerJobSessions.clear();
 
     numStarsOut->setText("");
     skyBgOut->setText("");
@@ -2051,9 +1998,19 @@ void Analyze::startLog()
     QDir dir = QDir(KSPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/analyze");
     dir.mkpath(".");
 
-    logFilename = dir.filePath("ekos-" + QDateTime::currentDateTime().toString("yyyy-MM-ddThh-mm-ss") + ".analyze");
-    logFile.setFileName(logFilename);
-    logFile.open(QIODevice::WriteOnly | QIODevice::Text);
+    const QString name = "ekos-" + QDateTime::currentDateTime().toString("yyyy-MM-ddThh-mm-ss");
+    if (Options::analyzeBinaryLog())
+    {
+        logFilename = dir.filePath(name + ".analyzeb");
+        binaryLog.reset(new AnalyzeBinaryWriter());
+        binaryLog->open(logFilename);
+    }
+    else
+    {
+        logFilename = dir.filePath(name + ".analyze");
+        logFile.setFileName(logFilename);
+        logFile.open(QIODevice::WriteOnly | QIODevice::Text);
+    }
 
     // This must happen before the below appendToLog() call.
     logInitialized = true;
@@ -2068,6 +2025,23 @@ void Analyze::appendToLog(const QString &lines)
 {
     if (!logInitialized)
         startLog();
+    if (binaryLog || reloadingSession())
+    {
+        // Parsed as they would be read back, comments are not kept.
+        AnalyzeLoader::Line line;
+        for (const QString &text : lines.split(QLatin1Char('\n'), QString::SkipEmptyParts))
+        {
+            const QByteArray bytes = text.toUtf8();
+            if (!AnalyzeLoader::parseLine(bytes.constData(), bytes.constData() + bytes.size(), &line))
+                continue;
+            if (reloadingSession())
+                liveLines.append(line);
+            if (binaryLog)
+                binaryLog->append(line);
+        }
+        if (binaryLog)
+            return;
+    }
     QTextStream out(&logFile);
     out << lines;
     out.flush();
@@ -2150,7 +2124,8 @@ void Analyze::captureStarting(double exposureSeconds, const QString &filter)
 {
     saveMessage("CaptureStarting",
                 QString("%1,%2").arg(QString::number(exposureSeconds, 'f', 3), filter));
-    processCaptureStarting(logTime(), exposureSeconds, filter);
+    if (!reloadingSession())
+        processCaptureStarting(logTime(), exposureSeconds, filter);
 }
 
 // Called by either the above (when live data is received), or reading from file.
@@ -2261,7 +2236,8 @@ void Analyze::autofocusStarting(double temperature, const QString &filter)
                 QString("%1,%2")
                 .arg(filter)
                 .arg(QString::number(temperature, 'f', 1)));
-    processAutofocusStarting(logTime(), temperature, filter);
+    if (!reloadingSession())
+        processAutofocusStarting(logTime(), temperature, filter);
 }
 
 void Analyze::processAutofocusStarting(double time, double temperature, const QString &filter, bool batchMode)
@@ -7,9 +7,11 @@
 #ifndef ANALYZE_H
 #define ANALYZE_H
 
+#include <QElapsedTimer>
 #include <QtDBus>
 #include <memory>
 
+#include "analyzeloader.h"
 #include "ekos/ekos.h"
 #include "ekos/mount/mount.h"
 #include "indi/inditelescope.h"
@@ -22,6 +24,7 @@ class OffsetDateTimeTicker;
 namespace Ekos
 {
 
+class AnalyzeBinaryWriter;
 class RmsFilter;
 
 /**
@@ -318,6 +321,8 @@ class Analyze : public QWidget, public Ui::Analyze
         void initTimelinePlot();
         void initGraphicsPlot();
         void initInputSelection();
+        // Converts a log chosen by the user to the binary format, or back to text.
+        void convertLog(bool toBinary);
 
         // Displays the focus positions and HFRs on the graphics plot.
         void displayFocusGraphics(const QVector<double> &positions, const QVector<double> &hfrs, bool success);
@@ -351,9 +356,18 @@ class Analyze : public QWidget, public Ui::Analyze
         void resetSchedulerJob();
         void resetTemperature();
 
-        // Read and display an input .analyze file.
-        double readDataFromFile(const QString &filename);
-        double processInputLine(const QString &line);
+        // Read and display an input .analyze file. The file is read in the background, and the
+        // plots fill as its lines arrive. If currentSession is true, live data are displayed once
+        // the file is read.
+        // Reads the first length bytes of filename, the whole file if length is negative.
+        void readDataFromFile(const QString &filename, bool currentSession, qint64 length = -1);
+        void processInputLines(const QVector<AnalyzeLoader::Line> &lines, int percent);
+        // batchMode is false for live lines, see the process methods.
+        double processInputLine(const AnalyzeLoader::Line &line, bool batchMode = true);
+        void inputFileRead(bool ok);
+        // True while the log of the current session is read back. Live data are kept in liveLines then.
+        bool reloadingSession() const;
+        void inputFileProgress();
 
         // Opens a FITS file for viewing.
         void displayFITS(const QString &filename);
@@ -370,6 +384,8 @@ class Analyze : public QWidget, public Ui::Analyze
         // The .analyze log file being written.
         QString logFilename { "" };
         QFile logFile;
+        // Written instead of logFile if the binary log option is set.
+        std::unique_ptr<AnalyzeBinaryWriter> binaryLog;
         bool logInitialized { false };
 
         // These define the view for the timeline and stats plots.
@@ -427,6 +443,14 @@ class Analyze : public QWidget, public Ui::Analyze
         // Keeps the directory from the last time the user loaded a .analyze file.
         QUrl dirPath;
 
+        // Reads .analyze files in the background. Owned by this widget.
+        AnalyzeLoader *loader { nullptr };
+        bool loadingCurrentSession { false };
+        // Lines logged while the current session is reloaded, past the part of the log being read.
+        // They are processed as live data once the log is read.
+        QVector<AnalyzeLoader::Line> liveLines;
+        QElapsedTimer loadReplotTimer;
+
         // True if Analyze is displaying data as it comes in from the other modules.
         // False if Analyze is displaying data read from a file.
         bool runtimeDisplay { true };
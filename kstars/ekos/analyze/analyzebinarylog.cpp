@@ -0,0 +1,721 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "analyzebinarylog.h"
+
+#include <QFileInfo>
+#include <QLocale>
+#include <QTextStream>
+#include <QtEndian>
+
+#include <ekos_analyze_debug.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+using Ekos::AnalyzeLoader;
+
+const char kFileMagic[8] = { 'K', 'S', 'A', 'N', 'L', 'Y', 'Z', 'B' };
+const char kTrailerMagic[8] = { 'K', 'S', 'A', 'N', 'I', 'D', 'X', '1' };
+constexpr quint32 kVersion = 1;
+constexpr qint64 kFileHeaderSize = 16;
+constexpr quint32 kBlockMagic = 0x4B4C4243;  // "CBLK"
+constexpr qint64 kBlockHeaderSize = 48;
+constexpr quint32 kIndexMagic = 0x58444943;  // "CIDX"
+constexpr qint64 kIndexEntrySize = 32;
+constexpr qint64 kTrailerSize = 16;
+// Lines of one type written per block, when not flushed earlier.
+constexpr int kBlockLines = 4096;
+// Log seconds after which the writer flushes, so that little is lost if KStars stops.
+constexpr double kFlushInterval = 60;
+
+qint64 align8(qint64 size)
+{
+    return (size + 7) & ~qint64(7);
+}
+
+void put32(QByteArray *out, quint32 value)
+{
+    char bytes[4];
+    qToLittleEndian(value, bytes);
+    out->append(bytes, 4);
+}
+
+void put64(QByteArray *out, quint64 value)
+{
+    char bytes[8];
+    qToLittleEndian(value, bytes);
+    out->append(bytes, 8);
+}
+
+void putDouble(QByteArray *out, double value)
+{
+    quint64 bits;
+    memcpy(&bits, &value, 8);
+    put64(out, bits);
+}
+
+void pad8(QByteArray *out)
+{
+    out->append(static_cast<int>(align8(out->size()) - out->size()), '\0');
+}
+
+quint32 get32(const uchar *p)
+{
+    return qFromLittleEndian<quint32>(p);
+}
+
+quint64 get64(const uchar *p)
+{
+    return qFromLittleEndian<quint64>(p);
+}
+
+double getDouble(const uchar *p)
+{
+    const quint64 bits = get64(p);
+    double value;
+    memcpy(&value, &bits, 8);
+    return value;
+}
+
+// Encodings of the columns of numbers. Most numbers Analyze logs are integers or have at most three
+// decimals, they are stored as 32 bit integers when that is exact for the whole column.
+constexpr quint32 kDoubles = 0;
+constexpr quint32 kIntegers = 1;
+constexpr quint32 kThousandths = 2;
+
+bool exactAsInt32(const QVector<double> &numbers, double scale)
+{
+    for (double number : numbers)
+    {
+        const double scaled = number * scale;
+        if (!(std::abs(scaled) < 2147483647.0) || (number == 0 && std::signbit(number)))
+            return false;
+        if (static_cast<qint32>(std::lround(scaled)) / scale != number)
+            return false;
+    }
+    return true;
+}
+
+// Writes the encoding, the numbers, then pads to 8 bytes.
+void putNumbers(QByteArray *out, const QVector<double> &numbers)
+{
+    const quint32 encoding = exactAsInt32(numbers, 1) ? kIntegers :
+                             exactAsInt32(numbers, 1000) ? kThousandths : kDoubles;
+    put32(out, encoding);
+    for (double number : numbers)
+    {
+        if (encoding == kDoubles)
+            putDouble(out, number);
+        else
+        {
+            const double scaled = encoding == kThousandths ? number * 1000 : number;
+            put32(out, static_cast<quint32>(static_cast<qint32>(std::lround(scaled))));
+        }
+    }
+    pad8(out);
+}
+
+struct NumberColumn
+{
+    quint32 encoding { kDoubles };
+    const uchar *data { nullptr };
+
+    double at(qint64 i) const
+    {
+        if (encoding == kDoubles)
+            return getDouble(data + i * 8);
+        const double number = static_cast<qint32>(get32(data + i * 4));
+        return encoding == kThousandths ? number / 1000 : number;
+    }
+};
+
+struct BlockHeader
+{
+    quint32 type { 0 };
+    quint32 count { 0 };
+    quint32 payloadSize { 0 };
+    quint64 firstSequence { 0 };
+    quint64 lastSequence { 0 };
+    double minTime { 0 };
+    double maxTime { 0 };
+};
+
+QByteArray encodeHeader(const BlockHeader &header)
+{
+    QByteArray out;
+    put32(&out, kBlockMagic);
+    put32(&out, header.type);
+    put32(&out, header.count);
+    put32(&out, header.payloadSize);
+    put64(&out, header.firstSequence);
+    put64(&out, header.lastSequence);
+    putDouble(&out, header.minTime);
+    putDouble(&out, header.maxTime);
+    return out;
+}
+
+// Decodes the block header at offset, false if there is no complete block there.
+bool decodeHeader(const uchar *data, qint64 size, qint64 offset, BlockHeader *header)
+{
+    if (offset < kFileHeaderSize || offset + kBlockHeaderSize > size)
+        return false;
+    const uchar *p = data + offset;
+    if (get32(p) != kBlockMagic)
+        return false;
+    header->type = get32(p + 4);
+    header->count = get32(p + 8);
+    header->payloadSize = get32(p + 12);
+    header->firstSequence = get64(p + 16);
+    header->lastSequence = get64(p + 24);
+    header->minTime = getDouble(p + 32);
+    header->maxTime = getDouble(p + 40);
+    return header->type < static_cast<quint32>(AnalyzeLoader::TYPE_COUNT) &&
+           offset + kBlockHeaderSize + header->payloadSize <= size;
+}
+
+bool validFileHeader(const uchar *data, qint64 size)
+{
+    return size >= kFileHeaderSize && memcmp(data, kFileMagic, 8) == 0 && get32(data + 8) == kVersion;
+}
+
+struct Entry
+{
+    qint64 offset;
+    BlockHeader header;
+};
+
+// Reads the index of a closed log. Index entries do not hold the sequence numbers.
+bool readIndex(const uchar *data, qint64 size, QVector<Entry> *entries, qint64 *indexOffset)
+{
+    if (size < kFileHeaderSize + kTrailerSize + 8 || memcmp(data + size - 8, kTrailerMagic, 8) != 0)
+        return false;
+    const qint64 offset = static_cast<qint64>(get64(data + size - kTrailerSize));
+    if (offset < kFileHeaderSize || offset + 8 > size - kTrailerSize || get32(data + offset) != kIndexMagic)
+        return false;
+    const qint64 count = get32(data + offset + 4);
+    if (offset + 8 + count * kIndexEntrySize != size - kTrailerSize)
+        return false;
+
+    entries->clear();
+    for (qint64 i = 0; i < count; ++i)
+    {
+        const uchar *p = data + offset + 8 + i * kIndexEntrySize;
+        Entry entry;
+        entry.offset = static_cast<qint64>(get64(p));
+        entry.header.type = get32(p + 8);
+        entry.header.count = get32(p + 12);
+        entry.header.minTime = getDouble(p + 16);
+        entry.header.maxTime = getDouble(p + 24);
+        if (entry.header.type >= static_cast<quint32>(AnalyzeLoader::TYPE_COUNT) || entry.offset >= offset)
+            return false;
+        entries->append(entry);
+    }
+    *indexOffset = offset;
+    return true;
+}
+
+// Removes the lines written before sequence from lines, and returns them in the order they were written.
+// Blocks hold one type each, this puts the lines of all types back in order.
+QVector<AnalyzeLoader::Line> takeInOrder(QVector<AnalyzeLoader::Line> *lines, QVector<quint64> *sequences,
+        quint64 sequence)
+{
+    QVector<int> order(lines->size());
+    for (int i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [sequences](int a, int b)
+    {
+        return (*sequences)[a] < (*sequences)[b];
+    });
+
+    QVector<AnalyzeLoader::Line> taken, kept;
+    QVector<quint64> keptSequences;
+    for (int i : order)
+    {
+        if ((*sequences)[i] < sequence)
+            taken.append((*lines)[i]);
+        else
+        {
+            kept.append((*lines)[i]);
+            keptSequences.append((*sequences)[i]);
+        }
+    }
+    *lines = kept;
+    *sequences = keptSequences;
+    return taken;
+}
+
+// Walks the blocks of a log that was not closed. Returns the end of the last complete block.
+qint64 scanBlocks(const uchar *data, qint64 size, QVector<Entry> *entries)
+{
+    entries->clear();
+    qint64 offset = kFileHeaderSize;
+    Entry entry;
+    while (decodeHeader(data, size, offset, &entry.header))
+    {
+        entry.offset = offset;
+        entries->append(entry);
+        offset += kBlockHeaderSize + entry.header.payloadSize;
+    }
+    return offset;
+}
+
+// Decodes the lines of a block with start <= time <= end, with their sequence numbers.
+bool decodeBlock(const uchar *data, qint64 size, qint64 offset, double start, double end,
+                 QVector<AnalyzeLoader::Line> *lines, QVector<quint64> *sequences)
+{
+    BlockHeader header;
+    if (!decodeHeader(data, size, offset, &header))
+        return false;
+
+    const auto type = static_cast<AnalyzeLoader::Type>(header.type);
+    const qint64 count = header.count;
+    const int numValues = AnalyzeLoader::valueCount(type);
+    const int numTexts = AnalyzeLoader::textCount(type);
+
+    // Takes the next bytes of the payload, padded to 8, or nullptr past its end.
+    const uchar *p = data + offset + kBlockHeaderSize;
+    qint64 remaining = header.payloadSize;
+    const auto take = [&p, &remaining](qint64 bytes) -> const uchar *
+    {
+        bytes = align8(bytes);
+        if (bytes > remaining)
+            return nullptr;
+        const uchar *taken = p;
+        p += bytes;
+        remaining -= bytes;
+        return taken;
+    };
+    const auto takeNumbers = [&](NumberColumn *column)
+    {
+        if (remaining < 4)
+            return false;
+        column->encoding = get32(p);
+        if (column->encoding > kThousandths)
+            return false;
+        const uchar *taken = take(4 + count * (column->encoding == kDoubles ? 8 : 4));
+        column->data = taken ? taken + 4 : nullptr;
+        return taken != nullptr;
+    };
+
+    const uchar *sequenceColumn = take(count * 4);
+    NumberColumn timeColumn;
+    if (!sequenceColumn || !takeNumbers(&timeColumn))
+        return false;
+    NumberColumn valueColumns[7];
+    for (int v = 0; v < numValues; ++v)
+    {
+        if (!takeNumbers(&valueColumns[v]))
+            return false;
+    }
+    const uchar *textOffsets[2] = {};
+    const uchar *textBytes[2] = {};
+    qint64 textSizes[2] = {};
+    for (int t = 0; t < numTexts; ++t)
+    {
+        if ((count + 1) * 4 > remaining)
+            return false;
+        textOffsets[t] = p;
+        textSizes[t] = get32(p + count * 4);
+        if (!take((count + 1) * 4 + textSizes[t]))
+            return false;
+        textBytes[t] = textOffsets[t] + (count + 1) * 4;
+    }
+    AnalyzeLoader::Line line;
+    line.type = type;
+    for (qint64 i = 0; i < count; ++i)
+    {
+        line.time = timeColumn.at(i);
+        if (line.time < start || line.time > end)
+            continue;
+        for (int v = 0; v < numValues; ++v)
+            line.values[v] = valueColumns[v].at(i);
+        for (int t = 0; t < numTexts; ++t)
+        {
+            const quint32 from = get32(textOffsets[t] + i * 4);
+            const quint32 to = get32(textOffsets[t] + i * 4 + 4);
+            if (from > to || to > textSizes[t])
+                return false;
+            line.text[t] = QString::fromUtf8(reinterpret_cast<const char *>(textBytes[t]) + from, to - from);
+        }
+        lines->append(line);
+        sequences->append(header.firstSequence + get32(sequenceColumn + i * 4));
+    }
+    return true;
+}
+
+// Formats a line as Analyze writes it in .analyze files.
+QString toCsvLine(const AnalyzeLoader::Line &line)
+{
+    QStringList fields;
+    fields << AnalyzeLoader::messageName(line.type);
+    if (line.type != AnalyzeLoader::ANALYZE_START_TIME)
+        fields << QString::number(line.time, 'f', 3);
+
+    const auto number = [](double value)
+    {
+        return QString::number(value, 'g', QLocale::FloatingPointShortest);
+    };
+    switch (line.type)
+    {
+        case AnalyzeLoader::CAPTURE_STARTING:
+            fields << number(line.values[0]) << line.text[0];
+            break;
+        case AnalyzeLoader::AUTOFOCUS_STARTING:
+            fields << line.text[0] << number(line.values[0]);
+            break;
+        case AnalyzeLoader::CAPTURE_COMPLETE:
+            fields << number(line.values[0]) << line.text[0] << number(line.values[1]) << line.text[1]
+                   << number(line.values[2]) << number(line.values[3]) << number(line.values[4]);
+            break;
+        default:
+            for (int v = 0; v < AnalyzeLoader::valueCount(line.type); ++v)
+                fields << number(line.values[v]);
+            for (int t = 0; t < AnalyzeLoader::textCount(line.type); ++t)
+                fields << line.text[t];
+            break;
+    }
+    return fields.join(QLatin1Char(','));
+}
+}
+
+namespace Ekos
+{
+
+AnalyzeBinaryWriter::AnalyzeBinaryWriter()
+{
+}
+
+AnalyzeBinaryWriter::~AnalyzeBinaryWriter()
+{
+    close();
+}
+
+bool AnalyzeBinaryWriter::open(const QString &filename)
+{
+    close();
+    blocks.clear();
+    nextSequence = 0;
+    flushTime = 0;
+
+    file.setFileName(filename);
+    if (!file.open(QIODevice::ReadWrite))
+    {
+        qCWarning(KSTARS_EKOS_ANALYZE) << "Could not open" << filename << file.errorString();
+        return false;
+    }
+
+    if (file.size() == 0)
+    {
+        QByteArray header(kFileMagic, 8);
+        put32(&header, kVersion);
+        put32(&header, 0);
+        return file.write(header) == header.size();
+    }
+
+    // Append to an existing log, dropping its index or an incomplete last block.
+    const qint64 size = file.size();
+    const uchar *data = file.map(0, size);
+    if (data == nullptr || !validFileHeader(data, size))
+    {
+        qCWarning(KSTARS_EKOS_ANALYZE) << filename << "is not a binary Analyze log";
+        if (data != nullptr)
+            file.unmap(const_cast<uchar *>(data));
+        file.close();
+        return false;
+    }
+
+    QVector<Entry> entries;
+    qint64 end = 0;
+    if (!readIndex(data, size, &entries, &end))
+        end = scanBlocks(data, size, &entries);
+    for (const auto &entry : entries)
+    {
+        BlockHeader header;
+        if (!decodeHeader(data, size, entry.offset, &header))
+            continue;
+        blocks.append({entry.offset, header.type, header.count, header.minTime, header.maxTime});
+        nextSequence = std::max(nextSequence, header.lastSequence + 1);
+        flushTime = std::max(flushTime, header.maxTime);
+    }
+    file.unmap(const_cast<uchar *>(data));
+
+    return file.resize(end) && file.seek(end);
+}
+
+void AnalyzeBinaryWriter::append(const AnalyzeLoader::Line &line)
+{
+    if (!file.isOpen())
+        return;
+
+    Columns &columns = pending[line.type];
+    columns.sequences.append(nextSequence++);
+    columns.times.append(line.time);
+    for (int v = 0; v < AnalyzeLoader::valueCount(line.type); ++v)
+        columns.values[v].append(line.values[v]);
+    for (int t = 0; t < AnalyzeLoader::textCount(line.type); ++t)
+        columns.texts[t].append(line.text[t].toUtf8());
+
+    if (columns.times.size() >= kBlockLines)
+        writeBlock(line.type);
+    if (line.time - flushTime >= kFlushInterval)
+    {
+        flush();
+        flushTime = line.time;
+    }
+}
+
+bool AnalyzeBinaryWriter::flush()
+{
+    bool ok = true;
+    for (int type = 0; type < AnalyzeLoader::TYPE_COUNT; ++type)
+    {
+        if (!pending[type].times.isEmpty())
+            ok = writeBlock(static_cast<AnalyzeLoader::Type>(type)) && ok;
+    }
+    ok = file.flush() && ok;
+    return ok;
+}
+
+bool AnalyzeBinaryWriter::close()
+{
+    if (!file.isOpen())
+        return true;
+
+    bool ok = flush();
+
+    QByteArray index;
+    put32(&index, kIndexMagic);
+    put32(&index, blocks.size());
+    for (const auto &block : blocks)
+    {
+        put64(&index, static_cast<quint64>(block.offset));
+        put32(&index, block.type);
+        put32(&index, block.count);
+        putDouble(&index, block.minTime);
+        putDouble(&index, block.maxTime);
+    }
+    put64(&index, static_cast<quint64>(file.pos()));
+    index.append(kTrailerMagic, 8);
+    ok = file.write(index) == index.size() && ok;
+
+    file.close();
+    return ok;
+}
+
+bool AnalyzeBinaryWriter::writeBlock(AnalyzeLoader::Type type)
+{
+    Columns &columns = pending[type];
+    const int count = columns.times.size();
+
+    BlockHeader header;
+    header.type = type;
+    header.count = count;
+    header.firstSequence = columns.sequences.first();
+    header.lastSequence = columns.sequences.last();
+    const auto range = std::minmax_element(columns.times.cbegin(), columns.times.cend());
+    header.minTime = *range.first;
+    header.maxTime = *range.second;
+
+    QByteArray payload;
+    for (quint64 sequence : columns.sequences)
+        put32(&payload, static_cast<quint32>(sequence - header.firstSequence));
+    pad8(&payload);
+    putNumbers(&payload, columns.times);
+    for (int v = 0; v < AnalyzeLoader::valueCount(type); ++v)
+        putNumbers(&payload, columns.values[v]);
+    for (int t = 0; t < AnalyzeLoader::textCount(type); ++t)
+    {
+        quint32 offset = 0;
+        put32(&payload, offset);
+        for (const QByteArray &text : columns.texts[t])
+        {
+            offset += text.size();
+            put32(&payload, offset);
+        }
+        for (const QByteArray &text : columns.texts[t])
+            payload.append(text);
+        pad8(&payload);
+    }
+    header.payloadSize = payload.size();
+
+    const qint64 offset = file.pos();
+    const bool ok = file.write(encodeHeader(header)) == kBlockHeaderSize && file.write(payload) == payload.size();
+    if (ok)
+        blocks.append({offset, header.type, header.count, header.minTime, header.maxTime});
+    else
+        qCWarning(KSTARS_EKOS_ANALYZE) << "Failed writing" << file.fileName() << file.errorString();
+
+    columns = Columns();
+    return ok;
+}
+
+bool AnalyzeBinaryWriter::fromCsv(const QString &csvFilename, const QString &binaryFilename)
+{
+    QFile input(csvFilename);
+    if (!input.open(QIODevice::ReadOnly))
+    {
+        qCWarning(KSTARS_EKOS_ANALYZE) << "Could not open" << csvFilename << input.errorString();
+        return false;
+    }
+    QFile::remove(binaryFilename);
+    AnalyzeBinaryWriter writer;
+    if (!writer.open(binaryFilename))
+        return false;
+
+    AnalyzeLoader::readLines(&input, kBlockLines, [&writer](QVector<AnalyzeLoader::Line> &&lines, int)
+    {
+        for (const auto &line : lines)
+            writer.append(line);
+        return true;
+    });
+    return writer.close();
+}
+
+AnalyzeBinaryReader::AnalyzeBinaryReader()
+{
+}
+
+AnalyzeBinaryReader::~AnalyzeBinaryReader()
+{
+    close();
+}
+
+bool AnalyzeBinaryReader::open(const QString &filename, qint64 length)
+{
+    close();
+    file.setFileName(filename);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qCWarning(KSTARS_EKOS_ANALYZE) << "Could not open" << filename << file.errorString();
+        return false;
+    }
+
+    size = length >= 0 ? std::min(length, file.size()) : file.size();
+    data = size > 0 ? file.map(0, size) : nullptr;
+    if (data == nullptr || !validFileHeader(data, size))
+    {
+        qCWarning(KSTARS_EKOS_ANALYZE) << filename << "is not a binary Analyze log";
+        close();
+        return false;
+    }
+
+    QVector<Entry> entries;
+    qint64 indexOffset;
+    if (!readIndex(data, size, &entries, &indexOffset))
+        scanBlocks(data, size, &entries);
+    for (const auto &entry : entries)
+        index.append({entry.offset, static_cast<AnalyzeLoader::Type>(entry.header.type),
+                      static_cast<int>(entry.header.count), entry.header.minTime, entry.header.maxTime});
+    return true;
+}
+
+void AnalyzeBinaryReader::close()
+{
+    if (data != nullptr)
+        file.unmap(const_cast<uchar *>(data));
+    data = nullptr;
+    size = 0;
+    index.clear();
+    file.close();
+}
+
+double AnalyzeBinaryReader::lastTime() const
+{
+    double last = 0;
+    for (const auto &block : index)
+        last = std::max(last, block.maxTime);
+    return last;
+}
+
+QVector<AnalyzeLoader::Line> AnalyzeBinaryReader::read(double start, double end) const
+{
+    QVector<AnalyzeLoader::Line> lines;
+    QVector<quint64> sequences;
+    lastBlocksRead = 0;
+    for (const auto &block : index)
+    {
+        if (block.maxTime < start || block.minTime > end)
+            continue;
+        lastBlocksRead++;
+        if (!decodeBlock(data, size, block.offset, start, end, &lines, &sequences))
+            qCWarning(KSTARS_EKOS_ANALYZE) << "Corrupt block at" << block.offset << "in" << file.fileName();
+    }
+
+    return takeInOrder(&lines, &sequences, std::numeric_limits<quint64>::max());
+}
+
+bool AnalyzeBinaryReader::read(int chunkLines,
+                               const std::function<bool(QVector<AnalyzeLoader::Line> &&, int)> &publish) const
+{
+    // Blocks of the types are interleaved in the file, a decoded line is in its final place once no
+    // later block starts before it.
+    QVector<quint64> laterFirst(index.size() + 1);
+    laterFirst[index.size()] = std::numeric_limits<quint64>::max();
+    for (int i = index.size() - 1; i >= 0; --i)
+    {
+        BlockHeader header;
+        laterFirst[i] = laterFirst[i + 1];
+        if (decodeHeader(data, size, index[i].offset, &header))
+            laterFirst[i] = std::min(laterFirst[i], header.firstSequence);
+    }
+
+    QVector<AnalyzeLoader::Line> lines;
+    QVector<quint64> sequences;
+    lastBlocksRead = 0;
+    for (int i = 0; i < index.size(); ++i)
+    {
+        lastBlocksRead++;
+        if (!decodeBlock(data, size, index[i].offset, -std::numeric_limits<double>::infinity(),
+                         std::numeric_limits<double>::infinity(), &lines, &sequences))
+            qCWarning(KSTARS_EKOS_ANALYZE) << "Corrupt block at" << index[i].offset << "in" << file.fileName();
+        if (lines.size() < chunkLines && i + 1 < index.size())
+            continue;
+
+        QVector<AnalyzeLoader::Line> chunk = takeInOrder(&lines, &sequences, laterFirst[i + 1]);
+        if (!chunk.isEmpty() && !publish(std::move(chunk), 100 * (i + 1) / index.size()))
+            return false;
+    }
+    return true;
+}
+
+bool AnalyzeBinaryReader::isBinaryLog(const QString &filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray header = file.read(kFileHeaderSize);
+    return validFileHeader(reinterpret_cast<const uchar *>(header.constData()), header.size());
+}
+
+bool AnalyzeBinaryReader::toCsv(const QString &binaryFilename, const QString &csvFilename)
+{
+    AnalyzeBinaryReader reader;
+    if (!reader.open(binaryFilename))
+        return false;
+
+    QFile output(csvFilename);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        qCWarning(KSTARS_EKOS_ANALYZE) << "Could not open" << csvFilename << output.errorString();
+        return false;
+    }
+    QTextStream out(&output);
+    out << "#Converted from the binary Analyze log " << QFileInfo(binaryFilename).fileName() << ".\n\n";
+    reader.read(kBlockLines, [&out](QVector<AnalyzeLoader::Line> &&lines, int)
+    {
+        for (const auto &line : lines)
+            out << toCsvLine(line) << "\n";
+        return true;
+    });
+    out.flush();
+    return out.status() == QTextStream::Ok;
+}
+
+}
@@ -0,0 +1,145 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "analyzeloader.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QVector>
+
+#include <functional>
+#include <limits>
+
+namespace Ekos
+{
+
+/**
+ * @short Binary session logs of Analyze.
+ *
+ * A binary log holds the same messages as a .analyze text file, stored by columns. The file starts
+ * with a 16 byte header, followed by blocks appended as the session goes. Each block holds lines of
+ * one message type: a 48 byte header giving the type, the number of lines, the range of their times
+ * and the sequence numbers of its first and last line, then one column for the sequence numbers,
+ * one for the times, one per value and one per text field of the type. Sequence numbers keep the
+ * order of the lines of all types. A column of numbers is stored as 32 bit integers, or thousandths,
+ * when that is exact for all its numbers, which is the case for most of what Analyze logs, else as
+ * doubles.
+ *
+ * Closing the log appends an index of the blocks and a trailer pointing to it. A reader finds the
+ * blocks of a time window from the index, and only the pages of those blocks are read from the
+ * mapped file. A log that was not closed, e.g. the log being written, is read by walking the block
+ * headers, ignoring an incomplete last block. Reopening a log for writing removes its index, which
+ * is written again on close.
+ *
+ * All numbers are little-endian.
+ */
+class AnalyzeBinaryWriter
+{
+    public:
+        AnalyzeBinaryWriter();
+        // Closes the log.
+        ~AnalyzeBinaryWriter();
+
+        // Creates filename, or opens it to append lines if it is a binary log.
+        bool open(const QString &filename);
+        bool isOpen() const
+        {
+            return file.isOpen();
+        }
+        void append(const AnalyzeLoader::Line &line);
+        // Writes the lines appended so far.
+        bool flush();
+        // Flushes, then writes the index.
+        bool close();
+
+        // Imports a .analyze text file.
+        static bool fromCsv(const QString &csvFilename, const QString &binaryFilename);
+
+    private:
+        struct Columns
+        {
+            QVector<quint64> sequences;
+            QVector<double> times;
+            QVector<double> values[7];
+            QVector<QByteArray> texts[2];
+        };
+        struct Block
+        {
+            qint64 offset;
+            quint32 type;
+            quint32 count;
+            double minTime;
+            double maxTime;
+        };
+
+        bool writeBlock(AnalyzeLoader::Type type);
+
+        QFile file;
+        Columns pending[AnalyzeLoader::TYPE_COUNT];
+        QVector<Block> blocks;
+        quint64 nextSequence { 0 };
+        // Time of the last line when everything was flushed.
+        double flushTime { 0 };
+};
+
+class AnalyzeBinaryReader
+{
+    public:
+        // A block of lines of one type, in the file.
+        struct Block
+        {
+            qint64 offset;
+            AnalyzeLoader::Type type;
+            int count;
+            double minTime;
+            double maxTime;
+        };
+
+        AnalyzeBinaryReader();
+        ~AnalyzeBinaryReader();
+
+        // Maps the log, or only its first length bytes if length is not negative, e.g. the log being
+        // written as it was when a reload started. Blocks appended past length are not read.
+        bool open(const QString &filename, qint64 length = -1);
+        void close();
+
+        const QVector<Block> &blocks() const
+        {
+            return index;
+        }
+        // Largest time of the log.
+        double lastTime() const;
+
+        // Lines with start <= time <= end, in the order they were written. Only the blocks holding
+        // such lines are read.
+        QVector<AnalyzeLoader::Line> read(double start = -std::numeric_limits<double>::infinity(),
+                                          double end = std::numeric_limits<double>::infinity()) const;
+        // All the lines, in the order they were written, handed to publish in chunks of about chunkLines
+        // lines as the blocks are decoded, with the percentage of the blocks decoded so far. Stops and
+        // returns false as soon as publish returns false.
+        bool read(int chunkLines, const std::function<bool(QVector<AnalyzeLoader::Line> &&, int)> &publish) const;
+        // Number of blocks read by the last read().
+        int blocksRead() const
+        {
+            return lastBlocksRead;
+        }
+
+        // True if filename starts as a binary log.
+        static bool isBinaryLog(const QString &filename);
+        // Exports to a .analyze text file.
+        static bool toCsv(const QString &binaryFilename, const QString &csvFilename);
+
+    private:
+        QFile file;
+        const uchar *data { nullptr };
+        qint64 size { 0 };
+        QVector<Block> index;
+        mutable int lastBlocksRead { 0 };
+};
+
+}
@@ -0,0 +1,516 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "analyzeloader.h"
+
+#include "analyzebinarylog.h"
+
+#include <QFile>
+#include <QtConcurrent>
+
+#include <ekos_analyze_debug.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+// Bytes read from the file at a time.
+constexpr qint64 kBlockSize = 1 << 20;
+// Lines delivered to the GUI thread at a time.
+constexpr int kChunkLines = 10000;
+// Chunks the worker may read ahead of the GUI thread.
+constexpr int kChunksAhead = 4;
+// No message has more fields than this.
+constexpr int kMaxFields = 9;
+
+// Names and layouts of the messages, in the order of AnalyzeLoader::Type.
+struct Layout
+{
+    const char *name;
+    int values;
+    int texts;
+};
+constexpr Layout kLayouts[] =
+{
+    { "AnalyzeStartTime", 0, 2 },
+    { "CaptureStarting", 1, 1 },
+    { "CaptureComplete", 5, 2 },
+    { "CaptureAborted", 1, 0 },
+    { "AutofocusStarting", 1, 1 },
+    { "AutofocusComplete", 0, 2 },
+    { "AutofocusAborted", 0, 2 },
+    { "GuideState", 0, 1 },
+    { "GuideStats", 7, 0 },
+    { "Temperature", 1, 0 },
+    { "TargetDistance", 1, 0 },
+    { "MountState", 0, 1 },
+    { "MountCoords", 6, 0 },
+    { "AlignState", 0, 1 },
+    { "MeridianFlipState", 0, 1 },
+    { "SchedulerJobStart", 0, 1 },
+    { "SchedulerJobEnd", 0, 2 }
+};
+static_assert(sizeof(kLayouts) / sizeof(kLayouts[0]) == Ekos::AnalyzeLoader::TYPE_COUNT, "One layout per message type");
+
+// Powers of ten exactly representable as doubles.
+constexpr double kPowersOfTen[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+struct Field
+{
+    const char *begin;
+    const char *end;
+
+    int size() const
+    {
+        return static_cast<int>(end - begin);
+    }
+    bool is(const char *name) const
+    {
+        const int length = static_cast<int>(strlen(name));
+        return size() == length && memcmp(begin, name, length) == 0;
+    }
+    QString toString() const
+    {
+        return QString::fromUtf8(begin, size());
+    }
+};
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+void trim(const char *&begin, const char *&end)
+{
+    while (begin < end && isSpace(*begin))
+        ++begin;
+    while (end > begin && isSpace(end[-1]))
+        --end;
+}
+
+// Same results as QString::toDouble(). Decimal numbers of up to 15 significant digits, which is
+// what Analyze writes, are converted with a single correctly rounded operation. Anything else
+// goes through QByteArray::toDouble().
+bool toDouble(const Field &field, double *value)
+{
+    const char *begin = field.begin, *end = field.end;
+    trim(begin, end);
+
+    const char *p = begin;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+
+    quint64 mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool hasDigits = false;
+    for (; p < end && isDigit(*p); ++p)
+    {
+        hasDigits = true;
+        mantissa = mantissa * 10 + (*p - '0');
+        digits += mantissa > 0;
+        if (digits > 15)
+            break;
+    }
+    if (p < end && *p == '.' && digits <= 15)
+    {
+        for (++p; p < end && isDigit(*p); ++p)
+        {
+            hasDigits = true;
+            mantissa = mantissa * 10 + (*p - '0');
+            digits += mantissa > 0;
+            exponent--;
+            if (digits > 15)
+                break;
+        }
+    }
+    if (hasDigits && digits <= 15 && p < end && (*p == 'e' || *p == 'E'))
+    {
+        ++p;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            negativeExponent = *p++ == '-';
+        int e = 0, exponentDigits = 0;
+        for (; p < end && isDigit(*p) && exponentDigits < 4; ++p, ++exponentDigits)
+            e = e * 10 + (*p - '0');
+        if (exponentDigits == 0)
+            hasDigits = false;
+        exponent += negativeExponent ? -e : e;
+    }
+
+    if (hasDigits && digits <= 15 && p == end && exponent >= -22 && exponent <= 22)
+    {
+        double result = static_cast<double>(mantissa);
+        result = exponent < 0 ? result / kPowersOfTen[-exponent] : result * kPowersOfTen[exponent];
+        *value = negative ? -result : result;
+        return true;
+    }
+
+    bool ok = false;
+    *value = QByteArray(begin, static_cast<int>(end - begin)).toDouble(&ok);
+    return ok;
+}
+
+// Same results as QString::toInt().
+bool toInt(const Field &field, double *value)
+{
+    const char *begin = field.begin, *end = field.end;
+    trim(begin, end);
+
+    const char *p = begin;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+    if (p < end && end - p <= 9)
+    {
+        int result = 0;
+        for (; p < end && isDigit(*p); ++p)
+            result = result * 10 + (*p - '0');
+        if (p == end)
+        {
+            *value = negative ? -result : result;
+            return true;
+        }
+    }
+
+    bool ok = false;
+    *value = QByteArray(begin, static_cast<int>(end - begin)).toInt(&ok);
+    return ok;
+}
+
+// Parses consecutive fields into values, each as a double or an int as given by the letters of types.
+bool toNumbers(const Field *fields, const char *types, double *values)
+{
+    for (int i = 0; types[i] != 0; ++i)
+    {
+        const bool ok = types[i] == 'i' ? toInt(fields[i], &values[i]) : toDouble(fields[i], &values[i]);
+        if (!ok)
+            return false;
+    }
+    return true;
+}
+}
+
+namespace Ekos
+{
+
+AnalyzeLoader::AnalyzeLoader(QObject *parent) : QObject(parent), freeChunks(kChunksAhead)
+{
+    qRegisterMetaType<QVector<Ekos::AnalyzeLoader::Line>>("QVector<Ekos::AnalyzeLoader::Line>");
+    // The worker emits these, they are queued to the thread of the loader.
+    connect(this, &AnalyzeLoader::chunkRead, this, &AnalyzeLoader::deliverChunk, Qt::QueuedConnection);
+    connect(this, &AnalyzeLoader::readDone, this, &AnalyzeLoader::deliverDone, Qt::QueuedConnection);
+}
+
+AnalyzeLoader::~AnalyzeLoader()
+{
+    cancel();
+}
+
+const char *AnalyzeLoader::messageName(Type type)
+{
+    return kLayouts[type].name;
+}
+
+int AnalyzeLoader::valueCount(Type type)
+{
+    return kLayouts[type].values;
+}
+
+int AnalyzeLoader::textCount(Type type)
+{
+    return kLayouts[type].texts;
+}
+
+void AnalyzeLoader::load(const QString &filename, qint64 length)
+{
+    cancel();
+    canceled = 0;
+    loading = true;
+    future = QtConcurrent::run(this, &AnalyzeLoader::read, filename, length, generation);
+}
+
+void AnalyzeLoader::cancel()
+{
+    generation++;
+    canceled = 1;
+    future.waitForFinished();
+    loading = false;
+}
+
+void AnalyzeLoader::read(const QString &filename, qint64 length, int generation)
+{
+    const auto publish = [this, generation](QVector<Line> &&lines, int percent)
+    {
+        // Wait until the GUI thread caught up, unless canceled.
+        while (!freeChunks.tryAcquire(1, 100))
+        {
+            if (canceled)
+                return false;
+        }
+        if (canceled)
+        {
+            freeChunks.release();
+            return false;
+        }
+        emit chunkRead(generation, lines, percent);
+        return true;
+    };
+
+    if (AnalyzeBinaryReader::isBinaryLog(filename))
+    {
+        AnalyzeBinaryReader reader;
+        if (!reader.open(filename, length))
+        {
+            emit readDone(generation, false);
+            return;
+        }
+        // Chunks are published as the blocks are decoded.
+        if (reader.read(kChunkLines, publish))
+            emit readDone(generation, true);
+        return;
+    }
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qCWarning(KSTARS_EKOS_ANALYZE) << "Could not open" << filename << file.errorString();
+        emit readDone(generation, false);
+        return;
+    }
+
+    if (readLines(&file, kChunkLines, publish, length))
+        emit readDone(generation, true);
+}
+
+void AnalyzeLoader::deliverChunk(int generation, const QVector<Line> &lines, int percent)
+{
+    if (generation == this->generation)
+        emit linesRead(lines, percent);
+    freeChunks.release();
+}
+
+void AnalyzeLoader::deliverDone(int generation, bool ok)
+{
+    if (generation != this->generation)
+        return;
+    loading = false;
+    emit finished(ok);
+}
+
+bool AnalyzeLoader::readLines(QIODevice *device, int chunkLines,
+                              const std::function<bool(QVector<Line> &&, int)> &publish, qint64 length)
+{
+    const qint64 size = length >= 0 ? std::min(length, device->size()) : device->size();
+    QVector<Line> lines;
+    lines.reserve(chunkLines);
+    Line line;
+
+    // Bytes of an incomplete line at the end of the previous block.
+    QByteArray pending;
+    bool atEnd = false;
+    while (!atEnd)
+    {
+        // Lines appended past length, while the device is read, are left out.
+        QByteArray block = device->read(length >= 0 ? std::min<qint64>(kBlockSize, size - device->pos()) : kBlockSize);
+        atEnd = block.isEmpty();
+        if (!pending.isEmpty())
+        {
+            pending.append(block);
+            block = pending;
+            pending.clear();
+        }
+
+        const char *p = block.constData();
+        const char *end = p + block.size();
+        while (p < end)
+        {
+            const char *newline = static_cast<const char *>(memchr(p, '\n', end - p));
+            if (newline == nullptr && !atEnd)
+            {
+                pending = QByteArray(p, static_cast<int>(end - p));
+                break;
+            }
+            const char *lineEnd = newline != nullptr ? newline : end;
+            if (parseLine(p, lineEnd, &line))
+                lines.append(line);
+            p = newline != nullptr ? newline + 1 : end;
+
+            if (lines.size() >= chunkLines)
+            {
+                const int percent = size > 0 ? static_cast<int>(100 * (device->pos() - (end - p)) / size) : 0;
+                if (!publish(std::move(lines), percent))
+                    return false;
+                lines = QVector<Line>();
+                lines.reserve(chunkLines);
+            }
+        }
+    }
+
+    if (!lines.isEmpty() && !publish(std::move(lines), 100))
+        return false;
+    return true;
+}
+
+bool AnalyzeLoader::parseLine(const char *begin, const char *end, Line *line)
+{
+    // Split the line into comma-separated fields, as QString::split would.
+    Field fields[kMaxFields];
+    int count = 0;
+    for (const char *p = begin; ; ++p)
+    {
+        if (p == end || *p == ',')
+        {
+            if (count == kMaxFields)
+                return false;
+            fields[count++] = {begin, p};
+            if (p == end)
+                break;
+            begin = p + 1;
+        }
+    }
+    // The last field may hold the \r of a line written on Windows.
+    if (fields[count - 1].end > fields[count - 1].begin && fields[count - 1].end[-1] == '\r')
+        fields[count - 1].end--;
+
+    // We need at least a command and a timestamp.
+    if (count < 2)
+        return false;
+    // Comment character # must be at start of line.
+    if (fields[0].size() > 0 && *fields[0].begin == '#')
+        return false;
+
+    line->text[0].clear();
+    line->text[1].clear();
+    const Field &name = fields[0];
+
+    if (name.is("AnalyzeStartTime") && count == 3)
+    {
+        line->type = ANALYZE_START_TIME;
+        line->time = 0;
+        line->text[0] = fields[1].toString();
+        line->text[1] = fields[2].toString();
+        return true;
+    }
+
+    // Except for comments and the above AnalyzeStartTime, the second item
+    // in the csv line is a double which represents seconds since start of the log.
+    if (!toDouble(fields[1], &line->time))
+        return false;
+    if (line->time < 0 || line->time > 3600 * 24 * 10)
+        return false;
+
+    double *values = line->values;
+    if (name.is("CaptureStarting") && count == 4)
+    {
+        line->type = CAPTURE_STARTING;
+        line->text[0] = fields[3].toString();
+        return toNumbers(&fields[2], "d", values);
+    }
+    else if (name.is("CaptureComplete") && count >= 6 && count <= 9)
+    {
+        line->type = CAPTURE_COMPLETE;
+        values[2] = values[3] = values[4] = 0;
+        if (!toNumbers(&fields[2], "d", &values[0]) || !toNumbers(&fields[4], "d", &values[1]))
+            return false;
+        // Stars, median and eccentricity were added in later versions.
+        const char *types[] = { "", "i", "ii", "iid" };
+        if (!toNumbers(&fields[6], types[count - 6], &values[2]))
+            return false;
+        line->text[0] = fields[3].toString();
+        line->text[1] = fields[5].toString();
+        return true;
+    }
+    else if (name.is("CaptureAborted") && count == 3)
+    {
+        line->type = CAPTURE_ABORTED;
+        return toNumbers(&fields[2], "d", values);
+    }
+    else if (name.is("AutofocusStarting") && count == 4)
+    {
+        line->type = AUTOFOCUS_STARTING;
+        line->text[0] = fields[2].toString();
+        return toNumbers(&fields[3], "d", values);
+    }
+    else if ((name.is("AutofocusComplete") || name.is("AutofocusAborted")) && count == 4)
+    {
+        line->type = name.is("AutofocusComplete") ? AUTOFOCUS_COMPLETE : AUTOFOCUS_ABORTED;
+        line->text[0] = fields[2].toString();
+        line->text[1] = fields[3].toString();
+        return true;
+    }
+    else if (name.is("GuideState") && count == 3)
+    {
+        line->type = GUIDE_STATE;
+        line->text[0] = fields[2].toString();
+        return true;
+    }
+    else if (name.is("GuideStats") && count == 9)
+    {
+        line->type = GUIDE_STATS;
+        return toNumbers(&fields[2], "ddiiddi", values);
+    }
+    else if (name.is("Temperature") && count == 3)
+    {
+        line->type = TEMPERATURE;
+        return toNumbers(&fields[2], "d", values);
+    }
+    else if (name.is("TargetDistance") && count == 3)
+    {
+        line->type = TARGET_DISTANCE;
+        return toNumbers(&fields[2], "d", values);
+    }
+    else if (name.is("MountState") && count == 3)
+    {
+        line->type = MOUNT_STATE;
+        line->text[0] = fields[2].toString();
+        return true;
+    }
+    else if (name.is("MountCoords") && (count == 7 || count == 8))
+    {
+        line->type = MOUNT_COORDS;
+        values[5] = 0;
+        return toNumbers(&fields[2], count == 8 ? "ddddid" : "ddddi", values);
+    }
+    else if (name.is("AlignState") && count == 3)
+    {
+        line->type = ALIGN_STATE;
+        line->text[0] = fields[2].toString();
+        return true;
+    }
+    else if (name.is("MeridianFlipState") && count == 3)
+    {
+        line->type = MERIDIAN_FLIP_STATE;
+        line->text[0] = fields[2].toString();
+        return true;
+    }
+    else if (name.is("SchedulerJobStart") && count == 3)
+    {
+        line->type = SCHEDULER_JOB_START;
+        line->text[0] = fields[2].toString();
+        return true;
+    }
+    else if (name.is("SchedulerJobEnd") && count == 4)
+    {
+        line->type = SCHEDULER_JOB_END;
+        line->text[0] = fields[2].toString();
+        line->text[1] = fields[3].toString();
+        return true;
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,131 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QAtomicInt>
+#include <QFuture>
+#include <QMetaType>
+#include <QObject>
+#include <QSemaphore>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+class QIODevice;
+
+namespace Ekos
+{
+
+/**
+ * @class AnalyzeLoader
+ * @short Reads .analyze logs on a worker thread.
+ *
+ * The file is read in large blocks and each line is split and converted in place, without building
+ * a QString per field. Only the text fields, such as filters and file names, become QStrings.
+ * Lines are delivered to the GUI thread in chunks through linesRead(), at most a few chunks ahead
+ * of the receiver, so that the plots fill while the rest of the file is read.
+ *
+ * Binary logs, see AnalyzeBinaryWriter, are read as well.
+ */
+class AnalyzeLoader : public QObject
+{
+        Q_OBJECT
+
+    public:
+        // The message types of a .analyze file, with the layout of their fields in Line.
+        enum Type
+        {
+            ANALYZE_START_TIME,   // text: start time, time zone
+            CAPTURE_STARTING,     // values: exposure. text: filter
+            CAPTURE_COMPLETE,     // values: exposure, hfr, stars, median, eccentricity. text: filter, filename
+            CAPTURE_ABORTED,      // values: exposure
+            AUTOFOCUS_STARTING,   // values: temperature. text: filter
+            AUTOFOCUS_COMPLETE,   // text: filter, points
+            AUTOFOCUS_ABORTED,    // text: filter, points
+            GUIDE_STATE,          // text: state
+            GUIDE_STATS,          // values: ra, dec, ra pulse, dec pulse, snr, sky background, stars
+            TEMPERATURE,          // values: temperature
+            TARGET_DISTANCE,      // values: distance
+            MOUNT_STATE,          // text: state
+            MOUNT_COORDS,         // values: ra, dec, az, alt, pier side, ha
+            ALIGN_STATE,          // text: state
+            MERIDIAN_FLIP_STATE,  // text: state
+            SCHEDULER_JOB_START,  // text: job name
+            SCHEDULER_JOB_END     // text: job name, reason
+        };
+
+        static constexpr int TYPE_COUNT = SCHEDULER_JOB_END + 1;
+
+        // Name of the message in .analyze files.
+        static const char *messageName(Type type);
+        // Numbers of values and text fields of a Line of that type.
+        static int valueCount(Type type);
+        static int textCount(Type type);
+
+        // One valid line of a .analyze file.
+        struct Line
+        {
+            Type type { ANALYZE_START_TIME };
+            // Seconds since the start of the log, 0 for ANALYZE_START_TIME.
+            double time { 0 };
+            double values[7] { 0, 0, 0, 0, 0, 0, 0 };
+            QString text[2];
+        };
+
+        explicit AnalyzeLoader(QObject *parent = nullptr);
+        // Cancels the current read.
+        ~AnalyzeLoader() override;
+
+        // Starts reading filename, canceling the previous read. If length is not negative, only the
+        // first length bytes are read: the log as it was when the load started, even if it is appended
+        // to while it is read.
+        void load(const QString &filename, qint64 length = -1);
+        // Stops the current read. No signal of that read is emitted after this returns.
+        void cancel();
+        bool isLoading() const
+        {
+            return loading;
+        }
+
+        // Parses one line, without its end of line. Returns false for comments, unknown
+        // messages and malformed lines, which are skipped.
+        static bool parseLine(const char *begin, const char *end, Line *line);
+
+        // Reads all lines of device, or of its first length bytes if length is not negative, calling
+        // publish with chunks of at most chunkLines lines and the percentage of the device read so far.
+        // Stops early if publish returns false. Returns false if the read was stopped.
+        static bool readLines(QIODevice *device, int chunkLines,
+                              const std::function<bool(QVector<Line> &&lines, int percent)> &publish,
+                              qint64 length = -1);
+
+    signals:
+        void linesRead(const QVector<Ekos::AnalyzeLoader::Line> &lines, int percent);
+        // Emitted once the whole file was delivered. Ok is false if the file could not be opened.
+        void finished(bool ok);
+
+        // Used by the worker to reach the GUI thread.
+        void chunkRead(int generation, const QVector<Ekos::AnalyzeLoader::Line> &lines, int percent);
+        void readDone(int generation, bool ok);
+
+    private:
+        void read(const QString &filename, qint64 length, int generation);
+        void deliverChunk(int generation, const QVector<Ekos::AnalyzeLoader::Line> &lines, int percent);
+        void deliverDone(int generation, bool ok);
+
+        QFuture<void> future;
+        // Incremented by each load and cancel, chunks of older reads are dropped.
+        int generation { 0 };
+        QAtomicInt canceled { 0 };
+        // Chunks the worker may send ahead of the GUI thread.
+        QSemaphore freeChunks;
+        bool loading { false };
+};
+
+}
+
+Q_DECLARE_METATYPE(Ekos::AnalyzeLoader::Line)
@@ -0,0 +1,97 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QList>
+#include <QVector>
+
+#include <algorithm>
+#include <limits>
+
+namespace Ekos
+{
+
+// Finds the sessions of a timeline line holding a given time.
+// T needs public start and end members, like Analyze::Session.
+//
+// Intervals are kept sorted by start, and viewed as a balanced binary tree whose root is the middle
+// of the array. Each node is augmented with the largest end of its subtree, so find() skips the
+// subtrees that end before the time and those that start after it. A find() costs O(log n + k)
+// for k results. The augmentation is rebuilt in O(n) by the first find() following an add().
+template <class T>
+class IntervalFinder
+{
+    public:
+        IntervalFinder() {}
+        ~IntervalFinder() {}
+        void add(const T &value)
+        {
+            // Sessions mostly arrive in order, and equal starts keep their order of arrival.
+            auto position = std::upper_bound(intervals.begin(), intervals.end(), value.start,
+                                             [](double start, const T & interval)
+            {
+                return start < interval.start;
+            });
+            intervals.insert(position, value);
+            dirty = true;
+        }
+        void clear()
+        {
+            intervals.clear();
+            maxEnd.clear();
+            dirty = false;
+        }
+        int size() const
+        {
+            return intervals.size();
+        }
+        // Returns the intervals with start <= t <= end, sorted by start.
+        QList<T> find(double t)
+        {
+            if (dirty)
+            {
+                maxEnd.resize(intervals.size());
+                build(0, intervals.size());
+                dirty = false;
+            }
+            QList<T> result;
+            find(0, intervals.size(), t, &result);
+            return result;
+        }
+    private:
+        // Computes maxEnd for the subtree of [lo, hi[, returns its largest end.
+        double build(int lo, int hi)
+        {
+            if (lo >= hi)
+                return -std::numeric_limits<double>::infinity();
+            const int mid = lo + (hi - lo) / 2;
+            const double end = std::max(intervals[mid].end, std::max(build(lo, mid), build(mid + 1, hi)));
+            maxEnd[mid] = end;
+            return end;
+        }
+        void find(int lo, int hi, double t, QList<T> *result) const
+        {
+            if (lo >= hi)
+                return;
+            const int mid = lo + (hi - lo) / 2;
+            if (maxEnd[mid] < t)
+                return;
+            find(lo, mid, t, result);
+            const T &interval = intervals[mid];
+            if (interval.start > t)
+                return;
+            if (t <= interval.end)
+                result->push_back(interval);
+            find(mid + 1, hi, t, result);
+        }
+
+        QVector<T> intervals;
+        QVector<double> maxEnd;
+        bool dirty { false };
+};
+
+}
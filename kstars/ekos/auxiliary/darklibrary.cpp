@@ -552,10 +552,17 @@ void DarkLibrary::processNewBLOB(IBLOB *bp)
     }
 
     uint32_t totalElements = m_CurrentDarkFrame->channels() * m_CurrentDarkFrame->samplesPerChannel();
-    if (totalElements != m_DarkMasterBuffer.size())
-        m_DarkMasterBuffer.assign(totalElements, 0);
+    // Frames of another size or type start a new master frame
+    if (totalElements != m_DarkStacker.samplesPerFrame() || m_CurrentDarkFrame->dataType() != m_DarkStacker.dataType())
+        m_DarkStacker.clear();
+
+    if (!m_DarkStacker.addFrame(m_CurrentDarkFrame->getImageBuffer(), totalElements, m_CurrentDarkFrame->dataType()))
+    {
+        qCWarning(KSTARS_EKOS) << "Failed to stack dark frame:" << m_DarkStacker.errorString();
+        m_FileLabel->setText(i18n("Failed to stack dark data: %1", m_DarkStacker.errorString()));
+        return;
+    }
 
-    aggregate(m_CurrentDarkFrame);
     darkProgress->setValue(darkProgress->value() + 1);
     m_StatusLabel->setText(i18n("Received %1/%2 images.", darkProgress->value(), darkProgress->maximum()));
 }
@@ -1177,7 +1184,7 @@ void DarkLibrary::generateDarkJobs()
 ///////////////////////////////////////////////////////////////////////////////////////
 void DarkLibrary::execute()
 {
-    m_DarkImagesCounter = 0;
+    m_DarkStacker.clear();
     darkProgress->setValue(0);
     darkProgress->setTextVisible(true);
     connect(m_CaptureModule, &Capture::newImage, this, &DarkLibrary::processNewImage, Qt::UniqueConnection);
@@ -1222,123 +1229,29 @@ void DarkLibrary::initView()
     });
 }
 
-///////////////////////////////////////////////////////////////////////////////////////
-///
-///////////////////////////////////////////////////////////////////////////////////////
-void DarkLibrary::aggregate(const QSharedPointer<FITSData> &data)
-{
-    switch (data->dataType())
-    {
-        case TBYTE:
-            aggregateInternal<uint8_t>(data);
-            break;
-
-        case TSHORT:
-            aggregateInternal<int16_t>(data);
-            break;
-
-        case TUSHORT:
-            aggregateInternal<uint16_t>(data);
-            break;
-
-        case TLONG:
-            aggregateInternal<int32_t>(data);
-            break;
-
-        case TULONG:
-            aggregateInternal<uint32_t>(data);
-            break;
-
-        case TFLOAT:
-            aggregateInternal<float>(data);
-            break;
-
-        case TLONGLONG:
-            aggregateInternal<int64_t>(data);
-            break;
-
-        case TDOUBLE:
-            aggregateInternal<double>(data);
-            break;
-
-        default:
-            break;
-    }
-}
-
-///////////////////////////////////////////////////////////////////////////////////////
-///
-///////////////////////////////////////////////////////////////////////////////////////
-template <typename T>
-void DarkLibrary::aggregateInternal(const QSharedPointer<FITSData> &data)
-{
-    T const *darkBuffer  = reinterpret_cast<T const*>(data->getImageBuffer());
-    for (uint32_t i = 0; i < m_DarkMasterBuffer.size(); i++)
-        m_DarkMasterBuffer[i] += darkBuffer[i];
-}
-
 ///////////////////////////////////////////////////////////////////////////////////////
 ///
 ///////////////////////////////////////////////////////////////////////////////////////
 void DarkLibrary::generateMasterFrame(const QSharedPointer<FITSData> &data, const QJsonObject &metadata)
 {
-    switch (data->dataType())
+    FrameStacker::Parameters parameters;
+    parameters.method = static_cast<FrameStacker::Method>(std::max(0, combinAlgorithmCombo->currentIndex()));
+    parameters.kappa = Options::darkStackingKappa();
+    parameters.memoryBudget = qint64(Options::darkStackingMemory()) * 1024 * 1024;
+
+    m_StatusLabel->setText(i18n("Stacking %1 images...", m_DarkStacker.frameCount()));
+    const bool stacked = m_DarkStacker.samplesPerFrame() == data->channels() * data->samplesPerChannel() &&
+                         m_DarkStacker.combine(data->getWritableImageBuffer(), parameters);
+    // Frames of the next master frame start from scratch
+    const QString error = m_DarkStacker.errorString();
+    m_DarkStacker.clear();
+    if (!stacked)
     {
-        case TBYTE:
-            generateMasterFrameInternal<uint8_t>(data, metadata);
-            break;
-
-        case TSHORT:
-            generateMasterFrameInternal<int16_t>(data, metadata);
-            break;
-
-        case TUSHORT:
-            generateMasterFrameInternal<uint16_t>(data, metadata);
-            break;
-
-        case TLONG:
-            generateMasterFrameInternal<int32_t>(data, metadata);
-            break;
-
-        case TULONG:
-            generateMasterFrameInternal<uint32_t>(data, metadata);
-            break;
-
-        case TFLOAT:
-            generateMasterFrameInternal<float>(data, metadata);
-            break;
-
-        case TLONGLONG:
-            generateMasterFrameInternal<int64_t>(data, metadata);
-            break;
-
-        case TDOUBLE:
-            generateMasterFrameInternal<double>(data, metadata);
-            break;
-
-        default:
-            break;
+        qCWarning(KSTARS_EKOS) << "Failed to stack dark frames:" << error;
+        m_FileLabel->setText(i18n("Failed to stack master frame: %1", error));
+        return;
     }
 
-    emit newImage(data);
-    // Reset Master Buffer
-    m_DarkMasterBuffer.assign(m_DarkMasterBuffer.size(), 0);
-
-}
-
-///////////////////////////////////////////////////////////////////////////////////////
-///
-///////////////////////////////////////////////////////////////////////////////////////
-template <typename T>  void DarkLibrary::generateMasterFrameInternal(const QSharedPointer<FITSData> &data,
-        const QJsonObject &metadata)
-{
-    T *writableBuffer = reinterpret_cast<T *>(data->getWritableImageBuffer());
-    const uint32_t count = metadata["count"].toInt();
-    // Average the values
-    for (uint32_t i = 0; i < m_DarkMasterBuffer.size(); i++)
-        writableBuffer[i] = m_DarkMasterBuffer[i] / count;
-
-
     QString ts = QDateTime::currentDateTime().toString("yyyy-MM-ddThh-mm-ss");
     QString path = QDir(KSPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("darks/darkframe_" + ts +
                    ".fits");
@@ -1364,6 +1277,8 @@ template <typename T>  void DarkLibrary::generateMasterFrameInternal(const QShar
     m_DarkFramesDatabaseList.append(map);
     m_FileLabel->setText(i18n("Master Dark saved to %1", path));
     KStarsData::Instance()->userdb()->AddDarkFrame(map);
+
+    emit newImage(data);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -1457,6 +1372,7 @@ void DarkLibrary::setDarkSettings(const QJsonObject &settings)
     const auto binTwoCheck = settings["BinTwo"].toBool(bin2Check->isChecked());
     const auto binFourCheck = settings["BinFour"].toBool(bin4Check->isChecked());
     const auto count = settings["count"].toInt(countSpin->value());
+    const auto algorithm = settings["combineAlgorithm"].toInt(combinAlgorithmCombo->currentIndex());
 
     cameraS->setCurrentText(camera);
     bin1Check->setChecked(binOneCheck);
@@ -1471,6 +1387,7 @@ void DarkLibrary::setDarkSettings(const QJsonObject &settings)
     if (maxTemperatureSpin->isEnabled())
         maxTemperatureSpin->setValue(maxTemperature);
     countSpin->setValue(count);
+    combinAlgorithmCombo->setCurrentIndex(algorithm);
 
 }
 
@@ -1488,6 +1405,7 @@ QJsonObject DarkLibrary::getDarkSettings()
         {"bin2Check", bin2Check->isChecked()},
         {"bin4Check", bin4Check->isChecked()},
         {"countSpin", countSpin->value()},
+        {"combineAlgorithm", combinAlgorithmCombo->currentIndex()},
         {"totalImages", totalImages->text()},
         {"totalTime", totalTime->text()},
         {"darkProgress", darkProgress->value()}
@@ -10,6 +10,7 @@
 #include "indi/indicap.h"
 #include "darkview.h"
 #include "defectmap.h"
+#include "framestacker.h"
 #include "ekos/ekos.h"
 
 #include <QDialog>
@@ -157,33 +158,13 @@ class DarkLibrary : public QDialog, public Ui::DarkLibrary
         void execute();
 
         /**
-         * @brief generateMasterFrameHelper Calls templated generateMasterFrame with the correct data type.
-         * @param data Passed dark frame data to generateMasterFrame
-         * @param metadata passed metadata to generateMasterFrame
-         */
-        void generateMasterFrame(const QSharedPointer<FITSData> &data, const QJsonObject &metadata);
-
-        /**
-         * @brief generateMasterFrame After data aggregation is done, the selected stacking algorithm is applied and the master dark
-         * frame is saved to disk and user database along with the metadata.
-         * @param data last used data. This is not used for reading, but to simply apply the algorithm to the FITSData buffer
-         * and then save it to disk.
+         * @brief generateMasterFrame After all dark frames are received, they are combined with the selected stacking
+         * algorithm and the master dark frame is saved to disk and user database along with the metadata.
+         * @param data last used data. This is not used for reading, but to simply receive the master frame in the FITSData
+         * buffer and then save it to disk.
          * @param metadata information on frame to help in the stacking process.
          */
-        template <typename T>  void generateMasterFrameInternal(const QSharedPointer<FITSData> &data, const QJsonObject &metadata);
-
-        /**
-         * @brief aggregateHelper Calls tempelated aggregate function with the appropiate data type.
-         * @param data Dark frame data to pass on to aggregate function.
-         */
-        void aggregate(const QSharedPointer<FITSData> &data);
-
-        /**
-         * @brief aggregate Aggregate the data as per the selected algorithm. Each time a new dark frame is received, this function
-         * adds the frame data to the dark buffer.
-         * @param data Dark frame data.
-         */
-        template <typename T> void aggregateInternal(const QSharedPointer<FITSData> &data);
+        void generateMasterFrame(const QSharedPointer<FITSData> &data, const QJsonObject &metadata);
 
         /**
          * @brief cacheDarkFrameFromFile Load dark frame from disk and saves it in the local dark frames cache
@@ -233,8 +214,8 @@ class DarkLibrary : public QDialog, public Ui::DarkLibrary
         QSqlTableModel *darkFramesModel = nullptr;
         QSortFilterProxyModel *sortFilter = nullptr;
 
-        std::vector<uint32_t> m_DarkMasterBuffer;
-        uint32_t m_DarkImagesCounter {0};
+        // Dark frames received so far, spooled to disk until the master frame is generated
+        FrameStacker m_DarkStacker;
         bool m_RememberFITSViewer {true};
         bool m_RememberSummaryView {true};
         bool m_JobsGenerated {false};
@@ -7,10 +7,113 @@
 #include "darkprocessor.h"
 #include "darklibrary.h"
 
+#include <QtConcurrent>
+
+#include <algorithm>
 #include <array>
+#include <limits>
+#include <type_traits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "ekos_debug.h"
 
+namespace
+{
+// Fewer rows or defects are not worth a task of their own
+constexpr uint32_t kMinBandRows = 16;
+constexpr int kMinBandDefects = 1024;
+
+// light - dark, clamped to 0 below and to the range of the type above
+template <typename T>
+inline T subtractClamped(T light, T dark, std::true_type)
+{
+    using Unsigned = typename std::make_unsigned<T>::type;
+    if (light <= dark)
+        return 0;
+    // Exact in the unsigned type since light > dark
+    const Unsigned difference = static_cast<Unsigned>(light) - static_cast<Unsigned>(dark);
+    return static_cast<T>(std::min<Unsigned>(difference, std::numeric_limits<T>::max()));
+}
+
+template <typename T>
+inline T subtractClamped(T light, T dark, std::false_type)
+{
+    return (light > dark) ? (light - dark) : 0;
+}
+
+// Branch-free, so that the compiler vectorizes it. light and dark may be the same row.
+template <typename T>
+void subtractRow(T *light, const T *dark, uint32_t count)
+{
+    for (uint32_t x = 0; x < count; x++)
+        light[x] = subtractClamped(light[x], dark[x], std::is_integral<T>());
+}
+
+#ifdef __SSE2__
+// SSE2 has saturating subtraction for 8 and 16-bit samples, 16 or 8 of them per instruction
+void subtractRow(uint8_t *light, const uint8_t *dark, uint32_t count)
+{
+    uint32_t x = 0;
+    for (; x + 16 <= count; x += 16)
+    {
+        const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(light + x));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dark + x));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(light + x), _mm_subs_epu8(l, d));
+    }
+    for (; x < count; x++)
+        light[x] = subtractClamped(light[x], dark[x], std::true_type());
+}
+
+void subtractRow(uint16_t *light, const uint16_t *dark, uint32_t count)
+{
+    uint32_t x = 0;
+    for (; x + 8 <= count; x += 8)
+    {
+        const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(light + x));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dark + x));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(light + x), _mm_subs_epu16(l, d));
+    }
+    for (; x < count; x++)
+        light[x] = subtractClamped(light[x], dark[x], std::true_type());
+}
+
+void subtractRow(int16_t *light, const int16_t *dark, uint32_t count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    uint32_t x = 0;
+    for (; x + 8 <= count; x += 8)
+    {
+        const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(light + x));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dark + x));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(light + x), _mm_max_epi16(_mm_subs_epi16(l, d), zero));
+    }
+    for (; x < count; x++)
+        light[x] = subtractClamped(light[x], dark[x], std::true_type());
+}
+#endif
+
+struct Band
+{
+    uint32_t begin;
+    uint32_t end;
+};
+
+// Bands of count items, at least minimum items each, a few per thread
+QVector<Band> makeBands(uint32_t count, uint32_t minimum)
+{
+    const uint32_t tasks = std::max(1, QThread::idealThreadCount()) * 2;
+    const uint32_t size = std::max(minimum, (count + tasks - 1) / tasks);
+
+    QVector<Band> bands;
+    for (uint32_t begin = 0; begin < count; begin += size)
+        bands.append({ begin, std::min(count, begin + size) });
+    return bands;
+}
+}
+
 namespace Ekos
 {
 
@@ -78,38 +181,24 @@ void DarkProcessor::normalizeDefectsInternal(const QSharedPointer<DefectMap> &de
 
     T *lightBuffer = reinterpret_cast<T *>(lightData->getWritableImageBuffer());
     const uint32_t width = lightData->width();
+    const uint32_t height = lightData->height();
 
-    // Account for offset X and Y
-    // e.g. if we send a subframed light frame 100x100 pixels wide
-    // but the source defect map covers 1000x1000 pixels array, then we need to only compensate
-    // for the 100x100 region.
-    for (BadPixelSet::const_iterator onePixel = defectMap->hotThreshold();
-            onePixel != defectMap->hotPixels().cend(); ++onePixel)
-    {
-        const uint16_t x = (*onePixel).x;
-        const uint16_t y = (*onePixel).y;
-
-        if (x <= offsetX || y <= offsetY)
-            continue;
-
-        uint32_t offset = (x - offsetX) + (y - offsetY) * width;
-
-        lightBuffer[offset] = median3x3Filter(x - offsetX, y - offsetY, width, lightBuffer);
-    }
+    // Sorted offsets of the bad pixels within the light frame, so they are visited in memory order
+    const QVector<uint32_t> offsets = defectMap->badPixelOffsets(width, height, offsetX, offsetY);
+    QVector<T> medians(offsets.size());
+    QVector<Band> bands = makeBands(offsets.size(), kMinBandDefects);
 
-    for (BadPixelSet::const_iterator onePixel = defectMap->coldPixels().cbegin();
-            onePixel != defectMap->coldThreshold(); ++onePixel)
+    // All medians are taken from the pixels as they were, then written, so that the bands don't race
+    QtConcurrent::blockingMap(bands, [&](Band & band)
     {
-        const uint16_t x = (*onePixel).x;
-        const uint16_t y = (*onePixel).y;
-
-        if (x <= offsetX || y <= offsetY)
-            continue;
-
-        uint32_t offset = (x - offsetX) + (y - offsetY) * width;
-
-        lightBuffer[offset] = median3x3Filter(x - offsetX, y - offsetY, width, lightBuffer);
-    }
+        for (uint32_t i = band.begin; i < band.end; i++)
+            medians[i] = median3x3Filter(offsets[i], width, lightBuffer);
+    });
+    QtConcurrent::blockingMap(bands, [&](Band & band)
+    {
+        for (uint32_t i = band.begin; i < band.end; i++)
+            lightBuffer[offsets[i]] = medians[i];
+    });
 
     lightData->calculateStats(true);
 
@@ -119,11 +208,11 @@ void DarkProcessor::normalizeDefectsInternal(const QSharedPointer<DefectMap> &de
 ///
 ///////////////////////////////////////////////////////////////////////////////////////
 template <typename T>
-T DarkProcessor::median3x3Filter(uint16_t x, uint16_t y, uint32_t width, T *buffer)
+T DarkProcessor::median3x3Filter(uint32_t offset, uint32_t width, T const *buffer)
 {
-    T *top = buffer + (y - 1) * width + (x - 1);
-    T *mid = buffer + (y - 0) * width + (x - 1);
-    T *bot = buffer + (y + 1) * width + (x - 1);
+    T const *top = buffer + offset - width - 1;
+    T const *mid = buffer + offset - 1;
+    T const *bot = buffer + offset + width - 1;
 
     std::array<T, 8> elements;
 
@@ -140,8 +229,9 @@ T DarkProcessor::median3x3Filter(uint16_t x, uint16_t y, uint32_t width, T *buff
     elements[6] = *(bot + 1);
     elements[7] = *(bot + 2);
 
-    std::sort(elements.begin(), elements.end());
-    auto median = (elements[3] + elements[4]) / 2;
+    // Only the two middle elements are needed
+    std::nth_element(elements.begin(), elements.begin() + 4, elements.end());
+    auto median = (*std::max_element(elements.begin(), elements.begin() + 4) + elements[4]) / 2;
     return median;
 }
 
@@ -205,14 +295,12 @@ void DarkProcessor::subtractInternal(const QSharedPointer<FITSData> &darkData, c
     const uint32_t darkoffset = offsetX + offsetY * darkStride;
     T const *darkBuffer  = reinterpret_cast<T const*>(darkData->getImageBuffer()) + darkoffset;
 
-    for (uint32_t y = 0; y < height; y++)
+    QVector<Band> bands = makeBands(height, kMinBandRows);
+    QtConcurrent::blockingMap(bands, [&](Band & band)
     {
-        for (uint32_t x = 0; x < width; x++)
-            lightBuffer[x] = (lightBuffer[x] > darkBuffer[x]) ? (lightBuffer[x] - darkBuffer[x]) : 0;
-
-        lightBuffer += width;
-        darkBuffer += darkStride;
-    }
+        for (uint32_t y = band.begin; y < band.end; y++)
+            subtractRow(lightBuffer + size_t(y) * width, darkBuffer + size_t(y) * darkStride, width);
+    });
 
     lightData->calculateStats(true);
 }
@@ -95,7 +95,7 @@ class DarkProcessor : public QObject
                                       uint16_t offsetX, uint16_t offsetY);
 
         template <typename T>
-        T median3x3Filter(uint16_t x, uint16_t y, uint32_t width, T *buffer);
+        T median3x3Filter(uint32_t offset, uint32_t width, T const *buffer);
 
     signals:
         void darkFrameCompleted(bool);
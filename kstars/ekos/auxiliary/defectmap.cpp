@@ -7,6 +7,8 @@
 #include "defectmap.h"
 #include <QJsonDocument>
 
+#include <algorithm>
+
 //////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////
@@ -74,6 +76,7 @@ bool DefectMap::load(const QString &filename)
     }
 
     m_ColdPixelsCount = m_ColdPixels.size();
+    invalidateOffsets();
     return true;
 }
 
@@ -264,15 +267,62 @@ void DefectMap::filterPixels()
     else
         m_ColdPixelsCount = std::distance(m_ColdPixels.cbegin(), m_ColdPixelsThreshold);
 
+    invalidateOffsets();
     emit pixelsUpdated(m_HotPixelsCount, m_ColdPixelsCount);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////
+QVector<uint32_t> DefectMap::badPixelOffsets(uint32_t width, uint32_t height, uint16_t offsetX, uint16_t offsetY) const
+{
+    QMutexLocker locker(&m_OffsetsMutex);
+
+    const QRect frame(offsetX, offsetY, width, height);
+    if (m_OffsetsValid && m_OffsetsFrame == frame)
+        return m_Offsets;
+
+    m_Offsets.clear();
+    auto addPixel = [&](const BadPixel & onePixel)
+    {
+        // e.g. if we send a subframed light frame 100x100 pixels wide
+        // but the source defect map covers 1000x1000 pixels array, then we need to only compensate
+        // for the 100x100 region.
+        const int x = onePixel.x - offsetX;
+        const int y = onePixel.y - offsetY;
+        if (x < 1 || y < 1 || x >= static_cast<int>(width) - 1 || y >= static_cast<int>(height) - 1)
+            return;
+        m_Offsets.append(x + y * width);
+    };
+
+    std::for_each(hotThreshold(), m_HotPixels.cend(), addPixel);
+    std::for_each(m_ColdPixels.cbegin(), coldThreshold(), addPixel);
+
+    // Memory order, and the same pixel only once
+    std::sort(m_Offsets.begin(), m_Offsets.end());
+    m_Offsets.erase(std::unique(m_Offsets.begin(), m_Offsets.end()), m_Offsets.end());
+
+    m_OffsetsFrame = frame;
+    m_OffsetsValid = true;
+    return m_Offsets;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////
+void DefectMap::invalidateOffsets()
+{
+    QMutexLocker locker(&m_OffsetsMutex);
+    m_OffsetsValid = false;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////
 void DefectMap::setHotEnabled(bool enabled)
 {
     m_HotEnabled = enabled;
+    invalidateOffsets();
     emit pixelsUpdated(m_HotEnabled ? m_HotPixelsCount : 0, m_ColdPixelsCount);
 }
 
@@ -282,5 +332,6 @@ void DefectMap::setHotEnabled(bool enabled)
 void DefectMap::setColdEnabled(bool enabled)
 {
     m_ColdEnabled = enabled;
+    invalidateOffsets();
     emit pixelsUpdated(m_HotPixelsCount, m_ColdEnabled ? m_ColdPixelsCount : 0);
 }
@@ -9,6 +9,8 @@
 #include <set>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QMutex>
+#include <QVector>
 
 #include "fitsviewer/fitsdata.h"
 
@@ -91,6 +93,17 @@ class DefectMap : public QObject
         }
 
         void filterPixels();
+
+        /**
+         * @brief badPixelOffsets Offsets of the enabled hot and cold pixels within a subframe.
+         * @param width Width of the subframe.
+         * @param height Height of the subframe.
+         * @param offsetX Position of the subframe on the sensor the map covers.
+         * @param offsetY Position of the subframe on the sensor the map covers.
+         * @return offsets in ascending order, without the pixels on the border of the subframe since they
+         * don't have a full 3x3 neighborhood. The list is cached until the pixels or thresholds change.
+         */
+        QVector<uint32_t> badPixelOffsets(uint32_t width, uint32_t height, uint16_t offsetX, uint16_t offsetY) const;
     signals:
         //        void hotPixelsUpdated(const BadPixelSet::const_iterator &start, const BadPixelSet::const_iterator &end);
         //        void coldPixelsUpdated(const BadPixelSet::const_iterator &start, const BadPixelSet::const_iterator &end);
@@ -102,6 +115,7 @@ class DefectMap : public QObject
         double calculateSigma(uint8_t aggressiveness);
         template <typename T>
         void initBadPixelsInternal(double hotPixelThreshold, double coldPixelThreshold);
+        void invalidateOffsets();
 
         BadPixelSet m_ColdPixels, m_HotPixels;
         BadPixelSet::const_iterator m_ColdPixelsThreshold, m_HotPixelsThreshold;
@@ -114,5 +128,11 @@ class DefectMap : public QObject
 
         QSharedPointer<FITSData> m_DarkData;
 
+        // Cache of badPixelOffsets(), which runs in the denoising thread
+        mutable QMutex m_OffsetsMutex;
+        mutable QVector<uint32_t> m_Offsets;
+        mutable QRect m_OffsetsFrame;
+        mutable bool m_OffsetsValid {false};
+
 };
 
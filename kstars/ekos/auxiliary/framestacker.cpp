@@ -0,0 +1,365 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "framestacker.h"
+
+#include <KLocalizedString>
+
+#include <QDir>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <fitsio.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+// Fewer pixels are not worth a task of their own
+constexpr uint32_t kMinTilePixels = 4096;
+// Stops the winsorization once sigma changes by less than that fraction
+constexpr double kWinsorizationTolerance = 0.0005;
+// Ratio of the standard deviation to the one of samples winsorized at 1.5 sigma, for a normal distribution
+constexpr double kWinsorizedSigmaCorrection = 1.134;
+
+struct Tile
+{
+    uint32_t begin;
+    uint32_t end;
+    bool ok;
+};
+
+double mean(const double *values, int count)
+{
+    double sum = 0;
+    for (int i = 0; i < count; i++)
+        sum += values[i];
+    return sum / count;
+}
+
+double standardDeviation(const double *values, int count, double center)
+{
+    double sum = 0;
+    for (int i = 0; i < count; i++)
+        sum += (values[i] - center) * (values[i] - center);
+    return std::sqrt(sum / count);
+}
+
+// values must be sorted
+double sortedMedian(const double *values, int count)
+{
+    return (count % 2) ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2;
+}
+
+double median(double *values, int count)
+{
+    std::nth_element(values, values + count / 2, values + count);
+    const double upper = values[count / 2];
+    if (count % 2)
+        return upper;
+    return (*std::max_element(values, values + count / 2) + upper) / 2;
+}
+
+// Sigma of the samples, made robust by clamping them to 1.5 sigma of the median until sigma settles
+double winsorizedSigma(const double *values, int count, double center, std::vector<double> &winsorized)
+{
+    winsorized.assign(values, values + count);
+    double sigma = standardDeviation(winsorized.data(), count, center);
+
+    for (int i = 0; i < 10 && sigma > 0; i++)
+    {
+        const double low = center - 1.5 * sigma;
+        const double high = center + 1.5 * sigma;
+        for (double &value : winsorized)
+            value = std::min(std::max(value, low), high);
+
+        const double previous = sigma;
+        sigma = kWinsorizedSigmaCorrection * standardDeviation(winsorized.data(), count, mean(winsorized.data(), count));
+        if (std::fabs(sigma - previous) <= kWinsorizationTolerance * previous)
+            break;
+    }
+
+    return sigma;
+}
+
+// Mean of the samples left once those further than kappa sigma from the median are rejected
+double sigmaClip(double *values, int count, const Ekos::FrameStacker::Parameters &parameters,
+                 std::vector<double> &winsorized)
+{
+    std::sort(values, values + count);
+
+    // Samples kept are the sorted range [first, last)
+    int first = 0, last = count;
+    for (int i = 0; i < parameters.iterations && last - first > 2; i++)
+    {
+        const double *kept = values + first;
+        const int keptCount = last - first;
+        const double center = sortedMedian(kept, keptCount);
+        const double sigma = parameters.method == Ekos::FrameStacker::STACK_WINSORIZED_SIGMA ?
+                             winsorizedSigma(kept, keptCount, center, winsorized) :
+                             standardDeviation(kept, keptCount, mean(kept, keptCount));
+        if (sigma <= 0)
+            break;
+
+        const double low = center - parameters.kappa * sigma;
+        const double high = center + parameters.kappa * sigma;
+        const int newFirst = std::lower_bound(values + first, values + last, low) - values;
+        const int newLast = std::upper_bound(values + first, values + last, high) - values;
+        if (newFirst == first && newLast == last)
+            break;
+
+        first = newFirst;
+        last = newLast;
+    }
+
+    return mean(values + first, last - first);
+}
+
+template <typename T>
+T toSample(double value, std::true_type)
+{
+    value = std::round(value);
+    value = std::min<double>(std::max<double>(value, std::numeric_limits<T>::lowest()), std::numeric_limits<T>::max());
+    return static_cast<T>(value);
+}
+
+template <typename T>
+T toSample(double value, std::false_type)
+{
+    return static_cast<T>(value);
+}
+}
+
+namespace Ekos
+{
+
+FrameStacker::FrameStacker()
+{
+}
+
+FrameStacker::~FrameStacker()
+{
+    clear();
+}
+
+int FrameStacker::sampleSize(int dataType)
+{
+    switch (dataType)
+    {
+        case TBYTE:
+            return sizeof(uint8_t);
+        case TSHORT:
+        case TUSHORT:
+            return sizeof(uint16_t);
+        case TLONG:
+        case TULONG:
+        case TFLOAT:
+            return sizeof(uint32_t);
+        case TLONGLONG:
+        case TDOUBLE:
+            return sizeof(uint64_t);
+        default:
+            return 0;
+    }
+}
+
+bool FrameStacker::addFrame(const uint8_t *samples, uint32_t count, int dataType)
+{
+    if (m_FrameCount == 0)
+    {
+        clear();
+        if (sampleSize(dataType) == 0)
+        {
+            m_Error = i18n("Unsupported data type %1.", dataType);
+            return false;
+        }
+
+        m_Spool.reset(new QTemporaryFile(QDir::temp().filePath("kstars_stack_XXXXXX")));
+        if (!m_Spool->open())
+        {
+            m_Error = i18n("Failed to create temporary file: %1", m_Spool->errorString());
+            m_Spool.reset();
+            return false;
+        }
+
+        m_Samples = count;
+        m_DataType = dataType;
+    }
+    else if (count != m_Samples || dataType != m_DataType)
+    {
+        m_Error = i18n("Frame does not match the size or type of the previous frames.");
+        return false;
+    }
+
+    const qint64 size = qint64(count) * sampleSize(dataType);
+    if (m_Spool->write(reinterpret_cast<const char *>(samples), size) != size)
+    {
+        m_Error = i18n("Failed to write temporary file: %1", m_Spool->errorString());
+        return false;
+    }
+
+    m_FrameCount++;
+    return true;
+}
+
+bool FrameStacker::combine(uint8_t *output, const Parameters &parameters)
+{
+    if (m_FrameCount == 0 || output == nullptr)
+    {
+        m_Error = i18n("No frames to combine.");
+        return false;
+    }
+
+    if (!m_Spool->flush())
+    {
+        m_Error = i18n("Failed to write temporary file: %1", m_Spool->errorString());
+        return false;
+    }
+
+    // Falls back to reading the file if it does not fit in the address space
+    m_Map = m_Spool->map(0, m_Spool->size());
+
+    bool ok = false;
+    switch (m_DataType)
+    {
+        case TBYTE:
+            ok = combineInternal(reinterpret_cast<uint8_t *>(output), parameters);
+            break;
+        case TSHORT:
+            ok = combineInternal(reinterpret_cast<int16_t *>(output), parameters);
+            break;
+        case TUSHORT:
+            ok = combineInternal(reinterpret_cast<uint16_t *>(output), parameters);
+            break;
+        case TLONG:
+            ok = combineInternal(reinterpret_cast<int32_t *>(output), parameters);
+            break;
+        case TULONG:
+            ok = combineInternal(reinterpret_cast<uint32_t *>(output), parameters);
+            break;
+        case TFLOAT:
+            ok = combineInternal(reinterpret_cast<float *>(output), parameters);
+            break;
+        case TLONGLONG:
+            ok = combineInternal(reinterpret_cast<int64_t *>(output), parameters);
+            break;
+        case TDOUBLE:
+            ok = combineInternal(reinterpret_cast<double *>(output), parameters);
+            break;
+        default:
+            break;
+    }
+
+    if (m_Map)
+    {
+        m_Spool->unmap(m_Map);
+        m_Map = nullptr;
+    }
+
+    if (!ok)
+        m_Error = i18n("Failed to read temporary file: %1", m_Spool->errorString());
+    return ok;
+}
+
+template <typename T>
+bool FrameStacker::combineInternal(T *output, const Parameters &parameters)
+{
+    const int frames = m_FrameCount;
+    const uint32_t threads = std::max(1, QThread::idealThreadCount());
+
+    // Each running tile holds a slice of every frame, either mapped or read
+    const qint64 bytesPerPixel = qint64(frames) * sizeof(T);
+    const qint64 tilePixels = std::max<qint64>(kMinTilePixels, parameters.memoryBudget / (threads * bytesPerPixel));
+
+    QVector<Tile> tiles;
+    for (uint32_t begin = 0; begin < m_Samples; begin += std::min<qint64>(tilePixels, m_Samples - begin))
+        tiles.append({ begin, static_cast<uint32_t>(std::min<qint64>(m_Samples, begin + tilePixels)), false });
+
+    QtConcurrent::blockingMap(tiles, [&](Tile & tile)
+    {
+        const uint32_t count = tile.end - tile.begin;
+        std::vector<T> slices;
+        std::vector<const T *> frameSamples(frames);
+
+        if (m_Map)
+        {
+            for (int f = 0; f < frames; f++)
+                frameSamples[f] = reinterpret_cast<const T *>(m_Map) + size_t(f) * m_Samples + tile.begin;
+        }
+        else
+        {
+            slices.resize(size_t(frames) * count);
+            for (int f = 0; f < frames; f++)
+            {
+                if (!readSamples(f, tile.begin, count, reinterpret_cast<uint8_t *>(slices.data() + size_t(f) * count)))
+                    return;
+                frameSamples[f] = slices.data() + size_t(f) * count;
+            }
+        }
+
+        // Consecutive pixels read the same cache line of each frame, so the stacks are gathered in place
+        std::vector<double> stack(frames), winsorized;
+        for (uint32_t p = 0; p < count; p++)
+        {
+            for (int f = 0; f < frames; f++)
+                stack[f] = frameSamples[f][p];
+
+            double value = 0;
+            switch (parameters.method)
+            {
+                case STACK_MEAN:
+                    value = mean(stack.data(), frames);
+                    break;
+                case STACK_MEDIAN:
+                    value = median(stack.data(), frames);
+                    break;
+                case STACK_KAPPA_SIGMA:
+                case STACK_WINSORIZED_SIGMA:
+                    value = sigmaClip(stack.data(), frames, parameters, winsorized);
+                    break;
+            }
+
+            output[tile.begin + p] = toSample<T>(value, std::is_integral<T>());
+        }
+
+        tile.ok = true;
+    });
+
+    return std::all_of(tiles.cbegin(), tiles.cend(), [](const Tile & tile)
+    {
+        return tile.ok;
+    });
+}
+
+bool FrameStacker::readSamples(int frame, uint32_t first, uint32_t count, uint8_t *destination)
+{
+    const int size = sampleSize(m_DataType);
+    const qint64 bytes = qint64(count) * size;
+
+    QMutexLocker locker(&m_ReadMutex);
+    return m_Spool->seek((qint64(frame) * m_Samples + first) * size) &&
+           m_Spool->read(reinterpret_cast<char *>(destination), bytes) == bytes;
+}
+
+void FrameStacker::clear()
+{
+    if (m_Spool && m_Map)
+        m_Spool->unmap(m_Map);
+    m_Map = nullptr;
+    // Removes the file
+    m_Spool.reset();
+    m_FrameCount = 0;
+    m_Samples = 0;
+    m_DataType = 0;
+}
+
+}
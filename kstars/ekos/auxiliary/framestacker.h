@@ -0,0 +1,115 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QMutex>
+#include <QString>
+#include <QTemporaryFile>
+
+#include <cstdint>
+#include <memory>
+
+namespace Ekos
+{
+
+/**
+ * @brief The FrameStacker class
+ *
+ * Combines calibration frames into a master frame without keeping them in memory.
+ *
+ * Each frame is spooled to a temporary file as it arrives. Once all frames are in, the file is memory mapped
+ * and the master frame is computed in tiles of pixels, several tiles in parallel. Each tile gathers the stack
+ * of every one of its pixels from all frames, so the memory in use is bounded by the memory budget whatever
+ * the number of frames. Pages of the mapped file are clean and the kernel drops them as needed instead of
+ * swapping them out. If the file can't be mapped, for instance on a 32-bit system, the tiles read it instead.
+ *
+ * Frames hold samples of one of the FITS data types, and the master frame has the same type.
+ */
+class FrameStacker
+{
+    public:
+        enum Method
+        {
+            /** Mean of all samples */
+            STACK_MEAN,
+            /** Median of all samples */
+            STACK_MEDIAN,
+            /** Mean of the samples within kappa sigma of the median, repeated until no sample is rejected */
+            STACK_KAPPA_SIGMA,
+            /** Like STACK_KAPPA_SIGMA, with sigma estimated on samples winsorized at 1.5 sigma */
+            STACK_WINSORIZED_SIGMA
+        };
+
+        struct Parameters
+        {
+            Method method { STACK_MEAN };
+            /** Samples further than kappa sigma from the median are rejected */
+            double kappa { 3 };
+            /** Maximum number of rejection rounds */
+            int iterations { 5 };
+            /** Memory used to gather the stacks of the tiles, in bytes */
+            qint64 memoryBudget { 512 * 1024 * 1024 };
+        };
+
+        FrameStacker();
+        ~FrameStacker();
+
+        /**
+         * @brief addFrame Spool a frame to disk. All frames must have the same size and data type.
+         * @param samples count samples of the given FITS data type (TBYTE, TUSHORT...)
+         * @return false if the frame does not match the previous ones or could not be written, see errorString().
+         */
+        bool addFrame(const uint8_t *samples, uint32_t count, int dataType);
+
+        /**
+         * @brief combine Compute the master frame of the spooled frames, blocking until done.
+         * @param output samplesPerFrame() samples of dataType().
+         * @return false if there are no frames or the spool could not be read, see errorString().
+         */
+        bool combine(uint8_t *output, const Parameters &parameters);
+
+        /** Forget all frames and remove the spool file. */
+        void clear();
+
+        int frameCount() const
+        {
+            return m_FrameCount;
+        }
+        uint32_t samplesPerFrame() const
+        {
+            return m_Samples;
+        }
+        int dataType() const
+        {
+            return m_DataType;
+        }
+        const QString &errorString() const
+        {
+            return m_Error;
+        }
+
+        /** @return the size of a sample of the FITS data type, or 0 if the type is not supported. */
+        static int sampleSize(int dataType);
+
+    private:
+        template <typename T>
+        bool combineInternal(T *output, const Parameters &parameters);
+
+        // Read count samples of a frame starting at sample first, when the spool is not mapped
+        bool readSamples(int frame, uint32_t first, uint32_t count, uint8_t *destination);
+
+        std::unique_ptr<QTemporaryFile> m_Spool;
+        // Serializes reads when the spool is not mapped
+        QMutex m_ReadMutex;
+        uchar *m_Map {nullptr};
+        int m_FrameCount {0};
+        uint32_t m_Samples {0};
+        int m_DataType {0};
+        QString m_Error;
+};
+
+}
@@ -13,6 +13,7 @@
 #include "rotatorsettings.h"
 #include "sequencejob.h"
 #include "placeholderpath.h"
+#include "captureframeindex.h"
 #include "skymap.h"
 #include "ui_calibrationoptions.h"
 #include "auxiliary/QProgressIndicator.h"
@@ -468,6 +469,9 @@ void Capture::addCCD(ISD::GDInterface * newCCD)
 
     cameraS->addItem(ccd->getDeviceName());
 
+    // Every camera, not only the current one, so that the index holds all the frames written
+    connect(ccd, &ISD::CCD::fileWritten, this, &Ekos::Capture::indexFile, Qt::UniqueConnection);
+
     DarkLibrary::Instance()->addCamera(newCCD);
 
     if (Filters.count() > 0)
@@ -873,6 +877,7 @@ void Capture::stop(CaptureState targetState)
     //button->setEnabled(true);
 
     seqDelayTimer->stop();
+    m_WaitingForWriteQueue = false;
 
     setActiveJob(nullptr);
     // meridian flip may take place if requested
@@ -1164,6 +1169,7 @@ void Capture::checkCCD(int ccdNum)
         connect(currentCCD, &ISD::CCD::videoStreamToggled, this, &Ekos::Capture::setVideoStreamEnabled);
         connect(currentCCD, &ISD::CCD::ready, this, &Ekos::Capture::ready);
         connect(currentCCD, &ISD::CCD::error, this, &Ekos::Capture::processCaptureError);
+        connect(currentCCD, &ISD::CCD::writeQueueChanged, this, &Ekos::Capture::updateWriteQueue, Qt::UniqueConnection);
 
         DarkLibrary::Instance()->checkCamera();
     }
@@ -2302,6 +2308,23 @@ void Capture::updateTargetDistance(double targetDiff)
     targetDrift->setText(QString("%L1").arg(targetDiff, 0, 'd', 1));
 }
 
+void Capture::updateWriteQueue(int depth, int capacity, double latency)
+{
+    captureStatusWidget->setWriteQueue(depth, capacity, latency);
+
+    if (m_WaitingForWriteQueue && depth < capacity)
+    {
+        m_WaitingForWriteQueue = false;
+        if (activeJob != nullptr)
+            captureImage();
+    }
+}
+
+void Capture::indexFile(const QString &filename, qint64 directoryBefore, qint64 directoryAfter)
+{
+    CaptureFrameIndex::Instance()->addFile(filename, directoryBefore, directoryAfter);
+}
+
 void Capture::captureImage()
 {
     if (activeJob == nullptr)
@@ -2345,6 +2368,17 @@ void Capture::captureImage()
         return;
     }
 
+    // Hold back while the disk catches up, updateWriteQueue() resumes
+    if (currentCCD->isWriteQueueFull())
+    {
+        if (!m_WaitingForWriteQueue)
+            qCDebug(KSTARS_EKOS_CAPTURE) << "Image write queue is full, waiting before next capture.";
+        m_WaitingForWriteQueue = true;
+        captureStatusWidget->setStatus(i18n("Writing images..."), Qt::yellow);
+        return;
+    }
+    m_WaitingForWriteQueue = false;
+
     captureTimeout.stop();
     seqDelayTimer->stop();
     captureDelayTimer->stop();
@@ -2548,15 +2582,11 @@ void Capture::checkSeqBoundary(const QString &path)
     if (meridianFlipStage >= MF_ALIGNING)
         return;
 
-    QDirIterator it(sig_dir, QDir::Files);
-
-    while (it.hasNext())
+    QStringList const files = CaptureFrameIndex::Instance()->files(sig_dir);
+    for (const QString &fileName : files)
     {
-        tempName = it.next();
-        QFileInfo info(tempName);
-
         // This returns the filename without the extension
-        tempName = info.completeBaseName();
+        tempName = QFileInfo(fileName).completeBaseName();
 
         // This remove any additional extension (e.g. m42_001.fits.fz)
         // the completeBaseName() would return m42_001.fits
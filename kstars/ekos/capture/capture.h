@@ -959,6 +959,22 @@ class Capture : public QWidget, public Ui::Capture
          */
         void processCaptureError(ISD::CCD::ErrorType type);
 
+        /**
+         * @brief updateWriteQueue Show the state of the image write queue of the camera, and resume
+         * capturing if it was held back by a full queue.
+         * @param depth frames waiting to be written
+         * @param capacity frames the queue holds
+         * @param latency time taken to write the last frame, in milliseconds
+         */
+        void updateWriteQueue(int depth, int capacity, double latency);
+
+        /**
+         * @brief indexFile Add an image written by a camera to the frame index of its directory.
+         * @param directoryBefore modification time of the directory before the write
+         * @param directoryAfter modification time of the directory after the write
+         */
+        void indexFile(const QString &filename, qint64 directoryBefore, qint64 directoryAfter);
+
         /**
          * @brief setDarkFlatExposure Given a dark flat job, find the exposure suitable from it by searching for
          * completed flat frames.
@@ -994,6 +1010,8 @@ class Capture : public QWidget, public Ui::Capture
         int seqFileCount { 0 };
         bool isBusy { false };
         bool m_isFraming { false };
+        // Next capture held back until the camera has written enough frames to disk
+        bool m_WaitingForWriteQueue { false };
 
         // Capture timeout timer
         QTimer captureTimeout;
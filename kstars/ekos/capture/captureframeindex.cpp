@@ -0,0 +1,258 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "captureframeindex.h"
+
+#include "kspaths.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+
+#include <ekos_capture_debug.h>
+
+#include <algorithm>
+
+namespace
+{
+// Suffix of the files still being written by the image write queue
+const QString kPartSuffix = QStringLiteral(".part");
+
+QString directoryKey(const QString &path)
+{
+    return QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+}
+}
+
+namespace Ekos
+{
+
+CaptureFrameIndex *CaptureFrameIndex::m_Instance = nullptr;
+
+CaptureFrameIndex *CaptureFrameIndex::Instance()
+{
+    if (m_Instance == nullptr)
+        m_Instance = new CaptureFrameIndex(QDir(KSPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath(
+                                               "captureindex.sqlite"));
+    return m_Instance;
+}
+
+CaptureFrameIndex::CaptureFrameIndex(const QString &databaseFile)
+{
+    // One connection per index, so that tests may open several
+    m_ConnectionName = QString("captureindex_%1").arg(reinterpret_cast<quintptr>(this));
+    m_DB = QSqlDatabase::addDatabase("QSQLITE", m_ConnectionName);
+    m_DB.setDatabaseName(databaseFile);
+
+    if (!m_DB.open())
+    {
+        qCWarning(KSTARS_EKOS_CAPTURE) << "Capture frame index" << databaseFile << "cannot be opened, it is kept in memory:"
+                                       << m_DB.lastError().text();
+        return;
+    }
+
+    QSqlQuery query(m_DB);
+    if (!query.exec("CREATE TABLE IF NOT EXISTS directories (path TEXT PRIMARY KEY, modified INTEGER)") ||
+            !query.exec("CREATE TABLE IF NOT EXISTS frames (directory TEXT, name TEXT, PRIMARY KEY (directory, name))"))
+    {
+        qCWarning(KSTARS_EKOS_CAPTURE) << "Capture frame index tables cannot be created:" << query.lastError().text();
+        m_DB.close();
+    }
+}
+
+CaptureFrameIndex::~CaptureFrameIndex()
+{
+    m_DB.close();
+    m_DB = QSqlDatabase();
+    QSqlDatabase::removeDatabase(m_ConnectionName);
+}
+
+void CaptureFrameIndex::addFile(const QString &filename, qint64 directoryBefore, qint64 directoryAfter)
+{
+    QFileInfo const info(filename);
+    QString const name = info.fileName();
+    if (!isIndexed(name))
+        return;
+
+    // Directories never queried are listed on their first query
+    QString const path = directoryKey(info.dir().path());
+    auto it = m_Directories.find(path);
+    if (it == m_Directories.end())
+    {
+        Directory entry;
+        if (!load(path, entry))
+            return;
+        it = m_Directories.insert(path, entry);
+    }
+
+    Directory &entry = it.value();
+    auto const position = std::lower_bound(entry.names.begin(), entry.names.end(), name);
+    if (position == entry.names.end() || *position != name)
+    {
+        entry.names.insert(position, name);
+        entry.counts.clear();
+    }
+    // If the directory changed since it was listed, another program changed it too and the entry stays stale,
+    // so that the next query lists it again. Otherwise only the write changed it, and it stays up to date.
+    const bool current = entry.modified == directoryBefore;
+    if (current)
+        entry.modified = directoryAfter;
+
+    if (!m_DB.isOpen())
+        return;
+
+    QSqlQuery query(m_DB);
+    query.prepare("INSERT OR REPLACE INTO frames (directory, name) VALUES (?, ?)");
+    query.addBindValue(path);
+    query.addBindValue(name);
+    if (!query.exec())
+        qCWarning(KSTARS_EKOS_CAPTURE) << "Capture frame index cannot add" << filename << query.lastError().text();
+
+    if (!current)
+        return;
+
+    query.prepare("UPDATE directories SET modified = ? WHERE path = ?");
+    query.addBindValue(entry.modified);
+    query.addBindValue(path);
+    if (!query.exec())
+        qCWarning(KSTARS_EKOS_CAPTURE) << "Capture frame index cannot update" << path << query.lastError().text();
+}
+
+int CaptureFrameIndex::count(const QString &directory, const QString &prefix)
+{
+    Directory &entry = this->directory(directory);
+
+    auto const cached = entry.counts.constFind(prefix);
+    if (cached != entry.counts.constEnd())
+        return cached.value();
+
+    // Names of the files matching are in the sorted range of the names starting with the prefix, only the last
+    // extension of a name is removed before matching, as QFileInfo::completeBaseName does
+    int result = 0;
+    for (auto it = std::lower_bound(entry.names.cbegin(), entry.names.cend(), prefix);
+            it != entry.names.cend() && it->startsWith(prefix); ++it)
+    {
+        if (QFileInfo(*it).completeBaseName().startsWith(prefix))
+            result++;
+    }
+
+    entry.counts.insert(prefix, result);
+    return result;
+}
+
+QStringList CaptureFrameIndex::files(const QString &directory)
+{
+    return this->directory(directory).names;
+}
+
+CaptureFrameIndex::Directory &CaptureFrameIndex::directory(const QString &path)
+{
+    QString const key = directoryKey(path);
+    auto it = m_Directories.find(key);
+    if (it == m_Directories.end())
+    {
+        Directory entry;
+        if (!load(key, entry))
+            scan(key, entry);
+        it = m_Directories.insert(key, entry);
+    }
+
+    if (it->modified != modificationTime(key))
+        scan(key, it.value());
+
+    return it.value();
+}
+
+void CaptureFrameIndex::scan(const QString &path, Directory &entry)
+{
+    // The time is read before listing, so that files added while listing make the next query list again
+    entry.modified = modificationTime(path);
+    entry.names.clear();
+    entry.counts.clear();
+
+    for (const QString &name : QDir(path).entryList(QDir::Files, QDir::Name))
+    {
+        if (isIndexed(name))
+            entry.names.append(name);
+    }
+    // Sorted as QString compares, which the range queries use
+    std::sort(entry.names.begin(), entry.names.end());
+
+    if (!m_DB.isOpen())
+        return;
+
+    m_DB.transaction();
+    QSqlQuery query(m_DB);
+
+    query.prepare("DELETE FROM frames WHERE directory = ?");
+    query.addBindValue(path);
+    bool ok = query.exec();
+
+    query.prepare("INSERT OR REPLACE INTO directories (path, modified) VALUES (?, ?)");
+    query.addBindValue(path);
+    query.addBindValue(entry.modified);
+    ok = ok && query.exec();
+
+    query.prepare("INSERT INTO frames (directory, name) VALUES (?, ?)");
+    for (int i = 0; ok && i < entry.names.size(); i++)
+    {
+        query.addBindValue(path);
+        query.addBindValue(entry.names[i]);
+        ok = query.exec();
+    }
+
+    if (ok)
+        m_DB.commit();
+    else
+    {
+        qCWarning(KSTARS_EKOS_CAPTURE) << "Capture frame index cannot store" << path << query.lastError().text();
+        m_DB.rollback();
+    }
+}
+
+bool CaptureFrameIndex::load(const QString &path, Directory &entry)
+{
+    if (!m_DB.isOpen())
+        return false;
+
+    QSqlQuery query(m_DB);
+    query.prepare("SELECT modified FROM directories WHERE path = ?");
+    query.addBindValue(path);
+    if (!query.exec() || !query.next())
+        return false;
+    entry.modified = query.value(0).toLongLong();
+
+    query.prepare("SELECT name FROM frames WHERE directory = ?");
+    query.addBindValue(path);
+    if (!query.exec())
+    {
+        qCWarning(KSTARS_EKOS_CAPTURE) << "Capture frame index cannot load" << path << query.lastError().text();
+        return false;
+    }
+
+    entry.names.clear();
+    entry.counts.clear();
+    while (query.next())
+        entry.names.append(query.value(0).toString());
+    std::sort(entry.names.begin(), entry.names.end());
+    return true;
+}
+
+qint64 CaptureFrameIndex::modificationTime(const QString &path)
+{
+    QFileInfo const info(path);
+    return info.isDir() ? info.lastModified().toMSecsSinceEpoch() : -1;
+}
+
+bool CaptureFrameIndex::isIndexed(const QString &name)
+{
+    return !name.endsWith(kPartSuffix);
+}
+
+}
@@ -0,0 +1,89 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+
+namespace Ekos
+{
+
+/**
+ * @class CaptureFrameIndex
+ * @short Persistent index of the files in the capture directories.
+ *
+ * The scheduler counts the frames already captured for each sequence job by listing the capture directory and
+ * matching file names against the job prefix, and Capture lists it again to find the next file number. Over a
+ * network share holding several seasons of captures, these listings take minutes.
+ *
+ * The index keeps the file names of each directory it was asked about in an SQLite database next to the user
+ * database, along with the modification time of the directory when it was listed. A directory is listed again
+ * only when its modification time changed, which is when another program added or removed files in it. Files
+ * written by the capture are added as they are written, without listing anything. Such a write keeps the entry
+ * of the directory current only if the entry was current right before it, so that changes made by others in
+ * the meantime are still found.
+ *
+ * Counts by prefix are cached until the directory changes. The index is not thread-safe, it is used from the
+ * GUI thread.
+ */
+class CaptureFrameIndex
+{
+    public:
+        /** @param databaseFile SQLite file of the index, created if needed. */
+        explicit CaptureFrameIndex(const QString &databaseFile);
+        ~CaptureFrameIndex();
+
+        /** The index of the application, in the user data directory. */
+        static CaptureFrameIndex *Instance();
+
+        /**
+         * @brief addFile Record a file just written, in the index of its directory.
+         * @param directoryBefore modification time of the directory before the file was created, as returned by
+         * modificationTime().
+         * @param directoryAfter modification time of the directory once the file was in place.
+         */
+        void addFile(const QString &filename, qint64 directoryBefore, qint64 directoryAfter);
+
+        /**
+         * @brief count Number of files of a directory whose name without extensions starts with prefix.
+         * Files being written, with a .part suffix, are not counted.
+         */
+        int count(const QString &directory, const QString &prefix);
+
+        /** Names of the files of a directory, sorted. */
+        QStringList files(const QString &directory);
+
+        /** Modification time of a directory, in milliseconds since the epoch, -1 if missing. */
+        static qint64 modificationTime(const QString &path);
+
+    private:
+        struct Directory
+        {
+            // Modification time of the directory when listed, in milliseconds since the epoch, -1 if missing
+            qint64 modified { -1 };
+            QStringList names;
+            QHash<QString, int> counts;
+        };
+
+        // The entry of a directory, listed again if it changed
+        Directory &directory(const QString &path);
+        // Lists a directory and replaces its entry, in memory and in the database
+        void scan(const QString &path, Directory &entry);
+        bool load(const QString &path, Directory &entry);
+
+        static bool isIndexed(const QString &name);
+
+        static CaptureFrameIndex *m_Instance;
+
+        QString m_ConnectionName;
+        QSqlDatabase m_DB;
+        QHash<QString, Directory> m_Directories;
+};
+
+}
@@ -16,6 +16,11 @@ CaptureStatusWidget::CaptureStatusWidget(QWidget * parent) : QWidget(parent)
     statusLed->setObjectName("statusLed");
     statusLayout->insertWidget(-1, statusLed, 0, Qt::AlignVCenter);
 
+    writeQueueText = new QLabel(this);
+    writeQueueText->setObjectName("writeQueueText");
+    writeQueueText->setVisible(false);
+    statusLayout->insertWidget(0, writeQueueText, 0, Qt::AlignVCenter);
+
     statusText->setText(i18n("Idle"));
 }
 
@@ -113,4 +118,12 @@ void CaptureStatusWidget::setStatus(QString text, Qt::GlobalColor color)
     statusLed->setColor(color);
 }
 
+void CaptureStatusWidget::setWriteQueue(int depth, int capacity, double latency)
+{
+    writeQueueText->setText(i18nc("frames waiting to be written / queue capacity, time to write the last one",
+                                  "Disk %1/%2, %3 ms", depth, capacity, QString::number(latency, 'f', 0)));
+    writeQueueText->setToolTip(i18n("Frames waiting to be written and time taken to write the last one"));
+    writeQueueText->setVisible(true);
+}
+
 }
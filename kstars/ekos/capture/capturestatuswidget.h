@@ -31,6 +31,14 @@ public:
      */
     QString getStatusText() { return statusText->text(); }
 
+    /**
+     * @brief Show the frames waiting to be written and the time the last one took
+     * @param depth frames in the write queue
+     * @param capacity frames the queue holds before capture waits for it
+     * @param latency milliseconds from reception until the last file was in place
+     */
+    void setWriteQueue(int depth, int capacity, double latency);
+
 public slots:
     /**
      * @brief Handle new capture state
@@ -44,6 +52,7 @@ public slots:
 
 private:
     KLed *statusLed {nullptr};
+    QLabel *writeQueueText {nullptr};
 
     FilterState lastFilterState = FILTER_IDLE;
 };
@@ -332,9 +332,7 @@ void Media::upload(FITSView * view)
     // For high bandwidth images
     else
     {
-        QImage scaledImage =  view->getDisplayImage().width() > scaleWidth ?
-                              view->getDisplayImage().scaledToWidth(scaleWidth, Qt::SmoothTransformation) :
-                              view->getDisplayImage();
+        QImage scaledImage = view->getDisplayImage(scaleWidth);
         scaledImage.save(&buffer, ext.toLatin1().constData(), scaleWidth);
     }
     buffer.close();
@@ -13,9 +13,15 @@
 #include "ekos/ekos.h"
 #include "ui_scheduler.h"
 
+#include <QThread>
+#include <QtConcurrent>
+
 // Can make the scheduling a bit faster by sampling every other minute instead of every minute.
 constexpr int SCHEDULE_RESOLUTION_MINUTES = 2;
 
+// Searches kept for incremental scheduling, beyond which the oldest are dropped.
+constexpr int MAX_CACHED_SEARCHES = 20000;
+
 namespace Ekos
 {
 
@@ -41,6 +47,7 @@ QList<SchedulerJob *> GreedyScheduler::scheduleJobs(QList<SchedulerJob *> &jobs,
 {
     for (auto job : jobs)
         job->clearCache();
+    checkSearchCache();
 
     SchedulerJob::enableGraphicsUpdates(false);
     QDateTime when;
@@ -53,8 +60,9 @@ QList<SchedulerJob *> GreedyScheduler::scheduleJobs(QList<SchedulerJob *> &jobs,
         prepareJobsForEvaluation(jobs, now, capturedFramesCount, scheduler);
 
     scheduledJob = selectNextJob(sortedJobs, now, nullptr, true, &when, nullptr, nullptr, &capturedFramesCount);
+    rotateSearchCache();
     auto schedule = getSchedule();
-    if (!schedule.empty())
+    if (scheduler != nullptr && !schedule.empty())
     {
         // Print in reverse order ?! The log window at the bottom of the screen
         // prints "upside down" -- most recent on top -- and I believe that view
@@ -64,7 +72,8 @@ QList<SchedulerJob *> GreedyScheduler::scheduleJobs(QList<SchedulerJob *> &jobs,
         scheduler->appendLogText(QString("Greedy Scheduler plan for the next 48 hours starting %1 (%2)s:")
                                  .arg(now.toString()).arg(timer.elapsed() / 1000.0));
     }
-    else scheduler->appendLogText(QString("Greedy Scheduler: empty plan (%1s)").arg(timer.elapsed() / 1000.0));
+    else if (scheduler != nullptr)
+        scheduler->appendLogText(QString("Greedy Scheduler: empty plan (%1s)").arg(timer.elapsed() / 1000.0));
     if (scheduledJob != nullptr)
     {
         qCDebug(KSTARS_EKOS_SCHEDULER)
@@ -93,7 +102,11 @@ bool GreedyScheduler::checkJob(QList<SchedulerJob *> &jobs,
                                SchedulerJob *currentJob)
 {
     QDateTime startTime;
+    checkSearchCache();
     SchedulerJob *next = selectNextJob(jobs, now, currentJob, false, &startTime);
+    // Checks are frequent and search from a different time each, keep the cache bounded until the next scheduling.
+    if (searchCache.startTimes.size() > MAX_CACHED_SEARCHES)
+        rotateSearchCache();
     if (next == currentJob && now.secsTo(startTime) <= 1)
     {
         return true;
@@ -254,6 +267,27 @@ QDateTime firstPossibleStart(SchedulerJob *job, const QDateTime &now,
         possibleStart = now;
     return possibleStart;
 }
+
+// Finds the result of a search in those of this scheduling, or else of the previous one,
+// in which case it is copied to this scheduling's so that it is kept for the next.
+template <typename T>
+bool findSearch(QHash<QString, T> &searches, const QHash<QString, T> &previousSearches, const QString &key, T *result)
+{
+    auto found = searches.constFind(key);
+    if (found != searches.constEnd())
+    {
+        *result = found.value();
+        return true;
+    }
+    found = previousSearches.constFind(key);
+    if (found != previousSearches.constEnd())
+    {
+        *result = found.value();
+        searches.insert(key, found.value());
+        return true;
+    }
+    return false;
+}
 }  // namespace
 
 // Consider all jobs marked as JOB_EVALUATION/ABORT/ERROR. Assume ordered by highest priority first.
@@ -284,6 +318,12 @@ SchedulerJob *GreedyScheduler::selectNextJob(const QList<SchedulerJob *> &jobs,
     SchedulerJob *nextJob = nullptr;
     QString interruptStr;
 
+    // The start times of the jobs are searched in parallel, a batch of jobs at a time, as the loop
+    // below usually stops well before the end of the list.
+    const int batchSize = std::max(1, QThread::idealThreadCount());
+    QVector<QDateTime> startTimes(jobs.size());
+    int searched = 0;
+
     for (int i = 0; i < jobs.size(); ++i)
     {
         SchedulerJob *job = jobs[i];
@@ -292,15 +332,13 @@ SchedulerJob *GreedyScheduler::selectNextJob(const QList<SchedulerJob *> &jobs,
         if (!allowJob(job, rescheduleAbortsImmediate, rescheduleAbortsQueue, rescheduleErrors))
             continue;
 
-        // If the job state is abort or error, might have to delay the first possible start time.
-        QDateTime startSearchingtAt = firstPossibleStart(
-                                          job, now, rescheduleAbortsQueue, abortDelaySeconds, rescheduleErrors, errorDelaySeconds);
-
         // Find the first time this job can meet all its constraints.
-        // I found that passing in an "until" 4th argument actually hurt performance, as it reduces
-        // the effectiveness of the cache that getNextPossibleStartTime uses.
-        const QDateTime startTime = job->getNextPossibleStartTime(startSearchingtAt, SCHEDULE_RESOLUTION_MINUTES,
-                                    evaluatingCurrentJob);
+        if (i >= searched)
+        {
+            searched = std::min(jobs.size(), i + batchSize);
+            searchStartTimes(jobs, i, searched, now, currentJob, startTimes);
+        }
+        const QDateTime &startTime = startTimes[i];
         if (startTime.isValid())
         {
             if (nextJob == nullptr)
@@ -370,8 +408,7 @@ SchedulerJob *GreedyScheduler::selectNextJob(const QList<SchedulerJob *> &jobs,
                                                   errorDelaySeconds);
                 // atTime above is the user-specified start time. atJobStartTime is the time it can
                 // actually start, given all the constraints (altitude, twilight, etc).
-                const QDateTime atJobStartTime = atJob->getNextPossibleStartTime(startSearchingtAt, SCHEDULE_RESOLUTION_MINUTES, currentJob
-                                                 && (atJob == currentJob));
+                const QDateTime atJobStartTime = nextPossibleStartTime(atJob, startSearchingtAt, currentJob && (atJob == currentJob));
                 if (atJobStartTime.isValid())
                 {
                     // This difference between the user-specified start time, and the time it can really start.
@@ -486,8 +523,7 @@ void GreedyScheduler::simulate(const QList<SchedulerJob *> &jobs, const QDateTim
 
         QString constraintReason;
         // Get the time that this next job would fail its constraints, and a human-readable explanation.
-        QDateTime jobConstraintTime = selectedJob->getNextEndTime(jobStartTime, SCHEDULE_RESOLUTION_MINUTES, &constraintReason,
-                                      jobInterruptTime);
+        QDateTime jobConstraintTime = nextEndTime(selectedJob, jobStartTime, &constraintReason, jobInterruptTime);
         QDateTime jobCompletionTime;
         if (selectedJob->getEstimatedTime() > 0)
         {
@@ -561,6 +597,126 @@ void GreedyScheduler::simulate(const QList<SchedulerJob *> &jobs, const QDateTim
     return;
 }
 
+void GreedyScheduler::searchStartTimes(const QList<SchedulerJob *> &jobs, int first, int last, const QDateTime &now,
+                                       SchedulerJob *currentJob, QVector<QDateTime> &startTimes)
+{
+    struct Search
+    {
+        int index;
+        QDateTime from;
+        bool runningJob;
+    };
+    QVector<Search> searches;
+
+    for (int i = first; i < last; ++i)
+    {
+        SchedulerJob *job = jobs[i];
+        startTimes[i] = QDateTime();
+        if (!allowJob(job, rescheduleAbortsImmediate, rescheduleAbortsQueue, rescheduleErrors))
+            continue;
+
+        // If the job state is abort or error, might have to delay the first possible start time.
+        const QDateTime startSearchingtAt = firstPossibleStart(
+                                                job, now, rescheduleAbortsQueue, abortDelaySeconds, rescheduleErrors, errorDelaySeconds);
+        const bool runningJob = currentJob && (job == currentJob);
+
+        // The running job is searched differently, and its search is not worth keeping.
+        if (runningJob || !findSearch(searchCache.startTimes, previousSearchCache.startTimes,
+                                      startTimeKey(job, startSearchingtAt), &startTimes[i]))
+            searches.append({ i, startSearchingtAt, runningJob });
+    }
+
+    // Jobs only write to their own caches when searching, and the ephemerides they share are locked.
+    // I found that passing in an "until" 4th argument actually hurt performance, as it reduces
+    // the effectiveness of the cache that getNextPossibleStartTime uses.
+    QDateTime *results = startTimes.data();
+    // The shared tables filled lazily, such as the constraints of the artificial horizon, are filled here
+    // on this thread, rather than by whichever worker queries them first
+    SchedulerJob::prepareConcurrentSearches();
+    QtConcurrent::blockingMap(searches, [&](const Search & search)
+    {
+        results[search.index] = jobs[search.index]->getNextPossibleStartTime(search.from, SCHEDULE_RESOLUTION_MINUTES,
+                                search.runningJob);
+    });
+
+    for (const auto &search : searches)
+    {
+        if (!search.runningJob)
+            searchCache.startTimes.insert(startTimeKey(jobs[search.index], search.from), startTimes[search.index]);
+    }
+}
+
+QDateTime GreedyScheduler::nextPossibleStartTime(SchedulerJob *job, const QDateTime &from, bool runningJob)
+{
+    if (runningJob)
+        return job->getNextPossibleStartTime(from, SCHEDULE_RESOLUTION_MINUTES, true);
+
+    const QString key = startTimeKey(job, from);
+    QDateTime result;
+    if (!findSearch(searchCache.startTimes, previousSearchCache.startTimes, key, &result))
+    {
+        result = job->getNextPossibleStartTime(from, SCHEDULE_RESOLUTION_MINUTES);
+        searchCache.startTimes.insert(key, result);
+    }
+    return result;
+}
+
+QDateTime GreedyScheduler::nextEndTime(SchedulerJob *job, const QDateTime &start, QString *reason, const QDateTime &until)
+{
+    const QString key = QString("%1 %2 %3").arg(jobSignature(job)).arg(start.toMSecsSinceEpoch())
+                        .arg(until.isValid() ? until.toMSecsSinceEpoch() : 0);
+    QPair<QDateTime, QString> result;
+    if (!findSearch(searchCache.endTimes, previousSearchCache.endTimes, key, &result))
+    {
+        result.first = job->getNextEndTime(start, SCHEDULE_RESOLUTION_MINUTES, &result.second, until);
+        searchCache.endTimes.insert(key, result);
+    }
+    if (reason) *reason = result.second;
+    return result.first;
+}
+
+QString GreedyScheduler::startTimeKey(SchedulerJob *job, const QDateTime &from)
+{
+    return QString("%1 %2").arg(jobSignature(job)).arg(from.toMSecsSinceEpoch());
+}
+
+const QString &GreedyScheduler::jobSignature(SchedulerJob *job)
+{
+    auto signature = jobSignatures.find(job);
+    if (signature == jobSignatures.end())
+        signature = jobSignatures.insert(job, job->getConstraintSignature());
+    return signature.value();
+}
+
+void GreedyScheduler::checkSearchCache()
+{
+    // Jobs may have been edited since the last scheduling, and their copies deleted.
+    jobSignatures.clear();
+
+    const QString environment = SchedulerJob::getConstraintEnvironment();
+    if (!incremental || environment != searchEnvironment)
+        clearSearchCache();
+    searchEnvironment = environment;
+}
+
+void GreedyScheduler::rotateSearchCache()
+{
+    if (incremental)
+    {
+        // Searches used since the last rotation were copied or added to searchCache, the others are dropped.
+        previousSearchCache = searchCache;
+        searchCache = SearchCache();
+    }
+    else
+        clearSearchCache();
+}
+
+void GreedyScheduler::clearSearchCache()
+{
+    searchCache = SearchCache();
+    previousSearchCache = SearchCache();
+}
+
 void GreedyScheduler::unsetEvaluation(const QList<SchedulerJob *> &jobs)
 {
     for (int i = 0; i < jobs.size(); ++i)
@@ -9,6 +9,8 @@
 #include <QList>
 #include <QMap>
 #include <QDateTime>
+#include <QHash>
+#include <QPair>
 #include <QString>
 #include <QVector>
 #include "schedulerjob.h"
@@ -122,6 +124,19 @@ class GreedyScheduler : public QObject
         {
             errorDelaySeconds = value;
         }
+        /**
+          * @brief setIncremental sets the incremental parameter. When true, the constraint searches
+          * of a scheduling are kept for the next one, which only searches again for the jobs whose
+          * constraints changed, and for the times the previous scheduling did not look at.
+          */
+        void setIncremental(bool value)
+        {
+            incremental = value;
+        }
+        /**
+          * @brief clearSearchCache Forgets the constraint searches kept for incremental scheduling.
+          */
+        void clearSearchCache();
 
         // For debugging
         static void printJobs(const QList<SchedulerJob *> &jobs, const QDateTime &time, const QString &label = "");
@@ -153,6 +168,24 @@ class GreedyScheduler : public QObject
                                     QString *interruptReason = nullptr,
                                     const QMap<QString, uint16_t> *capturedFramesCount = nullptr);
 
+        // Fills startTimes[first..last[ with the next possible start times of the jobs that may be scheduled,
+        // searched in parallel, or an invalid time for the jobs that may not.
+        void searchStartTimes(const QList<SchedulerJob *> &jobs, int first, int last, const QDateTime &now,
+                              SchedulerJob *currentJob, QVector<QDateTime> &startTimes);
+
+        // SchedulerJob::getNextPossibleStartTime() and getNextEndTime(), through the search cache.
+        QDateTime nextPossibleStartTime(SchedulerJob *job, const QDateTime &from, bool runningJob);
+        QDateTime nextEndTime(SchedulerJob *job, const QDateTime &start, QString *reason, const QDateTime &until);
+
+        // Keys of the search cache, from the constraints of the job and the search times.
+        QString startTimeKey(SchedulerJob *job, const QDateTime &from);
+        const QString &jobSignature(SchedulerJob *job);
+
+        // Clears the search cache if incremental scheduling is off, or if something all searches depend on changed.
+        void checkSearchCache();
+        // Keeps the searches used since the last call for the next scheduling, and drops the others.
+        void rotateSearchCache();
+
         // Simulate the running of the scheduler from time to endTime.
         // Used to find which jobs will be run in the future.
         void simulate(const QList<SchedulerJob *> &jobs, const QDateTime &time,
@@ -166,6 +199,22 @@ class GreedyScheduler : public QObject
         bool rescheduleErrors {false};
         int abortDelaySeconds { 3600 };
         int errorDelaySeconds { 3600 };
+        bool incremental { false };
+
+        // Results of the constraint searches of jobs, keyed by what they depend on: the constraints of the job
+        // and the search times. Jobs that did not change since the previous scheduling find their searches here.
+        struct SearchCache
+        {
+            QHash<QString, QDateTime> startTimes;
+            QHash<QString, QPair<QDateTime, QString>> endTimes;
+        };
+        // Searches used since the last rotation, and those of the rotation before.
+        SearchCache searchCache;
+        SearchCache previousSearchCache;
+        // What all searches depend on, besides the jobs: location, options and artificial horizon.
+        QString searchEnvironment;
+        // SchedulerJob::getConstraintSignature() of the jobs, computed once per scheduling.
+        QHash<const SchedulerJob *, QString> jobSignatures;
 
         // These are values computed by scheduleJobs(), stored, and returned
         // by getScheduledJob() and getSchedule().
@@ -0,0 +1,216 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "nightephemeris.h"
+
+#include "ksmoon.h"
+#include "skyobject.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Nights kept for sharing, enough for the searches of a schedule spanning a few nights
+constexpr int kMaxNights = 8;
+// Nights kept by each track
+constexpr int kMaxTrackNights = 3;
+
+// Serializes the creation of nights and the computation of slots, which update the shared Moon and Earth
+QMutex s_Mutex;
+QList<std::shared_ptr<Ekos::NightEphemeris>> s_Nights;
+
+// Linear interpolation of an angle wrapping at period
+double interpolateAngle(double from, double to, double fraction, double period)
+{
+    double delta = std::fmod(to - from, period);
+    if (delta > period / 2)
+        delta -= period;
+    else if (delta < -period / 2)
+        delta += period;
+
+    double value = std::fmod(from + fraction * delta, period);
+    if (value < 0)
+        value += period;
+    return value;
+}
+}
+
+namespace Ekos
+{
+
+NightEphemeris::Slot::Slot(const KStarsDateTime &localTime, const GeoLocation &geo, KSMoon *moon)
+    : numbers(localTime.djd()), LST(geo.GSTtoLST(geo.LTtoUT(localTime).gst()))
+{
+    if (moon == nullptr)
+        return;
+
+    moon->updateCoords(&numbers, true, geo.lat(), &LST, true);
+    hasMoon = true;
+    this->moon = SkyPoint(moon->ra(), moon->dec());
+    moonAltitude = moon->alt().Degrees();
+    moonIllumination = moon->illum() * 100.0;
+}
+
+NightEphemeris::NightEphemeris(const GeoLocation &geo, const QDateTime &start, int stepMinutes, KSMoon *moon)
+    : m_Geo(geo), m_Start(start), m_StepMinutes(stepMinutes), m_Moon(moon)
+{
+    // One more slot than steps, so that the last time of the night interpolates between two slots. Nights
+    // are 23 or 25 hours long when daylight saving time starts or ends.
+    const qint64 minutes = start.secsTo(start.addDays(1)) / 60;
+    m_Slots.resize((minutes + stepMinutes - 1) / stepMinutes + 1);
+}
+
+std::shared_ptr<NightEphemeris> NightEphemeris::get(const GeoLocation *geo, const QDateTime &localTime, int stepMinutes,
+        KSMoon *moon)
+{
+    stepMinutes = std::max(1, stepMinutes);
+
+    QMutexLocker locker(&s_Mutex);
+    for (const auto &night : s_Nights)
+    {
+        if (night->matches(geo, localTime, stepMinutes, moon))
+            return night;
+    }
+
+    if (s_Nights.size() >= kMaxNights)
+        s_Nights.removeFirst();
+    s_Nights.append(std::shared_ptr<NightEphemeris>(new NightEphemeris(*geo, nightStart(localTime), stepMinutes, moon)));
+    return s_Nights.last();
+}
+
+void NightEphemeris::clearCache()
+{
+    QMutexLocker locker(&s_Mutex);
+    s_Nights.clear();
+}
+
+bool NightEphemeris::matches(const GeoLocation *geo, const QDateTime &localTime, int stepMinutes, const KSMoon *moon) const
+{
+    return stepMinutes == m_StepMinutes && moon == m_Moon &&
+           geo->lat()->Degrees() == m_Geo.lat()->Degrees() && geo->lng()->Degrees() == m_Geo.lng()->Degrees() &&
+           geo->TZ0() == m_Geo.TZ0() &&
+           m_Start <= localTime && localTime < m_Start.addDays(1) &&
+           localTime <= m_Start.addSecs(static_cast<qint64>(slotCount() - 1) * m_StepMinutes * 60);
+}
+
+const NightEphemeris::Slot &NightEphemeris::slot(int index)
+{
+    QMutexLocker locker(&s_Mutex);
+    std::unique_ptr<Slot> &slot = m_Slots[index];
+    if (!slot)
+        slot.reset(new Slot(KStarsDateTime(m_Start.addSecs(index * m_StepMinutes * 60)), m_Geo, m_Moon));
+    return *slot;
+}
+
+double NightEphemeris::slotPosition(const QDateTime &localTime) const
+{
+    return m_Start.msecsTo(localTime) / (m_StepMinutes * 60000.0);
+}
+
+QDateTime NightEphemeris::nightStart(const QDateTime &localTime)
+{
+    // Keeps the time spec of the argument, so that slot times compare with it
+    QDateTime start = localTime;
+    start.setTime(QTime(12, 0));
+    if (localTime < start)
+        start = start.addDays(-1);
+    return start;
+}
+
+TargetTrack::Position TargetTrack::at(const SkyPoint &target, const QDateTime &localTime, const GeoLocation *geo,
+                                      int stepMinutes, KSMoon *moon)
+{
+    stepMinutes = std::max(1, stepMinutes);
+
+    if (target.ra0().Degrees() != m_Target.ra0().Degrees() || target.dec0().Degrees() != m_Target.dec0().Degrees())
+    {
+        clear();
+        m_Target = target;
+    }
+
+    Night *night = nullptr;
+    for (auto &n : m_Nights)
+    {
+        if (n.ephemeris->matches(geo, localTime, stepMinutes, moon))
+        {
+            night = &n;
+            break;
+        }
+    }
+    if (night == nullptr)
+    {
+        if (m_Nights.size() >= kMaxTrackNights)
+            m_Nights.removeFirst();
+
+        Night n;
+        n.ephemeris = NightEphemeris::get(geo, localTime, stepMinutes, moon);
+        n.positions.resize(n.ephemeris->slotCount());
+        n.computed.resize(n.ephemeris->slotCount(), false);
+        m_Nights.append(n);
+        night = &m_Nights.last();
+    }
+
+    const double slotPosition = night->ephemeris->slotPosition(localTime);
+    const int index = std::min(static_cast<int>(std::floor(slotPosition)), night->ephemeris->slotCount() - 2);
+    // Times past the last slot, which matches() does not accept, take its position rather than extrapolating
+    const double fraction = std::max(0.0, std::min(1.0, slotPosition - index));
+
+    const Position &from = position(*night, index);
+    if (fraction == 0)
+        return from;
+    const Position &to = position(*night, index + 1);
+
+    Position result = from;
+    result.altitude = from.altitude + fraction * (to.altitude - from.altitude);
+    result.azimuth = interpolateAngle(from.azimuth, to.azimuth, fraction, 360.0);
+    result.hourAngle = interpolateAngle(from.hourAngle, to.hourAngle, fraction, 24.0);
+    result.moonSeparation = from.moonSeparation + fraction * (to.moonSeparation - from.moonSeparation);
+    result.moonAltitude = from.moonAltitude + fraction * (to.moonAltitude - from.moonAltitude);
+    result.moonIllumination = from.moonIllumination + fraction * (to.moonIllumination - from.moonIllumination);
+    return result;
+}
+
+void TargetTrack::clear()
+{
+    m_Nights.clear();
+}
+
+const TargetTrack::Position &TargetTrack::position(Night &night, int index)
+{
+    Position &position = night.positions[index];
+    if (night.computed[index])
+        return position;
+
+    const NightEphemeris::Slot &slot = night.ephemeris->slot(index);
+
+    // Same computation as SchedulerJob::findAltitude, with the numbers and sidereal time of the slot
+    SkyObject o;
+    o.setRA0(m_Target.ra0());
+    o.setDec0(m_Target.dec0());
+    o.updateCoordsNow(&slot.numbers);
+    o.EquatorialToHorizontal(&slot.LST, night.ephemeris->geo().lat());
+
+    position.altitude = o.alt().Degrees();
+    position.azimuth = o.az().Degrees();
+    position.hourAngle = std::fmod(slot.LST.Hours() - o.ra().Hours() + 24.0, 24.0);
+
+    position.hasMoon = slot.hasMoon;
+    if (slot.hasMoon)
+    {
+        position.moonSeparation = slot.moon.angularDistanceTo(&o).Degrees();
+        position.moonAltitude = slot.moonAltitude;
+        position.moonIllumination = slot.moonIllumination;
+    }
+
+    night.computed[index] = true;
+    return position;
+}
+
+}
@@ -0,0 +1,142 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "cachingdms.h"
+#include "geolocation.h"
+#include "ksnumbers.h"
+#include "kstarsdatetime.h"
+#include "skypoint.h"
+
+#include <QDateTime>
+#include <QList>
+
+#include <memory>
+#include <vector>
+
+class KSMoon;
+
+namespace Ekos
+{
+
+/**
+ * @brief The NightEphemeris class
+ *
+ * Target-independent ephemeris of one night for the scheduler: for each time slot, a given number of minutes
+ * apart from local noon to the next local noon, the KSNumbers of the slot, its local sidereal time and the
+ * position of the Moon. These are the expensive parts of evaluating the altitude and Moon constraints of a
+ * job, and they are the same for all jobs.
+ *
+ * Nights are shared by all jobs through get(), keyed by the geographic location, the night and the step.
+ * Slots are computed the first time they are used, so a search that stops early only pays for the slots it
+ * looked at. Slot times are local times, computed as SchedulerJob does.
+ */
+class NightEphemeris
+{
+    public:
+        struct Slot
+        {
+            Slot(const KStarsDateTime &localTime, const GeoLocation &geo, KSMoon *moon);
+
+            KSNumbers numbers;
+            CachingDms LST;
+            bool hasMoon { false };
+            /** Apparent coordinates of the Moon */
+            SkyPoint moon;
+            double moonAltitude { 0 };
+            /** Illuminated fraction of the Moon, in percent */
+            double moonIllumination { 0 };
+        };
+
+        /**
+         * @brief get The shared night holding a local time, created if needed.
+         * @param moon Moon object to update for the positions of the Moon, nullptr to ignore the Moon.
+         */
+        static std::shared_ptr<NightEphemeris> get(const GeoLocation *geo, const QDateTime &localTime, int stepMinutes,
+                KSMoon *moon);
+
+        /** Drop all shared nights. Nights still in use by a TargetTrack stay valid. */
+        static void clearCache();
+
+        /** @return true if the night is the one get() would return for these arguments. */
+        bool matches(const GeoLocation *geo, const QDateTime &localTime, int stepMinutes, const KSMoon *moon) const;
+
+        /** @return the slot at index, between 0 and slotCount() - 1, computed if needed. Thread-safe. */
+        const Slot &slot(int index);
+
+        /** @return the fractional index of the slot at a local time of the night. */
+        double slotPosition(const QDateTime &localTime) const;
+
+        int slotCount() const
+        {
+            return static_cast<int>(m_Slots.size());
+        }
+        const GeoLocation &geo() const
+        {
+            return m_Geo;
+        }
+
+    private:
+        NightEphemeris(const GeoLocation &geo, const QDateTime &start, int stepMinutes, KSMoon *moon);
+
+        // Local noon starting the night holding a local time
+        static QDateTime nightStart(const QDateTime &localTime);
+
+        GeoLocation m_Geo;
+        QDateTime m_Start;
+        int m_StepMinutes { 1 };
+        KSMoon *m_Moon { nullptr };
+        // Null until computed, the last slot is the first one of the next night
+        std::vector<std::unique_ptr<Slot>> m_Slots;
+};
+
+/**
+ * @brief The TargetTrack class
+ *
+ * Altitude, azimuth and Moon separation of a target through the nights of NightEphemeris, computed once per slot
+ * and linearly interpolated between slots. Each job owns its track, which is not thread-safe.
+ */
+class TargetTrack
+{
+    public:
+        struct Position
+        {
+            double altitude { 0 };
+            double azimuth { 0 };
+            /** Local sidereal time minus right ascension, in hours in [0, 24[, the target is setting below 12 */
+            double hourAngle { 0 };
+            bool hasMoon { false };
+            double moonSeparation { 180 };
+            double moonAltitude { 0 };
+            double moonIllumination { 0 };
+        };
+
+        /**
+         * @brief at Position of a target at a local time.
+         * @param target Catalog coordinates of the target. The track restarts if they change.
+         */
+        Position at(const SkyPoint &target, const QDateTime &localTime, const GeoLocation *geo, int stepMinutes,
+                    KSMoon *moon);
+
+        /** Drop the positions computed so far. */
+        void clear();
+
+    private:
+        struct Night
+        {
+            std::shared_ptr<NightEphemeris> ephemeris;
+            std::vector<Position> positions;
+            std::vector<bool> computed;
+        };
+
+        const Position &position(Night &night, int index);
+
+        SkyPoint m_Target;
+        QList<Night> m_Nights;
+};
+
+}
@@ -25,6 +25,7 @@
 #include "ekos/manager.h"
 #include "ekos/capture/sequencejob.h"
 #include "ekos/capture/placeholderpath.h"
+#include "ekos/capture/captureframeindex.h"
 #include "skyobjects/starobject.h"
 #include "greedyscheduler.h"
 
@@ -1980,6 +1981,7 @@ void Scheduler::syncGreedyParams()
         errorHandlingRescheduleErrorsCB->isChecked(),
         abortQueueSeconds,
         errorHandlingDelaySB->value());
+    m_GreedyScheduler->setIncremental(Options::greedyIncrementalScheduling());
 }
 
 void Scheduler::evaluateJobs(bool evaluateOnly)
@@ -7206,24 +7208,11 @@ SequenceJob * Scheduler::processJobInfo(XMLEle *root, SchedulerJob *schedJob)
 
 int Scheduler::getCompletedFiles(const QString &path, const QString &seqPrefix)
 {
-    int seqFileCount = 0;
     QFileInfo const path_info(path);
     QString const sig_dir(path_info.dir().path());
-    QString const sig_file(path_info.completeBaseName());
-    QDirIterator it(sig_dir, QDir::Files);
 
     /* FIXME: this counts all files with prefix in the storage location, not just captures. DSS analysis files are counted in, for instance. */
-    while (it.hasNext())
-    {
-        QString const fileName = QFileInfo(it.next()).completeBaseName();
-
-        if (fileName.startsWith(seqPrefix))
-        {
-            seqFileCount++;
-        }
-    }
-
-    return seqFileCount;
+    return CaptureFrameIndex::Instance()->count(sig_dir, seqPrefix);
 }
 
 void Scheduler::setINDICommunicationStatus(Ekos::CommunicationStatus status)
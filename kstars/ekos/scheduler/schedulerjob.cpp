@@ -190,6 +190,15 @@ ArtificialHorizon const *SchedulerJob::getHorizon()
     return &KStarsData::Instance()->skyComposite()->artificialHorizon()->getHorizon();
 }
 
+void SchedulerJob::prepareConcurrentSearches()
+{
+    // The artificial horizon precomputes its constraints on the first query, writing to a table that
+    // concurrent queries would read while it is filled
+    const ArtificialHorizon *horizon = getHorizon();
+    if (horizon != nullptr)
+        horizon->altitudeConstraint(0);
+}
+
 void SchedulerJob::setStartupCondition(const StartupCondition &value)
 {
     startupCondition = value;
@@ -1054,10 +1063,16 @@ int16_t SchedulerJob::getMoonSeparationScore(QDateTime const &when) const
     // Moon/Sky separation p
     double const separation = moon->angularDistanceTo(&o).Degrees();
 
+    return moonSeparationScore(separation, moonAltitude, o.alt().Degrees(), illum);
+}
+
+int16_t SchedulerJob::moonSeparationScore(double separation, double moonAltitude, double targetAltitude,
+        double illum) const
+{
     // Zenith distance of the moon
     double const zMoon = (90 - moonAltitude);
     // Zenith distance of target
-    double const zTarget = (90 - o.alt().Degrees());
+    double const zTarget = (90 - targetAltitude);
 
     int16_t score = 0;
 
@@ -1135,14 +1150,8 @@ QDateTime SchedulerJob::calculateNextTime(QDateTime const &when, bool checkIfCon
                           Qt::UTC == when.timeSpec() ? getGeo()->UTtoLT(KStarsDateTime(when)) : when :
                           getLocalTime());
 
-    // Create a sky object with the target catalog coordinates
+    // Catalog coordinates of the target
     SkyPoint const target = getTargetCoords();
-    SkyObject o;
-    o.setRA0(target.ra0());
-    o.setDec0(target.dec0());
-
-    // Calculate the UT at the argument time
-    KStarsDateTime const ut = getGeo()->LTtoUT(ltWhen);
 
     double const SETTING_ALTITUDE_CUTOFF = Options::settingAltitudeCutoff();
 
@@ -1180,15 +1189,10 @@ QDateTime SchedulerJob::calculateNextTime(QDateTime const &when, bool checkIfCon
             }
         }
 
-        // Update RA/DEC of the target for the current fraction of the day
-        KSNumbers numbers(ltOffset.djd());
-        o.updateCoordsNow(&numbers);
-
-        // Compute local sidereal time for the current fraction of the day, calculate altitude
-        CachingDms const LST = getGeo()->GSTtoLST(getGeo()->LTtoUT(ltOffset).gst());
-        o.EquatorialToHorizontal(&LST, getGeo()->lat());
-        double const altitude = o.alt().Degrees();
-        double const azimuth = o.az().Degrees();
+        // Position of the target and the Moon, from the ephemeris of the night shared by all jobs
+        Ekos::TargetTrack::Position const position = targetTrack.at(target, ltOffset, getGeo(), increment, moon);
+        double const altitude = position.altitude;
+        double const azimuth = position.azimuth;
         bool artificialHorizonConstrains = false;
         double const minAlt = getMinAltitudeConstraint(azimuth, &artificialHorizonConstrains);
 
@@ -1197,7 +1201,8 @@ QDateTime SchedulerJob::calculateNextTime(QDateTime const &when, bool checkIfCon
             // Don't test proximity to dawn in this situation, we only cater for altitude here
 
             // Continue searching if Moon separation is not good enough
-            if (0 < getMinMoonSeparation() && getMoonSeparationScore(ltOffset) < 0)
+            if (0 < getMinMoonSeparation() && position.hasMoon &&
+                    moonSeparationScore(position.moonSeparation, position.moonAltitude, altitude, position.moonIllumination) < 0)
             {
                 if (checkIfConstraintsAreMet)
                     continue;
@@ -1213,12 +1218,8 @@ QDateTime SchedulerJob::calculateNextTime(QDateTime const &when, bool checkIfCon
             {
                 if (!runningJob)
                 {
-                    double offset = LST.Hours() - o.ra().Hours();
-                    if (24.0 <= offset)
-                        offset -= 24.0;
-                    else if (offset < 0.0)
-                        offset += 24.0;
-                    if (0.0 <= offset && offset < 12.0)
+                    // Hour angle of the target, below 12 hours it is setting
+                    if (position.hourAngle < 12.0)
                         if (altitude - SETTING_ALTITUDE_CUTOFF < minAlt)
                             continue;
                 }
@@ -1487,9 +1488,32 @@ const QString &SchedulerJob::getInitialFilter() const
     return m_InitialFilter;
 }
 
+SchedulerJob::StartTimeCache::StartTimeCache(const StartTimeCache &other)
+{
+    QMutexLocker locker(&other.mutex);
+    startComputations = other.startComputations;
+}
+
+SchedulerJob::StartTimeCache &SchedulerJob::StartTimeCache::operator=(const StartTimeCache &other)
+{
+    if (this != &other)
+    {
+        QList<StartTimeComputation> computations;
+        {
+            QMutexLocker locker(&other.mutex);
+            computations = other.startComputations;
+        }
+        QMutexLocker locker(&mutex);
+        startComputations = computations;
+    }
+    return *this;
+}
+
 bool SchedulerJob::StartTimeCache::check(const QDateTime &from, const QDateTime &until,
         QDateTime *result, QDateTime *newFrom) const
 {
+    QMutexLocker locker(&mutex);
+
     // Look at the cached results from getNextPossibleStartTime.
     // If the desired 'from' time is in one of them, that is, between computation.from and computation.until,
     // then we can re-use that result (as long as the desired until time is < computation.until).
@@ -1520,15 +1544,12 @@ bool SchedulerJob::StartTimeCache::check(const QDateTime &from, const QDateTime
 
 void SchedulerJob::StartTimeCache::clear() const
 {
+    QMutexLocker locker(&mutex);
     startComputations.clear();
 }
 
 void SchedulerJob::StartTimeCache::add(const QDateTime &from, const QDateTime &until, const QDateTime &result) const
 {
-    // Manage the cache size.
-    if (startComputations.size() > 10)
-        startComputations.clear();
-
     // The getNextPossibleStartTime computation (which calls calculateNextTime) searches ahead at most 24 hours.
     QDateTime endTime;
     if (!until.isValid())
@@ -1546,6 +1567,11 @@ void SchedulerJob::StartTimeCache::add(const QDateTime &from, const QDateTime &u
     c.from = from;
     c.until = endTime;
     c.result = result;
+
+    QMutexLocker locker(&mutex);
+    // Manage the cache size.
+    if (startComputations.size() > 10)
+        startComputations.clear();
     startComputations.push_back(c);
 }
 
@@ -1595,6 +1621,49 @@ QDateTime SchedulerJob::getNextPossibleStartTime(const QDateTime &when, int incr
     }
 }
 
+QString SchedulerJob::getConstraintSignature() const
+{
+    auto const time = [](const QDateTime & t)
+    {
+        return t.isValid() ? QString::number(t.toMSecsSinceEpoch()) : QString("-");
+    };
+
+    SkyPoint const target = getTargetCoords();
+    return QStringList(
+    {
+        QString::number(target.ra0().Degrees(), 'g', 17), QString::number(target.dec0().Degrees(), 'g', 17),
+        QString::number(getMinAltitude(), 'g', 17), QString::number(getMinMoonSeparation(), 'g', 17),
+        QString::number(getEnforceTwilight()), QString::number(getEnforceArtificialHorizon()),
+        QString::number(getFileStartupCondition()), time(getFileStartupTime()),
+        QString::number(getCompletionCondition()), time(getCompletionTime()),
+        QString::number(moon != nullptr)
+    }).join(' ');
+}
+
+QString SchedulerJob::getConstraintEnvironment()
+{
+    QStringList environment;
+
+    GeoLocation const *geo = getGeo();
+    if (geo != nullptr)
+        environment << QString::number(geo->lat()->Degrees(), 'g', 17) << QString::number(geo->lng()->Degrees(), 'g', 17)
+                    << QString::number(geo->TZ0(), 'g', 17) << QString::number(geo->elevation(), 'g', 17);
+
+    environment << QString::number(Options::settingAltitudeCutoff(), 'g', 17) << QString::number(Options::preDawnTime(), 'g', 17)
+                << QString::number(Options::dawnOffset(), 'g', 17) << QString::number(Options::duskOffset(), 'g', 17)
+                << QString::number(Options::useRelativistic());
+
+    // The artificial horizon, sampled every degree of azimuth
+    ArtificialHorizon const *horizon = getHorizon();
+    if (horizon != nullptr)
+    {
+        for (int azimuth = 0; azimuth < 360; azimuth++)
+            environment << QString::number(horizon->altitudeConstraint(azimuth), 'g', 17);
+    }
+
+    return environment.join(' ');
+}
+
 // When will this job end (not looking at capture plan)?
 QDateTime SchedulerJob::getNextEndTime(const QDateTime &start, int increment, QString *reason, const QDateTime &until) const
 {
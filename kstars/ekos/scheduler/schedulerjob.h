@@ -7,9 +7,11 @@
 #pragma once
 
 #include "skypoint.h"
+#include "nightephemeris.h"
 
 #include <QUrl>
 #include <QMap>
+#include <QMutex>
 #include "ksmoon.h"
 #include "kstarsdatetime.h"
 
@@ -606,6 +608,20 @@ class SchedulerJob
         QDateTime getNextEndTime(const QDateTime &start, int increment = 1, QString *reason = nullptr,
                                  const QDateTime &until = QDateTime()) const;
 
+        /**
+             * @brief getConstraintSignature
+             * @return a string identifying the constraints of this job, equal for two jobs whose getNextPossibleStartTime()
+             * and getNextEndTime() return the same results, provided getConstraintEnvironment() does not change.
+             */
+        QString getConstraintSignature() const;
+
+        /**
+             * @brief getConstraintEnvironment
+             * @return a string identifying what the constraints of all jobs depend on: geographic location, options and
+             * artificial horizon.
+             */
+        static QString getConstraintEnvironment();
+
         /**
              * @brief calculateCulmination find culmination time adjust for the job offset
              * @param when date and time to start searching from, now if omitted
@@ -688,8 +704,19 @@ class SchedulerJob
         void clearCache()
         {
             startTimeCache.clear();
+            targetTrack.clear();
         }
+
+        /**
+         * @brief prepareConcurrentSearches Fill the tables that all jobs share and that are otherwise filled on
+         * first use, so that getNextPossibleStartTime() may then run for several jobs at once.
+         */
+        static void prepareConcurrentSearches();
     private:
+        // Score of getMoonSeparationScore() from the positions of the target and the Moon, illumination in percent.
+        int16_t moonSeparationScore(double separation, double moonAltitude, double targetAltitude,
+                                    double illumination) const;
+
         bool runsDuringAstronomicalNightTimeInternal(const QDateTime &time, QDateTime *minDawnDusk,
                 QDateTime *nextPossibleSuccess = nullptr) const;
 
@@ -834,6 +861,9 @@ class SchedulerJob
                 };
             public:
                 StartTimeCache() {}
+                // The mutex is not copied, only the cached computations.
+                StartTimeCache(const StartTimeCache &other);
+                StartTimeCache &operator=(const StartTimeCache &other);
                 // Check if the computation has been done, and if so, return the previous result.
                 bool check(const QDateTime &from, const QDateTime &until,
                            QDateTime *result, QDateTime *newFrom) const;
@@ -845,9 +875,15 @@ class SchedulerJob
                 // Made this mutable and all methods const so that the cache could be
                 // used in SchedulerJob const methods.
                 mutable QList<StartTimeComputation> startComputations;
+                // The Greedy scheduler searches the start times of several jobs in parallel.
+                mutable QMutex mutex;
         };
         StartTimeCache startTimeCache;
 
+        // Positions of the target through the shared night ephemerides, used by calculateNextTime().
+        // Mutable for the same reason as startTimeCache.
+        mutable Ekos::TargetTrack targetTrack;
+
         // These are used in testing, instead of KStars::Instance() resources
         static KStarsDateTime *storedLocalTime;
         static GeoLocation *storedGeo;
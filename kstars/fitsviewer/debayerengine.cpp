@@ -0,0 +1,297 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "debayerengine.h"
+
+#include "fitspixelbuffer.h"
+
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+// Smallest band worth a task of its own, in rows
+constexpr uint32_t kMinBandRows = 32;
+
+enum Color
+{
+    RED,
+    GREEN,
+    BLUE
+};
+
+// Color of the pixel at an even or odd row and column
+Color colorAt(dc1394color_filter_t filter, uint32_t row, uint32_t column)
+{
+    static const Color colors[4][2][2] =
+    {
+        { { RED, GREEN }, { GREEN, BLUE } },    // RGGB
+        { { GREEN, BLUE }, { RED, GREEN } },    // GBRG
+        { { GREEN, RED }, { BLUE, GREEN } },    // GRBG
+        { { BLUE, GREEN }, { GREEN, RED } }     // BGGR
+    };
+    return colors[filter - DC1394_COLOR_FILTER_MIN][row & 1][column & 1];
+}
+
+struct Band
+{
+    // Output rows
+    uint32_t begin;
+    uint32_t end;
+    dc1394error_t error;
+};
+
+// Where a decoded row goes
+template <typename T>
+struct Output
+{
+    T *rgb;
+    uint32_t width;
+    DebayerEngine::Layout layout;
+    size_t planeSize;
+
+    T *pixel(Color color, uint32_t row) const
+    {
+        return layout == DebayerEngine::PLANAR ? rgb + color * planeSize + size_t(row) * width
+               : rgb + size_t(row) * width * 3 + color;
+    }
+
+    void clearRow(uint32_t row) const
+    {
+        if (layout == DebayerEngine::PLANAR)
+        {
+            for (int c = RED; c <= BLUE; ++c)
+                memset(pixel(static_cast<Color>(c), row), 0, width * sizeof(T));
+        }
+        else
+            memset(pixel(RED, row), 0, width * 3 * sizeof(T));
+    }
+
+    // Copy a row of RGB triplets
+    void putRow(uint32_t row, const T *triplets) const
+    {
+        if (layout == DebayerEngine::INTERLEAVED)
+        {
+            memcpy(pixel(RED, row), triplets, width * 3 * sizeof(T));
+            return;
+        }
+
+        T * __restrict r = pixel(RED, row);
+        T * __restrict g = pixel(GREEN, row);
+        T * __restrict b = pixel(BLUE, row);
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            r[x] = triplets[3 * x];
+            g[x] = triplets[3 * x + 1];
+            b[x] = triplets[3 * x + 2];
+        }
+    }
+};
+
+// Bilinear interpolation of an interior row. The row holds green and another color, N, at
+// columns of parity nParity. The rows above and below hold green and the remaining color, M.
+template <typename T, int Stride>
+void bilinearRow(const T * __restrict up, const T * __restrict row, const T * __restrict down,
+                 T * __restrict outN, T * __restrict outG, T * __restrict outM, uint32_t width, uint32_t nParity)
+{
+    auto atN = [&](uint32_t x)
+    {
+        outN[x * Stride] = row[x];
+        outG[x * Stride] = static_cast<T>((up[x] + down[x] + row[x - 1] + row[x + 1] + 2) >> 2);
+        outM[x * Stride] = static_cast<T>((up[x - 1] + up[x + 1] + down[x - 1] + down[x + 1] + 2) >> 2);
+    };
+    auto atG = [&](uint32_t x)
+    {
+        outN[x * Stride] = static_cast<T>((row[x - 1] + row[x + 1] + 1) >> 1);
+        outG[x * Stride] = row[x];
+        outM[x * Stride] = static_cast<T>((up[x] + down[x] + 1) >> 1);
+    };
+
+    uint32_t x = 1;
+    if ((x & 1) != nParity)
+        atG(x++);
+    for (; x + 2 < width; x += 2)
+    {
+        atN(x);
+        atG(x + 1);
+    }
+    if (x + 1 < width)
+        atN(x);
+
+    // Black border, like the decoders of bayer.c
+    for (uint32_t edge : { 0u, width - 1 })
+        outN[edge * Stride] = outG[edge * Stride] = outM[edge * Stride] = 0;
+}
+
+template <typename T>
+void bilinearBand(const T *bayer, const Output<T> &output, uint32_t height, dc1394color_filter_t filter, Band &band)
+{
+    const uint32_t width = output.width;
+    for (uint32_t y = band.begin; y < band.end; ++y)
+    {
+        if (y == 0 || y + 1 == height || width < 3)
+        {
+            output.clearRow(y);
+            continue;
+        }
+
+        const uint32_t nParity = colorAt(filter, y, 0) == GREEN ? 1 : 0;
+        const Color n = colorAt(filter, y, nParity);
+        const Color m = n == RED ? BLUE : RED;
+        const T *row = bayer + size_t(y) * width;
+
+        if (output.layout == DebayerEngine::PLANAR)
+            bilinearRow<T, 1>(row - width, row, row + width, output.pixel(n, y), output.pixel(GREEN, y),
+                              output.pixel(m, y), width, nParity);
+        else
+            bilinearRow<T, 3>(row - width, row, row + width, output.pixel(n, y), output.pixel(GREEN, y),
+                              output.pixel(m, y), width, nParity);
+    }
+    band.error = DC1394_SUCCESS;
+}
+
+dc1394error_t decodeRows(const uint8_t *bayer, uint8_t *rgb, uint32_t width, uint32_t height,
+                         dc1394color_filter_t filter, dc1394bayer_method_t method, uint32_t)
+{
+    return dc1394_bayer_decoding_8bit(bayer, rgb, width, height, filter, method);
+}
+
+dc1394error_t decodeRows(const uint16_t *bayer, uint16_t *rgb, uint32_t width, uint32_t height,
+                         dc1394color_filter_t filter, dc1394bayer_method_t method, uint32_t bits)
+{
+    return dc1394_bayer_decoding_16bit(bayer, rgb, width, height, filter, method, bits);
+}
+
+template <typename T>
+void haloBand(const T *bayer, const Output<T> &output, uint32_t height, dc1394color_filter_t filter,
+              dc1394bayer_method_t method, uint32_t bits, Band &band)
+{
+    const uint32_t width = output.width;
+    const uint32_t halo = DebayerEngine::halo(method);
+    // Even, so that the band starts with the same filter phase as the mosaic
+    const uint32_t first = band.begin > halo ? (band.begin - halo) & ~1u : 0;
+    const uint32_t last = std::min(height, band.end + halo);
+    const uint32_t rows = last - first;
+
+    FITSPixelBuffer scratch = FITSPixelBuffer::allocate(qint64(rows) * width * 3 * sizeof(T));
+    if (scratch.isNull())
+    {
+        band.error = DC1394_MEMORY_ALLOCATION_FAILURE;
+        return;
+    }
+
+    // Some decoders leave borders alone or read them before writing them
+    T *triplets = reinterpret_cast<T *>(scratch.data());
+    memset(triplets, 0, size_t(rows) * width * 3 * sizeof(T));
+    band.error = decodeRows(bayer + size_t(first) * width, triplets, width, rows, filter, method, bits);
+    if (band.error != DC1394_SUCCESS)
+        return;
+
+    for (uint32_t y = band.begin; y < band.end; ++y)
+        output.putRow(y, triplets + size_t(y - first) * width * 3);
+}
+
+template <typename T>
+dc1394error_t decodeBands(const T *bayer, const Output<T> &output, uint32_t height, dc1394color_filter_t filter,
+                          dc1394bayer_method_t method, uint32_t bits)
+{
+    if (filter < DC1394_COLOR_FILTER_MIN || filter > DC1394_COLOR_FILTER_MAX)
+        return DC1394_INVALID_COLOR_FILTER;
+    if (method < DC1394_BAYER_METHOD_MIN || method > DC1394_BAYER_METHOD_MAX)
+        return DC1394_INVALID_BAYER_METHOD;
+    if (bayer == nullptr || output.rgb == nullptr || output.width == 0 || height == 0)
+        return DC1394_INVALID_ARGUMENT_VALUE;
+
+    // Downsampled pixels are packed at the start of the buffer, as bayer.c does
+    if (method == DC1394_BAYER_METHOD_DOWNSAMPLE)
+    {
+        if (output.layout == DebayerEngine::INTERLEAVED)
+            return decodeRows(bayer, output.rgb, output.width, height, filter, method, bits);
+
+        Band band { 0, height, DC1394_SUCCESS };
+        haloBand(bayer, output, height, filter, method, bits, band);
+        return band.error;
+    }
+
+    const uint32_t tasks = std::max(1, QThread::idealThreadCount()) * 4;
+    uint32_t bandRows = std::max(kMinBandRows, (height + tasks - 1) / tasks);
+    bandRows += bandRows & 1;
+
+    QVector<Band> bands;
+    for (uint32_t begin = 0; begin < height; begin += bandRows)
+        bands.append({ begin, std::min(height, begin + bandRows), DC1394_SUCCESS });
+
+    if (method == DC1394_BAYER_METHOD_BILINEAR)
+    {
+        QtConcurrent::blockingMap(bands, [&](Band & band)
+        {
+            bilinearBand(bayer, output, height, filter, band);
+        });
+    }
+    else
+    {
+        // AHD fills tables of bayer.c on first use, without locking. Do that before going parallel.
+        int start = 0;
+        if (method == DC1394_BAYER_METHOD_AHD)
+        {
+            haloBand(bayer, output, height, filter, method, bits, bands[0]);
+            start = 1;
+        }
+
+        QtConcurrent::blockingMap(bands.begin() + start, bands.end(), [&](Band & band)
+        {
+            haloBand(bayer, output, height, filter, method, bits, band);
+        });
+    }
+
+    for (const Band &band : bands)
+    {
+        if (band.error != DC1394_SUCCESS)
+            return band.error;
+    }
+    return DC1394_SUCCESS;
+}
+}
+
+uint32_t DebayerEngine::halo(dc1394bayer_method_t method)
+{
+    switch (method)
+    {
+        case DC1394_BAYER_METHOD_NEAREST:
+        case DC1394_BAYER_METHOD_SIMPLE:
+        case DC1394_BAYER_METHOD_BILINEAR:
+            return 2;
+        case DC1394_BAYER_METHOD_HQLINEAR:
+        case DC1394_BAYER_METHOD_EDGESENSE:
+        case DC1394_BAYER_METHOD_VNG:
+            return 4;
+        case DC1394_BAYER_METHOD_AHD:
+            return 8;
+        case DC1394_BAYER_METHOD_DOWNSAMPLE:
+        default:
+            return 0;
+    }
+}
+
+dc1394error_t DebayerEngine::decode(const uint8_t *bayer, uint8_t *rgb, uint32_t width, uint32_t height,
+                                    dc1394color_filter_t filter, dc1394bayer_method_t method,
+                                    Layout layout, size_t planeSize)
+{
+    const Output<uint8_t> output { rgb, width, layout, planeSize ? planeSize : size_t(width) * height };
+    return decodeBands(bayer, output, height, filter, method, 8);
+}
+
+dc1394error_t DebayerEngine::decode(const uint16_t *bayer, uint16_t *rgb, uint32_t width, uint32_t height,
+                                    dc1394color_filter_t filter, dc1394bayer_method_t method,
+                                    Layout layout, size_t planeSize, uint32_t bits)
+{
+    const Output<uint16_t> output { rgb, width, layout, planeSize ? planeSize : size_t(width) * height };
+    return decodeBands(bayer, output, height, filter, method, bits);
+}
@@ -0,0 +1,56 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "bayer.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class DebayerEngine
+ * @short Debayers a mosaic in parallel row bands.
+ *
+ * The mosaic is split in bands of rows, one task each. Bilinear interpolation has its own kernel
+ * that reads the mosaic directly and writes the requested layout. Its inner loop handles a pair
+ * of pixels at once without branches, so that the compiler vectorizes it.
+ *
+ * Other methods run the decoders of bayer.c on each band plus a halo of rows above and below,
+ * then copy the rows of the band to the output. The halo is wider than the support of the method
+ * and the border it clears, so the result matches that of decoding the whole mosaic at once.
+ * Bands start on even rows to keep the phase of the color filter. The downsampling method does
+ * not keep the geometry of the mosaic and is decoded in a single band.
+ */
+class DebayerEngine
+{
+    public:
+        enum Layout
+        {
+            /** Red, green and blue planes, planeSize samples apart, as FITSData stores them. */
+            PLANAR,
+            /** RGB triplets, as QImage::Format_RGB888 and the decoders of bayer.c store them. */
+            INTERLEAVED
+        };
+
+        /**
+         * @brief decode Debayer an 8-bit mosaic, blocking until done.
+         * @param bayer The mosaic, width x height samples.
+         * @param rgb The output, width x height pixels in the given layout.
+         * @param planeSize Distance between the planes of a planar output in samples, width x height if 0.
+         * @return DC1394_SUCCESS, or the error of the first band that failed.
+         */
+        static dc1394error_t decode(const uint8_t *bayer, uint8_t *rgb, uint32_t width, uint32_t height,
+                                    dc1394color_filter_t filter, dc1394bayer_method_t method,
+                                    Layout layout, size_t planeSize = 0);
+        /** @brief decode Debayer a 16-bit mosaic of which bits are significant, see above. */
+        static dc1394error_t decode(const uint16_t *bayer, uint16_t *rgb, uint32_t width, uint32_t height,
+                                    dc1394color_filter_t filter, dc1394bayer_method_t method,
+                                    Layout layout, size_t planeSize = 0, uint32_t bits = 16);
+
+        /** @return rows decoded above and below each band for the given method. */
+        static uint32_t halo(dc1394bayer_method_t method);
+};
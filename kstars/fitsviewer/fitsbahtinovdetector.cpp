@@ -12,6 +12,7 @@
 
 #include "fits_debug.h"
 #include "fitsbahtinovdetector.h"
+#include "hough/bahtinovhough.h"
 #include "hough/houghline.h"
 #include "fitsdata.h"
 
@@ -89,23 +90,119 @@ bool FITSBahtinovDetector::findBahtinovStar(const QRect &boundary)
     int subW = (boundary.isNull() ? m_ImageData->width() : boundary.width());
     int subH = (boundary.isNull() ? m_ImageData->height() : boundary.height());
 
+    QVector<HoughLine*> bahtinov_angles;
+    if (getValue("FAST_DETECTION", false).toBool())
+        bahtinov_angles = findLinesByGradient<T>(QRect(subX, subY, subW, subH));
+    else
+        bahtinov_angles = findLinesByRotation<T>(QRect(subX, subY, subW, subH));
+
+    // Proceed with focus offset calculation, but only when at least 3 lines have been detected
+    QVector<HoughLine*> top3Lines;
+    if (bahtinov_angles.size() >= 3)
+    {
+        HoughLine::getSortedTopThreeLines(bahtinov_angles, top3Lines);
+
+        // Debug output
+        qCDebug(KSTARS_FITS) << "Sorted bahtinov angles:";
+        foreach (HoughLine* ln, top3Lines)
+        {
+            ln->printHoughLine();
+        }
+
+        // Determine intersection between outer lines
+        HoughLine* oneLine = top3Lines[0];
+        HoughLine* otherLine = top3Lines[2];
+        QPointF intersection;
+        HoughLine::IntersectResult result = oneLine->Intersect(*otherLine, intersection);
+        if (result == HoughLine::INTERESECTING)
+        {
+
+            qCDebug(KSTARS_FITS) << "Intersection: " << intersection.x() << ", " << intersection.y();
+
+            // Determine offset between intersection and middle line
+            HoughLine* midLine = top3Lines[1];
+            QPointF intersectionOnMidLine;
+            double distance;
+            if (midLine->DistancePointLine(intersection, intersectionOnMidLine, distance))
+            {
+                qCDebug(KSTARS_FITS) << "Distance between intersection and midline is " << distance
+                                     << " at mid line point " << intersectionOnMidLine.x() << ", "
+                                     << intersectionOnMidLine.y();
+
+                // Add star center to selected stars
+                // Maximum Radius
+                int maxR = qMin(subW - 1, subH - 1) / 2;
+                BahtinovEdge* center  = new BahtinovEdge();
+                center->width = maxR / 3;
+                center->x     = subX + intersection.x();
+                center->y     = subY + intersection.y();
+                // Set distance value in HFR
+                center->HFR   = distance;
+
+                center->offset.setX(subX + intersectionOnMidLine.x());
+                center->offset.setY(subY + intersectionOnMidLine.y());
+                oneLine->Offset(subX, subY);
+                midLine->Offset(subX, subY);
+                otherLine->Offset(subX, subY);
+                center->line.append(*oneLine);
+                center->line.append(*midLine);
+                center->line.append(*otherLine);
+                starCenters.append(center);
+            }
+            else
+            {
+                qCWarning(KSTARS_FITS) << "Closest point does not fall within the line segment.";
+            }
+        }
+        else
+        {
+            qCWarning(KSTARS_FITS) << "Lines are not intersecting (result: " << result << ")";
+        }
+    }
+
+    // Clean up Bahtinov line array (of pointers) as they are no longer needed
+    for (int index = 0; index < bahtinov_angles.size(); index++)
+    {
+        HoughLine* pLineAverage = bahtinov_angles[index];
+        if (pLineAverage != nullptr)
+        {
+            delete pLineAverage;
+        }
+    }
+    bahtinov_angles.clear();
+
+    top3Lines.clear();
+
+    m_ImageData->setStarCenters(starCenters);
+
+    return true;
+}
+
+template <typename T>
+QVector<HoughLine*> FITSBahtinovDetector::findLinesByRotation(const QRect &box)
+{
+    int subX = box.x();
+    int subY = box.y();
+    int subW = box.width();
+    int subH = box.height();
+
     int BBP = m_ImageData->getBytesPerPixel();
     uint16_t dataWidth = m_ImageData->width();
 
-    // #1 Find offsets
+    // #1 Find size
     uint32_t size   = subW * subH;
-    uint32_t offset = subX + subY * dataWidth;
 
-    // #2 Create new buffer
-    auto * buffer = new uint8_t[size * BBP];
-    // If there is no offset, copy whole buffer in one go
-    if (offset == 0)
-    {
-        memcpy(buffer, m_ImageData->getImageBuffer(), size * BBP);
-    }
+    // #2 Share the pixels of the whole frame, copy a sub-frame into a new buffer
+    FITSPixelBuffer buffer;
+    if (subW == m_ImageData->width() && subH == m_ImageData->height())
+        buffer = m_ImageData->getPixelBuffer();
     else
     {
-        uint8_t * dataPtr = buffer;
+        buffer = FITSPixelBuffer::allocate(size * BBP);
+        if (buffer.isNull())
+            return QVector<HoughLine*>();
+
+        uint8_t * dataPtr = buffer.data();
         const uint8_t * origDataPtr = m_ImageData->getImageBuffer();
         // Copy data line by line
         for (int height = subY; height < (subY + subH); height++)
@@ -196,89 +293,62 @@ bool FITSBahtinovDetector::findBahtinovStar(const QRect &boundary)
         }
     }
 
-    // Proceed with focus offset calculation, but only when at least 3 lines have been detected
-    QVector<HoughLine*> top3Lines;
-    if (bahtinov_angles.size() >= 3)
-    {
-        HoughLine::getSortedTopThreeLines(bahtinov_angles, top3Lines);
+    // Clean up line averages array as they are no longer needed
+    lineAveragesPerAngle.clear();
 
-        // Debug output
-        qCDebug(KSTARS_FITS) << "Sorted bahtinov angles:";
-        foreach (HoughLine* ln, top3Lines)
+    return bahtinov_angles;
+}
+
+template <typename T>
+QVector<HoughLine*> FITSBahtinovDetector::findLinesByGradient(const QRect &box)
+{
+    const auto * buffer = reinterpret_cast<const T *>(m_ImageData->getImageBuffer());
+    const uint32_t channelSize = m_ImageData->samplesPerChannel();
+    const int numChannels = m_ImageData->channels();
+    const uint16_t dataWidth = m_ImageData->width();
+
+    // Average the channels of the box, as the rotation search does
+    QVector<float> luminance(box.width() * box.height());
+    for (int y = 0; y < box.height(); y++)
+    {
+        for (int x = 0; x < box.width(); x++)
         {
-            ln->printHoughLine();
+            const uint32_t index = (box.y() + y) * dataWidth + box.x() + x;
+            double sum = 0;
+            for (int i = 0; i < numChannels; i++)
+                sum += buffer[index + i * channelSize];
+            luminance[y * box.width() + x] = sum / numChannels;
         }
+    }
 
-        // Determine intersection between outer lines
-        HoughLine* oneLine = top3Lines[0];
-        HoughLine* otherLine = top3Lines[2];
-        QPointF intersection;
-        HoughLine::IntersectResult result = oneLine->Intersect(*otherLine, intersection);
-        if (result == HoughLine::INTERESECTING)
-        {
+    QElapsedTimer timer;
+    timer.start();
 
-            qCDebug(KSTARS_FITS) << "Intersection: " << intersection.x() << ", " << intersection.y();
+    BahtinovHough hough(luminance.constData(), box.width(), box.height());
+    QVector<HoughLine*> lines = hough.findSpikes(numberOfAverageRows());
 
-            // Determine offset between intersection and middle line
-            HoughLine* midLine = top3Lines[1];
-            QPointF intersectionOnMidLine;
-            double distance;
-            if (midLine->DistancePointLine(intersection, intersectionOnMidLine, distance))
-            {
-                qCDebug(KSTARS_FITS) << "Distance between intersection and midline is " << distance
-                                     << " at mid line point " << intersectionOnMidLine.x() << ", "
-                                     << intersectionOnMidLine.y();
+    qCDebug(KSTARS_FITS) << "Gradient oriented Hough transform took" << timer.elapsed() << "milliseconds";
 
-                // Add star center to selected stars
-                // Maximum Radius
-                int maxR = qMin(subW - 1, subH - 1) / 2;
-                BahtinovEdge* center  = new BahtinovEdge();
-                center->width = maxR / 3;
-                center->x     = subX + intersection.x();
-                center->y     = subY + intersection.y();
-                // Set distance value in HFR
-                center->HFR   = distance;
+    return lines;
+}
 
-                center->offset.setX(subX + intersectionOnMidLine.x());
-                center->offset.setY(subY + intersectionOnMidLine.y());
-                oneLine->Offset(subX, subY);
-                midLine->Offset(subX, subY);
-                otherLine->Offset(subX, subY);
-                center->line.append(*oneLine);
-                center->line.append(*midLine);
-                center->line.append(*otherLine);
-                starCenters.append(center);
-            }
-            else
-            {
-                qCWarning(KSTARS_FITS) << "Closest point does not fall within the line segment.";
-            }
-        }
-        else
-        {
-            qCWarning(KSTARS_FITS) << "Lines are not intersecting (result: " << result << ")";
-        }
+int FITSBahtinovDetector::numberOfAverageRows() const
+{
+    int NUMBER_OF_AVERAGE_ROWS = getValue("NUMBER_OF_AVERAGE_ROWS", 1).toInt();
+    if (NUMBER_OF_AVERAGE_ROWS % 2 == 0)
+    {
+        NUMBER_OF_AVERAGE_ROWS--;
+        qCWarning(KSTARS_FITS) << "Warning, number of rows must be an odd number, correcting number of rows to "
+                               << NUMBER_OF_AVERAGE_ROWS;
     }
-
-    // Clean up Bahtinov line array (of pointers) as they are no longer needed
-    for (int index = 0; index < bahtinov_angles.size(); index++)
+    // Rows must be a positive number!
+    if (NUMBER_OF_AVERAGE_ROWS < 1)
     {
-        HoughLine* pLineAverage = bahtinov_angles[index];
-        if (pLineAverage != nullptr)
-        {
-            delete pLineAverage;
-        }
+        NUMBER_OF_AVERAGE_ROWS = 1;
+        qCWarning(KSTARS_FITS) << "Warning, number of rows must be positive correcting number of rows to "
+                               << NUMBER_OF_AVERAGE_ROWS;
     }
-    bahtinov_angles.clear();
-
-    // Clean up line averages array as they are no longer needed
-    lineAveragesPerAngle.clear();
-
-    top3Lines.clear();
-
-    m_ImageData->setStarCenters(starCenters);
-
-    return true;
+    return NUMBER_OF_AVERAGE_ROWS;
 }
 
 template <typename T>
@@ -300,20 +370,7 @@ BahtinovLineAverage FITSBahtinovDetector::calculateMaxAverage(const FITSData *da
 
     //    printf("Angle;%d;Width;%d;Height;%d;Rows;%d;;RowSum;", angle, width, height, NUMBER_OF_AVERAGE_ROWS);
 
-    int NUMBER_OF_AVERAGE_ROWS = getValue("NUMBER_OF_AVERAGE_ROWS", 1).toInt();
-    if (NUMBER_OF_AVERAGE_ROWS % 2 == 0)
-    {
-        NUMBER_OF_AVERAGE_ROWS--;
-        qCWarning(KSTARS_FITS) << "Warning, number of rows must be an odd number, correcting number of rows to "
-                               << NUMBER_OF_AVERAGE_ROWS;
-    }
-    // Rows must be a positive number!
-    if (NUMBER_OF_AVERAGE_ROWS < 1)
-    {
-        NUMBER_OF_AVERAGE_ROWS = 1;
-        qCWarning(KSTARS_FITS) << "Warning, number of rows must be positive correcting number of rows to "
-                               << NUMBER_OF_AVERAGE_ROWS;
-    }
+    const int NUMBER_OF_AVERAGE_ROWS = numberOfAverageRows();
 
     for (int y = 0; y < height; y++)
     {
@@ -9,6 +9,8 @@
 
 #include "fitsstardetector.h"
 
+class HoughLine;
+
 class BahtinovLineAverage
 {
     public:
@@ -39,6 +41,8 @@ class FITSBahtinovDetector: public FITSStarDetector
         /** @brief Configure the detection method.
          * @see FITSStarDetector::configure().
          * @note Parameter "numaveragerows" defaults to NUMBER_OF_AVERAGE_ROWS of the mean pixel value of the frame.
+         * @note Parameter "FAST_DETECTION" selects the gradient oriented Hough transform of BahtinovHough instead of
+         * rotating the tracking box over all angles.
          * @todo Provide parameters for detection configuration.
          */
         //void configure(const QString &setting, const QVariant &value) override;
@@ -57,6 +61,15 @@ class FITSBahtinovDetector: public FITSStarDetector
         bool findBahtinovStar(const QRect &boundary);
 
     private:
+        /** @internal Find the lines of the spikes by rotating the box over 180 angles, one degree apart. */
+        template <typename T>
+        QVector<HoughLine*> findLinesByRotation(const QRect &box);
+        /** @internal Find the lines of the spikes with a gradient oriented Hough transform, refined below a degree. */
+        template <typename T>
+        QVector<HoughLine*> findLinesByGradient(const QRect &box);
+        /** @internal Validated setting NUMBER_OF_AVERAGE_ROWS, a positive odd number. */
+        int numberOfAverageRows() const;
+
         template <typename T>
         BahtinovLineAverage calculateMaxAverage(const FITSData *data, int angle);
         template <typename T>
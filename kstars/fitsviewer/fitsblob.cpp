@@ -0,0 +1,161 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "fitsblob.h"
+
+#include <QMutexLocker>
+#include <QtConcurrent>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+// Pixels are converted in chunks of that many bytes, in parallel when adopted and
+// through a scratch buffer when written.
+constexpr qint64 kChunkSize = 4 * 1024 * 1024;
+
+// FITS pixels are big endian. Unsigned integers are stored as signed with BZERO = 2^(bits - 1),
+// which amounts to flipping the sign bit.
+template <typename T>
+void fromFITS(uint8_t *bytes, qint64 count, T flip)
+{
+    T *values = reinterpret_cast<T *>(bytes);
+    for (qint64 i = 0; i < count; ++i)
+        values[i] = qFromBigEndian(values[i]) ^ flip;
+}
+
+template <typename T>
+void toFITS(uint8_t *bytes, qint64 count, T flip)
+{
+    T *values = reinterpret_cast<T *>(bytes);
+    for (qint64 i = 0; i < count; ++i)
+        values[i] = qToBigEndian(static_cast<T>(values[i] ^ flip));
+}
+
+void convert(uint8_t *bytes, qint64 count, int bytesPerPixel, bool signFlip, bool native)
+{
+    switch (bytesPerPixel)
+    {
+        case 2:
+        {
+            const uint16_t flip = signFlip ? 0x8000 : 0;
+            native ? fromFITS<uint16_t>(bytes, count, flip) : toFITS<uint16_t>(bytes, count, flip);
+            break;
+        }
+        case 4:
+        {
+            const uint32_t flip = signFlip ? 0x80000000u : 0;
+            native ? fromFITS<uint32_t>(bytes, count, flip) : toFITS<uint32_t>(bytes, count, flip);
+            break;
+        }
+        case 8:
+            native ? fromFITS<uint64_t>(bytes, count, 0) : toFITS<uint64_t>(bytes, count, 0);
+            break;
+        default:
+            break;
+    }
+}
+
+bool writeAll(QIODevice *device, const char *data, qint64 size)
+{
+    while (size > 0)
+    {
+        const qint64 n = device->write(data, size);
+        if (n <= 0)
+            return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+}
+
+FITSBlob::FITSBlob(const char *data, int size) : m_Data(data, size)
+{
+    m_Bytes = m_Data.data();
+}
+
+uint8_t *FITSBlob::adoptPixels(qint64 offset, qint64 count, int bytesPerPixel, bool signFlip)
+{
+    if (isAdopted() || offset < 0 || count <= 0 || offset + count * bytesPerPixel > m_Data.size())
+        return nullptr;
+    if (bytesPerPixel != 1 && bytesPerPixel != 2 && bytesPerPixel != 4 && bytesPerPixel != 8)
+        return nullptr;
+
+    uint8_t *pixels = reinterpret_cast<uint8_t *>(m_Bytes + offset);
+    if (reinterpret_cast<quintptr>(pixels) % bytesPerPixel != 0)
+        return nullptr;
+
+    waitForWrite();
+
+    if (bytesPerPixel > 1)
+    {
+        const qint64 chunkPixels = kChunkSize / bytesPerPixel;
+        QVector<qint64> starts;
+        for (qint64 start = 0; start < count; start += chunkPixels)
+            starts.append(start);
+
+        QtConcurrent::blockingMap(starts, [&](qint64 start)
+        {
+            convert(pixels + start * bytesPerPixel, std::min(chunkPixels, count - start), bytesPerPixel, signFlip, true);
+        });
+    }
+
+    m_PixelOffset   = offset;
+    m_PixelCount    = count;
+    m_BytesPerPixel = bytesPerPixel;
+    m_SignFlip      = signFlip;
+    return pixels;
+}
+
+bool FITSBlob::write(QIODevice *device) const
+{
+    if (!isAdopted() || m_BytesPerPixel == 1)
+        return writeAll(device, m_Bytes, m_Data.size());
+
+    // Header as is, then the adopted pixels converted back, then whatever follows them
+    if (!writeAll(device, m_Bytes, m_PixelOffset))
+        return false;
+
+    const qint64 pixelBytes = m_PixelCount * m_BytesPerPixel;
+    std::vector<uint64_t> scratch(kChunkSize / sizeof(uint64_t));
+    uint8_t *chunk = reinterpret_cast<uint8_t *>(scratch.data());
+
+    for (qint64 done = 0; done < pixelBytes; done += kChunkSize)
+    {
+        const qint64 bytes = std::min(kChunkSize, pixelBytes - done);
+        memcpy(chunk, m_Bytes + m_PixelOffset + done, bytes);
+        convert(chunk, bytes / m_BytesPerPixel, m_BytesPerPixel, m_SignFlip, false);
+        if (!writeAll(device, reinterpret_cast<const char *>(chunk), bytes))
+            return false;
+    }
+
+    const qint64 end = m_PixelOffset + pixelBytes;
+    return writeAll(device, m_Bytes + end, m_Data.size() - end);
+}
+
+void FITSBlob::beginWrite()
+{
+    QMutexLocker locker(&m_WriteMutex);
+    m_PendingWrites++;
+}
+
+void FITSBlob::endWrite()
+{
+    QMutexLocker locker(&m_WriteMutex);
+    if (--m_PendingWrites == 0)
+        m_WriteDone.wakeAll();
+}
+
+void FITSBlob::waitForWrite()
+{
+    QMutexLocker locker(&m_WriteMutex);
+    while (m_PendingWrites > 0)
+        m_WriteDone.wait(&m_WriteMutex);
+}
@@ -0,0 +1,88 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <cstdint>
+
+class QIODevice;
+
+/**
+ * @class FITSBlob
+ * @short A FITS file received in memory, shared by the FITSData that shows it and the writer that saves it.
+ *
+ * FITSData opens the blob with fits_open_memfile and may adopt the pixels of the primary image in
+ * place instead of reading them into a buffer of its own. Adopted pixels are converted once from
+ * the big endian FITS encoding to the native type, and the writer converts them back chunk by
+ * chunk as it saves the file. Both hold the blob through a QSharedPointer, so there is a single
+ * copy of the pixels for as long as either of them needs it.
+ *
+ * A blob is meant to be loaded by a single FITSData. Adopted pixels must not be modified while a
+ * write is pending, see waitForWrite(). Writers run on any thread and report with beginWrite()
+ * and endWrite().
+ */
+class FITSBlob
+{
+    public:
+        /** Copy a received blob, its memory may be reused as soon as this returns. */
+        FITSBlob(const char *data, int size);
+
+        /** @return the FITS file, with the adopted pixels in native encoding if any */
+        const QByteArray &data() const
+        {
+            return m_Data;
+        }
+        int size() const
+        {
+            return m_Data.size();
+        }
+
+        /**
+         * @brief adoptPixels Convert pixels of the file to the native type in place.
+         * @param offset Offset in bytes of the first pixel in the file.
+         * @param count Number of pixels.
+         * @param bytesPerPixel Size of one pixel, 1, 2, 4 or 8. Floating point pixels are swapped like integers.
+         * @param signFlip Flip the sign bit, for unsigned 16 and 32-bit pixels stored as signed with BZERO.
+         * @return the native pixels, or nullptr if the range does not fit the file or pixels were adopted already.
+         */
+        uint8_t *adoptPixels(qint64 offset, qint64 count, int bytesPerPixel, bool signFlip);
+        bool isAdopted() const
+        {
+            return m_PixelCount > 0;
+        }
+        /** @return the adopted pixels, nullptr if none */
+        const uint8_t *pixels() const
+        {
+            return isAdopted() ? reinterpret_cast<const uint8_t *>(m_Bytes + m_PixelOffset) : nullptr;
+        }
+
+        /** Write the file in FITS encoding. @return false on I/O errors */
+        bool write(QIODevice *device) const;
+
+        /** Mark a write as pending from the time it is queued, until endWrite(). */
+        void beginWrite();
+        void endWrite();
+        /** Block until no write is pending. Call before modifying adopted pixels. */
+        void waitForWrite();
+
+    private:
+        QByteArray m_Data;
+        // Detached pointer to m_Data, m_Data is never shared so that it stays valid
+        char *m_Bytes { nullptr };
+
+        qint64 m_PixelOffset { 0 };
+        qint64 m_PixelCount { 0 };
+        int m_BytesPerPixel { 0 };
+        bool m_SignFlip { false };
+
+        QMutex m_WriteMutex;
+        QWaitCondition m_WriteDone;
+        int m_PendingWrites { 0 };
+};
@@ -8,6 +8,8 @@
 */
 
 #include "fitsdata.h"
+#include "debayerengine.h"
+#include "imagetransform.h"
 #include "fitsbahtinovdetector.h"
 #include "fitsthresholddetector.h"
 #include "fitsgradientdetector.h"
@@ -25,6 +27,8 @@
 
 #include <KFormat>
 #include <QApplication>
+#include <QBuffer>
+#include <QElapsedTimer>
 #include <QImage>
 #include <QtConcurrent>
 #include <QImageReader>
@@ -85,9 +89,9 @@ FITSData::FITSData(const QSharedPointer<FITSData> &other)
     this->m_Mode = other->m_Mode;
     this->m_Statistics.channels = other->m_Statistics.channels;
     memcpy(&m_Statistics, &(other->m_Statistics), sizeof(m_Statistics));
-    m_ImageBuffer = new uint8_t[m_Statistics.samples_per_channel * m_Statistics.channels * m_Statistics.bytesPerPixel];
-    memcpy(m_ImageBuffer, other->m_ImageBuffer,
-           m_Statistics.samples_per_channel * m_Statistics.channels * m_Statistics.bytesPerPixel);
+    // The pixels are shared until either image modifies them
+    m_ImageBuffer = other->m_ImageBuffer;
+    m_ImageBufferSize = other->m_ImageBufferSize;
 }
 
 FITSData::~FITSData()
@@ -140,6 +144,7 @@ void FITSData::loadCommon(const QString &inFilename)
         m_PackBuffer = nullptr;
         fptr = nullptr;
     }
+    m_Blob.reset();
 
     m_Filename = inFilename;
 }
@@ -151,6 +156,27 @@ bool FITSData::loadFromBuffer(const QByteArray &buffer, const QString &extension
     return privateLoad(buffer, extension, silent);
 }
 
+bool FITSData::loadFromBlob(const QSharedPointer<FITSBlob> &blob, const QString &extension, const QString &inFilename,
+                            bool silent)
+{
+    loadCommon(inFilename);
+    qCDebug(KSTARS_FITS) << "Reading file blob (" << KFormat().formatByteSize(blob->size()) << ")";
+
+    // Pixels adopted by another FITSData are no longer FITS encoded, read them back through the writer
+    if (blob->isAdopted())
+    {
+        QBuffer encoded;
+        encoded.open(QIODevice::WriteOnly);
+        blob->write(&encoded);
+        return privateLoad(encoded.data(), extension, silent);
+    }
+
+    // Compressed blobs are unpacked to a buffer of their own, nothing to adopt
+    if (!extension.contains(".fz"))
+        m_Blob = blob;
+    return privateLoad(blob->data(), extension, silent);
+}
+
 QFuture<bool> FITSData::loadFromFile(const QString &inFilename, bool silent)
 {
     loadCommon(inFilename);
@@ -198,8 +224,12 @@ bool FITSData::loadFITSImage(const QByteArray &buffer, const QString &extension,
     int status = 0, anynull = 0;
     long naxes[3];
     QString errMessage;
+    QElapsedTimer timer;
+    timer.start();
 
     m_HistogramConstructed = false;
+    m_SampleHistograms.clear();
+    m_ParseTime = m_StatsTime = 0;
 
     if (extension.contains(".fz"))
     {
@@ -386,29 +416,34 @@ bool FITSData::loadFITSImage(const QByteArray &buffer, const QString &extension,
     if ( (m_Mode != FITS_NORMAL && m_Mode != FITS_CALIBRATE) || !Options::auto3DCube())
         m_Statistics.channels = 1;
 
-    m_ImageBufferSize = m_Statistics.samples_per_channel * m_Statistics.channels * m_Statistics.bytesPerPixel;
-    m_ImageBuffer = new uint8_t[m_ImageBufferSize];
-    if (m_ImageBuffer == nullptr)
-    {
-        qCWarning(KSTARS_FITS) << "FITSData: Not enough memory for image_buffer channel. Requested: "
-                               << m_ImageBufferSize << " bytes.";
-        clearImageBuffers();
-        free(m_PackBuffer);
-        m_PackBuffer = nullptr;
-        return false;
-    }
-
     rotCounter     = 0;
     flipHCounter   = 0;
     flipVCounter   = 0;
     long nelements = m_Statistics.samples_per_channel * m_Statistics.channels;
 
-    if (fits_read_img(fptr, m_Statistics.dataType, 1, nelements, nullptr, m_ImageBuffer, &anynull, &status))
+    m_ImageBufferSize = m_Statistics.samples_per_channel * m_Statistics.channels * m_Statistics.bytesPerPixel;
+
+    // Pixels of a blob are used in place if possible, otherwise read into a buffer of our own
+    if (!adoptBlobPixels(nelements))
     {
-        recordLastError(status);
-        free(m_PackBuffer);
-        m_PackBuffer = nullptr;
-        return fitsOpenError(status, i18n("Error reading image."), silent);
+        m_ImageBuffer = FITSPixelBuffer::allocate(m_ImageBufferSize);
+        if (m_ImageBuffer.isNull())
+        {
+            qCWarning(KSTARS_FITS) << "FITSData: Not enough memory for image_buffer channel. Requested: "
+                                   << m_ImageBufferSize << " bytes.";
+            clearImageBuffers();
+            free(m_PackBuffer);
+            m_PackBuffer = nullptr;
+            return false;
+        }
+
+        if (fits_read_img(fptr, m_Statistics.dataType, 1, nelements, nullptr, m_ImageBuffer.data(), &anynull, &status))
+        {
+            recordLastError(status);
+            free(m_PackBuffer);
+            m_PackBuffer = nullptr;
+            return fitsOpenError(status, i18n("Error reading image."), silent);
+        }
     }
 
     parseHeader();
@@ -423,21 +458,28 @@ bool FITSData::loadFITSImage(const QByteArray &buffer, const QString &extension,
 
     // Only check for debayed IF the original naxes[2] is 1
     // which is for single channels.
+    bool computeStats = true;
     if (naxes[2] == 1 && m_Statistics.channels == 1 && Options::autoDebayer() && checkDebayer())
     {
         // Save bayer image on disk in case we need to save it later since debayer destorys this data
         if (m_isTemporary && m_TemporaryDataFile.open())
         {
-            m_TemporaryDataFile.write(buffer);
+            // Adopted pixels must be converted back
+            if (m_Blob)
+                m_Blob->write(&m_TemporaryDataFile);
+            else
+                m_TemporaryDataFile.write(buffer);
             m_TemporaryDataFile.close();
             m_Filename = m_TemporaryDataFile.fileName();
         }
 
-        if (debayer())
-            calculateStats();
+        computeStats = debayer();
     }
-    else
+
+    m_ParseTime = timer.restart();
+    if (computeStats)
         calculateStats();
+    m_StatsTime = timer.elapsed();
 
     if (m_Mode == FITS_NORMAL || m_Mode == FITS_ALIGN)
         checkForWCS();
@@ -447,6 +489,57 @@ bool FITSData::loadFITSImage(const QByteArray &buffer, const QString &extension,
     return true;
 }
 
+bool FITSData::adoptBlobPixels(long nelements)
+{
+    if (!m_Blob)
+        return false;
+
+    int status = 0;
+    LONGLONG headStart = 0, dataStart = 0, dataEnd = 0;
+    if (fits_is_compressed_image(fptr, &status) || fits_get_hduaddrll(fptr, &headStart, &dataStart, &dataEnd, &status))
+        return false;
+
+    // Only pixels that fits_read_img would not scale can be used as they are
+    double bzero = 0, bscale = 1;
+    if (fits_read_key_dbl(fptr, "BZERO", &bzero, nullptr, &status) == KEY_NO_EXIST)
+        status = 0;
+    if (fits_read_key_dbl(fptr, "BSCALE", &bscale, nullptr, &status) == KEY_NO_EXIST)
+        status = 0;
+    if (status != 0 || bscale != 1)
+        return false;
+
+    bool signFlip = false;
+    switch (m_Statistics.dataType)
+    {
+        case TUSHORT:
+        case TULONG:
+            // Stored as signed integers offset by 2^15 or 2^31
+            signFlip = true;
+            if (bzero != (m_Statistics.bytesPerPixel == 2 ? 32768.0 : 2147483648.0))
+                return false;
+            break;
+        case TBYTE:
+        case TFLOAT:
+        case TLONGLONG:
+        case TDOUBLE:
+            if (bzero != 0)
+                return false;
+            break;
+        default:
+            return false;
+    }
+
+    if (dataEnd - dataStart < static_cast<LONGLONG>(nelements) * m_Statistics.bytesPerPixel)
+        return false;
+
+    uint8_t *pixels = m_Blob->adoptPixels(dataStart, nelements, m_Statistics.bytesPerPixel, signFlip);
+    if (pixels == nullptr)
+        return false;
+
+    m_ImageBuffer = FITSPixelBuffer::fromBlob(m_Blob, pixels, m_ImageBufferSize);
+    return true;
+}
+
 bool FITSData::loadCanonicalImage(const QByteArray &buffer, const QString &extension, bool silent)
 {
     // TODO need to add error popups as well later on
@@ -531,8 +624,8 @@ bool FITSData::loadCanonicalImage(const QByteArray &buffer, const QString &exten
     clearImageBuffers();
     m_ImageBufferSize = m_Statistics.samples_per_channel * m_Statistics.channels * static_cast<uint16_t>
                         (m_Statistics.bytesPerPixel);
-    m_ImageBuffer = new uint8_t[m_ImageBufferSize];
-    if (m_ImageBuffer == nullptr)
+    m_ImageBuffer = FITSPixelBuffer::allocate(m_ImageBufferSize);
+    if (m_ImageBuffer.isNull())
     {
         qCCritical(KSTARS_FITS) << QString("FITSData: Not enough memory for image_buffer channel. Requested: %1 bytes ").arg(
                                     m_ImageBufferSize);
@@ -542,12 +635,12 @@ bool FITSData::loadCanonicalImage(const QByteArray &buffer, const QString &exten
 
     if (m_Statistics.channels == 1)
     {
-        memcpy(m_ImageBuffer, imageFromFile.bits(), m_ImageBufferSize);
+        memcpy(m_ImageBuffer.data(), imageFromFile.bits(), m_ImageBufferSize);
     }
     else
     {
 
-        auto debayered_buffer = reinterpret_cast<uint8_t *>(m_ImageBuffer);
+        auto debayered_buffer = m_ImageBuffer.data();
         auto * original_bayered_buffer = reinterpret_cast<uint8_t *>(imageFromFile.bits());
 
         // Data in RGBA, with bytes in the order of B,G,R we need to copy them into 3 layers for FITS
@@ -647,8 +740,8 @@ bool FITSData::loadRAWImage(const QByteArray &buffer, const QString &extension,
     m_Statistics.samples_per_channel = m_Statistics.width * m_Statistics.height;
     clearImageBuffers();
     m_ImageBufferSize = m_Statistics.samples_per_channel * m_Statistics.channels * m_Statistics.bytesPerPixel;
-    m_ImageBuffer = new uint8_t[m_ImageBufferSize];
-    if (m_ImageBuffer == nullptr)
+    m_ImageBuffer = FITSPixelBuffer::allocate(m_ImageBufferSize);
+    if (m_ImageBuffer.isNull())
     {
         qCCritical(KSTARS_FITS) << QString("FITSData: Not enough memory for image_buffer channel. Requested: %1 bytes ").arg(
                                     m_ImageBufferSize);
@@ -657,7 +750,7 @@ bool FITSData::loadRAWImage(const QByteArray &buffer, const QString &extension,
         return false;
     }
 
-    auto destination_buffer = reinterpret_cast<uint8_t *>(m_ImageBuffer);
+    auto destination_buffer = m_ImageBuffer.data();
     auto source_buffer = reinterpret_cast<uint8_t *>(image->data);
 
     // For mono, we memcpy directly
@@ -975,8 +1068,9 @@ bool FITSData::saveImage(const QString &newFilename)
 
     rotCounter = flipHCounter = flipVCounter = 0;
 
-    // Here we need to use the actual data type
-    if (fits_write_img(fptr, m_Statistics.dataType, 1, nelements, m_ImageBuffer, &status))
+    // Here we need to use the actual data type. CFITSIO does not modify the pixels it writes.
+    if (fits_write_img(fptr, m_Statistics.dataType, 1, nelements, const_cast<uint8_t *>(m_ImageBuffer.constData()),
+                       &status))
     {
         recordLastError(status);
         return false;
@@ -993,13 +1087,18 @@ bool FITSData::saveImage(const QString &newFilename)
 
 void FITSData::clearImageBuffers()
 {
-    delete[] m_ImageBuffer;
-    m_ImageBuffer = nullptr;
+    // Pixels shared with other images or adopted from a blob stay with them
+    m_ImageBuffer.reset();
+    // The histograms describe the pixels, e.g. a single channel before debayering
+    m_SampleHistograms.clear();
     //m_BayerBuffer = nullptr;
 }
 
 void FITSData::calculateStats(bool refresh)
 {
+    // The image may have changed, it is scanned again if any statistic is missing from the header
+    m_SampleHistograms.clear();
+
     // Calculate min max
     calculateMinMax(refresh);
     calculateMedian(refresh);
@@ -1027,43 +1126,15 @@ void FITSData::calculateStats(bool refresh)
             return;
     }
 
-    // Get standard deviation and mean in one run
-    switch (m_Statistics.dataType)
-    {
-        case TBYTE:
-            runningAverageStdDev<uint8_t>();
-            break;
-
-        case TSHORT:
-            runningAverageStdDev<int16_t>();
-            break;
-
-        case TUSHORT:
-            runningAverageStdDev<uint16_t>();
-            break;
-
-        case TLONG:
-            runningAverageStdDev<int32_t>();
-            break;
-
-        case TULONG:
-            runningAverageStdDev<uint32_t>();
-            break;
-
-        case TFLOAT:
-            runningAverageStdDev<float>();
-            break;
-
-        case TLONGLONG:
-            runningAverageStdDev<int64_t>();
-            break;
-
-        case TDOUBLE:
-            runningAverageStdDev<double>();
-            break;
+    // Get standard deviation and mean from the same scan as min, max and median
+    const QVector<SampleHistogram> &histograms = getSampleHistograms();
+    if (histograms.isEmpty())
+        return;
 
-        default:
-            return;
+    for (int n = 0; n < histograms.size(); n++)
+    {
+        m_Statistics.mean[n]   = histograms[n].mean();
+        m_Statistics.stddev[n] = histograms[n].stddev();
     }
 
     // FIXME That's not really SNR, must implement a proper solution for this value
@@ -1108,51 +1179,11 @@ void FITSData::calculateMinMax(bool refresh)
             return;
     }
 
-    m_Statistics.min[0] = 1.0E30;
-    m_Statistics.max[0] = -1.0E30;
-
-    m_Statistics.min[1] = 1.0E30;
-    m_Statistics.max[1] = -1.0E30;
-
-    m_Statistics.min[2] = 1.0E30;
-    m_Statistics.max[2] = -1.0E30;
-
-    switch (m_Statistics.dataType)
+    const QVector<SampleHistogram> &histograms = getSampleHistograms();
+    for (int n = 0; n < 3; n++)
     {
-        case TBYTE:
-            calculateMinMax<uint8_t>();
-            break;
-
-        case TSHORT:
-            calculateMinMax<int16_t>();
-            break;
-
-        case TUSHORT:
-            calculateMinMax<uint16_t>();
-            break;
-
-        case TLONG:
-            calculateMinMax<int32_t>();
-            break;
-
-        case TULONG:
-            calculateMinMax<uint32_t>();
-            break;
-
-        case TFLOAT:
-            calculateMinMax<float>();
-            break;
-
-        case TLONGLONG:
-            calculateMinMax<int64_t>();
-            break;
-
-        case TDOUBLE:
-            calculateMinMax<double>();
-            break;
-
-        default:
-            break;
+        m_Statistics.min[n] = n < histograms.size() ? histograms[n].min() : 0;
+        m_Statistics.max[n] = n < histograms.size() ? histograms[n].max() : 0;
     }
 }
 
@@ -1182,137 +1213,67 @@ void FITSData::calculateMedian(bool refresh)
     m_Statistics.median[GREEN_CHANNEL] = 0;
     m_Statistics.median[BLUE_CHANNEL] = 0;
 
+    const QVector<SampleHistogram> &histograms = getSampleHistograms();
+    for (int n = 0; n < histograms.size(); n++)
+        m_Statistics.median[n] = histograms[n].median();
+}
+
+const QVector<SampleHistogram> &FITSData::getSampleHistograms()
+{
+    if (m_SampleHistograms.size() == m_Statistics.channels || m_ImageBuffer.isNull())
+        return m_SampleHistograms;
+
+    // Histograms left from another layout of the pixels, e.g. before debayering
+    m_SampleHistograms.clear();
+
     switch (m_Statistics.dataType)
     {
         case TBYTE:
-            calculateMedian<uint8_t>();
+            computeSampleHistograms<uint8_t>();
             break;
 
         case TSHORT:
-            calculateMedian<int16_t>();
+            computeSampleHistograms<int16_t>();
             break;
 
         case TUSHORT:
-            calculateMedian<uint16_t>();
+            computeSampleHistograms<uint16_t>();
             break;
 
         case TLONG:
-            calculateMedian<int32_t>();
+            computeSampleHistograms<int32_t>();
             break;
 
         case TULONG:
-            calculateMedian<uint32_t>();
+            computeSampleHistograms<uint32_t>();
             break;
 
         case TFLOAT:
-            calculateMedian<float>();
+            computeSampleHistograms<float>();
             break;
 
         case TLONGLONG:
-            calculateMedian<int64_t>();
+            computeSampleHistograms<int64_t>();
             break;
 
         case TDOUBLE:
-            calculateMedian<double>();
+            computeSampleHistograms<double>();
             break;
 
         default:
             break;
     }
-}
-
-template <typename T>
-void FITSData::calculateMedian()
-{
-    auto * buffer = reinterpret_cast<T *>(m_ImageBuffer);
-    const uint32_t maxMedianSize = 500000;
-    uint32_t medianSize = m_Statistics.samples_per_channel;
-    uint8_t downsample = 1;
-    if (medianSize > maxMedianSize)
-    {
-        downsample = (static_cast<double>(medianSize) / maxMedianSize) + 0.999;
-        medianSize /= downsample;
-    }
-    std::vector<T> samples;
-    samples.reserve(medianSize);
 
-    for (uint8_t n = 0; n < m_Statistics.channels; n++)
-    {
-        auto *oneChannel = buffer + n * m_Statistics.samples_per_channel;
-        for (uint32_t upto = 0; upto < m_Statistics.samples_per_channel; upto += downsample)
-            samples.push_back(oneChannel[upto]);
-        const uint32_t middle = samples.size() / 2;
-        std::nth_element(samples.begin(), samples.begin() + middle, samples.end());
-        m_Statistics.median[n] = samples[middle];
-    }
+    return m_SampleHistograms;
 }
 
 template <typename T>
-QPair<T, T> FITSData::getParitionMinMax(uint32_t start, uint32_t stride)
+void FITSData::computeSampleHistograms()
 {
-    auto * buffer = reinterpret_cast<T *>(m_ImageBuffer);
-    T min = std::numeric_limits<T>::max();
-    T max = std::numeric_limits<T>::min();
-
-    uint32_t end = start + stride;
-
-    for (uint32_t i = start; i < end; i++)
-    {
-        min = qMin(buffer[i], min);
-        max = qMax(buffer[i], max);
-        //        if (buffer[i] < min)
-        //            min = buffer[i];
-        //        else if (buffer[i] > max)
-        //            max = buffer[i];
-    }
-
-    return qMakePair(min, max);
-}
-
-template <typename T>
-void FITSData::calculateMinMax()
-{
-    T min = std::numeric_limits<T>::max();
-    T max = std::numeric_limits<T>::min();
-
-
-    // Create N threads
-    const uint8_t nThreads = 16;
-
+    auto * const buffer = reinterpret_cast<T const *>(m_ImageBuffer.constData());
     for (int n = 0; n < m_Statistics.channels; n++)
-    {
-        uint32_t cStart = n * m_Statistics.samples_per_channel;
-
-        // Calculate how many elements we process per thread
-        uint32_t tStride = m_Statistics.samples_per_channel / nThreads;
-
-        // Calculate the final stride since we can have some left over due to division above
-        uint32_t fStride = tStride + (m_Statistics.samples_per_channel - (tStride * nThreads));
-
-        // Start location for inspecting elements
-        uint32_t tStart = cStart;
-
-        // List of futures
-        QList<QFuture<QPair<T, T>>> futures;
-
-        for (int i = 0; i < nThreads; i++)
-        {
-            // Run threads
-            futures.append(QtConcurrent::run(this, &FITSData::getParitionMinMax<T>, tStart, (i == (nThreads - 1)) ? fStride : tStride));
-            tStart += tStride;
-        }
-
-        // Now wait for results
-        for (int i = 0; i < nThreads; i++)
-        {
-            QPair<T, T> result = futures[i].result();
-            min = qMin(result.first, min);
-            max = qMax(result.second, max);
-        }
-
-        m_Statistics.min[n] = min;
-        m_Statistics.max[n] = max;
-    }
+        m_SampleHistograms.append(SampleHistogram::compute(buffer + n * m_Statistics.samples_per_channel,
+                                  m_Statistics.samples_per_channel));
 }
 
 template <typename T>
@@ -1321,7 +1282,7 @@ QPair<double, double> FITSData::getSquaredSumAndMean(uint32_t start, uint32_t st
     uint32_t m_n       = 2;
     double m_oldM = 0, m_newM = 0, m_oldS = 0, m_newS = 0;
 
-    auto * buffer = reinterpret_cast<T *>(m_ImageBuffer);
+    auto * buffer = reinterpret_cast<T const *>(m_ImageBuffer.constData());
     uint32_t end = start + stride;
 
     for (uint32_t i = start; i < end; i++)
@@ -1417,7 +1378,7 @@ QVector<double> FITSData::createGaussianKernel(int size, double sigma)
 template <typename T>
 void FITSData::convolutionFilter(const QVector<double> &kernel, int kernelSize)
 {
-    T * imagePtr = reinterpret_cast<T *>(m_ImageBuffer);
+    T * imagePtr = reinterpret_cast<T *>(m_ImageBuffer.data());
 
     // Create variable for pixel data for each kernel
     T gt = 0;
@@ -1732,6 +1693,7 @@ QFuture<bool> FITSData::findStars(StarAlgorithm algorithm, const QRect &tracking
             m_StarDetector.reset(new FITSBahtinovDetector(this));
             m_StarDetector->setSettings(m_SourceExtractorSettings);
             m_StarDetector->configure("NUMBER_OF_AVERAGE_ROWS", Options::focusMultiRowAverage());
+            m_StarDetector->configure("FAST_DETECTION", Options::focusFastBahtinov());
             m_StarFindFuture = m_StarDetector->findSources(trackingBox);
             return m_StarFindFuture;
         }
@@ -2072,7 +2034,7 @@ void FITSData::applyFilter(FITSScale type, uint8_t * targetImage, QVector<double
         image = reinterpret_cast<T *>(targetImage);
     else
     {
-        image     = reinterpret_cast<T *>(m_ImageBuffer);
+        image     = reinterpret_cast<T *>(m_ImageBuffer.data());
         calcStats = true;
     }
 
@@ -2186,6 +2148,7 @@ void FITSData::applyFilter(FITSScale type, uint8_t * targetImage, QVector<double
                     m_Statistics.max[i] = max[i];
                 }
                 //if (type != FITS_AUTO && type != FITS_LINEAR)
+                m_SampleHistograms.clear();
                 runningAverageStdDev<T>();
                 //QtConcurrent::run(this, &FITSData::runningAverageStdDev<T>);
             }
@@ -2232,10 +2195,12 @@ void FITSData::applyFilter(FITSScale type, uint8_t * targetImage, QVector<double
         case FITS_MEDIAN:
         {
             uint8_t BBP      = m_Statistics.bytesPerPixel;
-            auto * extension = new T[(width + 2) * (height + 2)];
+            // Taken from the pool, as this runs on every guide frame
+            FITSPixelBuffer extensionBuffer = FITSPixelBuffer::allocate(sizeof(T) * (width + 2) * (height + 2));
             //   Check memory allocation
-            if (!extension)
+            if (extensionBuffer.isNull())
                 return;
+            auto * extension = reinterpret_cast<T *>(extensionBuffer.data());
             //   Create image extension
             for (uint32_t ch = 0; ch < m_Statistics.channels; ch++)
             {
@@ -2287,11 +2252,11 @@ void FITSData::applyFilter(FITSScale type, uint8_t * targetImage, QVector<double
                     }
             }
 
-            //   Free memory
-            delete[] extension;
-
             if (calcStats)
+            {
+                m_SampleHistograms.clear();
                 runningAverageStdDev<T>();
+            }
         }
         break;
 
@@ -2748,256 +2713,47 @@ void FITSData::setRotCounter(int value)
 
 /* Rotate an image by 90, 180, or 270 degrees, with an optional
  * reflection across the vertical or horizontal axis.
- * verbose generates extra info on stdout.
- * return nullptr if successful or rotated image.
+ * return false if the rotated image could not be allocated.
  */
 template <typename T>
 bool FITSData::rotFITS(int rotate, int mirror)
 {
-    int ny, nx;
-    int x1, y1, x2, y2;
-    uint8_t * rotimage = nullptr;
-    int offset        = 0;
-
-    if (rotate == 1)
-        rotate = 90;
-    else if (rotate == 2)
-        rotate = 180;
-    else if (rotate == 3)
-        rotate = 270;
-    else if (rotate < 0)
-        rotate = rotate + 360;
+    const ImageTransform transform = ImageTransform::fromRotation(rotate, mirror);
+    if (transform.isIdentity())
+        return true;
 
-    nx = m_Statistics.width;
-    ny = m_Statistics.height;
+    const uint32_t nx = m_Statistics.width;
+    const uint32_t ny = m_Statistics.height;
 
-    int BBP = m_Statistics.bytesPerPixel;
+    // Flips and half turns move whole rows and are done in place, unless the pixels are shared
+    if (!transform.transposes() && !m_ImageBuffer.isShared())
+    {
+        auto * buffer = reinterpret_cast<T *>(m_ImageBuffer.data());
+        if (buffer == nullptr)
+            return false;
+        return transform.applyInPlace(buffer, nx, ny, m_Statistics.channels, m_Statistics.samples_per_channel);
+    }
 
     /* Allocate buffer for rotated image */
-    rotimage = new uint8_t[m_Statistics.samples_per_channel * m_Statistics.channels * BBP];
+    FITSPixelBuffer rotimage = FITSPixelBuffer::allocate(m_Statistics.samples_per_channel * m_Statistics.channels *
+                               m_Statistics.bytesPerPixel);
 
-    if (rotimage == nullptr)
+    if (rotimage.isNull())
     {
         qWarning() << "Unable to allocate memory for rotated image buffer!";
         return false;
     }
 
-    auto * rotBuffer = reinterpret_cast<T *>(rotimage);
-    auto * buffer    = reinterpret_cast<T *>(m_ImageBuffer);
+    transform.apply(reinterpret_cast<T const *>(m_ImageBuffer.constData()), reinterpret_cast<T *>(rotimage.data()),
+                    nx, ny, m_Statistics.channels, m_Statistics.samples_per_channel);
 
-    /* Mirror image without rotation */
-    if (rotate < 45 && rotate > -45)
+    if (transform.transposes())
     {
-        if (mirror == 1)
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (x1 = 0; x1 < nx; x1++)
-                {
-                    x2 = nx - x1 - 1;
-                    for (y1 = 0; y1 < ny; y1++)
-                        rotBuffer[(y1 * nx) + x2 + offset] = buffer[(y1 * nx) + x1 + offset];
-                }
-            }
-        }
-        else if (mirror == 2)
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    y2 = ny - y1 - 1;
-                    for (x1 = 0; x1 < nx; x1++)
-                        rotBuffer[(y2 * nx) + x1 + offset] = buffer[(y1 * nx) + x1 + offset];
-                }
-            }
-        }
-        else
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    for (x1 = 0; x1 < nx; x1++)
-                        rotBuffer[(y1 * nx) + x1 + offset] = buffer[(y1 * nx) + x1 + offset];
-                }
-            }
-        }
-    }
-
-    /* Rotate by 90 degrees */
-    else if (rotate >= 45 && rotate < 135)
-    {
-        if (mirror == 1)
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    x2 = ny - y1 - 1;
-                    for (x1 = 0; x1 < nx; x1++)
-                    {
-                        y2                                 = nx - x1 - 1;
-                        rotBuffer[(y2 * ny) + x2 + offset] = buffer[(y1 * nx) + x1 + offset];
-                    }
-                }
-            }
-        }
-        else if (mirror == 2)
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    for (x1 = 0; x1 < nx; x1++)
-                        rotBuffer[(x1 * ny) + y1 + offset] = buffer[(y1 * nx) + x1 + offset];
-                }
-            }
-        }
-        else
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    x2 = ny - y1 - 1;
-                    for (x1 = 0; x1 < nx; x1++)
-                    {
-                        y2                                 = x1;
-                        rotBuffer[(y2 * ny) + x2 + offset] = buffer[(y1 * nx) + x1 + offset];
-                    }
-                }
-            }
-        }
-
-        m_Statistics.width  = ny;
-        m_Statistics.height = nx;
-    }
-
-    /* Rotate by 180 degrees */
-    else if (rotate >= 135 && rotate < 225)
-    {
-        if (mirror == 1)
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    y2 = ny - y1 - 1;
-                    for (x1 = 0; x1 < nx; x1++)
-                        rotBuffer[(y2 * nx) + x1 + offset] = buffer[(y1 * nx) + x1 + offset];
-                }
-            }
-        }
-        else if (mirror == 2)
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (x1 = 0; x1 < nx; x1++)
-                {
-                    x2 = nx - x1 - 1;
-                    for (y1 = 0; y1 < ny; y1++)
-                        rotBuffer[(y1 * nx) + x2 + offset] = buffer[(y1 * nx) + x1 + offset];
-                }
-            }
-        }
-        else
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    y2 = ny - y1 - 1;
-                    for (x1 = 0; x1 < nx; x1++)
-                    {
-                        x2                                 = nx - x1 - 1;
-                        rotBuffer[(y2 * nx) + x2 + offset] = buffer[(y1 * nx) + x1 + offset];
-                    }
-                }
-            }
-        }
-    }
-
-    /* Rotate by 270 degrees */
-    else if (rotate >= 225 && rotate < 315)
-    {
-        if (mirror == 1)
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    for (x1 = 0; x1 < nx; x1++)
-                        rotBuffer[(x1 * ny) + y1 + offset] = buffer[(y1 * nx) + x1 + offset];
-                }
-            }
-        }
-        else if (mirror == 2)
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    x2 = ny - y1 - 1;
-                    for (x1 = 0; x1 < nx; x1++)
-                    {
-                        y2                                 = nx - x1 - 1;
-                        rotBuffer[(y2 * ny) + x2 + offset] = buffer[(y1 * nx) + x1 + offset];
-                    }
-                }
-            }
-        }
-        else
-        {
-            for (int i = 0; i < m_Statistics.channels; i++)
-            {
-                offset = m_Statistics.samples_per_channel * i;
-                for (y1 = 0; y1 < ny; y1++)
-                {
-                    x2 = y1;
-                    for (x1 = 0; x1 < nx; x1++)
-                    {
-                        y2                                 = nx - x1 - 1;
-                        rotBuffer[(y2 * ny) + x2 + offset] = buffer[(y1 * nx) + x1 + offset];
-                    }
-                }
-            }
-        }
-
         m_Statistics.width  = ny;
         m_Statistics.height = nx;
     }
 
-    /* If rotating by more than 315 degrees, assume top-bottom reflection */
-    else if (rotate >= 315 && mirror)
-    {
-        for (int i = 0; i < m_Statistics.channels; i++)
-        {
-            offset = m_Statistics.samples_per_channel * i;
-            for (y1 = 0; y1 < ny; y1++)
-            {
-                for (x1 = 0; x1 < nx; x1++)
-                {
-                    x2                                 = y1;
-                    y2                                 = x1;
-                    rotBuffer[(y2 * ny) + x2 + offset] = buffer[(y1 * nx) + x1 + offset];
-                }
-            }
-        }
-    }
-
-    delete[] m_ImageBuffer;
+    clearImageBuffers();
     m_ImageBuffer = rotimage;
 
     return true;
@@ -3107,48 +2863,18 @@ void FITSData::rotWCSFITS(int angle, int mirror)
 
     status = 0;
 
+    // The image was already rotated, the transform applies to the reference pixel of the unrotated one
+    const ImageTransform transform = ImageTransform::fromRotation(angle, mirror);
+    if (transform.transposes())
+        std::swap(naxis1, naxis2);
+
     /* Reset CRPIXn */
     if (!fits_read_key_dbl(fptr, "CRPIX1", &ctemp1, comment, &status) &&
             !fits_read_key_dbl(fptr, "CRPIX2", &ctemp2, comment, &status))
     {
-        if (mirror != 0)
-        {
-            if (angle == 0)
-                fits_update_key_dbl(fptr, "CRPIX1", naxis1 - ctemp1, WCS_DECIMALS, comment, &status);
-            else if (angle == 90)
-            {
-                fits_update_key_dbl(fptr, "CRPIX1", naxis2 - ctemp2, WCS_DECIMALS, comment, &status);
-                fits_update_key_dbl(fptr, "CRPIX2", naxis1 - ctemp1, WCS_DECIMALS, comment, &status);
-            }
-            else if (angle == 180)
-            {
-                fits_update_key_dbl(fptr, "CRPIX1", ctemp1, WCS_DECIMALS, comment, &status);
-                fits_update_key_dbl(fptr, "CRPIX2", naxis2 - ctemp2, WCS_DECIMALS, comment, &status);
-            }
-            else if (angle == 270)
-            {
-                fits_update_key_dbl(fptr, "CRPIX1", ctemp2, WCS_DECIMALS, comment, &status);
-                fits_update_key_dbl(fptr, "CRPIX2", ctemp1, WCS_DECIMALS, comment, &status);
-            }
-        }
-        else
-        {
-            if (angle == 90)
-            {
-                fits_update_key_dbl(fptr, "CRPIX1", naxis2 - ctemp2, WCS_DECIMALS, comment, &status);
-                fits_update_key_dbl(fptr, "CRPIX2", ctemp1, WCS_DECIMALS, comment, &status);
-            }
-            else if (angle == 180)
-            {
-                fits_update_key_dbl(fptr, "CRPIX1", naxis1 - ctemp1, WCS_DECIMALS, comment, &status);
-                fits_update_key_dbl(fptr, "CRPIX2", naxis2 - ctemp2, WCS_DECIMALS, comment, &status);
-            }
-            else if (angle == 270)
-            {
-                fits_update_key_dbl(fptr, "CRPIX1", ctemp2, WCS_DECIMALS, comment, &status);
-                fits_update_key_dbl(fptr, "CRPIX2", naxis1 - ctemp1, WCS_DECIMALS, comment, &status);
-            }
-        }
+        const QPointF crpix = transform.mapPoint(QPointF(ctemp1, ctemp2), naxis1, naxis2);
+        fits_update_key_dbl(fptr, "CRPIX1", crpix.x(), WCS_DECIMALS, comment, &status);
+        fits_update_key_dbl(fptr, "CRPIX2", crpix.y(), WCS_DECIMALS, comment, &status);
     }
 
     status = 0;
@@ -3157,44 +2883,11 @@ void FITSData::rotWCSFITS(int angle, int mirror)
     if (!fits_read_key_dbl(fptr, "CDELT1", &ctemp1, comment, &status) &&
             !fits_read_key_dbl(fptr, "CDELT2", &ctemp2, comment, &status))
     {
-        if (mirror != 0)
-        {
-            if (angle == 0)
-                fits_update_key_dbl(fptr, "CDELT1", -ctemp1, WCS_DECIMALS, comment, &status);
-            else if (angle == 90)
-            {
-                fits_update_key_dbl(fptr, "CDELT1", -ctemp2, WCS_DECIMALS, comment, &status);
-                fits_update_key_dbl(fptr, "CDELT2", -ctemp1, WCS_DECIMALS, comment, &status);
-            }
-            else if (angle == 180)
-            {
-                fits_update_key_dbl(fptr, "CDELT1", ctemp1, WCS_DECIMALS, comment, &status);
-                fits_update_key_dbl(fptr, "CDELT2", -ctemp2, WCS_DECIMALS, comment, &status);
-            }
-            else if (angle == 270)
-            {
-                fits_update_key_dbl(fptr, "CDELT1", ctemp2, WCS_DECIMALS, comment, &status);
-                fits_update_key_dbl(fptr, "CDELT2", ctemp1, WCS_DECIMALS, comment, &status);
-            }
-        }
-        else
-        {
-            if (angle == 90)
-            {
-                fits_update_key_dbl(fptr, "CDELT1", -ctemp2, WCS_DECIMALS, comment, &status);
-                fits_update_key_dbl(fptr, "CDELT2", ctemp1, WCS_DECIMALS, comment, &status);
-            }
-            else if (angle == 180)
-            {
-                fits_update_key_dbl(fptr, "CDELT1", -ctemp1, WCS_DECIMALS, comment, &status);
-                fits_update_key_dbl(fptr, "CDELT2", -ctemp2, WCS_DECIMALS, comment, &status);
-            }
-            else if (angle == 270)
-            {
-                fits_update_key_dbl(fptr, "CDELT1", ctemp2, WCS_DECIMALS, comment, &status);
-                fits_update_key_dbl(fptr, "CDELT2", -ctemp1, WCS_DECIMALS, comment, &status);
-            }
-        }
+        const double cdelt[2] = { ctemp1, ctemp2 };
+        fits_update_key_dbl(fptr, "CDELT1", transform.axisSign(0) * cdelt[transform.sourceAxis(0)], WCS_DECIMALS, comment,
+                            &status);
+        fits_update_key_dbl(fptr, "CDELT2", transform.axisSign(1) * cdelt[transform.sourceAxis(1)], WCS_DECIMALS, comment,
+                            &status);
     }
 
     /* Reset CD matrix, if present */
@@ -3288,18 +2981,26 @@ void FITSData::rotWCSFITS(int angle, int mirror)
 
 uint8_t * FITSData::getWritableImageBuffer()
 {
-    return m_ImageBuffer;
+    return m_ImageBuffer.data();
 }
 
 uint8_t const * FITSData::getImageBuffer() const
 {
-    return m_ImageBuffer;
+    return m_ImageBuffer.constData();
 }
 
 void FITSData::setImageBuffer(uint8_t * buffer)
 {
-    delete[] m_ImageBuffer;
+    setImageBuffer(FITSPixelBuffer::fromArray(buffer, m_Statistics.samples_per_channel * m_Statistics.channels *
+                   m_Statistics.bytesPerPixel));
+}
+
+void FITSData::setImageBuffer(const FITSPixelBuffer &buffer)
+{
+    clearImageBuffers();
     m_ImageBuffer = buffer;
+    m_ImageBufferSize = buffer.size();
+    m_SampleHistograms.clear();
 }
 
 bool FITSData::checkDebayer()
@@ -3409,8 +3110,14 @@ bool FITSData::debayer(bool reload)
     {
         int anynull = 0, status = 0;
 
-        if (fits_read_img(fptr, m_Statistics.dataType, 1, m_Statistics.samples_per_channel, nullptr, m_ImageBuffer,
-                          &anynull, &status))
+        // Adopted pixels were converted in place and can't be read through fptr anymore
+        if (m_Blob && m_Blob->isAdopted())
+        {
+            if (m_ImageBuffer.constData() != m_Blob->pixels())
+                memcpy(m_ImageBuffer.data(), m_Blob->pixels(), m_Statistics.samples_per_channel * m_Statistics.bytesPerPixel);
+        }
+        else if (fits_read_img(fptr, m_Statistics.dataType, 1, m_Statistics.samples_per_channel, nullptr, m_ImageBuffer.data(),
+                               &anynull, &status))
         {
             //                char errmsg[512];
             //                fits_get_errstatus(status, errmsg);
@@ -3437,27 +3144,16 @@ bool FITSData::debayer_8bit()
     dc1394error_t error_code;
 
     uint32_t rgb_size = m_Statistics.samples_per_channel * 3 * m_Statistics.bytesPerPixel;
-    uint8_t * destinationBuffer = nullptr;
+    // The mosaic is read while the planes are written, and may be shared with another image
+    FITSPixelBuffer rgbBuffer = FITSPixelBuffer::allocate(rgb_size);
 
-    try
-    {
-        destinationBuffer = new uint8_t[rgb_size];
-    }
-    catch (const std::bad_alloc &e)
-    {
-        logOOMError(rgb_size);
-        KSNotification::error(i18n("Unable to allocate memory for temporary bayer buffer: %1", e.what()), i18n("Debayer error"),
-                              10);
-        return false;
-    }
-
-    auto * bayer_source_buffer      = reinterpret_cast<uint8_t *>(m_ImageBuffer);
-    auto * bayer_destination_buffer = reinterpret_cast<uint8_t *>(destinationBuffer);
+    auto * bayer_source_buffer      = reinterpret_cast<uint8_t const *>(m_ImageBuffer.constData());
+    auto * bayer_destination_buffer = reinterpret_cast<uint8_t *>(rgbBuffer.data());
 
     if (bayer_destination_buffer == nullptr)
     {
         logOOMError(rgb_size);
-        KSNotification::error(i18n("Unable to allocate memory for temporary bayer buffer."), i18n("Debayer error"), 10);
+        KSNotification::error(i18n("Unable to allocate memory for bayer buffer."), i18n("Debayer error"), 10);
         return false;
     }
 
@@ -3471,59 +3167,32 @@ bool FITSData::debayer_8bit()
     }
     // offsetX == 1 is handled in checkDebayer() and should be 0 here.
 
-    error_code = dc1394_bayer_decoding_8bit(dc1394_source, bayer_destination_buffer, m_Statistics.width, ds1394_height,
-                                            debayerParams.filter,
-                                            debayerParams.method);
+    // Decoded in parallel straight into the R, G and B layers of FITS
+    error_code = DebayerEngine::decode(dc1394_source, bayer_destination_buffer, m_Statistics.width, ds1394_height,
+                                       debayerParams.filter, debayerParams.method,
+                                       DebayerEngine::PLANAR, m_Statistics.samples_per_channel);
 
     if (error_code != DC1394_SUCCESS)
     {
         KSNotification::error(i18n("Debayer failed (%1)", error_code), i18n("Debayer error"), 10);
         m_Statistics.channels = 1;
-        delete[] destinationBuffer;
         return false;
     }
 
-    if (m_ImageBufferSize != rgb_size)
-    {
-        delete[] m_ImageBuffer;
-        try
-        {
-            m_ImageBuffer = new uint8_t[rgb_size];
-        }
-        catch (const std::bad_alloc &e)
-        {
-            delete[] destinationBuffer;
-            logOOMError(rgb_size);
-            KSNotification::error(i18n("Unable to allocate memory for temporary bayer buffer: %1", e.what()), i18n("Debayer error"),
-                                  10);
-            return false;
-        }
+    // Last row of each layer when the mosaic was shifted up
+    for (int channel = 0; channel < 3 && ds1394_height < m_Statistics.height; channel++)
+        memset(bayer_destination_buffer + (channel + 1) * m_Statistics.samples_per_channel - m_Statistics.width, 0,
+               m_Statistics.width * sizeof(uint8_t));
 
-        m_ImageBufferSize = rgb_size;
-    }
-
-    auto bayered_buffer = reinterpret_cast<uint8_t *>(m_ImageBuffer);
-
-    // Data in R1G1B1, we need to copy them into 3 layers for FITS
-
-    uint8_t * rBuff = bayered_buffer;
-    uint8_t * gBuff = bayered_buffer + (m_Statistics.width * m_Statistics.height);
-    uint8_t * bBuff = bayered_buffer + (m_Statistics.width * m_Statistics.height * 2);
-
-    int imax = m_Statistics.samples_per_channel * 3 - 3;
-    for (int i = 0; i <= imax; i += 3)
-    {
-        *rBuff++ = bayer_destination_buffer[i];
-        *gBuff++ = bayer_destination_buffer[i + 1];
-        *bBuff++ = bayer_destination_buffer[i + 2];
-    }
+    clearImageBuffers();
+    m_ImageBuffer = rgbBuffer;
+    m_ImageBufferSize = rgb_size;
 
     // TODO Maybe all should be treated the same
     // Doing single channel saves lots of memory though for non-essential
     // frames
     m_Statistics.channels = (m_Mode == FITS_NORMAL || m_Mode == FITS_CALIBRATE) ? 3 : 1;
     m_Statistics.dataType = TBYTE;
-    delete[] destinationBuffer;
     return true;
 }
 
@@ -3532,26 +3201,16 @@ bool FITSData::debayer_16bit()
     dc1394error_t error_code;
 
     uint32_t rgb_size = m_Statistics.samples_per_channel * 3 * m_Statistics.bytesPerPixel;
-    uint8_t *destinationBuffer = nullptr;
-    try
-    {
-        destinationBuffer = new uint8_t[rgb_size];
-    }
-    catch (const std::bad_alloc &e)
-    {
-        logOOMError(rgb_size);
-        KSNotification::error(i18n("Unable to allocate memory for temporary bayer buffer: %1", e.what()), i18n("Debayer error"),
-                              10);
-        return false;
-    }
+    // The mosaic is read while the planes are written, and may be shared with another image
+    FITSPixelBuffer rgbBuffer = FITSPixelBuffer::allocate(rgb_size);
 
-    auto * bayer_source_buffer      = reinterpret_cast<uint16_t *>(m_ImageBuffer);
-    auto * bayer_destination_buffer = reinterpret_cast<uint16_t *>(destinationBuffer);
+    auto * bayer_source_buffer      = reinterpret_cast<uint16_t const *>(m_ImageBuffer.constData());
+    auto * bayer_destination_buffer = reinterpret_cast<uint16_t *>(rgbBuffer.data());
 
     if (bayer_destination_buffer == nullptr)
     {
         logOOMError(rgb_size);
-        KSNotification::error(i18n("Unable to allocate memory for temporary bayer buffer."), i18n("Debayer error"), 10);
+        KSNotification::error(i18n("Unable to allocate memory for bayer buffer."), i18n("Debayer error"), 10);
         return false;
     }
 
@@ -3565,56 +3224,29 @@ bool FITSData::debayer_16bit()
     }
     // offsetX == 1 is handled in checkDebayer() and should be 0 here.
 
-    error_code = dc1394_bayer_decoding_16bit(dc1394_source, bayer_destination_buffer, m_Statistics.width, ds1394_height,
-                 debayerParams.filter,
-                 debayerParams.method, 16);
+    // Decoded in parallel straight into the R, G and B layers of FITS
+    error_code = DebayerEngine::decode(dc1394_source, bayer_destination_buffer, m_Statistics.width, ds1394_height,
+                                       debayerParams.filter, debayerParams.method,
+                                       DebayerEngine::PLANAR, m_Statistics.samples_per_channel, 16);
 
     if (error_code != DC1394_SUCCESS)
     {
         KSNotification::error(i18n("Debayer failed (%1)", error_code), i18n("Debayer error"));
         m_Statistics.channels = 1;
-        delete[] destinationBuffer;
         return false;
     }
 
-    if (m_ImageBufferSize != rgb_size)
-    {
-        delete[] m_ImageBuffer;
-        try
-        {
-            m_ImageBuffer = new uint8_t[rgb_size];
-        }
-        catch (const std::bad_alloc &e)
-        {
-            logOOMError(rgb_size);
-            delete[] destinationBuffer;
-            KSNotification::error(i18n("Unable to allocate memory for temporary bayer buffer: %1", e.what()), i18n("Debayer error"),
-                                  10);
-            return false;
-        }
-
-        m_ImageBufferSize = rgb_size;
-    }
-
-    auto bayered_buffer = reinterpret_cast<uint16_t *>(m_ImageBuffer);
-
-    // Data in R1G1B1, we need to copy them into 3 layers for FITS
+    // Last row of each layer when the mosaic was shifted up
+    for (int channel = 0; channel < 3 && ds1394_height < m_Statistics.height; channel++)
+        memset(bayer_destination_buffer + (channel + 1) * m_Statistics.samples_per_channel - m_Statistics.width, 0,
+               m_Statistics.width * sizeof(uint16_t));
 
-    uint16_t * rBuff = bayered_buffer;
-    uint16_t * gBuff = bayered_buffer + (m_Statistics.width * m_Statistics.height);
-    uint16_t * bBuff = bayered_buffer + (m_Statistics.width * m_Statistics.height * 2);
-
-    int imax = m_Statistics.samples_per_channel * 3 - 3;
-    for (int i = 0; i <= imax; i += 3)
-    {
-        *rBuff++ = bayer_destination_buffer[i];
-        *gBuff++ = bayer_destination_buffer[i + 1];
-        *bBuff++ = bayer_destination_buffer[i + 2];
-    }
+    clearImageBuffers();
+    m_ImageBuffer = rgbBuffer;
+    m_ImageBufferSize = rgb_size;
 
     m_Statistics.channels = (m_Mode == FITS_NORMAL || m_Mode == FITS_CALIBRATE) ? 3 : 1;
     m_Statistics.dataType = TUSHORT;
-    delete[] destinationBuffer;
     return true;
 }
 
@@ -3965,50 +3597,10 @@ void FITSData::restoreStatistics(FITSImage::Statistic &other)
 
 void FITSData::constructHistogram()
 {
-    switch (m_Statistics.dataType)
-    {
-        case TBYTE:
-            constructHistogramInternal<uint8_t>();
-            break;
-
-        case TSHORT:
-            constructHistogramInternal<int16_t>();
-            break;
-
-        case TUSHORT:
-            constructHistogramInternal<uint16_t>();
-            break;
-
-        case TLONG:
-            constructHistogramInternal<int32_t>();
-            break;
-
-        case TULONG:
-            constructHistogramInternal<uint32_t>();
-            break;
-
-        case TFLOAT:
-            constructHistogramInternal<float>();
-            break;
-
-        case TLONGLONG:
-            constructHistogramInternal<int64_t>();
-            break;
-
-        case TDOUBLE:
-            constructHistogramInternal<double>();
-            break;
-
-        default:
-            break;
-    }
-}
-
-template <typename T> void FITSData::constructHistogramInternal()
-{
-    auto * const buffer = reinterpret_cast<T const *>(m_ImageBuffer);
-    uint32_t samples = m_Statistics.width * m_Statistics.height;
-    const uint32_t sampleBy = samples > 500000 ? samples / 500000 : 1;
+    // The histogram is rebinned from the sample histograms, without scanning the image again
+    const QVector<SampleHistogram> &histograms = getSampleHistograms();
+    if (histograms.size() < m_Statistics.channels)
+        return;
 
     m_HistogramBinCount = qMax(0., qMin(m_Statistics.max[0] - m_Statistics.min[0], 256.0));
     if (m_HistogramBinCount <= 0)
@@ -4037,13 +3629,16 @@ template <typename T> void FITSData::constructHistogramInternal()
     {
         futures.append(QtConcurrent::run([ = ]()
         {
-            uint32_t offset = n * samples;
+            const SampleHistogram &histogram = histograms[n];
+            // Bins that do not hold a single value are represented by their center
+            const double center = histogram.isExact() ? 0 : histogram.binWidth() / 2;
 
-            for (uint32_t i = 0; i < samples; i += sampleBy)
+            for (int i = 0; i < histogram.binCount(); i++)
             {
-                int32_t id = qMax(static_cast<T>(0), qMin(static_cast<T>(m_HistogramBinCount),
-                                  static_cast<T>(rint((buffer[i + offset] - m_Statistics.min[n]) / m_HistogramBinWidth[n]))));
-                m_HistogramFrequency[n][id] += sampleBy;
+                const double value = histogram.binValue(i) + center;
+                int32_t id = qBound(0., rint((value - m_Statistics.min[n]) / m_HistogramBinWidth[n]),
+                                    static_cast<double>(m_HistogramBinCount));
+                m_HistogramFrequency[n][id] += histogram.binFrequency(i);
             }
         }));
     }
@@ -23,6 +23,9 @@
 #include "skybackground.h"
 #include "fitscommon.h"
 #include "fitsstardetector.h"
+#include "fitsblob.h"
+#include "fitspixelbuffer.h"
+#include "samplehistogram.h"
 
 #ifdef WIN32
 // This header must be included before fitsio.h to avoid compiler errors with Visual Studio
@@ -120,6 +123,30 @@ class FITSData : public QObject
         bool loadFromBuffer(const QByteArray &buffer, const QString &extension, const QString &inFilename = QString(),
                             bool silent = true);
 
+        /**
+         * @brief loadFromBlob Loading FITS from a blob shared with its file writer.
+         * The pixels are adopted in place when their encoding allows it, instead of being copied. The blob is then
+         * referenced until the image buffer is cleared or replaced.
+         * @param blob The received FITS file.
+         * @param extension file extension (e.g. "fits", "fits.fz")
+         * @param inFilename Set filename metadata, does not load from file.
+         * @param silent If set, error messages are ignored. If set to false, the error message will get displayed in a popup.
+         * @return bool indicating success or failure.
+         */
+        bool loadFromBlob(const QSharedPointer<FITSBlob> &blob, const QString &extension,
+                          const QString &inFilename = QString(), bool silent = true);
+
+        /** @return milliseconds spent on the last FITS load reading the image, debayering included. */
+        qint64 getParseTime() const
+        {
+            return m_ParseTime;
+        }
+        /** @return milliseconds spent on the last FITS load computing the statistics. */
+        qint64 getStatsTime() const
+        {
+            return m_StatsTime;
+        }
+
         /**
          * @brief parseSolution Parse the WCS solution information from the header into the given struct.
          * @param solution Solution structure to fill out.
@@ -132,9 +159,17 @@ class FITSData : public QObject
 
         // Access functions
         void clearImageBuffers();
+        /** Take ownership of buffer, allocated with new[] and sized after the current statistics. */
         void setImageBuffer(uint8_t *buffer);
+        void setImageBuffer(const FITSPixelBuffer &buffer);
         uint8_t const *getImageBuffer() const;
+        /** Pixels that may be modified, copied first if they are shared with another image. */
         uint8_t *getWritableImageBuffer();
+        /** The pixels, to be shared with another image without copying them. */
+        const FITSPixelBuffer &getPixelBuffer() const
+        {
+            return m_ImageBuffer;
+        }
 
         ////////////////////////////////////////////////////////////////////////////////////////
         ////////////////////////////////////////////////////////////////////////////////////////
@@ -145,6 +180,12 @@ class FITSData : public QObject
         void calculateStats(bool refresh = false);
         void saveStatistics(FITSImage::Statistic &other);
         void restoreStatistics(FITSImage::Statistic &other);
+        /**
+         * @brief getSampleHistograms Histograms of each channel of the image, from which the statistics,
+         * the histogram and the auto-stretch parameters are all derived. The image is scanned on the first
+         * call after it was loaded or the statistics were refreshed.
+         */
+        const QVector<SampleHistogram> &getSampleHistograms();
         FITSImage::Statistic const &getStatistics() const
         {
             return m_Statistics;
@@ -446,6 +487,7 @@ class FITSData : public QObject
         void resetHistogram()
         {
             m_HistogramConstructed = false;
+            m_SampleHistograms.clear();
         }
         double getHistogramBinWidth(int channel = 0)
         {
@@ -578,6 +620,8 @@ class FITSData : public QObject
         bool loadCanonicalImage(const QByteArray &buffer, const QString &extension, bool silent);
         // Load FITS images.
         bool loadFITSImage(const QByteArray &buffer, const QString &extension, bool silent);
+        // Point m_ImageBuffer to the pixels of m_Blob, converted in place. False if their encoding can't be adopted.
+        bool adoptBlobPixels(long nelements);
         // Load RAW images.
         bool loadRAWImage(const QByteArray &buffer, const QString &extension, bool silent);
 
@@ -607,12 +651,7 @@ class FITSData : public QObject
         void applyFilter(FITSScale type, uint8_t *targetImage, QVector<double> * min = nullptr, QVector<double> * max = nullptr);
 
         template <typename T>
-        void calculateMinMax();
-        template <typename T>
-        void calculateMedian();
-
-        template <typename T>
-        QPair<T, T> getParitionMinMax(uint32_t start, uint32_t stride);
+        void computeSampleHistograms();
 
         /* Calculate the Gaussian blur matrix and apply it to the image using the convolution filter */
         QVector<double> createGaussianKernel(int size, double sigma);
@@ -630,17 +669,10 @@ class FITSData : public QObject
         template <typename T>
         void convertToQImage(double dataMin, double dataMax, double scale, double zero, QImage &image);
 
-        ////////////////////////////////////////////////////////////////////////////////////////
-        ////////////////////////////////////////////////////////////////////////////////////////
-        /// Private Histogram Functions.
-        ////////////////////////////////////////////////////////////////////////////////////////
-        ////////////////////////////////////////////////////////////////////////////////////////
-        template <typename T>  void constructHistogramInternal();
-
         /// Pointer to CFITSIO FITS file struct
         fitsfile *fptr { nullptr };
-        /// Generic data image buffer
-        uint8_t *m_ImageBuffer { nullptr };
+        /// Generic data image buffer, shared with copies of this image until modified
+        FITSPixelBuffer m_ImageBuffer;
         /// Above buffer size in bytes
         uint32_t m_ImageBufferSize { 0 };
         /// Is this a temporary file or one loaded from disk?
@@ -659,6 +691,11 @@ class FITSData : public QObject
         bool HasDebayer { false };
         /// Buffer to hold fpack uncompressed data
         uint8_t *m_PackBuffer {nullptr};
+        /// Blob backing fptr when loaded with loadFromBlob
+        QSharedPointer<FITSBlob> m_Blob;
+        /// Timings of the last FITS load, in milliseconds
+        qint64 m_ParseTime { 0 };
+        qint64 m_StatsTime { 0 };
 
         /// Our very own file name
         QString m_Filename, m_compressedFilename;
@@ -715,6 +752,7 @@ class FITSData : public QObject
         QVector<QVector<double>> m_HistogramIntensity;
         QVector<QVector<double>> m_HistogramFrequency;
         QVector<double> m_HistogramBinWidth;
+        QVector<SampleHistogram> m_SampleHistograms;
         uint16_t m_HistogramBinCount { 0 };
         double m_JMIndex { 1 };
         bool m_HistogramConstructed { false };
@@ -62,18 +62,20 @@ bool FITSGradientDetector::findSources(const QRect &boundary)
 
     uint16_t dataWidth = m_ImageData->width();
 
-    // #1 Find offsets
+    // #1 Find size
     uint32_t size   = subW * subH;
-    uint32_t offset = subX + subY * dataWidth;
 
-    // #2 Create new buffer
-    auto * buffer = new uint8_t[size * BBP];
-    // If there is no offset, copy whole buffer in one go
-    if (offset == 0)
-        memcpy(buffer, m_ImageData->getImageBuffer(), size * BBP);
+    // #2 Share the pixels of the whole frame, copy a sub-frame into a new buffer
+    FITSPixelBuffer buffer;
+    if (subW == m_ImageData->width() && subH == m_ImageData->height())
+        buffer = m_ImageData->getPixelBuffer();
     else
     {
-        uint8_t * dataPtr = buffer;
+        buffer = FITSPixelBuffer::allocate(size * BBP);
+        if (buffer.isNull())
+            return false;
+
+        uint8_t * dataPtr = buffer.data();
         uint8_t const * origDataPtr = m_ImageData->getImageBuffer();
         uint32_t lineOffset  = 0;
         // Copy data line by line
@@ -270,7 +270,7 @@ void FITSHistogramView::createNonLinearHistogram()
 
     Stretch stretch(width, height, m_ImageData->channels(), m_ImageData->dataType());
     // Compute new auto-stretch params.
-    StretchParams stretchParams = stretch.computeParams(m_ImageData->getImageBuffer());
+    StretchParams stretchParams = stretch.computeParams(m_ImageData->getImageBuffer(), m_ImageData->getSampleHistograms());
 
     stretch.setParams(stretchParams);
     stretch.run(m_ImageData->getImageBuffer(), &rawImage);
@@ -0,0 +1,218 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "fitspixelbuffer.h"
+
+#include "fitsblob.h"
+
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+FITSBufferPool *FITSBufferPool::Instance()
+{
+    // Never destroyed, images may outlive static destruction
+    static FITSBufferPool *pool = new FITSBufferPool();
+    return pool;
+}
+
+qint64 FITSBufferPool::sizeClass(qint64 size)
+{
+    if (size < MIN_POOLED_SIZE)
+        return size;
+
+    // Eight classes between consecutive powers of two
+    qint64 power = MIN_POOLED_SIZE;
+    while (power * 2 <= size)
+        power *= 2;
+    const qint64 step = power / 8;
+    return (size + step - 1) / step * step;
+}
+
+uint8_t *FITSBufferPool::acquire(qint64 size, qint64 *capacity)
+{
+    const qint64 wanted = sizeClass(size);
+
+    if (wanted >= MIN_POOLED_SIZE)
+    {
+        QMutexLocker locker(&m_Mutex);
+        // Most recently released first, it is the most likely to be still resident
+        for (int i = m_Free.size() - 1; i >= 0; --i)
+        {
+            if (m_Free[i].capacity != wanted)
+                continue;
+
+            uint8_t *buffer = m_Free[i].buffer;
+            m_Free.remove(i);
+            m_Statistics.retained -= wanted;
+            m_Statistics.hits++;
+            *capacity = wanted;
+            return buffer;
+        }
+        m_Statistics.misses++;
+    }
+
+    uint8_t *buffer = new (std::nothrow) uint8_t[wanted];
+    if (buffer == nullptr)
+    {
+        // Give back what we keep and try once more
+        clear();
+        buffer = new (std::nothrow) uint8_t[wanted];
+    }
+
+    *capacity = buffer ? wanted : 0;
+    return buffer;
+}
+
+void FITSBufferPool::release(uint8_t *buffer, qint64 capacity)
+{
+    if (buffer == nullptr)
+        return;
+
+    if (capacity < MIN_POOLED_SIZE || sizeClass(capacity) != capacity)
+    {
+        delete[] buffer;
+        return;
+    }
+
+    QMutexLocker locker(&m_Mutex);
+    if (capacity > m_RetainLimit)
+    {
+        delete[] buffer;
+        return;
+    }
+
+    trim(m_RetainLimit - capacity);
+    m_Free.append({buffer, capacity});
+    m_Statistics.retained += capacity;
+}
+
+void FITSBufferPool::setRetainLimit(qint64 bytes)
+{
+    QMutexLocker locker(&m_Mutex);
+    m_RetainLimit = std::max<qint64>(0, bytes);
+    trim(m_RetainLimit);
+}
+
+qint64 FITSBufferPool::retainLimit() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_RetainLimit;
+}
+
+void FITSBufferPool::clear()
+{
+    QMutexLocker locker(&m_Mutex);
+    trim(0);
+}
+
+FITSBufferPool::Statistics FITSBufferPool::statistics() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_Statistics;
+}
+
+void FITSBufferPool::trim(qint64 limit)
+{
+    int evicted = 0;
+    while (evicted < m_Free.size() && m_Statistics.retained > limit)
+    {
+        delete[] m_Free[evicted].buffer;
+        m_Statistics.retained -= m_Free[evicted].capacity;
+        evicted++;
+    }
+    m_Free.remove(0, evicted);
+}
+
+FITSPixelBuffer::Storage::~Storage()
+{
+    switch (owner)
+    {
+        case POOL:
+            FITSBufferPool::Instance()->release(pixels, capacity);
+            break;
+        case ARRAY:
+            delete[] pixels;
+            break;
+        case BLOB:
+            // The pixels belong to the blob
+            break;
+    }
+}
+
+FITSPixelBuffer FITSPixelBuffer::allocate(qint64 size)
+{
+    FITSPixelBuffer buffer;
+    if (size <= 0)
+        return buffer;
+
+    qint64 capacity = 0;
+    uint8_t *pixels = FITSBufferPool::Instance()->acquire(size, &capacity);
+    if (pixels == nullptr)
+        return buffer;
+
+    buffer.d = new Storage;
+    buffer.d->pixels = pixels;
+    buffer.d->size = size;
+    buffer.d->capacity = capacity;
+    buffer.d->owner = Storage::POOL;
+    return buffer;
+}
+
+FITSPixelBuffer FITSPixelBuffer::fromArray(uint8_t *pixels, qint64 size)
+{
+    FITSPixelBuffer buffer;
+    if (pixels == nullptr)
+        return buffer;
+
+    buffer.d = new Storage;
+    buffer.d->pixels = pixels;
+    buffer.d->size = size;
+    buffer.d->capacity = size;
+    buffer.d->owner = Storage::ARRAY;
+    return buffer;
+}
+
+FITSPixelBuffer FITSPixelBuffer::fromBlob(const QSharedPointer<FITSBlob> &blob, uint8_t *pixels, qint64 size)
+{
+    FITSPixelBuffer buffer;
+    if (blob.isNull() || pixels == nullptr)
+        return buffer;
+
+    buffer.d = new Storage;
+    buffer.d->pixels = pixels;
+    buffer.d->size = size;
+    buffer.d->capacity = size;
+    buffer.d->owner = Storage::BLOB;
+    buffer.d->blob = blob;
+    return buffer;
+}
+
+bool FITSPixelBuffer::isShared() const
+{
+    return d && d->ref.loadAcquire() > 1;
+}
+
+uint8_t *FITSPixelBuffer::data()
+{
+    if (!d)
+        return nullptr;
+
+    if (isShared())
+    {
+        FITSPixelBuffer copy = allocate(d->size);
+        if (copy.isNull())
+            return nullptr;
+        memcpy(copy.d->pixels, d->pixels, d->size);
+        d = copy.d;
+    }
+    else if (d->blob)
+        d->blob->waitForWrite();
+
+    return d->pixels;
+}
@@ -0,0 +1,162 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QExplicitlySharedDataPointer>
+#include <QMutex>
+#include <QSharedData>
+#include <QSharedPointer>
+#include <QVector>
+
+#include <cstdint>
+
+class FITSBlob;
+
+/**
+ * @class FITSBufferPool
+ * @short Recycles the large pixel buffers of FITSData.
+ *
+ * Ekos keeps receiving frames of the same few sizes, so buffers released by one frame are kept
+ * and handed to the next one of the same size class instead of going back to the allocator.
+ * Sizes are rounded up to one of eight classes per power of two, which wastes at most 12.5% of a
+ * buffer. Buffers smaller than MIN_POOLED_SIZE are not worth keeping and are allocated directly.
+ *
+ * At most retainLimit() bytes are kept. When a released buffer would exceed it, the buffers
+ * released longest ago are freed first. All methods are thread safe.
+ */
+class FITSBufferPool
+{
+    public:
+        static constexpr qint64 MIN_POOLED_SIZE = 64 * 1024;
+        static constexpr qint64 DEFAULT_RETAIN_LIMIT = 256 * 1024 * 1024;
+
+        struct Statistics
+        {
+            /** Buffers handed out from the pool */
+            quint64 hits { 0 };
+            /** Buffers that had to be allocated */
+            quint64 misses { 0 };
+            /** Bytes currently kept for reuse */
+            qint64 retained { 0 };
+        };
+
+        static FITSBufferPool *Instance();
+
+        /**
+         * @brief acquire Get a buffer of at least size bytes, its content is undefined.
+         * @param capacity Set to the actual size of the buffer, to be passed back to release().
+         * @return the buffer, or nullptr if memory is exhausted.
+         */
+        uint8_t *acquire(qint64 size, qint64 *capacity);
+        void release(uint8_t *buffer, qint64 capacity);
+
+        void setRetainLimit(qint64 bytes);
+        qint64 retainLimit() const;
+
+        /** Free all the buffers kept for reuse. */
+        void clear();
+        Statistics statistics() const;
+
+        /** @return the capacity of the buffers that serve a request of size bytes. */
+        static qint64 sizeClass(qint64 size);
+
+    private:
+        FITSBufferPool() = default;
+
+        // Called with the mutex locked
+        void trim(qint64 limit);
+
+        struct FreeBuffer
+        {
+            uint8_t *buffer;
+            qint64 capacity;
+        };
+
+        mutable QMutex m_Mutex;
+        /// Oldest released first
+        QVector<FreeBuffer> m_Free;
+        qint64 m_RetainLimit { DEFAULT_RETAIN_LIMIT };
+        Statistics m_Statistics;
+};
+
+/**
+ * @class FITSPixelBuffer
+ * @short Reference counted pixel buffer of FITSData, copied on write.
+ *
+ * Copies of a buffer share the same pixels until one of them asks for data(), which gives that
+ * copy pixels of its own first. Read-only consumers of a frame thus share a single allocation.
+ *
+ * The pixels are either taken from FITSBufferPool, adopted from an array allocated with new[],
+ * or adopted in place from a FITSBlob. In the latter case data() also waits for any pending write
+ * of the blob, so that the file is saved as it was received.
+ */
+class FITSPixelBuffer
+{
+    public:
+        FITSPixelBuffer() = default;
+
+        /** @return a buffer of size bytes from the pool, null if memory is exhausted. */
+        static FITSPixelBuffer allocate(qint64 size);
+        /** @return a buffer owning pixels, an array of size bytes allocated with new[]. */
+        static FITSPixelBuffer fromArray(uint8_t *pixels, qint64 size);
+        /** @return a buffer over pixels adopted from blob, see FITSBlob::adoptPixels(). */
+        static FITSPixelBuffer fromBlob(const QSharedPointer<FITSBlob> &blob, uint8_t *pixels, qint64 size);
+
+        bool isNull() const
+        {
+            return !d;
+        }
+        qint64 size() const
+        {
+            return d ? d->size : 0;
+        }
+        /** @return true if other buffers share these pixels. */
+        bool isShared() const;
+        /** @return the blob the pixels were adopted from, if any. */
+        QSharedPointer<FITSBlob> blob() const
+        {
+            return d ? d->blob : QSharedPointer<FITSBlob>();
+        }
+
+        const uint8_t *constData() const
+        {
+            return d ? d->pixels : nullptr;
+        }
+
+        /**
+         * @brief data Pixels that may be modified, copied first if shared.
+         * @return the pixels, or nullptr if the buffer is null or the copy could not be allocated.
+         */
+        uint8_t *data();
+
+        /** Release the pixels, the buffer becomes null. */
+        void reset()
+        {
+            d.reset();
+        }
+
+    private:
+        struct Storage : public QSharedData
+        {
+            enum Owner
+            {
+                POOL,
+                ARRAY,
+                BLOB
+            };
+
+            ~Storage();
+
+            uint8_t *pixels { nullptr };
+            qint64 size { 0 };
+            qint64 capacity { 0 };
+            Owner owner { POOL };
+            QSharedPointer<FITSBlob> blob;
+        };
+
+        QExplicitlySharedDataPointer<Storage> d;
+};
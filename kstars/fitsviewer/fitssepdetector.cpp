@@ -16,9 +16,12 @@
 #include "Options.h"
 #include "kspaths.h"
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <math.h>
 #include <QPointer>
+#include <QThread>
 #include <QtConcurrent>
 
 #ifdef HAVE_STELLARSOLVER
@@ -53,6 +56,176 @@
 // (e.g. unfiltered number of stars detected,background sky level). Waiting on rlancaste's
 // investigations into SEP before doing this.
 
+#ifdef HAVE_STELLARSOLVER
+namespace
+{
+// Regions are not split in tiles smaller than that many pixels per side, so that margins stay a small part of tiles
+constexpr int kMinTileSide = 1024;
+// Tiles extend that far past their core, so that sources straddling the core border are extracted whole
+constexpr int kMinTileMargin = 64;
+// Sources of two tiles closer than that, in pixels, are the same source
+constexpr float kDuplicateDistance = 2;
+// Stands for no limit on the number of sources a tile keeps
+constexpr int kUnlimitedStars = 1000000;
+
+struct ExtractionTile
+{
+    // Sources centered in the core belong to the tile
+    QRect core;
+    QList<FITSImage::Star> stars;
+    FITSImage::Background background;
+    bool extracted { false };
+};
+
+// Cores partitioning the region, about one per thread
+QVector<ExtractionTile> makeTiles(const QRect &region, int minSide)
+{
+    const int threads = std::max(1, QThread::idealThreadCount());
+    const int side = std::max(minSide, static_cast<int>(std::sqrt(double(region.width()) * region.height() / threads)));
+    const int columns = std::max(1, region.width() / side);
+    const int rows = std::max(1, region.height() / side);
+
+    QVector<ExtractionTile> tiles;
+    for (int row = 0; row < rows; row++)
+    {
+        const int top = region.y() + region.height() * row / rows;
+        const int bottom = region.y() + region.height() * (row + 1) / rows;
+        for (int column = 0; column < columns; column++)
+        {
+            const int left = region.x() + region.width() * column / columns;
+            const int right = region.x() + region.width() * (column + 1) / columns;
+            ExtractionTile tile;
+            tile.core = QRect(left, top, right - left, bottom - top);
+            tiles.append(tile);
+        }
+    }
+    return tiles;
+}
+
+// Filters of the profile that depend on the whole list of sources, applied once the tiles are merged
+void applyGlobalFilters(QList<FITSImage::Star> &stars, const SSolver::Parameters &parameters)
+{
+    std::sort(stars.begin(), stars.end(), [](const FITSImage::Star & star1, const FITSImage::Star & star2)
+    {
+        return star1.flux > star2.flux;
+    });
+
+    if (parameters.initialKeep > 0 && stars.count() > parameters.initialKeep)
+        stars = stars.mid(0, parameters.initialKeep);
+    if (parameters.removeBrightest > 0)
+        stars = stars.mid(static_cast<int>(stars.count() * parameters.removeBrightest / 100));
+    if (parameters.removeDimmest > 0)
+        stars = stars.mid(0, stars.count() - static_cast<int>(stars.count() * parameters.removeDimmest / 100));
+    if (parameters.keepNum > 0 && stars.count() > parameters.keepNum)
+        stars = stars.mid(0, parameters.keepNum);
+}
+
+// Extract sources of the tiles in parallel, then merge them as if the region was extracted at once.
+// skyPixels is the number of pixels the combined background level was estimated from.
+void extractTiled(FITSData const *data, const SSolver::Parameters &parameters, bool runHFR, const QRect &region,
+                  QVector<ExtractionTile> &tiles, QList<FITSImage::Star> &stars, FITSImage::Background &background,
+                  int &skyPixels)
+{
+    // Tiles run on their own threads and filter their sources only locally
+    SSolver::Parameters tileParameters = parameters;
+    tileParameters.partition = false;
+    tileParameters.initialKeep = kUnlimitedStars;
+    tileParameters.keepNum = kUnlimitedStars;
+    tileParameters.removeBrightest = 0;
+    tileParameters.removeDimmest = 0;
+
+    const int margin = std::max(kMinTileMargin, static_cast<int>(std::ceil(4 * parameters.maxSize)));
+
+    QtConcurrent::blockingMap(tiles, [&](ExtractionTile & tile)
+    {
+        QScopedPointer<StellarSolver, QScopedPointerDeleteLater> solver(new StellarSolver(data->getStatistics(),
+                data->getImageBuffer()));
+        solver->setParameters(tileParameters);
+        if (!solver->extract(runHFR, tile.core.adjusted(-margin, -margin, margin, margin) & region))
+            return;
+
+        tile.background = solver->getBackground();
+        tile.extracted = true;
+        // Sources right on the border may be centered on either side by each tile, so both tiles keep them
+        const QRectF owned = QRectF(tile.core).adjusted(-kDuplicateDistance, -kDuplicateDistance, kDuplicateDistance,
+                             kDuplicateDistance);
+        for (const auto &star : solver->getStarList())
+        {
+            if (owned.contains(star.x, star.y))
+                tile.stars.append(star);
+        }
+    });
+
+    // Sources of each tile, sorted by x so that duplicates are next to each other
+    QVector<QPair<FITSImage::Star, int>> sources;
+    for (int i = 0; i < tiles.count(); i++)
+    {
+        for (const auto &star : tiles[i].stars)
+            sources.append(qMakePair(star, i));
+    }
+    std::sort(sources.begin(), sources.end(), [](const QPair<FITSImage::Star, int> &source1,
+              const QPair<FITSImage::Star, int> &source2)
+    {
+        return source1.first.x < source2.first.x;
+    });
+
+    // Of the same source found by two tiles, keep the one with the most flux
+    QVector<bool> duplicate(sources.count(), false);
+    for (int i = 0; i < sources.count(); i++)
+    {
+        for (int j = i + 1; j < sources.count() && !duplicate[i]; j++)
+        {
+            const FITSImage::Star &star1 = sources[i].first;
+            const FITSImage::Star &star2 = sources[j].first;
+            if (star2.x - star1.x >= kDuplicateDistance)
+                break;
+            if (duplicate[j] || sources[i].second == sources[j].second ||
+                    std::hypot(star2.x - star1.x, star2.y - star1.y) >= kDuplicateDistance)
+                continue;
+
+            if (star2.flux > star1.flux)
+                duplicate[i] = true;
+            else
+                duplicate[j] = true;
+        }
+    }
+
+    stars.clear();
+    for (int i = 0; i < sources.count(); i++)
+    {
+        if (!duplicate[i])
+            stars.append(sources[i].first);
+    }
+
+    // The background of the region combines those of all the tiles that were extracted, weighted by their area.
+    // Each tile estimated its level from its own sky pixels, so the combined level rests on all of them.
+    double pixels = 0, mean = 0, variance = 0;
+    background = FITSImage::Background();
+    skyPixels = 0;
+    for (const auto &tile : tiles)
+    {
+        if (!tile.extracted)
+            continue;
+        const double area = double(tile.core.width()) * tile.core.height();
+        pixels += area;
+        mean += area * tile.background.global;
+        variance += area * tile.background.globalrms * tile.background.globalrms;
+        background.bw = std::max(background.bw, tile.background.bw);
+        background.bh = std::max(background.bh, tile.background.bh);
+        skyPixels += tile.background.bw * tile.background.bh;
+    }
+    if (pixels > 0)
+    {
+        background.global = mean / pixels;
+        background.globalrms = std::sqrt(variance / pixels);
+    }
+    background.num_stars_detected = stars.count();
+
+    applyGlobalFilters(stars, parameters);
+}
+}
+#endif
+
 QFuture<bool> FITSSEPDetector::findSources(QRect const &boundary)
 {
     return QtConcurrent::run(this, &FITSSEPDetector::findSourcesAndBackground, boundary);
@@ -70,8 +243,6 @@ bool FITSSEPDetector::findSourcesAndBackground(QRect const &boundary)
 
     int optionsProfileIndex = getValue("optionsProfileIndex", -1).toInt();
     Ekos::ProfileGroup group = static_cast<Ekos::ProfileGroup>(getValue("optionsProfileGroup", 1).toInt());
-    QScopedPointer<StellarSolver, QScopedPointerDeleteLater> solver(new StellarSolver(m_ImageData->getStatistics(),
-            m_ImageData->getImageBuffer()));
     QString filename = "";
     QPointer<FITSData> image(m_ImageData);
     switch(group)
@@ -112,33 +283,51 @@ bool FITSSEPDetector::findSourcesAndBackground(QRect const &boundary)
                 break;
         }
     }
+    SSolver::Parameters parameters; // This is default
     if (optionsProfileIndex >= 0 && optionsList.count() > optionsProfileIndex)
     {
-        solver->setParameters(optionsList[optionsProfileIndex]);
+        parameters = optionsList[optionsProfileIndex];
         qCDebug(KSTARS_FITS) << "Sextract with: " << optionsList[optionsProfileIndex].listName;
     }
-    else
-        solver->setParameters(SSolver::Parameters()); // This is default
 
     QList<FITSImage::Star> stars;
+    FITSImage::Background bg;
+    int skyPixels = 0;
     const bool runHFR = group != Ekos::AlignProfiles;
 
-    if (boundary.isValid())
-        solver->extract(runHFR, boundary);
+    const QRect frame(0, 0, m_ImageData->width(), m_ImageData->height());
+    const QRect region = boundary.isValid() ? boundary & frame : frame;
+    QVector<ExtractionTile> tiles;
+    if (getValue("tiledExtraction", Options::tiledStarExtraction()).toBool())
+        tiles = makeTiles(region, getValue("minTileSide", kMinTileSide).toInt());
+
+    if (tiles.count() > 1)
+    {
+        extractTiled(m_ImageData, parameters, runHFR, region, tiles, stars, bg, skyPixels);
+    }
     else
-        solver->extract(runHFR);
+    {
+        QScopedPointer<StellarSolver, QScopedPointerDeleteLater> solver(new StellarSolver(m_ImageData->getStatistics(),
+                m_ImageData->getImageBuffer()));
+        solver->setParameters(parameters);
+
+        if (boundary.isValid())
+            solver->extract(runHFR, boundary);
+        else
+            solver->extract(runHFR);
 
-    stars = solver->getStarList();
+        stars = solver->getStarList();
+        bg = solver->getBackground();
+        skyPixels = bg.bw * bg.bh;
+    }
 
     // If m_ImageData goes out of scope, also return.
     if (stars.empty() || image.isNull())
         return false;
 
-    auto bg = solver->getBackground();
-
     skyBG.mean = bg.global;
     skyBG.sigma = bg.globalrms;
-    skyBG.numPixelsInSkyEstimate = bg.bw * bg.bh;
+    skyBG.numPixelsInSkyEstimate = skyPixels;
     skyBG.setStarsDetected(bg.num_stars_detected);
     m_ImageData->setSkyBackground(skyBG);
 
@@ -26,6 +26,8 @@ class FITSSEPDetector : public FITSStarDetector
         QFuture<bool> findSources(QRect const &boundary = QRect()) override;
 
         /** @brief Find sources in the parent FITS data file as well as background sky information.
+         * @note Unless the "tiledExtraction" setting is false, regions of more than one "minTileSide" tile per side are
+         * split in overlapping tiles extracted in parallel. Sources found twice in the overlaps are merged.
          */
         bool findSourcesAndBackground(QRect const &boundary = QRect());
 
@@ -98,7 +98,7 @@ void FITSView::doStretch(QImage *outputImage)
     else if (autoStretch)
     {
         // Compute new auto-stretch params.
-        stretchParams = stretch.computeParams(m_ImageData->getImageBuffer());
+        stretchParams = stretch.computeParams(m_ImageData->getImageBuffer(), m_ImageData->getSampleHistograms());
         tempParams = stretchParams;
     }
     else
@@ -354,6 +354,7 @@ void FITSView::clearData()
 
     setWidget(noImageLabel);
 
+    m_Pyramid.clear();
     m_ImageData.clear();
 }
 
@@ -615,6 +616,7 @@ bool FITSView::rescale(FITSZoom type)
     initDisplayImage();
     m_ImageFrame->setScaledContents(true);
     doStretch(&rawImage);
+    m_Pyramid.setImage(rawImage);
     setWidget(m_ImageFrame);
 
     // This is needed by fitstab, even if the zoom doesn't change, to change the stretch UI.
@@ -722,7 +724,7 @@ bool FITSView::isLargeImage()
 // and get scale returns the ratio of that pixmap size to the image size.
 double FITSView::getScale()
 {
-    return (isLargeImage() ? 1.0 : currentZoom / ZOOM_DEFAULT) / m_PreviewSampling;
+    return (isLargeImage() ? 1.0 / (1 << m_PyramidLevel) : currentZoom / ZOOM_DEFAULT) / m_PreviewSampling;
 }
 
 // scaleSize() is only used with the large-image rendering strategy. It may increase the line
@@ -732,7 +734,7 @@ double FITSView::scaleSize(double size)
 {
     if (!isLargeImage())
         return size;
-    return (currentZoom > 100.0 ? size : std::round(size * 100.0 / currentZoom)) / m_PreviewSampling;
+    return (currentZoom > 100.0 ? size : std::round(size * 100.0 / currentZoom)) / (m_PreviewSampling << m_PyramidLevel);
 }
 
 void FITSView::updateFrame(bool now)
@@ -768,7 +770,10 @@ void FITSView::updateFrame(bool now)
 
 void FITSView::updateFrameLargeImage()
 {
-    if (!displayPixmap.convertFromImage(rawImage))
+    // Zoomed out, a level of the pyramid with about the resolution of the screen is enough.
+    // Clipping is drawn in image pixels, so it needs the full image.
+    m_PyramidLevel = showClipping ? 0 : m_Pyramid.levelFor(m_PreviewSampling * currentZoom / ZOOM_DEFAULT);
+    if (!displayPixmap.convertFromImage(m_Pyramid.level(m_PyramidLevel)))
         return;
 
     QPainter painter(&displayPixmap);
@@ -778,15 +783,16 @@ void FITSView::updateFrameLargeImage()
     font.setPixelSize(scaleSize(FONT_SIZE));
     painter.setFont(font);
 
-    drawOverlay(&painter, 1.0 / m_PreviewSampling);
-    drawStarFilter(&painter, 1.0 / m_PreviewSampling);
+    drawOverlay(&painter, getScale());
+    drawStarFilter(&painter, getScale());
     m_ImageFrame->setPixmap(displayPixmap);
-    m_ImageFrame->resize(((m_PreviewSampling * currentZoom) / 100.0) * displayPixmap.size());
+    m_ImageFrame->resize(((m_PreviewSampling * currentZoom) / 100.0) * rawImage.size());
 }
 
 void FITSView::updateFrameSmallImage()
 {
-    QImage scaledImage = rawImage.scaled(currentWidth, currentHeight, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    m_PyramidLevel = 0;
+    QImage scaledImage = m_Pyramid.scaled(QSize(currentWidth, currentHeight));
     if (!displayPixmap.convertFromImage(scaledImage))
         return;
 
@@ -1961,6 +1967,13 @@ QPoint FITSView::getImagePoint(QPoint viewPortPoint)
     return imagePoint;
 }
 
+QImage FITSView::getDisplayImage(int maxWidth)
+{
+    if (rawImage.width() <= maxWidth)
+        return rawImage;
+    return m_Pyramid.scaled(QSize(maxWidth, rawImage.height()));
+}
+
 void FITSView::initDisplayImage()
 {
     // Account for leftover when sampling. Thus a 5-wide image sampled by 2
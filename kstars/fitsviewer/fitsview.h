@@ -11,6 +11,7 @@
 
 #include <config-kstars.h>
 #include "stretch.h"
+#include "imagepyramid.h"
 
 #ifdef HAVE_DATAVISUALIZATION
 #include "starprofileviewer.h"
@@ -93,6 +94,11 @@ class FITSView : public QScrollArea
         {
             return rawImage;
         }
+        /**
+         * @brief getDisplayImage The display image downscaled to at most the given width, read from
+         * the smallest level of the display pyramid that is at least that wide.
+         */
+        QImage getDisplayImage(int maxWidth);
         const QPixmap &getDisplayPixmap() const
         {
             return displayPixmap;
@@ -352,6 +358,10 @@ class FITSView : public QScrollArea
 
         // Original full-size image
         QImage rawImage;
+        // Halved copies of rawImage, so that zoomed out frames are drawn from a level close to the screen size
+        ImagePyramid m_Pyramid;
+        // Level of m_Pyramid in displayPixmap, for large images
+        int m_PyramidLevel { 0 };
         // Actual pixmap after all the overlays
         QPixmap displayPixmap;
 
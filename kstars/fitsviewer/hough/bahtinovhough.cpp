@@ -0,0 +1,311 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "bahtinovhough.h"
+
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+// Angles of the accumulator, one per degree
+constexpr int kAngles = 180;
+// Pixels vote for lines within that many degrees of their gradient orientation
+constexpr double kVoteWindow = 5;
+// Pixels vote if they are that many standard deviations above the background
+constexpr double kVoteSigma = 3;
+// Half size of the window of the structure tensor
+constexpr int kTensorRadius = 2;
+// Spikes of a Bahtinov mask are at least that many degrees apart
+constexpr int kMinSpikeSeparation = 18;
+// Refinement projects the votes on angles kRefineStep apart, up to kRefineSteps steps on either side
+constexpr double kRefineStep = 0.1;
+constexpr int kRefineSteps = 40;
+// Fewer votes are not worth an accumulator of their own
+constexpr int kMinBandVotes = 4096;
+
+struct Band
+{
+    int begin;
+    int end;
+    QVector<double> accumulator;
+};
+
+struct Projection
+{
+    double theta;
+    double score;
+    double r;
+};
+
+// Median, and standard deviation estimated from the median absolute deviation
+void background(const float *image, int size, float &median, float &sigma)
+{
+    std::vector<float> samples(image, image + size);
+    std::nth_element(samples.begin(), samples.begin() + size / 2, samples.end());
+    median = samples[size / 2];
+
+    for (int i = 0; i < size; i++)
+        samples[i] = std::fabs(image[i] - median);
+    std::nth_element(samples.begin(), samples.begin() + size / 2, samples.end());
+    sigma = 1.4826f * samples[size / 2];
+}
+
+// Splits weight between the two offsets closest to r
+inline void splat(double *offsets, int count, double r, double weight)
+{
+    const int index = static_cast<int>(std::floor(r));
+    const double fraction = r - index;
+    if (index >= 0 && index < count)
+        offsets[index] += weight * (1 - fraction);
+    if (index + 1 >= 0 && index + 1 < count)
+        offsets[index + 1] += weight * fraction;
+}
+}
+
+BahtinovHough::BahtinovHough(const float *image, int width, int height)
+    : m_Image(image), m_Width(width), m_Height(height)
+{
+    m_CenterX = static_cast<int>(std::floor((width + 1) / 2.0));
+    m_CenterY = static_cast<int>(std::floor((height + 1) / 2.0));
+}
+
+QVector<HoughLine *> BahtinovHough::findSpikes(int averageRows)
+{
+    QVector<HoughLine *> lines;
+
+    collectVotes();
+    if (m_Votes.isEmpty())
+        return lines;
+
+    // The three strongest whole degrees, clearing their neighbourhood so that each spike is found once
+    const QVector<double> scores = accumulate(averageRows);
+    QVector<bool> cleared(kAngles, false);
+    QVector<Projection> projections;
+    for (int spike = 0; spike < 3; spike++)
+    {
+        int best = -1;
+        for (int angle = 0; angle < kAngles; angle++)
+        {
+            if (!cleared[angle] && (best < 0 || scores[angle] > scores[best]))
+                best = angle;
+        }
+
+        for (int angle = best - kMinSpikeSeparation; angle < best + kMinSpikeSeparation; angle++)
+            cleared[(angle + kAngles) % kAngles] = true;
+
+        for (int step = -kRefineSteps; step <= kRefineSteps; step++)
+            projections.append({ best + step * kRefineStep, 0, 0 });
+    }
+
+    QtConcurrent::blockingMap(projections, [&](Projection & projection)
+    {
+        projection.score = project(projection.theta, kAngles / 2, averageRows, projection.r);
+    });
+
+    const int steps = 2 * kRefineSteps + 1;
+    for (int spike = 0; spike < 3; spike++)
+    {
+        const Projection *refined = projections.constData() + spike * steps;
+        const int best = std::max_element(refined, refined + steps, [](const Projection & a, const Projection & b)
+        {
+            return a.score < b.score;
+        }) - refined;
+
+        double theta = refined[best].theta;
+        double r = refined[best].r;
+        if (best > 0 && best < steps - 1)
+        {
+            const double before = refined[best - 1].score;
+            const double after = refined[best + 1].score;
+            const double curvature = before - 2 * refined[best].score + after;
+            if (curvature < 0)
+            {
+                theta += 0.5 * (before - after) / curvature * kRefineStep;
+                project(theta, kAngles / 2, averageRows, r);
+            }
+        }
+
+        // Same line, with its angle back in [0, 180)
+        if (theta < 0 || theta >= kAngles)
+        {
+            theta += theta < 0 ? kAngles : -kAngles;
+            r = 2 * m_CenterY - r;
+        }
+
+        lines.append(new HoughLine(theta * M_PI / 180.0, r, m_Width, m_Height, qRound(refined[best].score)));
+    }
+
+    return lines;
+}
+
+void BahtinovHough::collectVotes()
+{
+    m_Votes.clear();
+    const int size = m_Width * m_Height;
+    if (m_Width < 2 * kTensorRadius + 1 || m_Height < 2 * kTensorRadius + 1)
+        return;
+
+    float median = 0, sigma = 0;
+    background(m_Image, size, median, sigma);
+    const float threshold = median + kVoteSigma * sigma;
+
+    // Blur with a 3x3 binomial kernel so that the gradients of faint spikes stand out of the noise
+    std::vector<float> blurred(m_Image, m_Image + size), pass(m_Image, m_Image + size);
+    for (int y = 0; y < m_Height; y++)
+    {
+        for (int x = 1; x < m_Width - 1; x++)
+        {
+            const float *p = m_Image + y * m_Width + x;
+            pass[y * m_Width + x] = (p[-1] + 2 * p[0] + p[1]) / 4;
+        }
+    }
+    for (int y = 1; y < m_Height - 1; y++)
+    {
+        for (int x = 0; x < m_Width; x++)
+        {
+            const float *p = pass.data() + y * m_Width + x;
+            blurred[y * m_Width + x] = (p[-m_Width] + 2 * p[0] + p[m_Width]) / 4;
+        }
+    }
+
+    // Sobel gradients, zero on the edges
+    std::vector<float> gx(size, 0), gy(size, 0);
+    for (int y = 1; y < m_Height - 1; y++)
+    {
+        for (int x = 1; x < m_Width - 1; x++)
+        {
+            const float *p = blurred.data() + y * m_Width + x;
+            const float *above = p - m_Width;
+            const float *below = p + m_Width;
+            gx[y * m_Width + x] = (above[1] + 2 * p[1] + below[1]) - (above[-1] + 2 * p[-1] + below[-1]);
+            gy[y * m_Width + x] = (below[-1] + 2 * below[0] + below[1]) - (above[-1] + 2 * above[0] + above[1]);
+        }
+    }
+
+    // Only the inner circle votes, as it is the part of the image present at all angles of a rotation
+    const double radius = 0.5 * std::sqrt(2.0) * std::min(m_CenterX, m_CenterY);
+    for (int y = kTensorRadius; y < m_Height - kTensorRadius; y++)
+    {
+        for (int x = kTensorRadius; x < m_Width - kTensorRadius; x++)
+        {
+            const float value = m_Image[y * m_Width + x];
+            if (value <= threshold || std::hypot(x - m_CenterX, y - m_CenterY) > radius)
+                continue;
+
+            double xx = 0, yy = 0, xy = 0;
+            for (int dy = -kTensorRadius; dy <= kTensorRadius; dy++)
+            {
+                for (int dx = -kTensorRadius; dx <= kTensorRadius; dx++)
+                {
+                    const int index = (y + dy) * m_Width + x + dx;
+                    xx += gx[index] * gx[index];
+                    yy += gy[index] * gy[index];
+                    xy += gx[index] * gy[index];
+                }
+            }
+
+            // The gradient is normal to the line, whose normal is (sin theta, cos theta)
+            const double normal = 0.5 * std::atan2(2 * xy, xx - yy);
+            const double theta = std::fmod((M_PI / 2 - normal) * 180.0 / M_PI + 2 * kAngles, kAngles);
+            m_Votes.append({ static_cast<float>(x), static_cast<float>(y), value - median, static_cast<float>(theta) });
+        }
+    }
+}
+
+QVector<double> BahtinovHough::accumulate(int averageRows) const
+{
+    double sines[kAngles], cosines[kAngles];
+    for (int angle = 0; angle < kAngles; angle++)
+    {
+        sines[angle] = std::sin(angle * M_PI / 180.0);
+        cosines[angle] = std::cos(angle * M_PI / 180.0);
+    }
+
+    const int votes = m_Votes.count();
+    const int bandCount = std::max(1, std::min(QThread::idealThreadCount(), votes / kMinBandVotes));
+    QVector<Band> bands;
+    for (int i = 0; i < bandCount; i++)
+        bands.append({ votes * i / bandCount, votes * (i + 1) / bandCount, QVector<double>() });
+
+    QtConcurrent::blockingMap(bands, [&](Band & band)
+    {
+        band.accumulator.fill(0, kAngles * m_Height);
+        for (int i = band.begin; i < band.end; i++)
+        {
+            const Vote &vote = m_Votes[i];
+            const int first = static_cast<int>(std::ceil(vote.theta - kVoteWindow));
+            const int last = static_cast<int>(std::floor(vote.theta + kVoteWindow));
+            for (int angle = first; angle <= last; angle++)
+            {
+                const int index = (angle + kAngles) % kAngles;
+                const double r = m_CenterY + (vote.x - m_CenterX) * sines[index] + (vote.y - m_CenterY) * cosines[index];
+                splat(band.accumulator.data() + index * m_Height, m_Height, r, vote.weight);
+            }
+        }
+    });
+
+    QVector<double> &accumulator = bands[0].accumulator;
+    for (int i = 1; i < bands.count(); i++)
+    {
+        for (int j = 0; j < accumulator.count(); j++)
+            accumulator[j] += bands[i].accumulator[j];
+    }
+
+    QVector<double> scores(kAngles);
+    for (int angle = 0; angle < kAngles; angle++)
+    {
+        double r = 0;
+        scores[angle] = peak(accumulator.mid(angle * m_Height, m_Height), averageRows, r);
+    }
+    return scores;
+}
+
+double BahtinovHough::project(double theta, double window, int averageRows, double &r) const
+{
+    QVector<double> offsets(m_Height, 0);
+    const double sine = std::sin(theta * M_PI / 180.0);
+    const double cosine = std::cos(theta * M_PI / 180.0);
+
+    for (const Vote &vote : m_Votes)
+    {
+        double distance = std::fabs(vote.theta - theta);
+        distance = std::min(distance, kAngles - distance);
+        if (distance > window)
+            continue;
+
+        splat(offsets.data(), m_Height, m_CenterY + (vote.x - m_CenterX) * sine + (vote.y - m_CenterY) * cosine, vote.weight);
+    }
+
+    return peak(offsets, averageRows, r);
+}
+
+double BahtinovHough::peak(const QVector<double> &offsets, int averageRows, double &r)
+{
+    const int count = offsets.count();
+    const int half = (averageRows - 1) / 2;
+
+    QVector<double> sums(count, 0);
+    for (int i = 0; i < count; i++)
+    {
+        for (int j = std::max(0, i - half); j <= std::min(count - 1, i + half); j++)
+            sums[i] += offsets[j];
+    }
+
+    const int best = std::max_element(sums.constBegin(), sums.constEnd()) - sums.constBegin();
+    r = best;
+    if (best > 0 && best < count - 1)
+    {
+        const double curvature = sums[best - 1] - 2 * sums[best] + sums[best + 1];
+        if (curvature < 0)
+            r += 0.5 * (sums[best - 1] - sums[best + 1]) / curvature;
+    }
+    return sums[best];
+}
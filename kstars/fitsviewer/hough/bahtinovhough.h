@@ -0,0 +1,73 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "houghline.h"
+
+#include <QVector>
+
+/**
+ * @class BahtinovHough
+ * @short Hough transform finding the three diffraction spikes of a Bahtinov mask.
+ *
+ * Lines are parameterized like those of the rotation search of FITSBahtinovDetector: a line of angle theta and
+ * offset r is row r of the image rotated by theta around its center, which is what HoughLine expects.
+ *
+ * Pixels brighter than the background vote with their brightness above the background. A Sobel pass of the
+ * slightly blurred image gives each pixel its dominant gradient orientation, smoothed over a 5x5 structure
+ * tensor, and a pixel votes only for lines within a few degrees of the orientation that gradient implies,
+ * instead of for all 180 angles. The accumulator is filled by several threads, each with its own copy.
+ *
+ * Orientations of noisy spikes are only good to a few degrees, so each of the three strongest angles, at least
+ * 18 degrees apart, is then refined by projecting all votes, whatever their orientation, on angles a tenth of
+ * a degree apart around it, and interpolating the peak of the projections.
+ */
+class BahtinovHough
+{
+    public:
+        /**
+         * @param image width * height samples of luminance, row by row. The image must outlive the transform.
+         */
+        BahtinovHough(const float *image, int width, int height);
+
+        /**
+         * @brief findSpikes Find the three Bahtinov spikes.
+         * @param averageRows Number of neighbouring offsets summed into the score of a line, must be odd.
+         * @return the lines of the spikes, by decreasing score, owned by the caller. Empty if no pixel stands out.
+         */
+        QVector<HoughLine *> findSpikes(int averageRows);
+
+    private:
+        struct Vote
+        {
+            float x;
+            float y;
+            float weight;
+            // Angle of the line through the pixel implied by its gradient, in degrees in [0, 180)
+            float theta;
+        };
+
+        // Collects the pixels brighter than the background within the inner circle
+        void collectVotes();
+
+        // Score of each whole degree, summed from the votes close to their own orientation
+        QVector<double> accumulate(int averageRows) const;
+
+        // Score of the best line at angle theta, from votes whose orientation is within window degrees
+        double project(double theta, double window, int averageRows, double &r) const;
+
+        // Peak of the sum of averageRows neighbouring offsets, interpolated offset in r
+        static double peak(const QVector<double> &offsets, int averageRows, double &r);
+
+        const float *m_Image { nullptr };
+        int m_Width { 0 };
+        int m_Height { 0 };
+        // Center of rotation, as in HoughLine
+        int m_CenterX { 0 };
+        int m_CenterY { 0 };
+        QVector<Vote> m_Votes;
+};
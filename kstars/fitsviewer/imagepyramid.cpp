@@ -0,0 +1,187 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "imagepyramid.h"
+
+#include <QMutexLocker>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+namespace
+{
+// Images are not halved once they are no larger than that on their longer side
+constexpr int kMinLevelSide = 256;
+
+// 2x2 box filter of the channels of each pixel. Odd last rows and columns are repeated.
+template <int BytesPerPixel>
+void halvePixels(const QImage &image, QImage &result)
+{
+    const int lastX = image.width() - 1;
+    const int lastY = image.height() - 1;
+
+    for (int y = 0; y < result.height(); y++)
+    {
+        const uchar *row0 = image.constScanLine(2 * y);
+        const uchar *row1 = image.constScanLine(std::min(2 * y + 1, lastY));
+        uchar *output = result.scanLine(y);
+
+        for (int x = 0; x < result.width(); x++)
+        {
+            const int left = 2 * x * BytesPerPixel;
+            const int right = std::min(2 * x + 1, lastX) * BytesPerPixel;
+            for (int c = 0; c < BytesPerPixel; c++)
+                output[x * BytesPerPixel + c] = (row0[left + c] + row0[right + c] + row1[left + c] + row1[right + c] + 2) >> 2;
+        }
+    }
+}
+
+// Indexes of the image are its grey levels, so they can be averaged
+bool isGreyRamp(const QImage &image)
+{
+    if (image.colorCount() != 256)
+        return false;
+    for (int i = 0; i < 256; i++)
+    {
+        if (image.color(i) != qRgb(i, i, i))
+            return false;
+    }
+    return true;
+}
+}
+
+ImagePyramid::~ImagePyramid()
+{
+    clear();
+    m_Builder.waitForFinished();
+}
+
+void ImagePyramid::setImage(const QImage &image)
+{
+    int count = 0;
+    if (!image.isNull())
+    {
+        count = 1;
+        for (int w = image.width(), h = image.height(); std::max(w, h) > kMinLevelSide; count++)
+        {
+            w = (w + 1) / 2;
+            h = (h + 1) / 2;
+        }
+    }
+
+    // Stops the builder of the previous image, it gives up after the level in progress
+    clear();
+    m_Builder.waitForFinished();
+
+    QMutexLocker locker(&m_Mutex);
+    const quint64 generation = ++m_Generation;
+    m_Levels.clear();
+    if (!image.isNull())
+        m_Levels.append(image);
+    m_LevelCount = count;
+
+    if (count > 1)
+        m_Builder = QtConcurrent::run(this, &ImagePyramid::buildLevels, generation);
+}
+
+void ImagePyramid::clear()
+{
+    QMutexLocker locker(&m_Mutex);
+    ++m_Generation;
+    m_Levels.clear();
+    m_LevelCount = 0;
+}
+
+int ImagePyramid::levelCount() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_LevelCount;
+}
+
+int ImagePyramid::levelFor(double scale) const
+{
+    const int count = levelCount();
+    int level = 0;
+    while (level + 1 < count && scale * (1 << (level + 1)) <= 1)
+        level++;
+    return level;
+}
+
+QImage ImagePyramid::level(int index)
+{
+    QMutexLocker locker(&m_Mutex);
+    if (m_Levels.isEmpty())
+        return QImage();
+
+    index = std::max(0, std::min(index, m_LevelCount - 1));
+    while (m_Levels.count() <= index)
+        appendLevel();
+    return m_Levels[index];
+}
+
+QImage ImagePyramid::scaled(const QSize &size)
+{
+    const QImage image = level(0);
+    if (image.isNull() || size.isEmpty())
+        return image;
+
+    const QSize fitted = image.size().scaled(size, Qt::KeepAspectRatio);
+    const double scale = std::max(fitted.width() / double(image.width()), fitted.height() / double(image.height()));
+    const QImage source = level(levelFor(scale));
+    if (source.size() == fitted)
+        return source;
+    return source.scaled(fitted, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
+void ImagePyramid::buildLevels(quint64 generation)
+{
+    while (true)
+    {
+        QImage last;
+        int index = 0;
+        {
+            QMutexLocker locker(&m_Mutex);
+            if (generation != m_Generation || m_Levels.count() >= m_LevelCount)
+                return;
+            last = m_Levels.last();
+            index = m_Levels.count();
+        }
+
+        // Halved unlocked, so that the levels stay available meanwhile
+        const QImage next = halve(last);
+
+        QMutexLocker locker(&m_Mutex);
+        // The level may have been built on demand meanwhile
+        if (generation == m_Generation && m_Levels.count() == index)
+            m_Levels.append(next);
+    }
+}
+
+void ImagePyramid::appendLevel()
+{
+    m_Levels.append(halve(m_Levels.last()));
+}
+
+QImage ImagePyramid::halve(const QImage &image)
+{
+    const int width = (image.width() + 1) / 2;
+    const int height = (image.height() + 1) / 2;
+
+    if (image.format() == QImage::Format_Indexed8 && isGreyRamp(image))
+    {
+        QImage result(width, height, QImage::Format_Indexed8);
+        result.setColorTable(image.colorTable());
+        halvePixels<1>(image, result);
+        return result;
+    }
+    if (image.format() == QImage::Format_RGB32)
+    {
+        QImage result(width, height, QImage::Format_RGB32);
+        halvePixels<4>(image, result);
+        return result;
+    }
+    return image.scaled(width, height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
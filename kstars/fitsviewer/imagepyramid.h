@@ -0,0 +1,76 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QFuture>
+#include <QImage>
+#include <QMutex>
+#include <QVector>
+
+/**
+ * @class ImagePyramid
+ * @short Successively halved copies of a stretched display image.
+ *
+ * Level 0 is the image itself, and each level is half the size of the previous one, down to a few
+ * hundred pixels. Zooming out or scaling the image to a screen sized preview then reads a level at
+ * most twice as large as the output, so the cost follows the number of screen pixels instead of
+ * the number of image pixels.
+ *
+ * Levels are built on a background thread as soon as a new image is set, and on demand if one is
+ * needed before it is ready. Setting a new image, for instance once the stretch changes, drops the
+ * levels of the previous one.
+ *
+ * Images of format Indexed8 with a grey color table and RGB32, as FITSView produces them, are halved
+ * with a 2x2 box filter. Other formats are halved by QImage::scaled().
+ */
+class ImagePyramid
+{
+    public:
+        ImagePyramid() = default;
+        ~ImagePyramid();
+
+        /** @brief setImage Replace the image, dropping the levels of the previous one. */
+        void setImage(const QImage &image);
+
+        /** @brief clear Drop the image and its levels. */
+        void clear();
+
+        /** @return the number of levels of the image, including the image itself. */
+        int levelCount() const;
+
+        /**
+         * @brief levelFor The smallest level that keeps enough resolution for a display scale.
+         * @param scale Ratio of the displayed size to the size of the image.
+         * @return the largest level whose size is at least scale times the size of the image.
+         */
+        int levelFor(double scale) const;
+
+        /** @return the given level, built now if it is not ready yet. Levels past the last are the last. */
+        QImage level(int index);
+
+        /**
+         * @brief scaled The image scaled to fit size, keeping its aspect ratio, read from the smallest
+         * level that is at least that large.
+         */
+        QImage scaled(const QSize &size);
+
+    private:
+        // Builds the missing levels in the background, unless the image changes
+        void buildLevels(quint64 generation);
+        // Appends the next level, m_Mutex locked
+        void appendLevel();
+
+        static QImage halve(const QImage &image);
+
+        mutable QMutex m_Mutex;
+        // Level 0 is the image itself
+        QVector<QImage> m_Levels;
+        int m_LevelCount { 0 };
+        // Incremented each time the image changes, so that a builder of the previous image stops
+        quint64 m_Generation { 0 };
+        QFuture<void> m_Builder;
+};
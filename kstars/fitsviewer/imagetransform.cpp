@@ -0,0 +1,63 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "imagetransform.h"
+
+namespace
+{
+// Fewer rows are not worth a task of their own
+constexpr uint32_t kMinBandRows = 64;
+}
+
+ImageTransform ImageTransform::fromRotation(int rotate, int mirror)
+{
+    if (rotate == 1)
+        rotate = 90;
+    else if (rotate == 2)
+        rotate = 180;
+    else if (rotate == 3)
+        rotate = 270;
+    else if (rotate < 0)
+        rotate = rotate + 360;
+
+    const bool flipX = mirror == 1;
+    const bool flipY = mirror == 2;
+
+    if (rotate < 45 && rotate > -45)
+        return ImageTransform(false, flipX, flipY);
+    // Clockwise, the mirror is rotated with the image
+    if (rotate >= 45 && rotate < 135)
+        return ImageTransform(true, !flipY, flipX);
+    if (rotate >= 135 && rotate < 225)
+        return ImageTransform(false, !flipX, !flipY);
+    if (rotate >= 225 && rotate < 315)
+        return ImageTransform(true, flipY, !flipX);
+    // More than 315 degrees is taken as a reflection across the diagonal
+    return ImageTransform(mirror != 0, false, false);
+}
+
+QPointF ImageTransform::mapPoint(const QPointF &point, double width, double height) const
+{
+    double x = m_Transpose ? point.y() : point.x();
+    double y = m_Transpose ? point.x() : point.y();
+    if (m_FlipX)
+        x = (m_Transpose ? height : width) - x;
+    if (m_FlipY)
+        y = (m_Transpose ? width : height) - y;
+    return QPointF(x, y);
+}
+
+QVector<ImageTransform::Band> ImageTransform::makeBands(uint32_t count, uint32_t step)
+{
+    const uint32_t tasks = std::max(1, QThread::idealThreadCount()) * 4;
+    uint32_t rows = std::max(kMinBandRows, (count + tasks - 1) / tasks);
+    rows = (rows + step - 1) / step * step;
+
+    QVector<Band> bands;
+    for (uint32_t begin = 0; begin < count; begin += rows)
+        bands.append({ begin, std::min(count, begin + rows) });
+    return bands;
+}
@@ -0,0 +1,222 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QPointF>
+#include <QtConcurrent>
+#include <QThread>
+#include <QVector>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class ImageTransform
+ * @short Rotates and mirrors planar images by multiples of 90 degrees.
+ *
+ * Any such transform is an optional transpose followed by optional horizontal and vertical flips
+ * of the result. Transforms without a transpose move whole rows, so they are applied in place by
+ * swapping and reversing rows. Transposes need a second buffer and are applied in square tiles
+ * small enough for both the source and the destination tile to stay in L1 cache, so the strided
+ * side of the copy does not miss on every pixel.
+ *
+ * Each channel is split in bands of destination rows that are processed in parallel.
+ */
+class ImageTransform
+{
+    public:
+        /** The identity. */
+        ImageTransform() = default;
+        ImageTransform(bool transpose, bool flipX, bool flipY) : m_Transpose(transpose), m_FlipX(flipX), m_FlipY(flipY) {}
+
+        /**
+         * @brief fromRotation The transform FITSData::rotFITS() applies.
+         * @param rotate Clockwise rotation in degrees, rounded to a multiple of 90.
+         * @param mirror 1 to mirror horizontally, 2 to mirror vertically, then rotated like the image.
+         */
+        static ImageTransform fromRotation(int rotate, int mirror);
+
+        bool isIdentity() const
+        {
+            return !m_Transpose && !m_FlipX && !m_FlipY;
+        }
+        /** @return true if width and height are exchanged, so the transform can't be applied in place. */
+        bool transposes() const
+        {
+            return m_Transpose;
+        }
+        bool flipsX() const
+        {
+            return m_FlipX;
+        }
+        bool flipsY() const
+        {
+            return m_FlipY;
+        }
+
+        /**
+         * @brief mapPoint Position of a point once transformed.
+         * @param point Position in a width x height image, in pixel units from its edges.
+         */
+        QPointF mapPoint(const QPointF &point, double width, double height) const;
+        /** @return the source axis, 0 for X or 1 for Y, that becomes the given destination axis. */
+        int sourceAxis(int axis) const
+        {
+            return m_Transpose ? 1 - axis : axis;
+        }
+        /** @return -1 if the given destination axis is flipped, 1 otherwise. */
+        int axisSign(int axis) const
+        {
+            return (axis == 0 ? m_FlipX : m_FlipY) ? -1 : 1;
+        }
+
+        /**
+         * @brief apply Transform an image into another buffer, blocking until done.
+         * @param source channels planes of width x height samples, planeSize samples apart.
+         * @param destination Same size as source, planes are planeSize samples apart too.
+         */
+        template <typename T>
+        void apply(const T *source, T *destination, uint32_t width, uint32_t height, uint32_t channels,
+                   size_t planeSize) const;
+
+        /**
+         * @brief applyInPlace Transform an image in its own buffer, blocking until done.
+         * @return false if the transform transposes, in which case the image is left alone.
+         */
+        template <typename T>
+        bool applyInPlace(T *pixels, uint32_t width, uint32_t height, uint32_t channels, size_t planeSize) const;
+
+    private:
+        struct Band
+        {
+            uint32_t begin;
+            uint32_t end;
+        };
+
+        // Bands of count rows, in multiples of step rows
+        static QVector<Band> makeBands(uint32_t count, uint32_t step);
+
+        // Samples per side of a tile, so that two tiles fit in 32 KiB of L1 cache
+        template <typename T>
+        static constexpr uint32_t tileSize()
+        {
+            return sizeof(T) <= 2 ? 64 : sizeof(T) <= 4 ? 32 : 16;
+        }
+
+        template <typename T>
+        void transposeBand(const T *source, T *destination, uint32_t width, uint32_t height, const Band &band) const;
+        template <typename T>
+        void copyBand(const T *source, T *destination, uint32_t width, uint32_t height, const Band &band) const;
+
+        bool m_Transpose { false };
+        bool m_FlipX { false };
+        bool m_FlipY { false };
+};
+
+template <typename T>
+void ImageTransform::apply(const T *source, T *destination, uint32_t width, uint32_t height, uint32_t channels,
+                           size_t planeSize) const
+{
+    // Destination rows
+    const uint32_t rows = m_Transpose ? width : height;
+    QVector<Band> bands = makeBands(rows, m_Transpose ? tileSize<T>() : 1);
+
+    for (uint32_t channel = 0; channel < channels; ++channel)
+    {
+        const T *plane = source + channel * planeSize;
+        T *output = destination + channel * planeSize;
+        QtConcurrent::blockingMap(bands, [&](Band & band)
+        {
+            if (m_Transpose)
+                transposeBand(plane, output, width, height, band);
+            else
+                copyBand(plane, output, width, height, band);
+        });
+    }
+}
+
+template <typename T>
+bool ImageTransform::applyInPlace(T *pixels, uint32_t width, uint32_t height, uint32_t channels, size_t planeSize) const
+{
+    if (m_Transpose)
+        return false;
+    if (isIdentity())
+        return true;
+
+    // Rows swapped with their mirror are handled by the task of the upper one
+    const uint32_t rows = m_FlipY ? (height + 1) / 2 : height;
+    QVector<Band> bands = makeBands(rows, 1);
+
+    for (uint32_t channel = 0; channel < channels; ++channel)
+    {
+        T *plane = pixels + channel * planeSize;
+        QtConcurrent::blockingMap(bands, [&](Band & band)
+        {
+            for (uint32_t y = band.begin; y < band.end; ++y)
+            {
+                T *row = plane + size_t(y) * width;
+                T *mirrored = plane + size_t(height - 1 - y) * width;
+                if (m_FlipY && mirrored != row)
+                {
+                    std::swap_ranges(row, row + width, mirrored);
+                    if (m_FlipX)
+                        std::reverse(mirrored, mirrored + width);
+                }
+                if (m_FlipX)
+                    std::reverse(row, row + width);
+            }
+        });
+    }
+
+    return true;
+}
+
+template <typename T>
+void ImageTransform::transposeBand(const T *source, T *destination, uint32_t width, uint32_t height,
+                                   const Band &band) const
+{
+    constexpr uint32_t tile = tileSize<T>();
+    // Destination is height x width. Its row y comes from a source column, its column x from a source row.
+    const ptrdiff_t rowStep = m_FlipX ? -ptrdiff_t(width) : ptrdiff_t(width);
+
+    for (uint32_t tileY = band.begin; tileY < band.end; tileY += tile)
+    {
+        const uint32_t endY = std::min(band.end, tileY + tile);
+
+        for (uint32_t tileX = 0; tileX < height; tileX += tile)
+        {
+            const uint32_t endX = std::min(height, tileX + tile);
+            const uint32_t firstRow = m_FlipX ? height - 1 - tileX : tileX;
+
+            for (uint32_t y = tileY; y < endY; ++y)
+            {
+                const uint32_t column = m_FlipY ? width - 1 - y : y;
+                const T *input = source + size_t(firstRow) * width + column;
+                T *output = destination + size_t(y) * height;
+
+                for (uint32_t x = tileX; x < endX; ++x, input += rowStep)
+                    output[x] = *input;
+            }
+        }
+    }
+}
+
+template <typename T>
+void ImageTransform::copyBand(const T *source, T *destination, uint32_t width, uint32_t height,
+                              const Band &band) const
+{
+    for (uint32_t y = band.begin; y < band.end; ++y)
+    {
+        const T *input = source + size_t(m_FlipY ? height - 1 - y : y) * width;
+        T *output = destination + size_t(y) * width;
+        if (m_FlipX)
+            std::reverse_copy(input, input + width, output);
+        else
+            std::copy(input, input + width, output);
+    }
+}
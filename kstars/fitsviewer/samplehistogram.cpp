@@ -0,0 +1,145 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "samplehistogram.h"
+
+namespace
+{
+// Below this, a band costs more to merge than to count.
+constexpr uint32_t minimumBandSize = 65536;
+}
+
+void SampleHistogram::Moments::merge(const Moments &other)
+{
+    if (other.count == 0)
+        return;
+    if (count == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    const uint64_t total = count + other.count;
+    const double delta = other.mean - mean;
+    mean += delta * other.count / total;
+    m2 += other.m2 + delta * delta * count * other.count / total;
+    count = total;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+QVector<SampleHistogram::Band> SampleHistogram::makeBands(uint32_t count)
+{
+    const uint32_t bandCount = std::max(1u, std::min(static_cast<uint32_t>(std::max(1, QThread::idealThreadCount())),
+                                        count / minimumBandSize));
+    QVector<Band> bands(bandCount);
+    for (uint32_t i = 0; i < bandCount; ++i)
+    {
+        bands[i].index = i;
+        bands[i].begin = static_cast<uint64_t>(count) * i / bandCount;
+        bands[i].end = static_cast<uint64_t>(count) * (i + 1) / bandCount;
+    }
+    return bands;
+}
+
+void SampleHistogram::mergeBins(const std::vector<std::vector<uint32_t>> &bands, double origin)
+{
+    std::vector<uint32_t> bins = bands.front();
+    for (size_t band = 1; band < bands.size(); ++band)
+    {
+        for (size_t i = 0; i < bins.size(); ++i)
+            bins[i] += bands[band][i];
+    }
+
+    size_t first = 0, last = bins.size();
+    while (first < last && bins[first] == 0)
+        first++;
+    while (last > first && bins[last - 1] == 0)
+        last--;
+
+    m_Bins.assign(bins.begin() + first, bins.begin() + last);
+    m_Origin = origin + first * m_BinWidth;
+    m_Count = 0;
+    for (uint32_t frequency : m_Bins)
+        m_Count += frequency;
+}
+
+void SampleHistogram::exactMoments()
+{
+    m_Min = binValue(0);
+    m_Max = binValue(binCount() - 1);
+
+    double sum = 0;
+    for (int i = 0; i < binCount(); ++i)
+        sum += static_cast<double>(m_Bins[i]) * binValue(i);
+    m_Mean = sum / m_Count;
+
+    double squares = 0;
+    for (int i = 0; i < binCount(); ++i)
+    {
+        const double delta = binValue(i) - m_Mean;
+        squares += m_Bins[i] * delta * delta;
+    }
+    m_StdDev = std::sqrt(squares / m_Count);
+}
+
+int SampleHistogram::rankBin(uint64_t rank, uint64_t *before) const
+{
+    uint64_t accumulator = 0;
+    for (int i = 0; i < binCount(); ++i)
+    {
+        if (accumulator + m_Bins[i] > rank)
+        {
+            *before = accumulator;
+            return i;
+        }
+        accumulator += m_Bins[i];
+    }
+    *before = accumulator - m_Bins.back();
+    return binCount() - 1;
+}
+
+double SampleHistogram::valueAtRank(uint64_t rank) const
+{
+    uint64_t before = 0;
+    const int bin = rankBin(rank, &before);
+    if (m_Exact)
+        return binValue(bin);
+    return binValue(bin) + m_BinWidth * (rank - before + 0.5) / m_Bins[bin];
+}
+
+double SampleHistogram::percentile(double fraction) const
+{
+    if (!isValid())
+        return 0;
+    const double position = std::max(0.0, std::min(fraction, 1.0)) * (m_Count - 1);
+    return valueAtRank(static_cast<uint64_t>(position));
+}
+
+void SampleHistogram::medianDeviation()
+{
+    // Histogram of the distances to the median, with the same bin width.
+    std::vector<uint64_t> deviations(m_Bins.size() + 1, 0);
+    for (int i = 0; i < binCount(); ++i)
+    {
+        const double center = m_Exact ? binValue(i) : binValue(i) + m_BinWidth / 2;
+        const size_t bin = std::min(static_cast<size_t>(std::fabs(center - m_Median) / m_BinWidth), m_Bins.size());
+        deviations[bin] += m_Bins[i];
+    }
+
+    const uint64_t rank = m_Count / 2;
+    uint64_t accumulator = 0;
+    for (size_t bin = 0; bin < deviations.size(); ++bin)
+    {
+        if (accumulator + deviations[bin] > rank)
+        {
+            m_MAD = m_Exact ? bin * m_BinWidth :
+                    (bin + (rank - accumulator + 0.5) / deviations[bin]) * m_BinWidth;
+            return;
+        }
+        accumulator += deviations[bin];
+    }
+}
@@ -0,0 +1,403 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtConcurrent>
+#include <QThread>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class SampleHistogram
+ * @short Histogram and order statistics of one image channel, computed in a single parallel scan.
+ *
+ * The samples are split in one band per thread, each band is counted in its own histogram and
+ * the histograms are merged at the end. Median, MAD (median absolute deviation from the median),
+ * percentiles, mean and standard deviation are then derived from the merged histogram, so the
+ * image is not copied or sorted.
+ *
+ * 8 and 16-bit integer samples get a bin per value and are counted in one pass, and every
+ * statistic is exact. Other types are counted in two passes: the first one finds the range and
+ * the moments, the second one counts RANGE_BINS bins over that range. Integers spanning fewer
+ * values than that still get a bin per value. Otherwise the median and the MAD are refined exactly
+ * from the samples of their bin, at the cost of a pass each, while percentiles are interpolated
+ * within a bin.
+ * NaN samples are ignored.
+ *
+ * Ranks follow the convention of std::nth_element on the samples: the median is the sample of
+ * rank count / 2, the upper one for an even count.
+ */
+class SampleHistogram
+{
+    public:
+        /** Number of bins of the histograms of types that do not get a bin per value. */
+        static constexpr int RANGE_BINS = 65536;
+
+        SampleHistogram() = default;
+
+        /**
+         * @brief compute Scans count samples of one channel. Blocks until done.
+         * @return the histogram, invalid if there are no samples other than NaN
+         */
+        template <typename T>
+        static SampleHistogram compute(T const *samples, uint32_t count);
+
+        bool isValid() const
+        {
+            return m_Count > 0;
+        }
+        /** @return true if each bin holds a single value, so that all statistics are exact. */
+        bool isExact() const
+        {
+            return m_Exact;
+        }
+        uint64_t count() const
+        {
+            return m_Count;
+        }
+        double min() const
+        {
+            return m_Min;
+        }
+        double max() const
+        {
+            return m_Max;
+        }
+        double mean() const
+        {
+            return m_Mean;
+        }
+        double stddev() const
+        {
+            return m_StdDev;
+        }
+        double median() const
+        {
+            return m_Median;
+        }
+        /** @return the median of the absolute deviations from the median. */
+        double mad() const
+        {
+            return m_MAD;
+        }
+        /** @return the sample of rank fraction * (count - 1), fraction being clamped to [0, 1]. */
+        double percentile(double fraction) const;
+
+        int binCount() const
+        {
+            return static_cast<int>(m_Bins.size());
+        }
+        double binWidth() const
+        {
+            return m_BinWidth;
+        }
+        /** @return the lowest value that falls in bin, the only one if the histogram is exact. */
+        double binValue(int bin) const
+        {
+            return m_Origin + bin * m_BinWidth;
+        }
+        uint32_t binFrequency(int bin) const
+        {
+            return m_Bins[bin];
+        }
+
+    private:
+        struct Band
+        {
+            int index;
+            uint32_t begin;
+            uint32_t end;
+        };
+
+        // Moments of a band, merged with the parallel variance algorithm.
+        struct Moments
+        {
+            uint64_t count { 0 };
+            double mean { 0 };
+            double m2 { 0 };
+            double min { std::numeric_limits<double>::max() };
+            double max { std::numeric_limits<double>::lowest() };
+
+            void merge(const Moments &other);
+        };
+
+        template <typename T>
+        using HasBinPerValue = std::integral_constant<bool, std::is_integral<T>::value && sizeof(T) <= 2>;
+
+        static QVector<Band> makeBands(uint32_t count);
+
+        template <typename T>
+        void countValues(T const *samples, uint32_t count, std::true_type);
+        template <typename T>
+        void countValues(T const *samples, uint32_t count, std::false_type);
+
+        // Merges the histograms of the bands and trims the empty bins at both ends.
+        void mergeBins(const std::vector<std::vector<uint32_t>> &bands, double origin);
+        // Computes the range and the moments of an exact histogram.
+        void exactMoments();
+        // Computes the MAD once the bins are counted and the median is known.
+        void medianDeviation();
+        // Computes the MAD exactly from the samples, once the median is known.
+        template <typename T>
+        void exactMedianDeviation(T const *samples, QVector<Band> bands);
+
+        // The bin that holds the sample of rank, and the number of samples in the bins before it.
+        int rankBin(uint64_t rank, uint64_t *before) const;
+        double valueAtRank(uint64_t rank) const;
+
+        std::vector<uint32_t> m_Bins;
+        double m_Origin { 0 };
+        double m_BinWidth { 1 };
+        bool m_Exact { false };
+
+        uint64_t m_Count { 0 };
+        double m_Min { 0 };
+        double m_Max { 0 };
+        double m_Mean { 0 };
+        double m_StdDev { 0 };
+        double m_Median { 0 };
+        double m_MAD { 0 };
+};
+
+template <typename T>
+SampleHistogram SampleHistogram::compute(T const *samples, uint32_t count)
+{
+    SampleHistogram histogram;
+    if (samples == nullptr || count == 0)
+        return histogram;
+
+    using Sample = typename std::remove_const<T>::type;
+    histogram.countValues<Sample>(samples, count, HasBinPerValue<Sample>());
+    return histogram;
+}
+
+template <typename T>
+void SampleHistogram::countValues(T const *samples, uint32_t count, std::true_type)
+{
+    constexpr int minValue = std::numeric_limits<T>::min();
+    constexpr int binCount = std::numeric_limits<T>::max() - minValue + 1;
+
+    QVector<Band> bands = makeBands(count);
+    std::vector<std::vector<uint32_t>> bandBins(bands.size());
+
+    QtConcurrent::blockingMap(bands, [&](Band & band)
+    {
+        std::vector<uint32_t> &bins = bandBins[band.index];
+        bins.assign(binCount, 0);
+        for (uint32_t i = band.begin; i < band.end; ++i)
+            bins[samples[i] - minValue]++;
+    });
+
+    m_Exact = true;
+    m_BinWidth = 1;
+    mergeBins(bandBins, minValue);
+    if (m_Count == 0)
+        return;
+
+    exactMoments();
+    m_Median = valueAtRank(m_Count / 2);
+    medianDeviation();
+}
+
+template <typename T>
+void SampleHistogram::countValues(T const *samples, uint32_t count, std::false_type)
+{
+    QVector<Band> bands = makeBands(count);
+
+    // First pass: range and moments. A shift by the first sample keeps the sums small.
+    std::vector<Moments> bandMoments(bands.size());
+    QtConcurrent::blockingMap(bands, [&](Band & band)
+    {
+        Moments &moments = bandMoments[band.index];
+        double shift = 0, sum = 0, sumSquares = 0;
+        uint64_t n = 0;
+        for (uint32_t i = band.begin; i < band.end; ++i)
+        {
+            const T value = samples[i];
+            if (std::isnan(static_cast<double>(value)))
+                continue;
+            if (n == 0)
+                shift = value;
+            const double delta = value - shift;
+            sum += delta;
+            sumSquares += delta * delta;
+            moments.min = std::min<double>(moments.min, value);
+            moments.max = std::max<double>(moments.max, value);
+            n++;
+        }
+        moments.count = n;
+        if (n > 0)
+        {
+            moments.mean = shift + sum / n;
+            moments.m2 = std::max(0.0, sumSquares - sum * sum / n);
+        }
+    });
+
+    Moments total;
+    for (const auto &moments : bandMoments)
+        total.merge(moments);
+    if (total.count == 0)
+        return;
+
+    m_Count = total.count;
+    m_Min = total.min;
+    m_Max = total.max;
+    m_Mean = total.mean;
+    m_StdDev = std::sqrt(total.m2 / total.count);
+
+    // Second pass: the histogram.
+    const double range = m_Max - m_Min;
+    int binCount = RANGE_BINS;
+    if (range == 0 || (std::is_integral<T>::value && range < RANGE_BINS))
+    {
+        m_Exact = true;
+        m_BinWidth = 1;
+        binCount = static_cast<int>(range) + 1;
+    }
+    else
+        m_BinWidth = range / RANGE_BINS;
+
+    const double minimum = m_Min;
+    const double scale = 1 / m_BinWidth;
+    const bool exact = m_Exact;
+    std::vector<std::vector<uint32_t>> bandBins(bands.size());
+
+    QtConcurrent::blockingMap(bands, [&](Band & band)
+    {
+        std::vector<uint32_t> &bins = bandBins[band.index];
+        bins.assign(binCount, 0);
+        for (uint32_t i = band.begin; i < band.end; ++i)
+        {
+            const double value = samples[i];
+            if (std::isnan(value))
+                continue;
+            const int bin = exact ? static_cast<int>(value - minimum) : static_cast<int>((value - minimum) * scale);
+            bins[std::min(bin, binCount - 1)]++;
+        }
+    });
+
+    mergeBins(bandBins, m_Min);
+
+    if (m_Exact)
+    {
+        m_Median = valueAtRank(m_Count / 2);
+        medianDeviation();
+        return;
+    }
+
+    // The median only lies somewhere in its bin, sort the samples of that bin to find it.
+    uint64_t before = 0;
+    const uint64_t rank = m_Count / 2;
+    const int medianBin = rankBin(rank, &before);
+    std::vector<std::vector<double>> bandSamples(bands.size());
+
+    QtConcurrent::blockingMap(bands, [&](Band & band)
+    {
+        std::vector<double> &inBin = bandSamples[band.index];
+        for (uint32_t i = band.begin; i < band.end; ++i)
+        {
+            const double value = samples[i];
+            if (std::isnan(value))
+                continue;
+            if (std::min(static_cast<int>((value - minimum) * scale), binCount - 1) == medianBin)
+                inBin.push_back(value);
+        }
+    });
+
+    std::vector<double> inBin;
+    inBin.reserve(m_Bins[medianBin]);
+    for (const auto &values : bandSamples)
+        inBin.insert(inBin.end(), values.begin(), values.end());
+
+    const uint64_t position = std::min<uint64_t>(rank - before, inBin.size() - 1);
+    std::nth_element(inBin.begin(), inBin.begin() + position, inBin.end());
+    m_Median = inBin[position];
+    exactMedianDeviation(samples, bands);
+}
+
+template <typename T>
+void SampleHistogram::exactMedianDeviation(T const *samples, QVector<Band> bands)
+{
+    // Same as for the median: count the deviations from the median in RANGE_BINS bins, then sort
+    // the deviations of the bin that holds the MAD.
+    const double median = m_Median;
+    const double range = std::max(m_Max - median, median - m_Min);
+    if (range <= 0)
+    {
+        m_MAD = 0;
+        return;
+    }
+
+    const double scale = RANGE_BINS / range;
+    const auto binOf = [scale](double deviation)
+    {
+        return std::min(static_cast<int>(deviation * scale), RANGE_BINS - 1);
+    };
+    std::vector<std::vector<uint32_t>> bandBins(bands.size());
+
+    QtConcurrent::blockingMap(bands, [&](Band & band)
+    {
+        std::vector<uint32_t> &bins = bandBins[band.index];
+        bins.assign(RANGE_BINS, 0);
+        for (uint32_t i = band.begin; i < band.end; ++i)
+        {
+            const double value = samples[i];
+            if (!std::isnan(value))
+                bins[binOf(std::fabs(value - median))]++;
+        }
+    });
+
+    const uint64_t rank = m_Count / 2;
+    uint64_t before = 0;
+    int madBin = RANGE_BINS - 1;
+    for (int bin = 0; bin < RANGE_BINS; ++bin)
+    {
+        uint64_t frequency = 0;
+        for (const auto &bins : bandBins)
+            frequency += bins[bin];
+        if (before + frequency > rank)
+        {
+            madBin = bin;
+            break;
+        }
+        before += frequency;
+    }
+
+    std::vector<std::vector<double>> bandDeviations(bands.size());
+    QtConcurrent::blockingMap(bands, [&](Band & band)
+    {
+        std::vector<double> &inBin = bandDeviations[band.index];
+        for (uint32_t i = band.begin; i < band.end; ++i)
+        {
+            const double value = samples[i];
+            if (std::isnan(value))
+                continue;
+            const double deviation = std::fabs(value - median);
+            if (binOf(deviation) == madBin)
+                inBin.push_back(deviation);
+        }
+    });
+
+    std::vector<double> inBin;
+    for (const auto &deviations : bandDeviations)
+        inBin.insert(inBin.end(), deviations.begin(), deviations.end());
+    if (inBin.empty())
+    {
+        medianDeviation();
+        return;
+    }
+
+    const uint64_t position = std::min<uint64_t>(rank - before, inBin.size() - 1);
+    std::nth_element(inBin.begin(), inBin.begin() + position, inBin.end());
+    m_MAD = inBin[position];
+}
@@ -5,22 +5,24 @@
 
 #include "stretch.h"
 
+#include "samplehistogram.h"
+
 #include <fitsio.h>
 #include <math.h>
 #include <QtConcurrent>
+#include <QThread>
 
-namespace
-{
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <vector>
 
-// Returns the median value of the vector.
-// The vector is modified in an undefined way.
-template <typename T>
-T median(std::vector<T> &values)
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace
 {
-    const int middle = values.size() / 2;
-    std::nth_element(values.begin(), values.begin() + middle, values.end());
-    return values[middle];
-}
 
 // Returns the rough max of the buffer.
 template <typename T>
@@ -33,18 +35,6 @@ T sampledMax(T const *values, int size, int sampleBy)
     return  maxVal;
 }
 
-// Returns the median of the sample values.
-// The values are not modified.
-template <typename T>
-T median(T const *values, int size, int sampleBy)
-{
-    const int downsampled_size = size / sampleBy;
-    std::vector<T> samples(downsampled_size);
-    for (int index = 0, i = 0; i < downsampled_size; ++i, index += sampleBy)
-        samples[i] = values[index];
-    return median(samples);
-}
-
 // This stretches one channel given the input parameters.
 // Based on the spec in section 8.5.6
 // https://pixinsight.com/doc/docs/XISF-1.0-spec/XISF-1.0-spec.html
@@ -206,42 +196,263 @@ void stretchThreeChannels(T *inputBuffer, QImage *outputImage,
         future.waitForFinished();
 }
 
+// The constants of the transfer function of one channel, computed as in the functions above.
+template <typename T>
+struct ChannelMTF
+{
+    ChannelMTF(const StretchParams1Channel &params, int inputRange)
+    {
+        constexpr int maxOutput = 255;
+        const float maxInput = inputRange > 1 ? inputRange - 1 : inputRange;
+        const float hsRangeFactor = params.highlights == params.shadows ?
+                                    1.0f : 1.0f / (params.highlights - params.shadows);
+        nativeShadows = params.shadows * maxInput;
+        nativeHighlights = params.highlights * maxInput;
+        midtones = params.midtones;
+        k1 = (midtones - 1) * hsRangeFactor * maxOutput / maxInput;
+        k2 = ((2 * midtones) - 1) * hsRangeFactor / maxInput;
+    }
+
+    // The stretch of one sample, exactly as stretchOneChannel() computes it.
+    uint8_t operator()(T input) const
+    {
+        if (input < nativeShadows) return 0;
+        else if (input >= nativeHighlights) return 255;
+        const T inputFloored = (input - nativeShadows);
+        return (inputFloored * k1) / (inputFloored * k2 - midtones);
+    }
+
+    // The input of mtfRow(): the distance to the shadows, or -1 at and above the highlights.
+    float offset(T input) const
+    {
+        return input >= nativeHighlights ? -1.0f : static_cast<float>(std::max(input, nativeShadows) - nativeShadows);
+    }
+
+    T nativeShadows;
+    T nativeHighlights;
+    float midtones;
+    float k1;
+    float k2;
+};
+
+// 8 and 16-bit samples are stretched through a table with an entry per ADU value.
+template <typename T>
+using HasStretchTable = std::integral_constant<bool, std::is_integral<T>::value && sizeof(T) <= 2>;
+
+template <typename T>
+std::vector<uint8_t> stretchTable(const ChannelMTF<T> &mtf)
+{
+    constexpr int minValue = std::numeric_limits<T>::min();
+    constexpr int maxValue = std::numeric_limits<T>::max();
+    std::vector<uint8_t> table(maxValue - minValue + 1);
+    for (int value = minValue; value <= maxValue; ++value)
+        table[value - minValue] = mtf(static_cast<T>(value));
+    return table;
+}
+
+// Evaluates the transfer function on the offsets computed by ChannelMTF::offset().
+// There is no branch, the comparisons are masks and the clamps are min/max, so with SSE2
+// 16 samples are stretched per iteration. A 0/0 at the shadows with midtones 0 clamps to 0.
+void mtfRow(const float *x, int count, float k1, float k2, float midtones, uint8_t *output)
+{
+    int i = 0;
+#ifdef __SSE2__
+    const __m128 vk1 = _mm_set1_ps(k1);
+    const __m128 vk2 = _mm_set1_ps(k2);
+    const __m128 vMidtones = _mm_set1_ps(midtones);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 maxOutput = _mm_set1_ps(255.0f);
+
+    auto mtf4 = [&](const float * p)
+    {
+        const __m128 v = _mm_loadu_ps(p);
+        __m128 y = _mm_div_ps(_mm_mul_ps(v, vk1), _mm_sub_ps(_mm_mul_ps(v, vk2), vMidtones));
+        // maxps returns its second operand for NaN
+        y = _mm_min_ps(_mm_max_ps(y, zero), maxOutput);
+        const __m128 highlight = _mm_cmplt_ps(v, zero);
+        y = _mm_or_ps(_mm_and_ps(highlight, maxOutput), _mm_andnot_ps(highlight, y));
+        return _mm_cvttps_epi32(y);
+    };
+
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i low = _mm_packs_epi32(mtf4(x + i), mtf4(x + i + 4));
+        const __m128i high = _mm_packs_epi32(mtf4(x + i + 8), mtf4(x + i + 12));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), _mm_packus_epi16(low, high));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        const float v = x[i];
+        const float y = std::min(std::max(0.0f, (v * k1) / (v * k2 - midtones)), 255.0f);
+        output[i] = v < 0 ? 255 : static_cast<uint8_t>(y);
+    }
+}
+
+// Calls stretchRows(begin, end) on a fixed number of bands of output rows, one thread each,
+// and blocks until done.
+template <typename F>
+void runInBands(int outputHeight, F stretchRows)
+{
+    // A couple of bands per thread, so that a thread that is preempted does not hold up the others.
+    const int bandCount = std::max(1, std::min(outputHeight, 2 * QThread::idealThreadCount()));
+    QVector<int> bands(bandCount);
+    std::iota(bands.begin(), bands.end(), 0);
+
+    QtConcurrent::blockingMap(bands, [&](int &band)
+    {
+        stretchRows(static_cast<int>(static_cast<qint64>(outputHeight) * band / bandCount),
+                    static_cast<int>(static_cast<qint64>(outputHeight) * (band + 1) / bandCount));
+    });
+}
+
+template <typename T>
+void bandedOneChannel(T const *inputBuffer, QImage *outputImage, const ChannelMTF<T> &mtf,
+                      int imageWidth, int sampling, std::true_type)
+{
+    const std::vector<uint8_t> table = stretchTable(mtf);
+    const uint8_t *lut = table.data() - std::numeric_limits<T>::min();
+
+    runInBands(outputImage->height(), [&](int begin, int end)
+    {
+        for (int jout = begin; jout < end; ++jout)
+        {
+            T const *inputLine = inputBuffer + static_cast<qint64>(jout) * sampling * imageWidth;
+            uint8_t *scanLine = outputImage->scanLine(jout);
+            for (int i = 0, iout = 0; i < imageWidth; i += sampling, iout++)
+                scanLine[iout] = lut[inputLine[i]];
+        }
+    });
+}
+
+template <typename T>
+void bandedOneChannel(T const *inputBuffer, QImage *outputImage, const ChannelMTF<T> &mtf,
+                      int imageWidth, int sampling, std::false_type)
+{
+    // Rows are converted to offsets and stretched a chunk at a time.
+    constexpr int chunkSize = 1024;
+
+    runInBands(outputImage->height(), [&](int begin, int end)
+    {
+        float x[chunkSize];
+        for (int jout = begin; jout < end; ++jout)
+        {
+            T const *inputLine = inputBuffer + static_cast<qint64>(jout) * sampling * imageWidth;
+            uint8_t *scanLine = outputImage->scanLine(jout);
+            for (int i = 0, iout = 0; i < imageWidth; iout += chunkSize)
+            {
+                int count = 0;
+                for (; count < chunkSize && i < imageWidth; ++count, i += sampling)
+                    x[count] = mtf.offset(inputLine[i]);
+                mtfRow(x, count, mtf.k1, mtf.k2, mtf.midtones, scanLine + iout);
+            }
+        }
+    });
+}
+
+template <typename T>
+void bandedThreeChannels(T const *inputBuffer, QImage *outputImage, const ChannelMTF<T> (&mtf)[3],
+                         int imageHeight, int imageWidth, int sampling, std::true_type)
+{
+    std::vector<uint8_t> tables[3];
+    const uint8_t *lut[3];
+    for (int c = 0; c < 3; ++c)
+    {
+        tables[c] = stretchTable(mtf[c]);
+        lut[c] = tables[c].data() - std::numeric_limits<T>::min();
+    }
+    const qint64 size = static_cast<qint64>(imageWidth) * imageHeight;
+
+    runInBands(outputImage->height(), [&](int begin, int end)
+    {
+        for (int jout = begin; jout < end; ++jout)
+        {
+            // R, G, B input images are stored one after another.
+            T const *inputLineR = inputBuffer + static_cast<qint64>(jout) * sampling * imageWidth;
+            T const *inputLineG = inputLineR + size;
+            T const *inputLineB = inputLineG + size;
+            auto *scanLine = reinterpret_cast<QRgb *>(outputImage->scanLine(jout));
+            for (int i = 0, iout = 0; i < imageWidth; i += sampling, iout++)
+                scanLine[iout] = qRgb(lut[0][inputLineR[i]], lut[1][inputLineG[i]], lut[2][inputLineB[i]]);
+        }
+    });
+}
+
+template <typename T>
+void bandedThreeChannels(T const *inputBuffer, QImage *outputImage, const ChannelMTF<T> (&mtf)[3],
+                         int imageHeight, int imageWidth, int sampling, std::false_type)
+{
+    constexpr int chunkSize = 1024;
+    const qint64 size = static_cast<qint64>(imageWidth) * imageHeight;
+
+    runInBands(outputImage->height(), [&](int begin, int end)
+    {
+        float x[chunkSize];
+        uint8_t rgb[3][chunkSize];
+        for (int jout = begin; jout < end; ++jout)
+        {
+            T const *inputLine = inputBuffer + static_cast<qint64>(jout) * sampling * imageWidth;
+            auto *scanLine = reinterpret_cast<QRgb *>(outputImage->scanLine(jout));
+            for (int start = 0, iout = 0; start < imageWidth; start += chunkSize * sampling, iout += chunkSize)
+            {
+                int count = 0;
+                for (int c = 0; c < 3; ++c)
+                {
+                    T const *channelLine = inputLine + c * size;
+                    count = 0;
+                    for (int i = start; count < chunkSize && i < imageWidth; ++count, i += sampling)
+                        x[count] = mtf[c].offset(channelLine[i]);
+                    mtfRow(x, count, mtf[c].k1, mtf[c].k2, mtf[c].midtones, rgb[c]);
+                }
+                for (int k = 0; k < count; ++k)
+                    scanLine[iout + k] = qRgb(rgb[0][k], rgb[1][k], rgb[2][k]);
+            }
+        }
+    });
+}
+
 template <typename T>
 void stretchChannels(T *input_buffer, QImage *output_image,
                      const StretchParams &stretch_params,
-                     int input_range, int image_height, int image_width, int num_channels, int sampling)
+                     int input_range, int image_height, int image_width, int num_channels, int sampling,
+                     StretchEngine engine)
 {
+    if (engine == STRETCH_ROW_FUTURES)
+    {
+        if (num_channels == 1)
+            stretchOneChannel(input_buffer, output_image, stretch_params, input_range,
+                              image_height, image_width, sampling);
+        else if (num_channels == 3)
+            stretchThreeChannels(input_buffer, output_image, stretch_params, input_range,
+                                 image_height, image_width, sampling);
+        return;
+    }
+
+    using Sample = typename std::remove_const<T>::type;
+    using UseTable = HasStretchTable<Sample>;
     if (num_channels == 1)
-        stretchOneChannel(input_buffer, output_image, stretch_params, input_range,
-                          image_height, image_width, sampling);
+    {
+        const ChannelMTF<Sample> mtf(stretch_params.grey_red, input_range);
+        bandedOneChannel<Sample>(input_buffer, output_image, mtf, image_width, sampling, UseTable());
+    }
     else if (num_channels == 3)
-        stretchThreeChannels(input_buffer, output_image, stretch_params, input_range,
-                             image_height, image_width, sampling);
+    {
+        const ChannelMTF<Sample> mtf[3] = { { stretch_params.grey_red, input_range },
+            { stretch_params.green, input_range },
+            { stretch_params.blue, input_range }
+        };
+        bandedThreeChannels<Sample>(input_buffer, output_image, mtf, image_height, image_width, sampling, UseTable());
+    }
 }
 
 // See section 8.5.7 in above link  https://pixinsight.com/doc/docs/XISF-1.0-spec/XISF-1.0-spec.html
-template <typename T>
-void computeParamsOneChannel(T const *buffer, StretchParams1Channel *params,
-                             int inputRange, int height, int width)
+// Derived from the median and the MAD of the channel, which are in ADU.
+void computeParamsOneChannel(const SampleHistogram &histogram, StretchParams1Channel *params, int inputRange)
 {
-    // Find the median sample.
-    constexpr int maxSamples = 500000;
-    const int sampleBy = width * height < maxSamples ? 1 : width * height / maxSamples;
-
-    T medianSample = median(buffer, width * height, sampleBy);
-    // Find the Median deviation: 1.4826 * median of abs(sample[i] - median).
-    const int numSamples = width * height / sampleBy;
-    std::vector<T> deviations(numSamples);
-    for (int index = 0, i = 0; i < numSamples; ++i, index += sampleBy)
-    {
-        if (medianSample > buffer[index])
-            deviations[i] = medianSample - buffer[index];
-        else
-            deviations[i] = buffer[index] - medianSample;
-    }
+    const float medianSample = histogram.median();
+    const float medDev = histogram.mad();
 
     // Shift everything to 0 -> 1.0.
-    const float medDev = median(deviations);
     const float normalizedMedian = medianSample / static_cast<float>(inputRange);
     const float MADN = 1.4826 * medDev / static_cast<float>(inputRange);
 
@@ -317,7 +528,7 @@ Stretch::Stretch(int width, int height, int channels, int data_type)
     input_range = getRange(dataType);
 }
 
-void Stretch::run(uint8_t const *input, QImage *outputImage, int sampling)
+void Stretch::run(uint8_t const *input, QImage *outputImage, int sampling, StretchEngine engine)
 {
     Q_ASSERT(outputImage->width() == (image_width + sampling - 1) / sampling);
     Q_ASSERT(outputImage->height() == (image_height + sampling - 1) / sampling);
@@ -327,31 +538,31 @@ void Stretch::run(uint8_t const *input, QImage *outputImage, int sampling)
     {
         case TBYTE:
             stretchChannels(reinterpret_cast<uint8_t const*>(input), outputImage, params,
-                            input_range, image_height, image_width, image_channels, sampling);
+                            input_range, image_height, image_width, image_channels, sampling, engine);
             break;
         case TSHORT:
             stretchChannels(reinterpret_cast<short const*>(input), outputImage, params,
-                            input_range, image_height, image_width, image_channels, sampling);
+                            input_range, image_height, image_width, image_channels, sampling, engine);
             break;
         case TUSHORT:
             stretchChannels(reinterpret_cast<unsigned short const*>(input), outputImage, params,
-                            input_range, image_height, image_width, image_channels, sampling);
+                            input_range, image_height, image_width, image_channels, sampling, engine);
             break;
         case TLONG:
             stretchChannels(reinterpret_cast<long const*>(input), outputImage, params,
-                            input_range, image_height, image_width, image_channels, sampling);
+                            input_range, image_height, image_width, image_channels, sampling, engine);
             break;
         case TFLOAT:
             stretchChannels(reinterpret_cast<float const*>(input), outputImage, params,
-                            input_range, image_height, image_width, image_channels, sampling);
+                            input_range, image_height, image_width, image_channels, sampling, engine);
             break;
         case TLONGLONG:
             stretchChannels(reinterpret_cast<long long const*>(input), outputImage, params,
-                            input_range, image_height, image_width, image_channels, sampling);
+                            input_range, image_height, image_width, image_channels, sampling, engine);
             break;
         case TDOUBLE:
             stretchChannels(reinterpret_cast<double const*>(input), outputImage, params,
-                            input_range, image_height, image_width, image_channels, sampling);
+                            input_range, image_height, image_width, image_channels, sampling, engine);
             break;
         default:
             break;
@@ -375,67 +586,51 @@ void Stretch::recalculateInputRange(uint8_t const *input)
 
 StretchParams Stretch::computeParams(uint8_t const *input)
 {
-    recalculateInputRange(input);
-    StretchParams result;
+    const int size = image_width * image_height;
+    QVector<SampleHistogram> histograms;
     for (int channel = 0; channel < image_channels; ++channel)
     {
-        int offset = channel * image_width * image_height;
-        StretchParams1Channel *params = channel == 0 ? &result.grey_red :
-                                        (channel == 1 ? &result.green : &result.blue);
         switch (dataType)
         {
             case TBYTE:
-            {
-                auto buffer = reinterpret_cast<uint8_t const*>(input);
-                computeParamsOneChannel(buffer + offset, params, input_range,
-                                        image_height, image_width);
+                histograms.append(SampleHistogram::compute(reinterpret_cast<uint8_t const*>(input) + channel * size, size));
                 break;
-            }
             case TSHORT:
-            {
-                auto buffer = reinterpret_cast<short const*>(input);
-                computeParamsOneChannel(buffer + offset, params, input_range,
-                                        image_height, image_width);
+                histograms.append(SampleHistogram::compute(reinterpret_cast<short const*>(input) + channel * size, size));
                 break;
-            }
             case TUSHORT:
-            {
-                auto buffer = reinterpret_cast<unsigned short const*>(input);
-                computeParamsOneChannel(buffer + offset, params, input_range,
-                                        image_height, image_width);
+                histograms.append(SampleHistogram::compute(reinterpret_cast<unsigned short const*>(input) + channel * size, size));
                 break;
-            }
             case TLONG:
-            {
-                auto buffer = reinterpret_cast<long const*>(input);
-                computeParamsOneChannel(buffer + offset, params, input_range,
-                                        image_height, image_width);
+                histograms.append(SampleHistogram::compute(reinterpret_cast<long const*>(input) + channel * size, size));
                 break;
-            }
             case TFLOAT:
-            {
-                auto buffer = reinterpret_cast<float const*>(input);
-                computeParamsOneChannel(buffer + offset, params, input_range,
-                                        image_height, image_width);
+                histograms.append(SampleHistogram::compute(reinterpret_cast<float const*>(input) + channel * size, size));
                 break;
-            }
             case TLONGLONG:
-            {
-                auto buffer = reinterpret_cast<long long const*>(input);
-                computeParamsOneChannel(buffer + offset, params, input_range,
-                                        image_height, image_width);
+                histograms.append(SampleHistogram::compute(reinterpret_cast<long long const*>(input) + channel * size, size));
                 break;
-            }
             case TDOUBLE:
-            {
-                auto buffer = reinterpret_cast<double const*>(input);
-                computeParamsOneChannel(buffer + offset, params, input_range,
-                                        image_height, image_width);
+                histograms.append(SampleHistogram::compute(reinterpret_cast<double const*>(input) + channel * size, size));
                 break;
-            }
             default:
+                histograms.append(SampleHistogram());
                 break;
         }
     }
+    return computeParams(input, histograms);
+}
+
+StretchParams Stretch::computeParams(uint8_t const *input, const QVector<SampleHistogram> &histograms)
+{
+    recalculateInputRange(input);
+    StretchParams result;
+    for (int channel = 0; channel < image_channels && channel < histograms.size(); ++channel)
+    {
+        StretchParams1Channel *params = channel == 0 ? &result.grey_red :
+                                        (channel == 1 ? &result.green : &result.blue);
+        if (histograms[channel].isValid())
+            computeParamsOneChannel(histograms[channel], params, input_range);
+    }
     return result;
 }
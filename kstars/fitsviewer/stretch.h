@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include "samplehistogram.h"
+
 #include <memory>
 #include <QImage>
 
@@ -34,6 +36,11 @@ struct StretchParams
   StretchParams1Channel grey_red, green, blue;
 };
 
+// STRETCH_ROW_FUTURES starts a thread per output row and evaluates the stretch per pixel.
+// STRETCH_BANDS splits the output in a few bands of rows, one per thread, and maps 8 and 16-bit
+// samples through a lookup table and the other types through a vectorized transfer function.
+typedef enum { STRETCH_ROW_FUTURES, STRETCH_BANDS } StretchEngine;
+
 class Stretch
 {
     public:
@@ -68,6 +75,12 @@ class Stretch
          */
         StretchParams computeParams(const uint8_t *input);
 
+        /**
+         * @brief computeParams As above, from histograms of each channel of the image that were
+         * already computed, for instance by FITSData, so that the image is not scanned again.
+         */
+        StretchParams computeParams(const uint8_t *input, const QVector<SampleHistogram> &histograms);
+
         /**
          * @brief run run the stretch algorithm according to the params given
          * placing the output in output_image.
@@ -77,8 +90,11 @@ class Stretch
          * @param sampling The sampling parameter. Applies to both width and height.
          * Sampling is applied to the output (that is, with sampling=2, we compute every other output
          * sample both in width and height, so the output would have about 4X fewer pixels.
+         * @param engine The implementation to use. Both produce the same image, except for
+         * rounding differences of at most one level with 32 and 64-bit samples.
          */
-        void run(uint8_t const *input, QImage *output_image, int sampling=1);
+        void run(uint8_t const *input, QImage *output_image, int sampling=1,
+                 StretchEngine engine=STRETCH_BANDS);
 
  private:
         // Adjusts input_range for float and double types.
@@ -22,6 +22,11 @@
 #include <QHash>
 #include <QNetworkDiskCache>
 #include <QPainter>
+#include <QtConcurrent>
+
+// Maximum number of tiles prefetchPix() keeps in flight
+#define HIPS_MAX_PREFETCH_DECODES   8
+#define HIPS_MAX_PREFETCH_DOWNLOADS 32
 
 static QNetworkDiskCache *g_discCache = nullptr;
 static UrlFileDownload *g_download = nullptr;
@@ -79,8 +84,10 @@ HIPSManager::HIPSManager() : QObject(KStars::Instance())
     value = Options::hIPSMemoryCache() * 1024 * 1024;
     m_cache.setMaxCost(Options::hIPSMemoryCache() * 1024 * 1024);
 
-
-
+    // Both are emitted from worker threads
+    qRegisterMetaType<pixCacheKey_t>("pixCacheKey_t");
+    connect(this, &HIPSManager::sigTileDecoded, this, &HIPSManager::slotTileDecoded, Qt::QueuedConnection);
+    connect(this, &HIPSManager::sigTilePacksBuilt, this, &HIPSManager::slotTilePacksBuilt, Qt::QueuedConnection);
 }
 
 void HIPSManager::showSettings()
@@ -162,6 +169,14 @@ QImage *HIPSManager::getPix(bool allsky, int level, int pix, bool &freeImage)
 
     pixCacheItem_t *item = getCacheItem(key);
 
+    // Offline tiles are read right away from the tile packs or the files, without the network stack
+    if (item == nullptr && Options::hIPSUseOfflineSource())
+    {
+        item = loadOfflineItem(allsky, key);
+        if (item == nullptr)
+            return nullptr;
+    }
+
     if (m_downloadMap.contains(key))
     {
         // downloading
@@ -214,26 +229,180 @@ QImage *HIPSManager::getPix(bool allsky, int level, int pix, bool &freeImage)
         return cacheImage;
     }
 
-    QString path;
+    QUrl downloadURL(m_currentURL);
+    downloadURL.setPath(downloadURL.path() + tilePath(allsky, level, pix));
+    g_download->begin(downloadURL, key);
+    m_downloadMap.insert(key);
 
-    if (!allsky)
-    {
-        int dir = (pix / 10000) * 10000;
+    return nullptr;
+}
 
-        path = "/Norder" + QString::number(level) + "/Dir" + QString::number(dir) + "/Npix" + QString::number(pix) +
-               '.' + m_currentFormat;
-    }
+QString HIPSManager::tilePath(bool allsky, int level, int pix) const
+{
+    if (allsky)
+        return "/Norder3/Allsky." + m_currentFormat;
+
+    int dir = (pix / 10000) * 10000;
+
+    return "/Norder" + QString::number(level) + "/Dir" + QString::number(dir) + "/Npix" + QString::number(pix) +
+           '.' + m_currentFormat;
+}
+
+pixCacheItem_t *HIPSManager::loadOfflineItem(bool allsky, pixCacheKey_t &key)
+{
+    QImage image;
+
+    // The all sky image is not part of the packs, which only hold the Npix tiles
+    const std::shared_ptr<HIPSTilePack> pack = allsky ? nullptr : m_tilePacks.value(key.level);
+    if (pack && pack->contains(key.pix))
+        image = pack->tile(key.pix);
     else
+        image.load(Options::hIPSOfflinePath() + tilePath(allsky, key.level, key.pix));
+
+    if (image.isNull())
+        return nullptr;
+
+    auto *item = new pixCacheItem_t;
+    item->image = new QImage(std::move(image));
+    addToMemoryCache(key, item);
+
+    // The cache refuses items that are too large for it
+    return getCacheItem(key);
+}
+
+bool HIPSManager::prefetchPix(int level, int pix)
+{
+    if (Options::hIPSUseOfflineSource() == false && m_currentSource.isEmpty())
+        return false;
+
+    pixCacheKey_t key;
+
+    key.level = level;
+    key.pix = pix;
+    key.uid = m_uid;
+
+    if (m_downloadMap.contains(key) || m_prefetchMap.contains(key) || getCacheItem(key) != nullptr)
+        return false;
+
+    if (Options::hIPSUseOfflineSource())
     {
-        path = "/Norder3/Allsky." + m_currentFormat;
+        if (m_prefetchMap.size() >= HIPS_MAX_PREFETCH_DECODES)
+            return false;
+
+        const std::shared_ptr<HIPSTilePack> pack = m_tilePacks.value(level);
+        const QString path = Options::hIPSOfflinePath() + tilePath(false, level, pix);
+
+        m_prefetchMap.insert(key);
+        QtConcurrent::run([this, pack, path, key]()
+        {
+            QImage image = pack ? pack->tile(key.pix) : QImage();
+            if (image.isNull())
+                image.load(path);
+            emit sigTileDecoded(key, image);
+        });
+
+        return true;
     }
 
+    if (m_downloadMap.size() >= HIPS_MAX_PREFETCH_DOWNLOADS)
+        return false;
+
+    // Downloaded tiles end up in the memory cache through slotDone()
     QUrl downloadURL(m_currentURL);
-    downloadURL.setPath(downloadURL.path() + path);
+    downloadURL.setPath(downloadURL.path() + tilePath(false, level, pix));
     g_download->begin(downloadURL, key);
     m_downloadMap.insert(key);
 
-    return nullptr;
+    return true;
+}
+
+void HIPSManager::slotTileDecoded(pixCacheKey_t key, QImage image)
+{
+    m_prefetchMap.remove(key);
+
+    // Drop tiles of a previous source, and tiles that getPix() has loaded meanwhile
+    if (image.isNull() || key.uid != m_uid || getCacheItem(key) != nullptr)
+        return;
+
+    auto *item = new pixCacheItem_t;
+    item->image = new QImage(std::move(image));
+    addToMemoryCache(key, item);
+}
+
+QString HIPSManager::tilePackDirectory(const QString &directory)
+{
+    // One directory per offline source, named after its path
+    const QString name = QString::number(qHash(QDir(directory).absolutePath()), 16);
+    return QDir(KSPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("hips/packs/" + name);
+}
+
+void HIPSManager::updateTilePacks(const QString &directory, const QList<int> &orders, bool build)
+{
+    // Unmap the packs first, a pack that is still mapped cannot be replaced on every platform.
+    // Running decoders that hold one of them fall back to the tile files.
+    for (const auto &pack : m_tilePacks)
+        pack->close();
+    m_tilePacks.clear();
+
+    if (directory.isEmpty() || orders.isEmpty())
+        return;
+
+    const QString packDirectory = tilePackDirectory(directory);
+    QDir().mkpath(packDirectory);
+
+    QList<int> missing;
+    for (int order : orders)
+    {
+        const QString filename = HIPSTilePack::packFileName(packDirectory, order);
+        const QFileInfo packInfo(filename);
+        const QFileInfo orderInfo(QDir(directory).filePath(QString("Norder%1").arg(order)));
+
+        // Rebuild packs that are older than the tree they were built from
+        if (packInfo.exists() && packInfo.lastModified() >= orderInfo.lastModified())
+        {
+            auto pack = std::make_shared<HIPSTilePack>(filename);
+            if (pack->open())
+            {
+                m_tilePacks.insert(order, pack);
+                continue;
+            }
+        }
+
+        missing.append(order);
+    }
+
+    if (!build || missing.isEmpty() || m_tilePackBuilds.contains(directory))
+        return;
+
+    qCInfo(KSTARS) << "Building HiPS tile packs of" << directory << "for orders" << missing;
+
+    m_tilePackBuilds.insert(directory);
+    QtConcurrent::run([this, directory, packDirectory, missing]()
+    {
+        for (int order : missing)
+            HIPSTilePack::build(directory, order, HIPSTilePack::packFileName(packDirectory, order));
+
+        emit sigTilePacksBuilt(directory);
+    });
+}
+
+void HIPSManager::slotTilePacksBuilt(const QString &directory)
+{
+    m_tilePackBuilds.remove(directory);
+
+    // The user may have picked another source meanwhile
+    if (!Options::hIPSUseOfflineSource() || QDir(directory) != QDir(Options::hIPSOfflinePath()))
+        return;
+
+    // Open what was built, without building again the orders that failed
+    QList<int> orders;
+    for (auto it = m_OfflineLevelsMap.cbegin(); it != m_OfflineLevelsMap.cend(); ++it)
+    {
+        if (it.key() == it.value())
+            orders.append(it.key());
+    }
+
+    updateTilePacks(directory, orders, false);
 }
 
 
@@ -472,8 +641,10 @@ bool HIPSManager::setCurrentSource(const QString &title)
 }
 
 // Extract which levels are available for offline use.
-void HIPSManager::setOfflineLevels(const QStringList &value)
+void HIPSManager::setOfflineLevels(const QStringList &value, const QString &directory)
 {
+    QList<int> orders;
+
     for (auto oneLevel : value)
     {
         if (oneLevel.startsWith("Norder"))
@@ -481,9 +652,12 @@ void HIPSManager::setOfflineLevels(const QStringList &value)
             oneLevel.remove("Norder");
             auto level =  oneLevel.toUInt();
             m_OfflineLevelsMap[level] = level;
+            orders.append(level);
         }
     }
 
+    updateTilePacks(directory.isEmpty() ? Options::hIPSOfflinePath() : directory, orders, true);
+
     // Now let's map all the missing levels, if any
     for (int i = 3; i < 9; i++)
     {
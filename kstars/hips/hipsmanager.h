@@ -9,6 +9,7 @@
 #pragma once
 
 #include "hips.h"
+#include "hipstilepack.h"
 #include "opships.h"
 #include "pixcache.h"
 #include "urlfiledownload.h"
@@ -94,7 +95,24 @@ class HIPSManager : public QObject
         {
             return m_uid;
         }
-        void setOfflineLevels(const QStringList &value);
+        /**
+         * @short Extract which levels are available for offline use
+         *
+         * Tile packs are built in the background for the levels that have none yet, see HIPSTilePack.
+         * @param value The names of the Norder<N> directories of the offline survey
+         * @param directory The offline survey, Options::hIPSOfflinePath() if empty
+         */
+        void setOfflineLevels(const QStringList &value, const QString &directory = QString());
+
+        /**
+         * @short Load a tile in the background if it is not cached yet
+         *
+         * Used to fetch the tiles around the visible ones while the sky map slews, so that they are
+         * in the memory cache when they come into view. Offline tiles are decoded on a worker thread,
+         * online tiles are downloaded. The number of tiles in flight is limited.
+         * @return true if a load was started
+         */
+        bool prefetchPix(int level, int pix);
 
     public slots:
         bool setCurrentSource(const QString &title);
@@ -102,11 +120,15 @@ class HIPSManager : public QObject
 
     signals:
         void sigRepaint();
+        void sigTileDecoded(pixCacheKey_t key, QImage image);
+        void sigTilePacksBuilt(QString directory);
 
     private slots:
         void slotDone(QNetworkReply::NetworkError error, QByteArray &data, pixCacheKey_t &key);
         void slotApply();
         void removeTimer(pixCacheKey_t &key);
+        void slotTileDecoded(pixCacheKey_t key, QImage image);
+        void slotTilePacksBuilt(const QString &directory);
 
     private:
         HIPSManager();
@@ -120,6 +142,19 @@ class HIPSManager : public QObject
         void addToMemoryCache(pixCacheKey_t &key, pixCacheItem_t *item);
         pixCacheItem_t *getCacheItem(pixCacheKey_t &key);
 
+        // Offline storage
+        QString tilePath(bool allsky, int level, int pix) const;
+        pixCacheItem_t *loadOfflineItem(bool allsky, pixCacheKey_t &key);
+        void updateTilePacks(const QString &directory, const QList<int> &orders, bool build);
+        static QString tilePackDirectory(const QString &directory);
+
+        // Tile packs of the offline source by order, shared with the background decoders
+        QMap<int, std::shared_ptr<HIPSTilePack>> m_tilePacks;
+        // Offline sources whose tile packs are being built
+        QSet<QString> m_tilePackBuilds;
+        // Tiles being decoded in the background by prefetchPix()
+        QSet<pixCacheKey_t> m_prefetchMap;
+
         // List of all sources in the database
         QList<QMap<QString, QString>> m_hipsSources;
 
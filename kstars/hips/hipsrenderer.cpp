@@ -15,6 +15,18 @@
 #include "skyqpainter.h"
 #include "projections/projector.h"
 
+#include <QtConcurrent>
+
+#include <atomic>
+#include <limits>
+#include <numeric>
+
+// Size of the screen tiles rendered in parallel by the tiled rasterizer, in pixels
+#define HIPS_TILE_SIZE 128
+
+// Maximum number of tiles prefetched per frame
+#define HIPS_PREFETCH_BUDGET 24
+
 HIPSRenderer::HIPSRenderer()
 {
     m_scanRender.reset(new ScanRender());
@@ -95,8 +107,18 @@ bool HIPSRenderer::render(uint16_t w, uint16_t h, QImage *hipsImage, const Proje
     bool old = m_scanRender->isBilinearInterpolationEnabled();
     m_scanRender->setBilinearInterpolationEnabled(Options::hIPSBiLinearInterpolation() && (size >= HIPSManager::Instance()->getCurrentTileWidth() || allSky));
 
+    // The grid is painted between the tiles, so it needs the serial path to come out the same
+    m_tiled = Options::hIPSTiledRendering() && !Options::hIPSShowGrid();
+
     renderRec(allSky, level, centerPix, hipsImage);
 
+    if (m_tiled)
+        renderTiles(hipsImage);
+
+    // While slewing, load the tiles that are about to come into view
+    if (!allSky && SkyMap::IsSlewing())
+        prefetch(level);
+
     m_scanRender->setBilinearInterpolationEnabled(old);
 
     return true;
@@ -157,6 +179,14 @@ bool HIPSRenderer::renderPix(bool allsky, int level, int pix, QImage *pDest)
         {
             m_rendered++;
 
+            // The tiles that getPix() loads later in the walk may evict this one from the cache before
+            // renderTiles() reads it. A shallow copy keeps its pixels alive until then.
+            if (m_tiled)
+            {
+                m_tileImages.emplace_back(freeImage ? image : new QImage(*image));
+                image = m_tileImages.back().get();
+            }
+
 #if QT_VERSION >= QT_VERSION_CHECK(5,10,0)
             m_size += image->sizeInBytes();
 #else
@@ -218,15 +248,16 @@ bool HIPSRenderer::renderPix(bool allsky, int level, int pix, QImage *pDest)
 
                     for (int i = 0; i < 4; i++)
                         fineScreenCoords[i] = m_projector->toScreen(&fineSkyPoints[i]);
-                    m_scanRender->renderPolygon(3, fineScreenCoords, pDest, image, uv[j]);
+                    if (m_tiled)
+                        queuePolygon(fineScreenCoords, uv[j], image);
+                    else
+                        m_scanRender->renderPolygon(3, fineScreenCoords, pDest, image, uv[j]);
                     j++;
                 }
             }
 
-            if (freeImage)
-            {
+            if (freeImage && !m_tiled)
                 delete image;
-            }
         }
 
         if (Options::hIPSShowGrid())
@@ -248,3 +279,155 @@ bool HIPSRenderer::renderPix(bool allsky, int level, int pix, QImage *pDest)
 
     return false;
 }
+
+void HIPSRenderer::queuePolygon(const QPointF *screen, const QPointF *uv, QImage *image)
+{
+    TilePolygon polygon;
+    double minX = screen[0].x(), maxX = minX, minY = screen[0].y(), maxY = minY;
+
+    for (int i = 0; i < 4; i++)
+    {
+        polygon.screen[i] = screen[i];
+        polygon.uv[i]     = uv[i];
+
+        minX = std::min(minX, screen[i].x());
+        maxX = std::max(maxX, screen[i].x());
+        minY = std::min(minY, screen[i].y());
+        maxY = std::max(maxY, screen[i].y());
+    }
+
+    // ScanRender truncates the corners and steps along the edges in floating point, so leave a
+    // margin of a couple of pixels. The subdivided polygons stay inside the corners' bounding box.
+    // Polygons with corners far off the screen are sent to every tile, whatever ScanRender makes of them.
+    const double limit = 1e6;
+    if (std::fabs(minX) < limit && std::fabs(maxX) < limit && std::fabs(minY) < limit && std::fabs(maxY) < limit)
+        polygon.bounds = QRect(QPoint(std::floor(minX) - 2, std::floor(minY) - 2),
+                               QPoint(std::ceil(maxX) + 2, std::ceil(maxY) + 2));
+    else
+        polygon.bounds = QRect(-1, -1, std::numeric_limits<int>::max() / 2, std::numeric_limits<int>::max() / 2);
+    polygon.image = image;
+
+    m_polygons.push_back(polygon);
+}
+
+void HIPSRenderer::renderTiles(QImage *pDest)
+{
+    const QRect imageRect = pDest->rect();
+    const int columns = (imageRect.width() + HIPS_TILE_SIZE - 1) / HIPS_TILE_SIZE;
+    const int rows = (imageRect.height() + HIPS_TILE_SIZE - 1) / HIPS_TILE_SIZE;
+
+    // Bin the polygons per tile. Each bin keeps the order in which renderRec() visited the
+    // polygons, so overlapping polygons are painted over each other just like the serial path.
+    std::vector<std::vector<int>> bins(columns * rows);
+    for (int i = 0; i < static_cast<int>(m_polygons.size()); i++)
+    {
+        const QRect bounds = m_polygons[i].bounds.intersected(imageRect);
+        if (bounds.isEmpty())
+            continue;
+
+        for (int row = bounds.top() / HIPS_TILE_SIZE; row <= bounds.bottom() / HIPS_TILE_SIZE; row++)
+        {
+            for (int column = bounds.left() / HIPS_TILE_SIZE; column <= bounds.right() / HIPS_TILE_SIZE; column++)
+                bins[row * columns + column].push_back(i);
+        }
+    }
+
+    const int workers = std::max(1, std::min(QThreadPool::globalInstance()->maxThreadCount(), columns * rows));
+    while (static_cast<int>(m_tileRenders.size()) < workers)
+        m_tileRenders.emplace_back(new ScanRender());
+
+    // QImage::bits() may detach and always touches the image's private data, so every worker
+    // writes through an image of its own that wraps the destination pixels.
+    uchar *bits = pDest->bits();
+    std::vector<QImage> targets;
+    targets.reserve(workers);
+    for (int i = 0; i < workers; i++)
+        targets.emplace_back(bits, pDest->width(), pDest->height(), pDest->bytesPerLine(), pDest->format());
+
+    const bool bilinear = m_scanRender->isBilinearInterpolationEnabled();
+    std::atomic<int> nextTile { 0 };
+    std::vector<int> workerIDs(workers);
+    std::iota(workerIDs.begin(), workerIDs.end(), 0);
+
+    QtConcurrent::blockingMap(workerIDs, [&](int &worker)
+    {
+        ScanRender *scanRender = m_tileRenders[worker].get();
+        QImage *target = &targets[worker];
+
+        scanRender->setBilinearInterpolationEnabled(bilinear);
+
+        for (int tile = nextTile++; tile < static_cast<int>(bins.size()); tile = nextTile++)
+        {
+            if (bins[tile].empty())
+                continue;
+
+            const int column = tile % columns;
+            const int row = tile / columns;
+            scanRender->setClipRect(QRect(column * HIPS_TILE_SIZE, row * HIPS_TILE_SIZE, HIPS_TILE_SIZE,
+                                          HIPS_TILE_SIZE).intersected(imageRect));
+
+            for (int index : bins[tile])
+            {
+                TilePolygon &polygon = m_polygons[index];
+                scanRender->renderPolygon(3, polygon.screen, target, polygon.image, polygon.uv);
+            }
+        }
+
+        scanRender->setClipRect(QRect());
+    });
+
+    m_polygons.clear();
+    m_tileImages.clear();
+}
+
+void HIPSRenderer::prefetch(int level)
+{
+    HIPSManager *manager = HIPSManager::Instance();
+    int budget = HIPS_PREFETCH_BUDGET;
+
+    // Neighbours of the rendered tiles first, as they come into view while panning
+    const int nside = 1 << level;
+    for (int pix : m_renderedMap)
+    {
+        int dirs[8];
+        m_HEALpix->neighbours(nside, pix, dirs);
+
+        for (int dir : dirs)
+        {
+            if (dir < 0 || m_renderedMap.contains(dir) || !manager->prefetchPix(level, dir))
+                continue;
+            if (--budget == 0)
+                return;
+        }
+    }
+
+    // Then the parents, which getPix() falls back to while a tile is loading when zooming out
+    if (level > 3 && manager->getUsableLevel(level - 1) == level - 1)
+    {
+        QSet<int> parents;
+        for (int pix : m_renderedMap)
+            parents.insert(pix / 4);
+
+        for (int parent : parents)
+        {
+            if (manager->prefetchPix(level - 1, parent) && --budget == 0)
+                return;
+        }
+    }
+
+    // And the children for zooming in
+    if (level < manager->getCurrentOrder() && manager->getUsableLevel(level + 1) == level + 1)
+    {
+        for (int pix : m_renderedMap)
+        {
+            int childs[4];
+            m_HEALpix->getPixChilds(pix, childs);
+
+            for (int child : childs)
+            {
+                if (manager->prefetchPix(level + 1, child) && --budget == 0)
+                    return;
+            }
+        }
+    }
+}
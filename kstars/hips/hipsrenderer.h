@@ -13,6 +13,7 @@
 #include "scanrender.h"
 
 #include <memory>
+#include <vector>
 
 class Projector;
 
@@ -30,7 +31,22 @@ signals:
 
 public slots:
 
-private:  
+private:
+  // A polygon queued for the tiled rasterizer, see renderTiles()
+  struct TilePolygon
+  {
+    QPointF screen[4];
+    QPointF uv[4];
+    QImage *image;
+    QRect bounds;
+  };
+
+  void queuePolygon(const QPointF *screen, const QPointF *uv, QImage *image);
+  void renderTiles(QImage *pDest);
+
+  // Ask HIPSManager for the tiles around the rendered ones at level
+  void prefetch(int level);
+
   int m_blocks { 0 };
   int m_rendered { 0 };
   int m_size { 0 };
@@ -39,4 +55,12 @@ private:
   std::unique_ptr<ScanRender> m_scanRender;
   const Projector *m_projector;
   QColor gridColor;
+
+  // When set, renderPix() only queues the polygons and renderTiles() rasterizes them in parallel
+  bool m_tiled { false };
+  std::vector<TilePolygon> m_polygons;
+  // The tiles of the queued polygons, kept alive until renderTiles() is done even if the HiPS cache drops them
+  std::vector<std::unique_ptr<QImage>> m_tileImages;
+  // One scan converter per worker thread
+  std::vector<std::unique_ptr<ScanRender>> m_tileRenders;
 };
@@ -0,0 +1,316 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "hipstilepack.h"
+
+#include "kstars_debug.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace
+{
+const char kMagic[8] = { 'K', 'S', 'H', 'I', 'P', 'S', 'P', 'K' };
+constexpr quint32 kVersion = 2;
+
+// Entry flags
+constexpr quint32 kDecoded = 0x1;
+
+struct Header
+{
+    char magic[8];
+    quint32 version;
+    quint32 order;
+    quint32 tileWidth;
+    quint32 imageFormat;
+    quint32 reserved;
+    quint32 reserved2;
+    quint64 entryCount;
+};
+static_assert(sizeof(Header) == 40, "The pack header must not be padded");
+
+quint64 tileCountOf(int order)
+{
+    return 12ull << (2 * order);
+}
+
+qint64 alignTo8(qint64 value)
+{
+    return (value + 7) & ~qint64(7);
+}
+}
+
+struct HIPSTilePack::Entry
+{
+    quint64 pix;
+    quint64 offset;
+    quint32 size;
+    quint32 flags;
+};
+
+HIPSTilePack::HIPSTilePack(const QString &filename) : m_filename(filename), m_file(filename)
+{
+}
+
+HIPSTilePack::~HIPSTilePack()
+{
+    close();
+}
+
+void HIPSTilePack::close()
+{
+    QWriteLocker locker(&m_lock);
+
+    if (m_data)
+        m_file.unmap(m_data);
+    m_file.close();
+
+    m_data       = nullptr;
+    m_size       = 0;
+    m_index      = nullptr;
+    m_entryCount = 0;
+}
+
+QString HIPSTilePack::packFileName(const QString &directory, int order)
+{
+    return QDir(directory).filePath(QString("Norder%1.hpk").arg(order));
+}
+
+bool HIPSTilePack::open()
+{
+    static_assert(sizeof(Entry) == 24, "Pack index entries must not be padded");
+
+    QWriteLocker locker(&m_lock);
+
+    if (m_data)
+        return true;
+
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+
+    m_size = m_file.size();
+    if (m_size < static_cast<qint64>(sizeof(Header)))
+    {
+        m_file.close();
+        return false;
+    }
+
+    // The file stays open for as long as it is mapped
+    uchar *data = m_file.map(0, m_size);
+    if (data == nullptr)
+    {
+        qCWarning(KSTARS) << "Could not map HiPS tile pack" << m_filename;
+        m_file.close();
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+
+    const int order = qFromLittleEndian(header.order);
+    const quint64 entryCount = qFromLittleEndian(header.entryCount);
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || qFromLittleEndian(header.version) != kVersion ||
+            order < 0 || order > 13 || entryCount > tileCountOf(order) ||
+            static_cast<quint64>(m_size) < sizeof(Header) + entryCount * sizeof(Entry))
+    {
+        qCWarning(KSTARS) << "Invalid HiPS tile pack" << m_filename;
+        m_file.unmap(data);
+        m_file.close();
+        return false;
+    }
+
+    m_data        = data;
+    m_order       = order;
+    m_tileWidth   = qFromLittleEndian(header.tileWidth);
+    m_imageFormat = static_cast<QImage::Format>(qFromLittleEndian(header.imageFormat));
+    m_entryCount  = entryCount;
+    m_index       = reinterpret_cast<const Entry *>(m_data + sizeof(Header));
+
+    return true;
+}
+
+const HIPSTilePack::Entry *HIPSTilePack::entry(int pix) const
+{
+    if (!m_data || pix < 0)
+        return nullptr;
+
+    // The index is sorted by pixel number
+    const Entry *end   = m_index + m_entryCount;
+    const Entry *entry = std::lower_bound(m_index, end, static_cast<quint64>(pix), [](const Entry & candidate, quint64 value)
+    {
+        return qFromLittleEndian(candidate.pix) < value;
+    });
+    if (entry == end || qFromLittleEndian(entry->pix) != static_cast<quint64>(pix) || qFromLittleEndian(entry->size) == 0 ||
+            qFromLittleEndian(entry->offset) + qFromLittleEndian(entry->size) > static_cast<quint64>(m_size))
+        return nullptr;
+
+    return entry;
+}
+
+bool HIPSTilePack::contains(int pix) const
+{
+    QReadLocker locker(&m_lock);
+    return entry(pix) != nullptr;
+}
+
+QImage HIPSTilePack::tile(int pix) const
+{
+    QReadLocker locker(&m_lock);
+
+    const Entry *tileEntry = entry(pix);
+    if (tileEntry == nullptr)
+        return QImage();
+
+    const uchar *data = m_data + qFromLittleEndian(tileEntry->offset);
+    const quint32 size = qFromLittleEndian(tileEntry->size);
+
+    if ((qFromLittleEndian(tileEntry->flags) & kDecoded) && m_tileWidth > 0)
+    {
+        // Wrap the mapping and copy it out, the mapping may go away before the image does
+        const int bytesPerLine = size / m_tileWidth;
+        return QImage(data, m_tileWidth, m_tileWidth, bytesPerLine, m_imageFormat).copy();
+    }
+
+    return QImage::fromData(data, size);
+}
+
+bool HIPSTilePack::build(const QString &sourceDirectory, int order, const QString &filename, qint64 maxDecodedSize)
+{
+    const QString orderDirectory = QDir(sourceDirectory).filePath(QString("Norder%1").arg(order));
+    const quint64 tileCount = tileCountOf(order);
+
+    // The tiles are Npix<pix>.<ext> files spread over Dir<n> directories
+    std::map<quint64, QString> tiles;
+    QDirIterator it(orderDirectory, QStringList() << "Npix*", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        const QString path = it.next();
+        bool ok = false;
+        const quint64 pix = it.fileInfo().completeBaseName().mid(4).toULongLong(&ok);
+        if (ok && pix < tileCount)
+            tiles.emplace(pix, path);
+    }
+
+    if (tiles.empty())
+        return false;
+
+    QImage first(tiles.begin()->second);
+    if (first.isNull() || first.width() != first.height())
+    {
+        qCWarning(KSTARS) << "Cannot read HiPS tile" << tiles.begin()->second;
+        return false;
+    }
+
+    const int tileWidth = first.width();
+    const QImage::Format imageFormat = first.isGrayscale() ? QImage::Format_Grayscale8 : QImage::Format_RGB32;
+    const qint64 bytesPerLine = ((tileWidth * (imageFormat == QImage::Format_Grayscale8 ? 1 : 4)) + 3) & ~3;
+    const bool decode = static_cast<qint64>(tiles.size()) * bytesPerLine * tileWidth <= maxDecodedSize;
+
+    QFile file(filename + ".part");
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qCWarning(KSTARS) << "Cannot write HiPS tile pack" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version     = qToLittleEndian(kVersion);
+    header.order       = qToLittleEndian(static_cast<quint32>(order));
+    header.tileWidth   = qToLittleEndian(static_cast<quint32>(tileWidth));
+    header.imageFormat = qToLittleEndian(static_cast<quint32>(imageFormat));
+    header.reserved    = 0;
+    header.reserved2   = 0;
+    header.entryCount  = 0;
+
+    bool ok = file.write(reinterpret_cast<const char *>(&header), sizeof(Header)) == sizeof(Header);
+
+    // The index and the header are written last, reserve room for an entry per tile first.
+    // Tiles that cannot be read leave unused room at the end of the index.
+    const qint64 dataStart = sizeof(Header) + tiles.size() * sizeof(Entry);
+    ok = ok && file.resize(dataStart) && file.seek(dataStart);
+
+    std::vector<Entry> entries;
+    entries.reserve(tiles.size());
+
+    qint64 position = dataStart;
+    for (const auto &tile : tiles)
+    {
+        if (!ok)
+            break;
+
+        QByteArray data;
+        quint32 flags = 0;
+
+        if (decode)
+        {
+            QImage image(tile.second);
+            if (!image.isNull() && image.width() == tileWidth && image.height() == tileWidth)
+            {
+                image = image.convertToFormat(imageFormat);
+                for (int y = 0; y < tileWidth; y++)
+                    data.append(reinterpret_cast<const char *>(image.constScanLine(y)), bytesPerLine);
+                flags = kDecoded;
+            }
+        }
+
+        // Tiles that do not fit the decoded layout are kept as they are
+        if (data.isEmpty())
+        {
+            QFile source(tile.second);
+            if (!source.open(QIODevice::ReadOnly))
+                continue;
+            data = source.readAll();
+        }
+
+        if (data.isEmpty())
+            continue;
+
+        const qint64 offset = alignTo8(position);
+        ok = file.seek(offset) && file.write(data) == data.size();
+        position = offset + data.size();
+
+        // The tiles are visited in pixel order, so the index comes out sorted
+        Entry entry;
+        entry.pix    = qToLittleEndian(tile.first);
+        entry.offset = qToLittleEndian(static_cast<quint64>(offset));
+        entry.size   = qToLittleEndian(static_cast<quint32>(data.size()));
+        entry.flags  = qToLittleEndian(flags);
+        entries.push_back(entry);
+    }
+
+    header.entryCount = qToLittleEndian(static_cast<quint64>(entries.size()));
+    const qint64 indexBytes = entries.size() * sizeof(Entry);
+    ok = ok && file.seek(0) && file.write(reinterpret_cast<const char *>(&header), sizeof(Header)) == sizeof(Header) &&
+         file.write(reinterpret_cast<const char *>(entries.data()), indexBytes) == indexBytes;
+
+    file.close();
+
+    if (!ok)
+    {
+        qCWarning(KSTARS) << "Failed to write HiPS tile pack" << file.fileName() << file.errorString();
+        file.remove();
+        return false;
+    }
+
+    QFile::remove(filename);
+    if (!file.rename(filename))
+    {
+        qCWarning(KSTARS) << "Cannot rename HiPS tile pack to" << filename;
+        file.remove();
+        return false;
+    }
+
+    qCInfo(KSTARS) << "Built HiPS tile pack" << filename << "with" << entries.size() << (decode ? "decoded" : "encoded")
+                   << "tiles";
+    return true;
+}
@@ -0,0 +1,96 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QFile>
+#include <QImage>
+#include <QReadWriteLock>
+#include <QString>
+
+/**
+ * @class HIPSTilePack
+ * @short All the tiles of one order of a HiPS survey in a single memory-mapped file
+ *
+ * A pack replaces the Norder<N>/Dir<D>/Npix<P>.jpg tree of an offline survey. Tiles are
+ * looked up by their NESTED HEALPix pixel number in an index of the tiles present and read
+ * straight from the mapping, without the network stack or the disk cache. Packs that are small enough hold
+ * the tiles decoded, so reading them is a copy; the others keep the original JPEG or PNG data.
+ *
+ * File layout, all numbers little endian:
+ * - header: the magic "KSHIPSPK", version, order, tile width, QImage::Format of the decoded
+ *   tiles, two reserved words and the number of index entries.
+ * - index: one entry per tile present, sorted by pixel number, with the offset, size and flags
+ *   of its data. Surveys rarely cover the whole sky at deep orders, so the index only grows
+ *   with the tiles actually stored and not with the 12 * 4^order pixels of the order.
+ * - data: the tiles, each aligned to 8 bytes.
+ *
+ * tile() only reads the mapping and may be called from several threads at once. close() waits
+ * for the reads in progress, after which tile() returns null images.
+ */
+class HIPSTilePack
+{
+    public:
+        explicit HIPSTilePack(const QString &filename);
+        ~HIPSTilePack();
+
+        /** Map the pack and check its header. @return false if the file is missing or invalid */
+        bool open();
+        /** Unmap and close the pack, so that its file can be replaced */
+        void close();
+        bool isOpen() const
+        {
+            return m_data != nullptr;
+        }
+
+        int order() const
+        {
+            return m_order;
+        }
+        const QString &fileName() const
+        {
+            return m_filename;
+        }
+
+        /** @return true if the pack has a tile for the HEALPix pixel pix */
+        bool contains(int pix) const;
+
+        /** @return the tile of the HEALPix pixel pix, a null image if it is missing */
+        QImage tile(int pix) const;
+
+        /** @return the name of the pack of the given order in directory */
+        static QString packFileName(const QString &directory, int order);
+
+        /**
+         * @short Build a pack from the Norder<order> tree of an offline survey
+         *
+         * The pack is written next to filename and renamed when complete, so a pack that is
+         * open elsewhere is never seen half-written. The tiles are stored decoded if all of
+         * them take less than maxDecodedSize bytes that way.
+         *
+         * @return false if the survey has no tiles of that order or the pack could not be written
+         */
+        static bool build(const QString &sourceDirectory, int order, const QString &filename,
+                          qint64 maxDecodedSize = 256 * 1024 * 1024);
+
+    private:
+        struct Entry;
+
+        const Entry *entry(int pix) const;
+
+        // Held for reading while a tile is read from the mapping, and for writing to unmap it
+        mutable QReadWriteLock m_lock;
+        QString m_filename;
+        QFile m_file;
+        uchar *m_data { nullptr };
+        qint64 m_size { 0 };
+
+        int m_order { 0 };
+        int m_tileWidth { 0 };
+        QImage::Format m_imageFormat { QImage::Format_Invalid };
+        quint64 m_entryCount { 0 };
+        const Entry *m_index { nullptr };
+};
@@ -46,7 +46,7 @@ OpsHIPSCache::OpsHIPSCache() : QFrame(KStars::Instance())
 
         QDir hipsDirectory(dir);
         auto orders = hipsDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
-        HIPSManager::Instance()->setOfflineLevels(orders);
+        HIPSManager::Instance()->setOfflineLevels(orders, dir);
         HIPSManager::Instance()->setCurrentSource("Offline");
     });
 }
@@ -8,6 +8,12 @@
 
 #include "scanrender.h"
 
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 //#include <omp.h>
 //#define PARALLEL_OMP
 
@@ -19,6 +25,42 @@
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wcast-align"
 
+// Bilinear blend of the four ARGB source pixels a, b, c, d with the 16.16 fixed point weights w.
+// The SSE2 path blends the 4 channels at once in single precision. Every product and partial sum
+// is an integer below 2^24, so it is exact and the result matches the integer expression bit for bit.
+static inline quint32 bilinearARGB(quint32 a, quint32 b, quint32 c, quint32 d,
+                                   int wa, int wb, int wc, int wd)
+{
+#ifdef __SSE2__
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i pixels = _mm_set_epi32(static_cast<int>(d), static_cast<int>(c), static_cast<int>(b), static_cast<int>(a));
+  const __m128i ab = _mm_unpacklo_epi8(pixels, zero);
+  const __m128i cd = _mm_unpackhi_epi8(pixels, zero);
+
+  __m128 sum = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(ab, zero)), _mm_set1_ps(static_cast<float>(wa)));
+  sum = _mm_add_ps(sum, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(ab, zero)), _mm_set1_ps(static_cast<float>(wb))));
+  sum = _mm_add_ps(sum, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(cd, zero)), _mm_set1_ps(static_cast<float>(wc))));
+  sum = _mm_add_ps(sum, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(cd, zero)), _mm_set1_ps(static_cast<float>(wd))));
+
+  __m128i channels = _mm_srli_epi32(_mm_cvttps_epi32(sum), 16);
+  channels = _mm_packs_epi32(channels, channels);
+  channels = _mm_packus_epi16(channels, channels);
+
+  return 0xff000000 | (static_cast<quint32>(_mm_cvtsi128_si32(channels)) & 0xffffff);
+#else
+  // blue element
+  int blue = ((a&0xff)*(wa) + (b&0xff)*(wb) + (c&0xff)*(wc)  + (d&0xff)*(wd)) >> 16;
+
+  // green element
+  int green = (((a>>8)&0xff)*(wa) + ((b>>8)&0xff)*(wb) + ((c>>8)&0xff)*(wc)  + ((d>>8)&0xff)*(wd)) >> 16;
+
+  // red element
+  int red = (((a>>16)&0xff)*(wa) + ((b>>16)&0xff)*(wb) +((c>>16)&0xff)*(wc)  + ((d>>16)&0xff)*(wd)) >> 16;
+
+  return 0xff000000 | (((red)<<16)&0xff0000) | (((green)<<8)&0xff00) | (blue);
+#endif
+}
+
 //////////////////////////////
 ScanRender::ScanRender(void)
 //////////////////////////////
@@ -323,6 +365,37 @@ void ScanRender::setOpacity(float opacity)
   m_opacity = opacity;
 }
 
+void ScanRender::setClipRect(const QRect &clip)
+{
+  m_clip = clip;
+}
+
+void ScanRender::clipRows(int &y1, int &y2) const
+{
+  if (m_clip.isNull())
+    return;
+
+  y1 = qMax(y1, m_clip.top());
+  y2 = qMin(y2, m_clip.bottom());
+}
+
+// Narrows the span [x1, x2) to the clip rectangle and returns in x1 the number of pixels skipped
+// on the left, which the caller steps its texture coordinates over.
+void ScanRender::clipColumns(int w, int &x1, int &x2) const
+{
+  int left = 0;
+  int right = w;
+
+  if (!m_clip.isNull())
+  {
+    left = m_clip.left();
+    right = m_clip.right() + 1;
+  }
+
+  x2 = qMin(x2, right);
+  x1 = qMax(0, qMin(left, x2) - x1);
+}
+
 /////////////////////////////////////////////////////////
 void ScanRender::renderPolygon(QImage *dst, QImage *src)
 /////////////////////////////////////////////////////////
@@ -414,9 +487,13 @@ void ScanRender::renderPolygonNI(QImage *dst, QImage *src)
   quint32 *bitsDst = (quint32 *)dst->bits();
   bkScan_t *scan = scLR;
   bool bw = src->format() == QImage::Format_Indexed8 || src->format() == QImage::Format_Grayscale8;      
+  int minY = plMinY;
+  int maxY = plMaxY;
+
+  clipRows(minY, maxY);
 
   //#pragma omp parallel for
-  for (int y = plMinY; y <= plMaxY; y++)
+  for (int y = minY; y <= maxY; y++)
   {   
     if (scan[y].scan[0] > scan[y].scan[1])
     {
@@ -473,6 +550,17 @@ void ScanRender::renderPolygonNI(QImage *dst, QImage *src)
     fuv[0] = CLAMP(fuv[0], 0, (sw - 1) * 65536.);
     fuv[1] = CLAMP(fuv[1], 0, (sh - 1) * 65536.);
 
+    // Start at the left edge of the clip rectangle as if the skipped pixels had been stepped over
+    int skip = px1;
+    clipColumns(w, skip, px2);
+    if (skip > 0)
+    {
+      px1 += skip;
+      pDst += skip;
+      fuv[0] = static_cast<int>(static_cast<quint32>(fuv[0]) + static_cast<quint32>(fduv[0]) * static_cast<quint32>(skip));
+      fuv[1] = static_cast<int>(static_cast<quint32>(fuv[1]) + static_cast<quint32>(fduv[1]) * static_cast<quint32>(skip));
+    }
+
     if (bw)
     {
       for (int x = px1; x < px2; x++)
@@ -518,11 +606,15 @@ void ScanRender::renderPolygonBI(QImage *dst, QImage *src)
   quint32 *bitsDst = (quint32 *)dst->bits();
   bkScan_t *scan = scLR;
   bool bw = src->format() == QImage::Format_Indexed8 || src->format() == QImage::Format_Grayscale8;
+  int minY = plMinY;
+  int maxY = plMaxY;
+
+  clipRows(minY, maxY);
 
 #ifdef PARALLEL_OMP
   #pragma omp parallel for
 #endif
-  for (int y = plMinY; y <= plMaxY; y++)
+  for (int y = minY; y <= maxY; y++)
   {
     if (scan[y].scan[0] > scan[y].scan[1])
     {
@@ -567,6 +659,17 @@ void ScanRender::renderPolygonBI(QImage *dst, QImage *src)
 
     int size = sw * sh;
 
+    // Step over the pixels left of the clip rectangle one at a time, like the loops below do,
+    // so that the texture coordinates of the remaining pixels are the same to the last bit
+    int skip = px1;
+    clipColumns(w, skip, px2);
+    for (int i = 0; i < skip; i++)
+    {
+      uv[0] += duv[0];
+      uv[1] += duv[1];
+    }
+    px1 += skip;
+
     quint32 *pDst = bitsDst + (y * w) + px1;
     if (bw)
     {
@@ -618,16 +721,7 @@ void ScanRender::renderPolygonBI(QImage *dst, QImage *src)
         int qxy = (x_diff * y_diff) * 65536;
         int qyx1 = (y_diff * x_1diff) * 65536;
 
-        // blue element
-        int blue = ((a&0xff)*(qxy1) + (b&0xff)*(qxy2) + (c&0xff)*(qyx1)  + (d&0xff)*(qxy)) >> 16;
-
-        // green element
-        int green = (((a>>8)&0xff)*(qxy1) + ((b>>8)&0xff)*(qxy2) + ((c>>8)&0xff)*(qyx1)  + ((d>>8)&0xff)*(qxy)) >> 16;
-
-        // red element
-        int red = (((a>>16)&0xff)*(qxy1) + ((b>>16)&0xff)*(qxy2) +((c>>16)&0xff)*(qyx1)  + ((d>>16)&0xff)*(qxy)) >> 16;
-
-        *pDst = 0xff000000 | (((red)<<16)&0xff0000) | (((green)<<8)&0xff00) | (blue);
+        *pDst = bilinearARGB(a, b, c, d, qxy1, qxy2, qyx1, qxy);
 
         pDst++;
 
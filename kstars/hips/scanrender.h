@@ -43,7 +43,19 @@ class ScanRender
     void renderPolygonAlpha(QColor col, QImage *dst);
     void setOpacity(float opacity);
 
+    /**
+     * Restrict renderPolygonNI() and renderPolygonBI() to a rectangle of the destination image.
+     * The pixels inside the rectangle come out exactly as without clipping, so that an image can
+     * be split into tiles rendered by separate ScanRender instances. A null rectangle renders the
+     * whole image.
+     */
+    void setClipRect(const QRect &clip);
+    QRect clipRect() const { return m_clip; }
+
 private:
+    void clipRows(int &y1, int &y2) const;
+    void clipColumns(int w, int &x1, int &x2) const;
+
     float    m_opacity { 1.0f };
     int      plMinY { 0 };
     int      plMaxY { 0 };
@@ -51,4 +63,5 @@ private:
     int      m_sy { 0 };
     bkScan_t scLR[MAX_BK_SCANLINES];
     bool     bBilinear { false };
+  QRect    m_clip;
 };
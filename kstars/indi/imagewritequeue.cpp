@@ -0,0 +1,274 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "imagewritequeue.h"
+
+#include "fitsviewer/fitsblob.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+#include <indi_debug.h>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <cstdio>
+#include <unistd.h>
+#endif
+
+namespace
+{
+bool syncToDisk(QFile &file)
+{
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return fsync(file.handle()) == 0;
+#endif
+}
+
+// Replace the destination at once where the platform allows it
+bool replaceFile(const QString &source, const QString &destination)
+{
+#ifdef Q_OS_WIN
+    QFile::remove(destination);
+    return QFile::rename(source, destination);
+#else
+    return std::rename(QFile::encodeName(source).constData(), QFile::encodeName(destination).constData()) == 0;
+#endif
+}
+
+// Modification time of the directory of a file, in milliseconds since the epoch, -1 if missing
+qint64 directoryModified(const QString &filename)
+{
+    QFileInfo const directory(QFileInfo(filename).absolutePath());
+    return directory.isDir() ? directory.lastModified().toMSecsSinceEpoch() : -1;
+}
+}
+
+namespace ISD
+{
+ImageWriteQueue::ImageWriteQueue(QObject *parent) : QThread(parent)
+{
+    start();
+}
+
+ImageWriteQueue::~ImageWriteQueue()
+{
+    {
+        QMutexLocker locker(&m_Mutex);
+        m_Stop = true;
+        m_Wake.wakeAll();
+        m_Done.wakeAll();
+    }
+
+    wait();
+}
+
+void ImageWriteQueue::setCapacity(int frames)
+{
+    QMutexLocker locker(&m_Mutex);
+    m_Capacity = std::max(1, frames);
+    m_Done.wakeAll();
+}
+
+int ImageWriteQueue::capacity() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_Capacity;
+}
+
+void ImageWriteQueue::setSyncInterval(int files)
+{
+    QMutexLocker locker(&m_Mutex);
+    m_SyncInterval = std::max(0, files);
+}
+
+void ImageWriteQueue::enqueue(const QString &filename, const QSharedPointer<FITSBlob> &blob)
+{
+    // Adopted pixels must stay as they are until written
+    blob->beginWrite();
+
+    Job job;
+    job.filename = filename;
+    job.blob = blob;
+    enqueue(job);
+}
+
+void ImageWriteQueue::enqueue(const QString &filename, const QByteArray &data)
+{
+    Job job;
+    job.filename = filename;
+    job.data = data;
+    enqueue(job);
+}
+
+void ImageWriteQueue::enqueue(Job &job)
+{
+    int depth = 0, capacity = 0;
+    double latency = 0;
+    {
+        QMutexLocker locker(&m_Mutex);
+        // Memory is the limit here, only producers that ignore isFull() end up waiting
+        while (m_Queue.size() > m_Capacity && !m_Stop)
+            m_Done.wait(&m_Mutex);
+
+        job.queued.start();
+        m_Queue.enqueue(job);
+        m_Wake.wakeAll();
+
+        depth = m_Queue.size();
+        capacity = m_Capacity;
+        latency = m_Statistics.lastLatency;
+    }
+
+    emit statusChanged(depth, capacity, latency);
+}
+
+int ImageWriteQueue::depth() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_Queue.size();
+}
+
+bool ImageWriteQueue::isFull() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_Queue.size() >= m_Capacity;
+}
+
+ImageWriteQueue::Statistics ImageWriteQueue::statistics() const
+{
+    QMutexLocker locker(&m_Mutex);
+    Statistics statistics = m_Statistics;
+    statistics.depth = m_Queue.size();
+    statistics.capacity = m_Capacity;
+    return statistics;
+}
+
+void ImageWriteQueue::waitForDone()
+{
+    QMutexLocker locker(&m_Mutex);
+    while (!m_Queue.isEmpty())
+        m_Done.wait(&m_Mutex);
+}
+
+void ImageWriteQueue::run()
+{
+    QMutexLocker locker(&m_Mutex);
+
+    while (true)
+    {
+        while (m_Queue.isEmpty() && !m_Stop)
+            m_Wake.wait(&m_Mutex);
+
+        // Files still queued are written before stopping
+        if (m_Queue.isEmpty())
+            break;
+
+        // The job stays queued while it is written, so that it counts in the depth
+        Job job = m_Queue.head();
+        const int syncInterval = m_SyncInterval;
+        locker.unlock();
+
+        const bool ok = writeFile(job, syncInterval == 1);
+        if (job.blob)
+            job.blob->endWrite();
+
+        locker.relock();
+        QStringList toSync;
+        if (ok && syncInterval > 1)
+        {
+            m_Unsynced << job.filename;
+            if (m_Unsynced.size() >= syncInterval || m_Queue.size() == 1)
+                toSync.swap(m_Unsynced);
+        }
+        locker.unlock();
+
+        syncFiles(toSync);
+
+        locker.relock();
+        m_Queue.dequeue();
+        const double latency = job.queued.nsecsElapsed() / 1e6;
+        if (ok)
+        {
+            m_Statistics.written++;
+            m_Statistics.lastLatency = latency;
+            m_Statistics.totalLatency += latency;
+        }
+        else
+            m_Statistics.failed++;
+
+        const int depth = m_Queue.size();
+        const int capacity = m_Capacity;
+        m_Done.wakeAll();
+        locker.unlock();
+
+        if (ok)
+            emit fileWritten(job.filename, job.directoryBefore, job.directoryAfter);
+        else
+            emit writeFailed(job.filename);
+        emit statusChanged(depth, capacity, latency);
+
+        locker.relock();
+    }
+}
+
+bool ImageWriteQueue::writeFile(Job &job, bool sync)
+{
+    const QString partFilename = job.filename + ".part";
+    job.directoryBefore = directoryModified(job.filename);
+    QFile file(partFilename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qCCritical(KSTARS_INDI) << "Unable to open" << partFilename << "for writing:" << file.errorString();
+        return false;
+    }
+
+    bool ok = job.blob ? job.blob->write(&file) : file.write(job.data) == job.data.size();
+    ok = file.flush() && ok;
+    if (ok && sync)
+        ok = syncToDisk(file);
+    file.close();
+
+    if (!ok)
+    {
+        qCCritical(KSTARS_INDI) << "Failed writing" << job.filename << ":" << file.errorString();
+        file.remove();
+        return false;
+    }
+
+    file.setPermissions(QFileDevice::ReadUser |
+                        QFileDevice::WriteUser |
+                        QFileDevice::ReadGroup |
+                        QFileDevice::ReadOther);
+
+    if (!replaceFile(partFilename, job.filename))
+    {
+        qCCritical(KSTARS_INDI) << "Unable to rename" << partFilename << "to" << job.filename;
+        file.remove();
+        return false;
+    }
+
+    job.directoryAfter = directoryModified(job.filename);
+    return true;
+}
+
+void ImageWriteQueue::syncFiles(const QStringList &filenames)
+{
+    for (const QString &filename : filenames)
+    {
+        QFile file(filename);
+        if (!file.open(QIODevice::ReadOnly) || !syncToDisk(file))
+            qCWarning(KSTARS_INDI) << "Unable to flush" << filename << "to disk";
+    }
+}
+}
@@ -0,0 +1,121 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QQueue>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+
+class FITSBlob;
+
+namespace ISD
+{
+/**
+ * @class ImageWriteQueue
+ * @short Writes captured images to disk in order, on a thread of its own.
+ *
+ * Each file is written next to its destination with a .part suffix and renamed when complete, so
+ * a crash never leaves a truncated image under the final name. Files may be flushed to disk with
+ * fsync after each write, in batches, or never, leaving it to the operating system.
+ *
+ * The queue holds up to capacity() frames. Capture checks isFull() before starting the next
+ * exposure and waits for statusChanged() otherwise, so that a slow disk holds back the sequence
+ * instead of the GUI thread. enqueue() itself only blocks if the queue is over capacity anyway.
+ */
+class ImageWriteQueue : public QThread
+{
+        Q_OBJECT
+
+    public:
+        struct Statistics
+        {
+            int depth { 0 };
+            int capacity { 0 };
+            quint64 written { 0 };
+            quint64 failed { 0 };
+            /** Time from enqueue() until the file is in place, in milliseconds */
+            double lastLatency { 0 };
+            double totalLatency { 0 };
+
+            double meanLatency() const
+            {
+                return written > 0 ? totalLatency / written : 0;
+            }
+        };
+
+        explicit ImageWriteQueue(QObject *parent = nullptr);
+        /** Writes the files still queued, then stops the thread. */
+        ~ImageWriteQueue() override;
+
+        /** Number of frames that may wait to be written, at least 1. */
+        void setCapacity(int frames);
+        int capacity() const;
+
+        /** Flush files to disk every that many files, 1 for each file and 0 for never. */
+        void setSyncInterval(int files);
+
+        /** Queue a FITS file, the pixels of the blob are not copied. */
+        void enqueue(const QString &filename, const QSharedPointer<FITSBlob> &blob);
+        /** Queue any other file. */
+        void enqueue(const QString &filename, const QByteArray &data);
+
+        int depth() const;
+        bool isFull() const;
+        Statistics statistics() const;
+
+        /** Block until all queued files are written. */
+        void waitForDone();
+
+    signals:
+        /** The depth of the queue changed. Latency is that of the last file written, in milliseconds. */
+        void statusChanged(int depth, int capacity, double latency);
+        /**
+         * The file is in place under its final name. directoryBefore and directoryAfter are the modification
+         * times of its directory, in milliseconds since the epoch, before the file was created and once it was
+         * renamed, so that an index of the directory can tell whether anything else changed it meanwhile.
+         */
+        void fileWritten(const QString &filename, qint64 directoryBefore, qint64 directoryAfter);
+        void writeFailed(const QString &filename);
+
+    protected:
+        void run() override;
+
+    private:
+        struct Job
+        {
+            QString filename;
+            QSharedPointer<FITSBlob> blob;
+            QByteArray data;
+            QElapsedTimer queued;
+            // Modification times of the directory of the file around the write
+            qint64 directoryBefore { -1 };
+            qint64 directoryAfter { -1 };
+        };
+
+        void enqueue(Job &job);
+        static bool writeFile(Job &job, bool sync);
+        static void syncFiles(const QStringList &filenames);
+
+        /// Guards everything below
+        mutable QMutex m_Mutex;
+        QWaitCondition m_Wake;
+        QWaitCondition m_Done;
+
+        QQueue<Job> m_Queue;
+        bool m_Stop { false };
+        int m_Capacity { 4 };
+        int m_SyncInterval { 0 };
+        /// Written since the last batched sync
+        QStringList m_Unsynced;
+        Statistics m_Statistics;
+};
+}
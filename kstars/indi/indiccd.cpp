@@ -20,12 +20,14 @@
 #include "streamwg.h"
 //#include "ekos/manager.h"
 #ifdef HAVE_CFITSIO
+#include "fitsviewer/fitsblob.h"
 #include "fitsviewer/fitsdata.h"
 #endif
 
 #include <KNotifications/KNotification>
 #include "auxiliary/ksmessagebox.h"
 #include "ksnotification.h"
+#include <QElapsedTimer>
 #include <QImageReader>
 #include <QFileInfo>
 #include <QStatusBar>
@@ -844,6 +846,23 @@ CCD::CCD(GDInterface *iPtr) : DeviceDecorator(iPtr)
     m_Media.reset(new WSMedia(this));
     connect(m_Media.get(), &WSMedia::newFile, this, &CCD::setWSBLOB);
 
+    m_WriteQueue.reset(new ImageWriteQueue());
+    m_WriteQueue->setCapacity(Options::captureWriteQueueSize());
+    m_WriteQueue->setSyncInterval(Options::captureSyncInterval());
+    connect(m_WriteQueue.get(), &ImageWriteQueue::statusChanged, this, &CCD::writeQueueChanged);
+    connect(m_WriteQueue.get(), &ImageWriteQueue::writeFailed, this, [this](const QString & filename)
+    {
+        connect(KSMessageBox::Instance(), &KSMessageBox::accepted, this, [this]()
+        {
+            KSMessageBox::Instance()->disconnect(this);
+            emit error(ERROR_SAVE);
+        });
+        KSMessageBox::Instance()->error(i18n("Failed writing image to %1\nPlease check folder, filename & permissions.",
+                                             filename),
+                                        i18n("Image Write Failed"), 30);
+    });
+    connect(m_WriteQueue.get(), &ImageWriteQueue::fileWritten, this, &CCD::fileWritten);
+
     connect(clientManager, &ClientManager::newBLOBManager, this, &CCD::setBLOBManager, Qt::UniqueConnection);
     m_LastNotificationTS = QDateTime::currentDateTime();
 }
@@ -852,10 +871,6 @@ CCD::~CCD()
 {
     if (m_ImageViewerWindow)
         m_ImageViewerWindow->close();
-    if (fileWriteThread.isRunning())
-        fileWriteThread.waitForFinished();
-    if (fileWriteBuffer != nullptr)
-        delete [] fileWriteBuffer;
 }
 
 void CCD::setBLOBManager(const char *device, INDI::Property prop)
@@ -1373,45 +1388,21 @@ bool CCD::generateFilename(bool batch_mode, const QString &extension, QString *f
     return true;
 }
 
-bool CCD::writeImageFile(const QString &filename, IBLOB *bp, bool is_fits)
+void CCD::writeImageFile(const QString &filename, IBLOB *bp)
 {
-    // TODO: Not yet threading the writes for non-fits files.
-    // Would need to deal with the raw conversion, etc.
-    if (is_fits)
-    {
-        // Check if the last write is still ongoing, and if so wait.
-        // It is using the fileWriteBuffer.
-        if (fileWriteThread.isRunning())
-        {
-            fileWriteThread.waitForFinished();
-        }
-
-        // Wait until the file is written before overwritting the filename.
-        fileWriteFilename = filename;
-
-        // Will write blob data in a separate thread, and can't depend on the blob
-        // memory, so copy it first.
-
-        // Check buffer size.
-        if (fileWriteBufferSize != bp->size)
-        {
-            if (fileWriteBuffer != nullptr)
-                delete [] fileWriteBuffer;
-            fileWriteBufferSize = bp->size;
-            fileWriteBuffer = new char[fileWriteBufferSize];
-        }
+    // The blob memory belongs to the INDI client, copy it.
+    m_WriteQueue->setCapacity(Options::captureWriteQueueSize());
+    m_WriteQueue->setSyncInterval(Options::captureSyncInterval());
+    m_WriteQueue->enqueue(filename, QByteArray(static_cast<char *>(bp->blob), bp->size));
+}
 
-        // Copy memory, and write file on a separate thread.
-        // Probably too late to return an error if the file couldn't write.
-        memcpy(fileWriteBuffer, bp->blob, bp->size);
-        fileWriteThread = QtConcurrent::run(this, &ISD::CCD::WriteImageFileInternal, fileWriteFilename, fileWriteBuffer, bp->size);
-    }
-    else
-    {
-        if (!WriteImageFileInternal(filename, static_cast<char*>(bp->blob), bp->size))
-            return false;
-    }
-    return true;
+void CCD::writeImageFile(const QString &filename, const QSharedPointer<FITSBlob> &blob)
+{
+    // The blob may be shared with the FITSData loaded from it, the queue holds
+    // a reference so the pixels are not copied again.
+    m_WriteQueue->setCapacity(Options::captureWriteQueueSize());
+    m_WriteQueue->setSyncInterval(Options::captureSyncInterval());
+    m_WriteQueue->enqueue(filename, blob);
 }
 
 // Get or Create FITSViewer if we are using FITSViewer
@@ -1463,6 +1454,10 @@ void CCD::processBLOB(IBLOB *bp)
     if (bp->bvp->p == IP_WO || bp->size == 0)
         return;
 
+    // Stages of the image pipeline are timed: receive, parse, stats and display.
+    QElapsedTimer timer;
+    timer.start();
+
     BType = BLOB_OTHER;
 
     QString format = QString(bp->format).toLower();
@@ -1521,13 +1516,18 @@ void CCD::processBLOB(IBLOB *bp)
 
     }
 #endif
+    // FITS blobs are copied once, the copy is then shared by the file writer and the FITSData.
+    QSharedPointer<FITSBlob> fitsBlob;
+    if (BType == BLOB_FITS)
+        fitsBlob.reset(new FITSBlob(static_cast<char *>(bp->blob), bp->size));
+
     // Create file name for sequences.
-    if (targetChip->isBatchMode() && targetChip->getCaptureMode() != FITS_CALIBRATE)
+    const bool saveFile = targetChip->isBatchMode() && targetChip->getCaptureMode() != FITS_CALIBRATE;
+    if (saveFile)
     {
-        // If either generating file name or writing the image file fails
-        // then return
-        if (!generateFilename(targetChip->isBatchMode(), format, &filename) ||
-                !writeImageFile(filename, bp, BType == BLOB_FITS))
+        // If generating the file name fails then return.
+        // Files are written by the write queue, FITS files once loaded, see below.
+        if (!generateFilename(targetChip->isBatchMode(), format, &filename))
         {
             connect(KSMessageBox::Instance(), &KSMessageBox::accepted, this, [ = ]()
             {
@@ -1541,6 +1541,9 @@ void CCD::processBLOB(IBLOB *bp)
             emit BLOBUpdated(nullptr);
             return;
         }
+
+        if (!fitsBlob)
+            writeImageFile(filename, bp);
     }
     else
         filename = QDir::tempPath() + QDir::separator() + "image" + format;
@@ -1651,15 +1654,31 @@ void CCD::processBLOB(IBLOB *bp)
             Options::useSummaryPreview() == false &&
             targetChip->isBatchMode())
     {
+        if (saveFile && fitsBlob)
+            writeImageFile(filename, fitsBlob);
         emit BLOBUpdated(bp);
         emit newImage(nullptr);
         return;
     }
 
     QSharedPointer<FITSData> blob_data;
-    QByteArray buffer = QByteArray::fromRawData(reinterpret_cast<char *>(bp->blob), bp->size);
     blob_data.reset(new FITSData(targetChip->getCaptureMode()), &QObject::deleteLater);
-    if (!blob_data->loadFromBuffer(buffer, shortFormat, filename, false))
+    const qint64 receiveTime = timer.restart();
+    bool loaded = false;
+    if (fitsBlob)
+    {
+        loaded = blob_data->loadFromBlob(fitsBlob, shortFormat, filename, false);
+        // Only written now since loading may convert the pixels in place.
+        if (saveFile)
+            writeImageFile(filename, fitsBlob);
+    }
+    else
+    {
+        QByteArray buffer = QByteArray::fromRawData(reinterpret_cast<char *>(bp->blob), bp->size);
+        loaded = blob_data->loadFromBuffer(buffer, shortFormat, filename, false);
+    }
+
+    if (!loaded)
     {
         // If reading the blob fails, we treat it the same as exposure failure
         // and recapture again if possible
@@ -1668,7 +1687,10 @@ void CCD::processBLOB(IBLOB *bp)
         return;
     }
 
+    timer.restart();
     handleImage(targetChip, filename, bp, blob_data);
+    qCDebug(KSTARS_INDI) << "Image pipeline (ms): receive" << receiveTime << "parse" << blob_data->getParseTime()
+                         << "stats" << blob_data->getStatsTime() << "display" << timer.elapsed();
     //    else
     //        emit BLOBUpdated(bp);
 }
@@ -2612,37 +2634,6 @@ bool CCD::setTemperatureRegulation(double ramp, double threshold)
     return true;
 }
 
-// Internal function to write an image blob to disk.
-bool CCD::WriteImageFileInternal(const QString &filename, char *buffer, const size_t size)
-{
-    QFile file(filename);
-    if (!file.open(QIODevice::WriteOnly))
-    {
-        qCCritical(KSTARS_INDI) << "ISD:CCD Error: Unable to open write file: " <<
-                                filename;
-        return false;
-    }
-    int n = 0;
-    QDataStream out(&file);
-    bool ok = true;
-    for (size_t nr = 0; nr < size; nr += n)
-    {
-        n = out.writeRawData(buffer + nr, size - nr);
-        if (n < 0)
-        {
-            ok = false;
-            break;
-        }
-    }
-    ok = file.flush() && ok;
-    file.close();
-    file.setPermissions(QFileDevice::ReadUser |
-                        QFileDevice::WriteUser |
-                        QFileDevice::ReadGroup |
-                        QFileDevice::ReadOther);
-    return ok;
-}
-
 QString CCD::getCaptureFormat() const
 {
     if (m_CaptureFormatIndex < 0 || m_CaptureFormats.isEmpty() || m_CaptureFormatIndex > m_CaptureFormats.size())
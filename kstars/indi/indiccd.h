@@ -7,6 +7,7 @@
 #pragma once
 
 #include "indistd.h"
+#include "imagewritequeue.h"
 #include "wsmedia.h"
 #include "auxiliary/imageviewer.h"
 #include "fitsviewer/fitscommon.h"
@@ -20,6 +21,7 @@
 
 #include <memory>
 
+class FITSBlob;
 class FITSData;
 class FITSView;
 class QTimer;
@@ -335,6 +337,20 @@ class CCD : public DeviceDecorator
         }
         bool setFastCount(uint32_t count);
 
+        /**
+         * @brief isWriteQueueFull Whether enough captured images are waiting to be written to disk.
+         * The next exposure should wait for writeQueueChanged() then, so that captures do not
+         * outrun the disk.
+         */
+        bool isWriteQueueFull() const
+        {
+            return m_WriteQueue->isFull();
+        }
+        ImageWriteQueue::Statistics getWriteQueueStatistics() const
+        {
+            return m_WriteQueue->statistics();
+        }
+
         const QMap<QString, double> &getExposurePresets() const
         {
             return m_ExposurePresets;
@@ -367,14 +383,18 @@ class CCD : public DeviceDecorator
         void ready();
         void error(ErrorType type);
         void newImage(const QSharedPointer<FITSData> &data);
+        /** Queue depth and latency in milliseconds of the last image written to disk. */
+        void writeQueueChanged(int depth, int capacity, double latency);
+        /** An image is in place on disk, with the modification times of its directory before and after the write. */
+        void fileWritten(const QString &filename, qint64 directoryBefore, qint64 directoryAfter);
 
     private:
         void processStream(IBLOB *bp);
         void loadImageInView(ISD::CCDChip *targetChip, const QSharedPointer<FITSData> &data);
         bool generateFilename(bool batch_mode, const QString &extension, QString *filename);
-        // Saves an image to disk on a separate thread.
-        bool writeImageFile(const QString &filename, IBLOB *bp, bool is_fits);
-        bool WriteImageFileInternal(const QString &filename, char *buffer, const size_t size);
+        // Queues an image to be saved to disk by the write queue.
+        void writeImageFile(const QString &filename, IBLOB *bp);
+        void writeImageFile(const QString &filename, const QSharedPointer<FITSBlob> &blob);
         // Creates or finds the FITSViewer.
         QPointer<FITSViewer> getFITSViewer();
         void handleImage(CCDChip *targetChip, const QString &filename, IBLOB *bp, QSharedPointer<FITSData> data);
@@ -428,10 +448,7 @@ class CCD : public DeviceDecorator
         QMap<QString, double> m_ExposurePresets;
         QPair<double, double> m_ExposurePresetsMinMax;
 
-        // Used when writing the image fits file to disk in a separate thread.
-        char *fileWriteBuffer { nullptr };
-        int fileWriteBufferSize { 0 };
-        QString fileWriteFilename;
-        QFuture<void> fileWriteThread;        
+        // Writes captured images to disk on a thread of its own.
+        std::unique_ptr<ImageWriteQueue> m_WriteQueue;
 };
 }
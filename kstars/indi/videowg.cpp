@@ -6,6 +6,7 @@
 
 #include "videowg.h"
 
+#include "fitsviewer/debayerengine.h"
 #include "kstars_debug.h"
 
 #include <QImageReader>
@@ -152,8 +153,9 @@ bool VideoWG::debayer(const IBLOB *bp, const BayerParams &params)
     {
         dc1394_source++;
     }
-    dc1394error_t error_code = dc1394_bayer_decoding_8bit(dc1394_source, destinationBuffer, streamW, ds1394_height,
-                               params.filter, params.method);
+    // Row bands are decoded in parallel to keep up with the stream
+    dc1394error_t error_code = DebayerEngine::decode(dc1394_source, destinationBuffer, streamW, ds1394_height,
+                               params.filter, params.method, DebayerEngine::INTERLEAVED);
 
     if (error_code != DC1394_SUCCESS)
     {
@@ -35,3 +35,12 @@ double AzimuthalEquidistantProjector::projectionL(double x) const
 {
     return x;
 }
+
+void AzimuthalEquidistantProjector::toScreenBatch(const double *alt, const double *az, size_t n, float *x, float *y,
+                                                  uint8_t *visible) const
+{
+    toScreenBatchImpl([this](double c)
+    {
+        return AzimuthalEquidistantProjector::projectionK(c);
+    }, alt, az, n, x, y, visible);
+}
@@ -57,6 +57,43 @@ Eigen::Vector2f EquirectangularProjector::toScreenVec(const SkyPoint *o, bool oR
     return p;
 }
 
+void EquirectangularProjector::toScreenBatch(const double *alt, const double *az, size_t n, float *x, float *y,
+                                             uint8_t *visible) const
+{
+    // Same as toScreenVec(), with the focus terms hoisted out of the loop
+    const bool refract  = m_vp.useAltAz && m_vp.useRefraction;
+    const double sign   = m_vp.useAltAz ? -1.0 : 1.0; // Azimuth goes in opposite direction compared to RA
+    const double focusX = m_vp.useAltAz ? m_vp.focus->az().reduce().radians() : m_vp.focus->ra().reduce().radians();
+    const double focusY = m_vp.useAltAz ? SkyPoint::refract(m_vp.focus->alt(), refract).radians() :
+                          m_vp.focus->dec().radians();
+    const double origX  = 0.5 * m_vp.width;
+    const double origY  = 0.5 * m_vp.height;
+    const double zoom   = m_vp.zoomFactor;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        double Y  = alt[i];
+        double dX = sign * (az[i] - focusX);
+
+        if (refract)
+            Y = SkyPoint::refract(Y / dms::DegToRad) * dms::DegToRad; //account for atmospheric refraction
+
+        if (!(std::isfinite(Y) && std::isfinite(dX)))
+        {
+            x[i]       = 0;
+            y[i]       = 0;
+            visible[i] = 0;
+            continue;
+        }
+
+        dX -= 2 * M_PI * std::floor((dX + M_PI) / (2 * M_PI)); // reduce to [-π, π)
+
+        x[i]       = origX - zoom * dX;
+        y[i]       = origY - zoom * (Y - focusY);
+        visible[i] = (x[i] > 0 && x[i] < m_vp.width);
+    }
+}
+
 SkyPoint EquirectangularProjector::fromScreen(const QPointF &p, dms *LST, const dms *lat, bool onlyAltAz) const
 {
     SkyPoint result;
@@ -31,6 +31,15 @@ double GnomonicProjector::projectionL(double x) const
     return atan(x);
 }
 
+void GnomonicProjector::toScreenBatch(const double *alt, const double *az, size_t n, float *x, float *y,
+                                      uint8_t *visible) const
+{
+    toScreenBatchImpl([this](double c)
+    {
+        return GnomonicProjector::projectionK(c);
+    }, alt, az, n, x, y, visible);
+}
+
 double GnomonicProjector::cosMaxFieldAngle() const
 {
     //Don't let things approach infty.
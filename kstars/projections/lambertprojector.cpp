@@ -30,3 +30,12 @@ double LambertProjector::projectionL(double x) const
 {
     return 2.0 * asin(0.5 * x);
 }
+
+void LambertProjector::toScreenBatch(const double *alt, const double *az, size_t n, float *x, float *y,
+                                     uint8_t *visible) const
+{
+    toScreenBatchImpl([this](double c)
+    {
+        return LambertProjector::projectionK(c);
+    }, alt, az, n, x, y, visible);
+}
@@ -24,6 +24,8 @@ class LambertProjector : public Projector
     double radius() const override;
     double projectionK(double x) const override;
     double projectionL(double x) const override;
+    void toScreenBatch(const double *alt, const double *az, size_t n, float *x, float *y,
+                       uint8_t *visible) const override;
 };
 
 #endif // LAMBERTPROJECTOR_H
@@ -31,3 +31,12 @@ double OrthographicProjector::projectionL(double x) const
 {
     return asin(x);
 }
+
+void OrthographicProjector::toScreenBatch(const double *alt, const double *az, size_t n, float *x, float *y,
+                                          uint8_t *visible) const
+{
+    toScreenBatchImpl([this](double c)
+    {
+        return OrthographicProjector::projectionK(c);
+    }, alt, az, n, x, y, visible);
+}
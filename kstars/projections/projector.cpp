@@ -95,6 +95,15 @@ QPointF Projector::toScreen(const SkyPoint *o, bool oRefract, bool *onVisibleHem
     return KSUtils::vecToPoint(toScreenVec(o, oRefract, onVisibleHemisphere));
 }
 
+void Projector::toScreenBatch(const double *alt, const double *az, size_t n, float *x, float *y, uint8_t *visible) const
+{
+    // Generic version, dispatching projectionK virtually. Subclasses should reimplement this.
+    toScreenBatchImpl([this](double c)
+    {
+        return projectionK(c);
+    }, alt, az, n, x, y, visible);
+}
+
 bool Projector::onScreen(const QPointF &p) const
 {
     return (0 <= p.x() && p.x() <= m_vp.width && 0 <= p.y() && p.y() <= m_vp.height);
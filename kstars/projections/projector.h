@@ -28,6 +28,7 @@
 #include <QPointF>
 
 #include <cstddef>
+#include <cstdint>
 #include <cmath>
 
 class KStarsData;
@@ -132,6 +133,27 @@ class Projector
          */
         QPointF toScreen(const SkyPoint *o, bool oRefract = true, bool *onVisibleHemisphere = nullptr) const;
 
+        /**
+         * Project many points at once, without a virtual call per point.
+         *
+         * This is the batch equivalent of calling toScreenVec() with oRefract = true on each point,
+         * meant for the tight loops drawing stars and other point sources. Each projection
+         * reimplements it on top of toScreenBatchImpl() with its own projectionK, which the
+         * compiler can then inline.
+         *
+         * @param alt latitudes of the points in radians: altitudes if the sky map uses
+         *   horizontal coordinates, declinations otherwise
+         * @param az longitudes of the points in radians: azimuths if the sky map uses
+         *   horizontal coordinates, right ascensions otherwise
+         * @param n number of points
+         * @param x output screen x coordinates
+         * @param y output screen y coordinates
+         * @param visible output flags, set to 1 if the point is on the visible part of the
+         *   celestial sphere (see toScreenVec()), 0 otherwise
+         */
+        virtual void toScreenBatch(const double *alt, const double *az, size_t n, float *x, float *y,
+                                   uint8_t *visible) const;
+
         /**
          * @short Determine RA, Dec coordinates of the pixel at (dx, dy), which are the
          * screen pixel coordinate offsets from the center of the Sky pixmap.
@@ -289,6 +311,15 @@ class Projector
          */
         static SkyPoint pointAt(double az);
 
+        /**
+         * Implementation of toScreenBatch() for the projections that only differ by projectionK.
+         * @param K callable returning projectionK(c). Pass a lambda calling the projection's own
+         *   projectionK with a qualified name, so that it is resolved at compile time.
+         */
+        template <typename K>
+        void toScreenBatchImpl(K projectionK, const double *alt, const double *az, size_t n, float *x, float *y,
+                               uint8_t *visible) const;
+
         KStarsData *m_data { nullptr };
         ViewParams m_vp;
         double m_sinY0 { 0 };
@@ -301,3 +332,67 @@ class Projector
         double m_xrange { 0 };
         bool m_isPoleVisible { false };
 };
+
+template <typename K>
+void Projector::toScreenBatchImpl(K projectionK, const double *alt, const double *az, size_t n, float *x, float *y,
+                                  uint8_t *visible) const
+{
+    // See toScreenVec() for the details of the projection, this follows it step by step
+    const bool refract    = m_vp.useAltAz && m_vp.useRefraction;
+    const double focusX   = m_vp.useAltAz ? m_vp.focus->az().radians() : m_vp.focus->ra().radians();
+    const double sign     = m_vp.useAltAz ? -1.0 : 1.0; // Azimuth goes in opposite direction compared to RA
+    const double cosMax   = cosMaxFieldAngle();
+    const double origX    = m_vp.width / 2;
+    const double origY    = m_vp.height / 2;
+    const double zoom     = m_vp.zoomFactor;
+    const double sinY0    = m_sinY0;
+    const double cosY0    = m_cosY0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        double Y  = alt[i];
+        double dX = sign * (az[i] - focusX);
+
+        if (refract)
+            Y = SkyPoint::refract(Y / dms::DegToRad) * dms::DegToRad; //account for atmospheric refraction
+
+        if (!(std::isfinite(Y) && std::isfinite(dX)))
+        {
+            x[i]       = 0;
+            y[i]       = 0;
+            visible[i] = 0;
+            continue;
+        }
+
+        dX -= 2 * M_PI * std::floor((dX + M_PI) / (2 * M_PI)); // reduce to [-π, π)
+
+        const double sindX = std::sin(dX), cosdX = std::cos(dX);
+        const double sinY = std::sin(Y), cosY = std::cos(Y);
+
+        //c is the cosine of the angular distance from the center
+        const double c = sinY0 * sinY + cosY0 * cosY * cosdX;
+        const double k = projectionK(c);
+
+        visible[i] = (c > cosMax);
+        x[i]       = origX - zoom * k * cosY * sindX;
+        y[i]       = origY - zoom * k * (cosY0 * sinY - sinY0 * cosY * cosdX);
+    }
+
+#ifdef KSTARS_LITE
+    double skyRotation = SkyMapLite::Instance()->getSkyRotation();
+    if (skyRotation != 0)
+    {
+        dms rotation(skyRotation);
+        double cosT, sinT;
+
+        rotation.SinCos(sinT, cosT);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const double dx = x[i] - origX, dy = y[i] - origY;
+            x[i] = origX + dx * cosT - dy * sinT;
+            y[i] = origY + dx * sinT + dy * cosT;
+        }
+    }
+#endif
+}
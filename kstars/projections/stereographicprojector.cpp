@@ -30,3 +30,12 @@ double StereographicProjector::projectionL(double x) const
 {
     return 2.0 * atan2(x, 2.0);
 }
+
+void StereographicProjector::toScreenBatch(const double *alt, const double *az, size_t n, float *x, float *y,
+                                           uint8_t *visible) const
+{
+    toScreenBatchImpl([this](double c)
+    {
+        return StereographicProjector::projectionK(c);
+    }, alt, az, n, x, y, visible);
+}
@@ -19,6 +19,21 @@
 #include "skymapcomposite.h"
 #include "kspaths.h"
 #include "import_skycomp.h"
+#include "ksutils.h"
+
+#include <unordered_set>
+
+namespace
+{
+/**
+ * How many frames of the current slew to prefetch ahead, the shift of
+ * the prefetch aperture is capped to half of its radius.
+ */
+constexpr double prefetch_lookahead_frames = 8;
+
+/** Radius of the prefetch aperture relative to the drawn one. */
+constexpr double prefetch_radius_factor = 1.25;
+} // namespace
 
 CatalogsComponent::CatalogsComponent(SkyComposite *parent, const QString &db_filename,
                                      bool load_default)
@@ -39,9 +54,56 @@ CatalogsComponent::CatalogsComponent(SkyComposite *parent, const QString &db_fil
 
     m_catalog_colors = m_db_manager.get_catalog_colors();
     tryImportSkyComponents();
+
+    m_loader = std::make_unique<CatalogsTrixelLoader>(m_db_manager.db_file_name());
+    QObject::connect(
+        m_loader.get(), &CatalogsTrixelLoader::trixelsLoaded, m_loader.get(),
+        []()
+        {
+            if (SkyMap::Instance())
+                SkyMap::Instance()->forceUpdate();
+        },
+        Qt::QueuedConnection);
+
     qCInfo(KSTARS) << "Loaded DSO catalogs.";
 }
 
+CatalogsComponent::~CatalogsComponent()
+{
+    const auto &stats = cacheStatistics();
+    qCDebug(KSTARS) << "DSO cache hits:" << stats.hits << "misses:" << stats.misses
+                    << "prefetched trixels:" << stats.loader.loaded << "mean latency:"
+                    << stats.loader.meanLatency() << "ms";
+}
+
+void CatalogsComponent::resizeCache(const int percentage)
+{
+    const auto &stats = cacheStatistics();
+    qCDebug(KSTARS) << "Resizing the DSO cache to" << percentage << "%, hits:" << stats.hits
+                    << "misses:" << stats.misses << "mean latency:"
+                    << stats.loader.meanLatency() << "ms";
+
+    m_cache.set_size(calculateCacheSize(percentage));
+    resetCacheStatistics();
+}
+
+CatalogsComponent::CacheStatistics CatalogsComponent::cacheStatistics() const
+{
+    CacheStatistics stats;
+    stats.hits   = m_cache_hits;
+    stats.misses = m_cache_misses;
+    stats.loader = m_loader->statistics();
+
+    return stats;
+}
+
+void CatalogsComponent::resetCacheStatistics()
+{
+    m_cache_hits   = 0;
+    m_cache_misses = 0;
+    m_loader->resetStatistics();
+}
+
 double compute_maglim()
 {
     double maglim = Options::magLimitDrawDeepSky();
@@ -83,11 +145,16 @@ void CatalogsComponent::draw(SkyPainter *skyp)
     const auto label_padding{ 1 + (1 - (Options::deepSkyLabelDensity() / 100)) * 50 };
     auto &proj = *map.projector();
 
+    // before touching the visible trixels, so that they stay the most recently used
+    collectLoadedTrixels();
+
     updateSkyMesh(map);
 
     MeshIterator region(m_skyMesh, DRAW_BUF);
 
+    const bool blocking = m_blocking_load || m_loader->hasFailed();
     size_t num_trixels{ 0 };
+    std::vector<Trixel> missing;
 
     while (region.hasNext())
     {
@@ -95,24 +162,20 @@ void CatalogsComponent::draw(SkyPainter *skyp)
         num_trixels++;
 
         auto &objects = m_cache[trixel];
-        if (!objects.is_set())
+        if (objects.is_set())
+            m_cache_hits++;
+        else
         {
-            try
+            m_cache_misses++;
+
+            if (!blocking)
             {
-                objects = m_db_manager.get_objects_in_trixel(trixel);
+                // drawn once the loader is done with it
+                missing.push_back(trixel);
+                continue;
             }
-            catch (const CatalogsDB::DatabaseError &e)
-            {
-                qCCritical(KSTARS)
-                        << "Could not load catalog objects in trixel: " << trixel << ", "
-                        << e.what();
-
-                KMessageBox::detailedError(
-                    nullptr, i18n("Could not load catalog objects in trixel: %1", trixel),
-                    e.what());
 
-                throw; // do not silently fail
-            }
+            loadTrixel(trixel, objects);
         }
 
         for (auto &object : objects.data())
@@ -159,11 +222,102 @@ void CatalogsComponent::draw(SkyPainter *skyp)
         }
     }
 
+    prefetch(map, missing);
+
     // prune only if the to-be-pruned trixels are likely not visible
     // and we are not zooming
-    m_cache.prune(num_trixels * 1.2);
+    m_cache.prune(num_trixels * prefetch_radius_factor * prefetch_radius_factor * 1.2);
 };
 
+void CatalogsComponent::loadTrixel(Trixel trixel, TrixelCache<ObjectList>::element &objects)
+{
+    try
+    {
+        objects = m_db_manager.get_objects_in_trixel(trixel);
+    }
+    catch (const CatalogsDB::DatabaseError &e)
+    {
+        qCCritical(KSTARS) << "Could not load catalog objects in trixel: " << trixel
+                           << ", " << e.what();
+
+        KMessageBox::detailedError(
+            nullptr, i18n("Could not load catalog objects in trixel: %1", trixel),
+            e.what());
+
+        throw; // do not silently fail
+    }
+}
+
+void CatalogsComponent::collectLoadedTrixels()
+{
+    for (auto &loaded : m_loader->takeLoaded())
+    {
+        auto &objects = m_cache[loaded.first];
+        if (!objects.is_set())
+            objects = std::move(loaded.second);
+    }
+
+    // retry here to get the error in front of the user
+    for (const auto trixel : m_loader->takeFailed())
+    {
+        auto &objects = m_cache[trixel];
+        if (!objects.is_set())
+            loadTrixel(trixel, objects);
+    }
+}
+
+void CatalogsComponent::prefetch(SkyMap &map, const std::vector<Trixel> &missing)
+{
+    if (m_loader->hasFailed())
+        return;
+
+    const SkyPoint &focus = *map.focus();
+    const double radius   = std::min(map.projector()->fov(), 180.0);
+
+    // Guess the direction of slew from the last focus, in degrees on the sky.
+    double d_ra{ 0 }, d_dec{ 0 };
+    if (m_last_focus_valid)
+    {
+        d_ra  = KSUtils::reduceAngle(focus.ra().Degrees() - m_last_focus.ra().Degrees(),
+                                     -180.0, 180.0) *
+                std::cos(focus.dec().radians());
+        d_dec = focus.dec().Degrees() - m_last_focus.dec().Degrees();
+    }
+
+    m_last_focus       = SkyPoint(focus.ra(), focus.dec());
+    m_last_focus_valid = true;
+
+    SkyPoint center(focus.ra(), focus.dec());
+    const double step = std::hypot(d_ra, d_dec);
+    if (step > 1e-3 * radius)
+    {
+        const double shift = std::min(step * prefetch_lookahead_frames, radius / 2);
+        const double dec =
+            std::max(-90.0, std::min(90.0, focus.dec().Degrees() + d_dec / step * shift));
+        const double cos_dec = std::max(std::cos(focus.dec().radians()), 1e-3);
+        const double ra =
+            focus.ra().Degrees() + d_ra / step * shift / cos_dec;
+
+        center = SkyPoint(dms(ra).reduce(), dms(dec));
+    }
+
+    m_skyMesh->aperture(&center,
+                        std::min(radius * prefetch_radius_factor, 180.0) + 1.0,
+                        PREFETCH_BUF);
+    MeshIterator ring(m_skyMesh, PREFETCH_BUF);
+
+    std::vector<Trixel> trixels{ missing };
+    std::unordered_set<Trixel> queued(missing.begin(), missing.end());
+    while (ring.hasNext())
+    {
+        const Trixel trixel = ring.next();
+        if (!m_cache.contains(trixel) && queued.insert(trixel).second)
+            trixels.push_back(trixel);
+    }
+
+    m_loader->request(trixels);
+}
+
 void CatalogsComponent::updateSkyMesh(SkyMap &map, MeshBufNum_t buf)
 {
     SkyPoint *focus = map.focus();
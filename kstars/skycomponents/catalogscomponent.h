@@ -9,12 +9,14 @@
 
 #include "skycomponent.h"
 #include "catalogsdb.h"
+#include "catalogstrixelloader.h"
 #include "catalogobject.h"
 #include "skymesh.h"
 #include "trixelcache.h"
 #include "Options.h"
 
 #include "polyfills/qstring_hash.h"
+#include <memory>
 #include <unordered_map>
 
 class SkyMesh;
@@ -32,6 +34,12 @@ class SkyMap;
  * demands a pointer to a CatalogObject, it will be allocated into
  * `m_static_objects` on demand.
  *
+ * Trixels that are not cached are loaded by a `CatalogsTrixelLoader`
+ * on a worker thread, together with a ring of neighbouring trixels in
+ * the direction of slew. The draw pass only renders what is already
+ * cached and never waits for the database, unless `setBlockingLoad`
+ * is set (e.g. to export the sky map to an image).
+ *
  * If you want to access DSOs in _new_ code you should use a local
  * instance of `CatalogsDB::DBManager` instead and call `dropCache` if
  * necessary.
@@ -43,6 +51,18 @@ class CatalogsComponent : public SkyComponent
     public:
         using ObjectList = std::vector<CatalogObject>;
 
+        /**
+         * Counters to tune the cache size with. A hit is a visible trixel
+         * that was in the cache when it was drawn, a miss one that had to
+         * be loaded first.
+         */
+        struct CacheStatistics
+        {
+            quint64 hits{ 0 };
+            quint64 misses{ 0 };
+            CatalogsTrixelLoader::Statistics loader;
+        };
+
         /**
          * Constructs the Catalogscomponent with a \p parent and a
          * database file under the path \p db_filename. If \p load_ngc is
@@ -55,7 +75,7 @@ class CatalogsComponent : public SkyComponent
         explicit CatalogsComponent(SkyComposite *parent, const QString &db_filename,
                                    bool load_default = false);
 
-        ~CatalogsComponent() override = default;
+        ~CatalogsComponent() override;
 
         /**
          * Draws the objects in the currently visible trixels by
@@ -71,10 +91,7 @@ class CatalogsComponent : public SkyComponent
          * all the objects into memory. This is reasonable for catalog sizes up
          * to `10_000` objects.
          */
-        void resizeCache(const int percentage)
-        {
-            m_cache.set_size(calculateCacheSize(percentage));
-        };
+        void resizeCache(const int percentage);
 
         /**
          * \short Search the underlying database for an object with the \p
@@ -109,10 +126,27 @@ class CatalogsComponent : public SkyComponent
          */
         void dropCache()
         {
+            m_loader->invalidate();
             m_cache.clear();
             m_catalog_colors = m_db_manager.get_catalog_colors();
         };
 
+        /**
+         * If \p blocking is set, `draw` loads missing trixels
+         * synchronously instead of leaving them to the background loader.
+         * Use this when the sky is drawn only once, e.g. into an image.
+         */
+        void setBlockingLoad(const bool blocking) { m_blocking_load = blocking; }
+
+        /**
+         * @return the cache hit and miss counters and the background
+         * loader statistics since the last reset.
+         */
+        CacheStatistics cacheStatistics() const;
+
+        /** Reset the counters returned by `cacheStatistics`. */
+        void resetCacheStatistics();
+
         /**
          * Wether to show the DSOs.
          */
@@ -170,10 +204,46 @@ class CatalogsComponent : public SkyComponent
          */
         CatalogsDB::ColorMap m_catalog_colors;
 
+        /**
+         * Loads missing and neighbouring trixels in the background, using
+         * its own database connection.
+         */
+        std::unique_ptr<CatalogsTrixelLoader> m_loader;
+
+        /** Wether `draw` should wait for missing trixels. */
+        bool m_blocking_load{ false };
+
+        /** The focus of the last draw, to guess the direction of slew. */
+        SkyPoint m_last_focus;
+        bool m_last_focus_valid{ false };
+
+        quint64 m_cache_hits{ 0 };
+        quint64 m_cache_misses{ 0 };
+
         //@{
         /** Helpers */
 
         void updateSkyMesh(SkyMap &map, MeshBufNum_t buf = DRAW_BUF);
+
+        /**
+         * Move the trixels loaded in the background into the cache and
+         * load the ones that failed there synchronously, so that errors
+         * are reported.
+         */
+        void collectLoadedTrixels();
+
+        /**
+         * Load the objects in \p trixel synchronously into \p objects.
+         * Errors are reported to the user and rethrown.
+         */
+        void loadTrixel(Trixel trixel, TrixelCache<ObjectList>::element &objects);
+
+        /**
+         * Queue the \p missing visible trixels in the background loader,
+         * followed by the uncached trixels in a slightly larger aperture
+         * that is shifted in the direction of slew.
+         */
+        void prefetch(SkyMap &map, const std::vector<Trixel> &missing);
         size_t calculateCacheSize(const unsigned int percentage)
         {
             return m_skyMesh->size() * percentage / 100;
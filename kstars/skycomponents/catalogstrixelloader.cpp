@@ -0,0 +1,197 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "catalogstrixelloader.h"
+
+#include "kstars_debug.h"
+
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <memory>
+
+CatalogsTrixelLoader::CatalogsTrixelLoader(const QString &db_filename, QObject *parent)
+    : QThread(parent), m_db_filename{ db_filename }
+{
+    m_clock.start();
+    start(QThread::LowPriority);
+}
+
+CatalogsTrixelLoader::~CatalogsTrixelLoader()
+{
+    {
+        QMutexLocker _{ &m_mutex };
+        m_stop = true;
+        m_wake.wakeAll();
+    }
+
+    wait();
+}
+
+void CatalogsTrixelLoader::request(const std::vector<int> &trixels)
+{
+    QMutexLocker _{ &m_mutex };
+
+    // keep the time of the original request to measure the latency
+    std::unordered_map<int, qint64> queued;
+    for (const auto &request : m_queue)
+        queued.emplace(request.trixel, request.requested_at);
+
+    m_queue.clear();
+
+    const qint64 now = m_clock.elapsed();
+    for (const int trixel : trixels)
+    {
+        if (trixel == m_in_flight || m_loaded.count(trixel) > 0)
+            continue;
+
+        const auto found = queued.find(trixel);
+        m_queue.push_back({ trixel, found == queued.end() ? now : found->second });
+    }
+
+    if (!m_queue.empty())
+        m_wake.wakeAll();
+}
+
+CatalogsTrixelLoader::LoadedList CatalogsTrixelLoader::takeLoaded()
+{
+    LoadedList loaded;
+
+    QMutexLocker _{ &m_mutex };
+    if (m_loaded.empty())
+        return loaded;
+
+    loaded.reserve(m_loaded.size());
+    for (auto &trixel : m_loaded)
+        loaded.emplace_back(trixel.first, std::move(trixel.second));
+
+    m_loaded.clear();
+    return loaded;
+}
+
+std::vector<int> CatalogsTrixelLoader::takeFailed()
+{
+    std::vector<int> failed;
+
+    QMutexLocker _{ &m_mutex };
+    failed.swap(m_failed);
+    return failed;
+}
+
+void CatalogsTrixelLoader::invalidate()
+{
+    QMutexLocker _{ &m_mutex };
+
+    m_generation++;
+    m_statistics.discarded += m_loaded.size();
+    m_queue.clear();
+    m_loaded.clear();
+    m_failed.clear();
+}
+
+CatalogsTrixelLoader::Statistics CatalogsTrixelLoader::statistics() const
+{
+    QMutexLocker _{ &m_mutex };
+    return m_statistics;
+}
+
+void CatalogsTrixelLoader::resetStatistics()
+{
+    QMutexLocker _{ &m_mutex };
+    m_statistics = {};
+}
+
+void CatalogsTrixelLoader::run()
+{
+    // The connection has to live on this thread.
+    std::unique_ptr<CatalogsDB::DBManager> manager;
+    try
+    {
+        manager = std::make_unique<CatalogsDB::DBManager>(m_db_filename);
+    }
+    catch (const CatalogsDB::DatabaseError &e)
+    {
+        qCWarning(KSTARS) << "Could not open the DSO database for prefetching, "
+                          "loading trixels synchronously:"
+                          << e.what();
+
+        m_failed_to_open = true;
+        emit trixelsLoaded(); // let the map redraw with synchronous loading
+        return;
+    }
+
+    QMutexLocker lock{ &m_mutex };
+    size_t loaded_since_signal = 0;
+
+    while (!m_stop)
+    {
+        if (m_queue.empty())
+        {
+            if (loaded_since_signal > 0)
+            {
+                loaded_since_signal = 0;
+
+                lock.unlock();
+                emit trixelsLoaded();
+                lock.relock();
+                continue; // the queue may have changed meanwhile
+            }
+
+            m_wake.wait(&m_mutex);
+            continue;
+        }
+
+        const Request request = m_queue.front();
+        const quint64 generation = m_generation;
+        m_queue.pop_front();
+        m_in_flight = request.trixel;
+
+        lock.unlock();
+
+        QElapsedTimer query_timer;
+        query_timer.start();
+
+        ObjectList objects;
+        bool success = true;
+        try
+        {
+            objects = manager->get_objects_in_trixel(request.trixel);
+        }
+        catch (const CatalogsDB::DatabaseError &e)
+        {
+            qCWarning(KSTARS) << "Could not prefetch catalog objects in trixel:"
+                              << request.trixel << "," << e.what();
+            success = false;
+        }
+
+        const double query_time = query_timer.nsecsElapsed() / 1e6;
+
+        lock.relock();
+        m_in_flight = -1;
+
+        if (generation != m_generation)
+        {
+            m_statistics.discarded++;
+            continue;
+        }
+
+        if (!success)
+        {
+            m_failed.push_back(request.trixel);
+            loaded_since_signal++;
+            continue;
+        }
+
+        const double latency = m_clock.elapsed() - request.requested_at;
+        m_statistics.loaded++;
+        m_statistics.total_latency += latency;
+        m_statistics.max_latency = std::max(m_statistics.max_latency, latency);
+        m_statistics.total_query_time += query_time;
+
+        m_loaded.emplace(request.trixel, std::move(objects));
+        loaded_since_signal++;
+    }
+}
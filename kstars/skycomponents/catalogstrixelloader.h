@@ -0,0 +1,138 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "catalogsdb.h"
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \brief Loads the objects in catalog trixels on a worker thread.
+ *
+ * The loader owns a `CatalogsDB::DBManager` connection of its own
+ * which is created and destroyed on the worker thread, as required by
+ * `QSqlDatabase`. Trixels are queued in priority order with `request`
+ * and the loaded ones are collected with `takeLoaded`.
+ *
+ * The `trixelsLoaded` signal is emitted whenever the queue runs dry
+ * after some trixels have been loaded, so that the sky map can be
+ * repainted. Trixels that could not be loaded are handed back through
+ * `takeFailed`, so that the caller can retry them synchronously and
+ * report the error to the user.
+ *
+ * \sa CatalogsComponent
+ */
+class CatalogsTrixelLoader : public QThread
+{
+        Q_OBJECT
+
+    public:
+        using ObjectList = CatalogsDB::CatalogObjectVector;
+        using LoadedList = std::vector<std::pair<int, ObjectList>>;
+
+        /** Counters describing the work done by the loader. */
+        struct Statistics
+        {
+            /** Number of trixels loaded */
+            quint64 loaded{ 0 };
+
+            /** Number of loaded trixels thrown away by `invalidate` */
+            quint64 discarded{ 0 };
+
+            /** Sum and maximum of the time between request and completion, in ms */
+            double total_latency{ 0 };
+            double max_latency{ 0 };
+
+            /** Sum of the time spent in the database query, in ms */
+            double total_query_time{ 0 };
+
+            double meanLatency() const { return loaded ? total_latency / loaded : 0; }
+            double meanQueryTime() const { return loaded ? total_query_time / loaded : 0; }
+        };
+
+        /**
+         * Constructs a loader for the database under \p db_filename and
+         * starts the worker thread.
+         */
+        explicit CatalogsTrixelLoader(const QString &db_filename, QObject *parent = nullptr);
+
+        /** Stops the worker thread and waits for it. */
+        ~CatalogsTrixelLoader() override;
+
+        /**
+         * Replace the queue with \p trixels, highest priority first.
+         * Trixels that are being loaded or are waiting to be collected are
+         * skipped.
+         */
+        void request(const std::vector<int> &trixels);
+
+        /** @return the trixels loaded since the last call. */
+        LoadedList takeLoaded();
+
+        /** @return the trixels that failed to load since the last call. */
+        std::vector<int> takeFailed();
+
+        /**
+         * Drop all queued and loaded trixels, for example because the
+         * catalogs have changed. Trixels being loaded at the moment are
+         * discarded when they are done.
+         */
+        void invalidate();
+
+        /**
+         * @return wether the worker could not open its database
+         * connection. The caller should load trixels synchronously then.
+         */
+        bool hasFailed() const { return m_failed_to_open; }
+
+        /** @return a snapshot of the counters. */
+        Statistics statistics() const;
+
+        /** Reset the counters to zero. */
+        void resetStatistics();
+
+    signals:
+        void trixelsLoaded();
+
+    protected:
+        void run() override;
+
+    private:
+        struct Request
+        {
+            int trixel;
+            qint64 requested_at;
+        };
+
+        const QString m_db_filename;
+
+        /** Guards everything below */
+        mutable QMutex m_mutex;
+        QWaitCondition m_wake;
+
+        bool m_stop{ false };
+        std::atomic<bool> m_failed_to_open{ false };
+
+        /** Bumped by `invalidate` to recognize stale results */
+        quint64 m_generation{ 0 };
+
+        std::deque<Request> m_queue;
+        int m_in_flight{ -1 };
+        std::unordered_map<int, ObjectList> m_loaded;
+        std::vector<int> m_failed;
+
+        QElapsedTimer m_clock;
+        Statistics m_statistics;
+};
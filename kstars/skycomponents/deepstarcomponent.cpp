@@ -23,6 +23,8 @@
 #include <QtConcurrent>
 #include <QElapsedTimer>
 
+#include <numeric>
+
 #include <kstars_debug.h>
 
 #ifdef _WIN32
@@ -113,34 +115,45 @@ bool DeepStarComponent::loadStaticStars()
 
             m_starBlockList.at(trixel)->setStaticBlock(SB);
 
+            const RecordSpan span = starReader.getRecords(trixel);
+
             for (quint64 j = 0; j < records; ++j)
             {
-                bool fread_success = fread(&stardata, sizeof(StarData), 1, dataFile);
+                const StarData *data = &stardata;
 
-                if (!fread_success)
+                if (!span.isEmpty())
                 {
-                    qCCritical(KSTARS) << "ERROR: Could not read StarData structure for star #" << j << " under trixel #"
-                                       << trixel;
+                    data = mappedRecord(span.record(j), starReader.getByteSwap(), stardata);
                 }
+                else
+                {
+                    bool fread_success = fread(&stardata, sizeof(StarData), 1, dataFile);
+
+                    if (!fread_success)
+                    {
+                        qCCritical(KSTARS) << "ERROR: Could not read StarData structure for star #" << j << " under trixel #"
+                                           << trixel;
+                    }
 
-                /* Swap Bytes when required */
-                if (starReader.getByteSwap())
-                    byteSwap(&stardata);
+                    /* Swap Bytes when required */
+                    if (starReader.getByteSwap())
+                        byteSwap(&stardata);
+                }
 
                 /* Initialize star with data just read. */
                 StarObject *star;
 #ifdef KSTARS_LITE
-                star = &(SB->addStar(stardata)->star);
+                star = &(SB->addStar(*data)->star);
 #else
-                star = SB->addStar(stardata);
+                star = SB->addStar(*data);
 #endif
                 if (star)
                 {
                     //KStarsData* data = KStarsData::Instance();
                     //star->EquatorialToHorizontal( data->lst(), data->geo()->lat() );
                     //if( star->getHDIndex() != 0 )
-                    if (stardata.HD)
-                        m_CatalogNumber.insert(stardata.HD, star);
+                    if (data->HD)
+                        m_CatalogNumber.insert(data->HD, star);
                 }
                 else
                 {
@@ -164,27 +177,38 @@ bool DeepStarComponent::loadStaticStars()
 
             m_starBlockList.at(trixel)->setStaticBlock(SB);
 
+            const RecordSpan span = starReader.getRecords(trixel);
+
             for (quint64 j = 0; j < records; ++j)
             {
-                bool fread_success = false;
-                fread_success      = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
+                const DeepStarData *data = &deepstardata;
 
-                if (!fread_success)
+                if (!span.isEmpty())
                 {
-                    qCCritical(KSTARS) << "Could not read StarData structure for star #" << j << " under trixel #"
-                                       << trixel;
+                    data = mappedRecord(span.record(j), starReader.getByteSwap(), deepstardata);
+                }
+                else
+                {
+                    bool fread_success = false;
+                    fread_success      = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
+
+                    if (!fread_success)
+                    {
+                        qCCritical(KSTARS) << "Could not read StarData structure for star #" << j << " under trixel #"
+                                           << trixel;
+                    }
+
+                    /* Swap Bytes when required */
+                    if (starReader.getByteSwap())
+                        byteSwap(&deepstardata);
                 }
-
-                /* Swap Bytes when required */
-                if (starReader.getByteSwap())
-                    byteSwap(&deepstardata);
 
                 /* Initialize star with data just read. */
                 StarObject *star;
 #ifdef KSTARS_LITE
                 star = &(SB->addStar(stardata)->star);
 #else
-                star = SB->addStar(deepstardata);
+                star = SB->addStar(*data);
 #endif
                 if (star)
                 {
@@ -245,9 +269,14 @@ void DeepStarComponent::draw(SkyPainter *skyp)
     StarObject::updateCoordsCpuTime = 0.;
     StarObject::starsUpdated        = 0;
 #endif
-    SkyMap *map       = SkyMap::Instance();
-    KStarsData *data  = KStarsData::Instance();
-    UpdateID updateID = data->updateID();
+    SkyMap *map          = SkyMap::Instance();
+    KStarsData *data     = KStarsData::Instance();
+    UpdateID updateID    = data->updateID();
+    UpdateID updateNumID = data->updateNumID();
+
+    // Stars are updated in batches per StarBlock, see StarBlock::updateCoords()
+    const StarBlockKernel::Parameters jitParams =
+        StarBlockKernel::Parameters::fromNumbers(data->updateNum(), data->lst(), data->geo()->lat());
 
     //FIXME_FOV -- maybe not clamp like that...
     float radius = map->projector()->fov();
@@ -288,8 +317,10 @@ void DeepStarComponent::draw(SkyPainter *skyp)
     if (hideFaintStars && maglim > hideStarsMag)
         maglim = hideStarsMag;
 
+    // aperture() has just advanced the drawID. The blocks gathered below are marked with it, so that
+    // fillToMag() of a later trixel cannot recycle them before the parallel pass has projected them.
     StarBlockFactory *m_StarBlockFactory = StarBlockFactory::Instance();
-    //    m_StarBlockFactory->drawID = m_skyMesh->drawID();
+    m_StarBlockFactory->drawID = m_skyMesh->drawID();
     //    qDebug() << "Mesh size = " << m_skyMesh->size() << "; drawID = " << m_skyMesh->drawID();
     QElapsedTimer t;
     int nTrixels = 0;
@@ -308,18 +339,10 @@ void DeepStarComponent::draw(SkyPainter *skyp)
         while (region.hasNext())
         {
             Trixel currentRegion = region.next();
-            for (int i = 0; i < m_starBlockList.at(currentRegion)->getBlockCount(); ++i)
+            for (const auto &block : m_starBlockList.at(currentRegion)->contents())
             {
-                std::shared_ptr<StarBlock> prevBlock = ((i >= 1) ? m_starBlockList.at(currentRegion)->block(
-                        i - 1) : std::shared_ptr<StarBlock>());
-                std::shared_ptr<StarBlock> block     = m_starBlockList.at(currentRegion)->block(i);
-
-                if (i == 0 && !m_StarBlockFactory->markFirst(block))
-                    qCWarning(KSTARS) << "markFirst failed in trixel" << currentRegion;
-                if (i > 0 && !m_StarBlockFactory->markNext(prevBlock, block))
-                    qCWarning(KSTARS) << "markNext failed in trixel" << currentRegion << "while marking block" << i;
-                if (i < m_starBlockList.at(currentRegion)->getBlockCount() &&
-                        m_starBlockList.at(currentRegion)->block(i)->getFaintMag() < maglim)
+                m_StarBlockFactory->markUsed(block.get());
+                if (block->getFaintMag() < maglim)
                     break;
             }
         }
@@ -327,6 +350,10 @@ void DeepStarComponent::draw(SkyPainter *skyp)
         region.reset();
     }
 
+    // The frame is drawn in three stages: the visible trixels are gathered and loaded, then all their
+    // blocks are updated and projected in one parallel pass, and finally the painter consumes the
+    // projected stars block by block, in the same order as the blocks were gathered.
+    std::vector<StarBlock *> blocks;
     while (region.hasNext())
     {
         ++nTrixels;
@@ -352,51 +379,79 @@ void DeepStarComponent::draw(SkyPainter *skyp)
         //            qCWarning(KSTARS) << "SBL::fillToMag( " << maglim << " ) failed for trixel " << currentRegion;
         //        }
 
-        t_dynamicLoad += t.restart();
+        for (int i = 0; i < m_starBlockList.at(currentRegion)->getBlockCount(); ++i)
+            blocks.push_back(m_starBlockList.at(currentRegion)->block(i).get());
+    }
 
-        //        qDebug() << "Drawing SBL for trixel " << currentRegion << ", SBL has "
-        //                 <<  m_starBlockList[ currentRegion ]->getBlockCount() << " blocks";
+    t_dynamicLoad = t.restart();
 
-        // REMARK: The following should never carry state, except for const parameters like updateID and maglim
-        std::function<void(std::shared_ptr<StarBlock>)> mapFunction = [&updateID, &maglim](std::shared_ptr<StarBlock> myBlock)
-        {
-            for (StarObject &star : myBlock->contents())
-            {
-                if (star.updateID != updateID)
-                    star.JITupdate();
-                if (star.mag() > maglim)
-                    break;
-            }
-        };
+    if (m_projectedStars.size() < blocks.size())
+        m_projectedStars.resize(blocks.size());
 
-        QtConcurrent::blockingMap(m_starBlockList.at(currentRegion)->contents(), mapFunction);
+    const Projector *projector = map->projector();
+    const ViewParams viewParams = projector->viewParams();
+    const double altCrit = SkyPoint::altCrit * dms::DegToRad;
 
-        for (int i = 0; i < m_starBlockList.at(currentRegion)->getBlockCount(); ++i)
-        {
-            std::shared_ptr<StarBlock> block = m_starBlockList.at(currentRegion)->block(i);
-            //            qDebug() << "---> Drawing stars from block " << i << " of trixel " <<
-            //                currentRegion << ". SB has " << block->getStarCount() << " stars";
-            for (int j = 0; j < block->getStarCount(); j++)
-            {
-                StarObject *curStar = block->star(j);
-
-                //                qDebug() << "We claim that he's from trixel " << currentRegion
-                //<< ", and indexStar says he's from " << m_skyMesh->indexStar( curStar );
+    // REMARK: The following should never carry state, except for const parameters like updateID and maglim.
+    // Each block writes to its own entry of m_projectedStars, so no locking is needed, and QtConcurrent
+    // hands out the blocks to the pool threads as they become idle.
+    std::vector<int> indices(blocks.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::function<void(int &)> mapFunction = [&](int &index)
+    {
+        StarBlock *block = blocks[index];
+        ProjectedStars &projected = m_projectedStars[index];
+        const int count = block->updateCoords(jitParams, updateID, updateNumID, maglim);
 
-                float mag = curStar->mag();
+        if (static_cast<int>(projected.x.size()) < count)
+        {
+            projected.x.resize(count);
+            projected.y.resize(count);
+            projected.mag.resize(count);
+            projected.sp.resize(count);
+            projected.visible.resize(count);
+        }
 
-                if (mag > maglim)
-                    break;
+        projector->toScreenBatch(viewParams.useAltAz ? block->altData() : block->decData(),
+                                 viewParams.useAltAz ? block->azData() : block->raData(), count, projected.x.data(),
+                                 projected.y.data(), projected.visible.data());
 
-                if (skyp->drawPointSource(curStar, mag, curStar->spchar()))
-                    visibleStarCount++;
-            }
+        // Same checks as in SkyQPainter::drawPointSource(), compacting the arrays in place
+        int n = 0;
+        for (int j = 0; j < count; ++j)
+        {
+            const float mag = block->mag(j);
+            if (mag > maglim)
+                break;
+
+            if (!projected.visible[j] || (viewParams.fillGround && block->alt(j) <= altCrit))
+                continue;
+
+            const float x = projected.x[j], y = projected.y[j];
+            if (x < 0 || x > viewParams.width || y < 0 || y > viewParams.height)
+                continue;
+
+            projected.x[n]   = x;
+            projected.y[n]   = y;
+            projected.mag[n] = mag;
+            projected.sp[n]  = block->spchar(j);
+            ++n;
         }
+        projected.count = n;
+    };
+
+    QtConcurrent::blockingMap(indices, mapFunction);
 
-        // DEBUG: Uncomment to identify problems with Star Block Factory / preservation of Magnitude Order in the LRU Cache
-        //        verifySBLIntegrity();
-        t_drawUnnamed += t.restart();
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+        const ProjectedStars &projected = m_projectedStars[i];
+        visibleStarCount += skyp->drawProjectedPointSources(projected.x.data(), projected.y.data(),
+                            projected.mag.data(), projected.sp.data(), projected.count);
     }
+
+    // DEBUG: Uncomment to identify problems with Star Block Factory / preservation of Magnitude Order in the LRU Cache
+    //        verifySBLIntegrity();
+    t_drawUnnamed = t.restart();
     m_skyMesh->inDraw(false);
 #ifdef PROFILE_SINCOS
     trig_calls_here += dms::trig_function_calls;
@@ -462,6 +517,9 @@ bool DeepStarComponent::openDataFile()
         if (starReader.getByteSwap())
             MSpT = bswap_16(MSpT);
         fileOpened = true;
+        // Dynamically loaded trixels are then read straight from the mapped file, fread() is only a fallback
+        if (!starReader.mapFile())
+            qCInfo(KSTARS) << "  Could not map" << dataFileName << "into memory, falling back to buffered reads.";
         qCInfo(KSTARS) << "  Sky Mesh Size: " << m_skyMesh->size();
         for (long int i = 0; i < m_skyMesh->size(); i++)
         {
@@ -482,7 +540,13 @@ bool DeepStarComponent::openDataFile()
 StarObject *DeepStarComponent::findByHDIndex(int HDnum)
 {
     // Currently, we only handle HD catalog indexes
-    return m_CatalogNumber.value(HDnum, nullptr); // TODO: Maybe, make this more general.
+    StarObject *star = m_CatalogNumber.value(HDnum, nullptr); // TODO: Maybe, make this more general.
+
+    // Stars are drawn from the StarBlock arrays, so the object itself may not be up to date
+    if (star && star->updateID != KStarsData::Instance()->updateID())
+        star->JITupdate();
+
+    return star;
 }
 
 // This uses the main star index for looking up nearby stars but then
@@ -640,13 +704,11 @@ bool DeepStarComponent::verifySBLIntegrity()
                                   << ", brightMag of block #" << i << " = " << block->getBrightMag();
                 integrity = false;
             }
-            if (i > 1 && (!block->prev))
-                qCWarning(KSTARS) << "Trixel " << trixel << ": ERROR: Block" << i << "is unlinked in LRU Cache";
-            if (block->prev && block->prev->parent == m_starBlockList[trixel].get() &&
-                    block->prev != m_starBlockList[trixel]->block(i - 1))
+            if (!staticStars && block->poolIndex < 0)
+                qCWarning(KSTARS) << "Trixel " << trixel << ": ERROR: Block" << i << "is not in the StarBlockFactory pool";
+            if (block->parent != m_starBlockList[trixel].get())
             {
-                qCWarning(KSTARS) << "Trixel " << trixel
-                                  << ": ERROR: SBF LRU Cache linked list seems to be broken at before block " << i;
+                qCWarning(KSTARS) << "Trixel " << trixel << ": ERROR: Block" << i << "belongs to another trixel";
                 integrity = false;
             }
             faintMag = block->getFaintMag();
@@ -22,6 +22,10 @@
 #include "skyobjects/deepstardata.h"
 #include "skyobjects/stardata.h"
 
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
 class SkyLabeler;
 class SkyMesh;
 class StarBlockFactory;
@@ -99,6 +103,29 @@ class DeepStarComponent : public ListComponent
     static void byteSwap(DeepStarData *stardata);
     static void byteSwap(StarData *stardata);
 
+    /**
+     * @short Access a StarData / DeepStarData record stored in a memory-mapped catalog file
+     *
+     * If the record is in native byte order and suitably aligned, the returned pointer points
+     * straight into the mapped memory. Otherwise the record is copied into @p scratch, byte swapped
+     * there if required, and a pointer to @p scratch is returned.
+     *
+     * @param src Pointer to the record in the mapped file
+     * @param swap true if the record needs to be byte swapped
+     * @param scratch Storage used when the record cannot be used in place
+     */
+    template <typename T>
+    static const T *mappedRecord(const uchar *src, bool swap, T &scratch)
+    {
+        if (!swap && reinterpret_cast<quintptr>(src) % alignof(T) == 0)
+            return reinterpret_cast<const T *>(src);
+
+        memcpy(&scratch, src, sizeof(T));
+        if (swap)
+            byteSwap(&scratch);
+        return &scratch;
+    }
+
     static StarBlockFactory m_StarBlockFactory;
 
   private:
@@ -124,6 +151,20 @@ class DeepStarComponent : public ListComponent
     QVector<std::shared_ptr<StarBlockList>> m_starBlockList;
     QHash<int, StarObject *> m_CatalogNumber;
 
+    /**
+     * @short Stars of one StarBlock that passed the visibility checks, projected by the parallel pass
+     * of draw() and ready for the painter. The buffers only grow, so they are reused across frames.
+     */
+    struct ProjectedStars
+    {
+        int count { 0 };
+        std::vector<float> x, y, mag;
+        std::vector<char> sp;
+        std::vector<uint8_t> visible;
+    };
+    /// One entry per StarBlock drawn, in drawing order
+    std::vector<ProjectedStars> m_projectedStars;
+
     bool staticStars { false };
 
     // Stuff required for reading data
@@ -7,11 +7,15 @@
 #include <QDebug>
 
 #include "starblock.h"
+#include "Options.h"
 #include "skyobjects/starobject.h"
 #include "starcomponent.h"
 #include "skyobjects/stardata.h"
 #include "skyobjects/deepstardata.h"
 
+#include <algorithm>
+#include <cmath>
+
 #ifdef KSTARS_LITE
 #include "skymaplite.h"
 #include "kstarslite/skyitems/skynodes/pointsourcenode.h"
@@ -31,12 +35,14 @@ StarNode::~StarNode()
 #endif
 
 StarBlock::StarBlock(int nstars)
-    : faintMag(-5), brightMag(35), parent(nullptr), prev(nullptr), next(nullptr), drawID(0), nStars(0),
+    : faintMag(-5), brightMag(35), parent(nullptr), nStars(0),
 #ifdef KSTARS_LITE
       stars(nstars, StarNode())
 #else
       stars(nstars, StarObject())
 #endif
+      , m_RA0(nstars), m_Dec0(nstars), m_PmRA(nstars), m_PmDec(nstars), m_Mag(nstars), m_SpChar(nstars),
+      m_RA(nstars), m_Dec(nstars), m_Alt(nstars), m_Az(nstars), m_Fallback(nstars)
 {
 }
 
@@ -49,6 +55,105 @@ void StarBlock::reset()
     faintMag  = -5.0;
     brightMag = 35.0;
     nStars    = 0;
+
+    m_CoordsCount    = 0;
+    m_ApparentCount  = 0;
+    m_CoordsUpdateID = 0;
+    m_CoordsNumID    = 0;
+}
+
+void StarBlock::appendToArrays(int i, const StarObject &star)
+{
+    m_RA0[i]    = star.ra0().radians();
+    m_Dec0[i]   = star.dec0().radians();
+    m_PmRA[i]   = star.pmRA();
+    m_PmDec[i]  = star.pmDec();
+    m_Mag[i]    = star.mag();
+    m_SpChar[i] = star.spchar();
+}
+
+void StarBlock::materialize(int i)
+{
+#ifdef KSTARS_LITE
+    Q_UNUSED(i)
+#else
+    stars[i].setJITCoords(m_RA[i] / dms::DegToRad, m_Dec[i] / dms::DegToRad, m_Alt[i] / dms::DegToRad,
+                          m_Az[i] / dms::DegToRad, m_CoordsUpdateID, m_CoordsNumID, m_CoordsJD);
+#endif
+}
+
+void StarBlock::scalarUpdate(int i)
+{
+#ifdef KSTARS_LITE
+    StarObject &star = stars[i].star;
+#else
+    StarObject &star = stars[i];
+#endif
+
+    star.JITupdate();
+    m_RA[i]  = star.ra().radians();
+    m_Dec[i] = star.dec().radians();
+    m_Alt[i] = star.alt().radians();
+    m_Az[i]  = star.az().radians();
+}
+
+int StarBlock::updateCoords(const StarBlockKernel::Parameters &params, quint64 updateID, quint64 updateNumID, float maglim)
+{
+    // Stars are sorted by magnitude. Like the JIT update loop this replaces, we include the first star
+    // fainter than maglim.
+    int count = std::upper_bound(m_Mag.constBegin(), m_Mag.constBegin() + nStars, maglim) - m_Mag.constBegin();
+    count     = qMin(count + 1, nStars);
+
+    if (updateID == m_CoordsUpdateID && count <= m_CoordsCount)
+        return count;
+
+    // The kernel implements neither the gravitational bending of light nor the libnova expressions
+    if (Options::useRelativistic() || SkyPoint::implementationIsLibnova)
+    {
+        for (int i = 0; i < count; ++i)
+            scalarUpdate(i);
+
+        m_ApparentCount  = 0;
+        m_CoordsCount    = count;
+        m_CoordsUpdateID = updateID;
+        m_CoordsNumID    = updateNumID;
+        return count;
+    }
+
+    // As in StarObject::JITupdate(), apparent coordinates are only recomputed once per solar minute.
+    // Otherwise only stars which were not computed yet (because maglim was brighter) are done.
+    int first = m_ApparentCount;
+    if (updateNumID != m_CoordsNumID &&
+            (Options::alwaysRecomputeCoordinates() || std::abs(m_CoordsJD - params.jd) >= 0.00069444))
+        first = 0;
+
+    if (first < count)
+    {
+        StarBlockKernel::apparentCoords(params, m_RA0.constData() + first, m_Dec0.constData() + first,
+                                        m_PmRA.constData() + first, m_PmDec.constData() + first, count - first,
+                                        m_RA.data() + first, m_Dec.data() + first, m_Fallback.data() + first);
+        if (first == 0)
+            m_CoordsJD = params.jd;
+        m_ApparentCount = count;
+    }
+
+    // Horizontal coordinates change with every update
+    const int firstHorizontal = (updateID != m_CoordsUpdateID || first == 0) ? 0 : m_CoordsCount;
+
+    StarBlockKernel::horizontalCoords(params, m_RA.constData() + firstHorizontal, m_Dec.constData() + firstHorizontal,
+                                      count - firstHorizontal, m_Alt.data() + firstHorizontal,
+                                      m_Az.data() + firstHorizontal);
+
+    m_CoordsCount    = count;
+    m_CoordsUpdateID = updateID;
+    m_CoordsNumID    = updateNumID;
+
+    // Stars close to the poles go through the exact scalar expressions
+    for (int i = firstHorizontal; i < count; ++i)
+        if (m_Fallback[i])
+            scalarUpdate(i);
+
+    return count;
 }
 
 #ifdef KSTARS_LITE
@@ -60,6 +165,7 @@ StarNode *StarBlock::addStar(const StarData &data)
     StarObject &star = node.star;
 
     star.init(&data);
+    appendToArrays(nStars - 1, star);
     if (star.mag() > faintMag)
         faintMag = star.mag();
     if (star.mag() < brightMag)
@@ -75,6 +181,7 @@ StarNode *StarBlock::addStar(const DeepStarData &data)
     StarObject &star = node.star;
 
     star.init(&data);
+    appendToArrays(nStars - 1, star);
     if (star.mag() > faintMag)
         faintMag = star.mag();
     if (star.mag() < brightMag)
@@ -89,6 +196,7 @@ StarObject *StarBlock::addStar(const StarData &data)
     StarObject &star = stars[nStars++];
 
     star.init(&data);
+    appendToArrays(nStars - 1, star);
     if (star.mag() > faintMag)
         faintMag = star.mag();
     if (star.mag() < brightMag)
@@ -103,6 +211,7 @@ StarObject *StarBlock::addStar(const DeepStarData &data)
     StarObject &star = stars[nStars++];
 
     star.init(&data);
+    appendToArrays(nStars - 1, star);
     if (star.mag() > faintMag)
         faintMag = star.mag();
     if (star.mag() < brightMag)
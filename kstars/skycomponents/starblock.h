@@ -8,9 +8,13 @@
 
 #include "typedef.h"
 #include "starblocklist.h"
+#include "starblockkernel.h"
 
 #include <QVector>
 
+#include <atomic>
+#include <memory>
+
 class StarObject;
 class StarBlockList;
 class PointSourceNode;
@@ -94,10 +98,59 @@ class StarBlock
     /**
      * @short  Return the i-th star in this StarBlock
      *
+     * If the coordinates of the star were last computed by updateCoords(), they are copied into the
+     * StarObject first, so the returned object is always up to date with the batch update.
+     *
      * @param  i Index of StarBlock to return
      * @return A pointer to the i-th StarObject
      */
-    inline StarBlockEntry *star(int i) { return &stars[i]; }
+    inline StarBlockEntry *star(int i)
+    {
+#ifndef KSTARS_LITE
+        if (i < m_CoordsCount && stars[i].updateID != m_CoordsUpdateID)
+            materialize(i);
+#endif
+        return &stars[i];
+    }
+
+    /**
+     * @short Update the apparent and horizontal coordinates of the stars brighter than maglim
+     *
+     * This is the batch equivalent of calling StarObject::JITupdate() on every star of the block. The
+     * coordinates are kept in the structure-of-arrays members of the block; the StarObjects themselves
+     * are only updated when they are requested through star().
+     *
+     * @param params Parameters of the current epoch and location, see StarBlockKernel::Parameters
+     * @param updateID KStarsData::updateID() of the current update
+     * @param updateNumID KStarsData::updateNumID() of the current update
+     * @param maglim Magnitude limit, fainter stars are not updated
+     * @return the number of stars that were updated, i.e. the number of stars brighter than maglim
+     */
+    int updateCoords(const StarBlockKernel::Parameters &params, quint64 updateID, quint64 updateNumID, float maglim);
+
+    /** @return the apparent right ascension of the i-th star in radians, as computed by updateCoords() */
+    inline double ra(int i) const { return m_RA[i]; }
+
+    /** @return the apparent declination of the i-th star in radians, as computed by updateCoords() */
+    inline double dec(int i) const { return m_Dec[i]; }
+
+    /** @return the altitude of the i-th star in radians, as computed by updateCoords() */
+    inline double alt(int i) const { return m_Alt[i]; }
+
+    /** @return the azimuth of the i-th star in radians, as computed by updateCoords() */
+    inline double az(int i) const { return m_Az[i]; }
+
+    /** @return the arrays behind ra(), dec(), alt() and az(), e.g. for Projector::toScreenBatch() */
+    inline const double *raData() const { return m_RA.constData(); }
+    inline const double *decData() const { return m_Dec.constData(); }
+    inline const double *altData() const { return m_Alt.constData(); }
+    inline const double *azData() const { return m_Az.constData(); }
+
+    /** @return the magnitude of the i-th star */
+    inline float mag(int i) const { return m_Mag[i]; }
+
+    /** @return the first character of the spectral type of the i-th star */
+    inline char spchar(int i) const { return m_SpChar[i]; }
 
     /**
      * @return a reference to the internal container of this
@@ -135,17 +188,48 @@ class StarBlock
     float faintMag { 0 };
     float brightMag { 0 };
     StarBlockList *parent;
-    std::shared_ptr<StarBlock> prev;
-    std::shared_ptr<StarBlock> next;
-    quint32 drawID { 0 };
+    /** Slot of this block in the StarBlockFactory pool, -1 if it is not pooled */
+    int poolIndex { -1 };
+    /** StarBlockFactory::drawID of the last draw cycle this block was used in */
+    std::atomic<quint32> drawID { 0 };
+    /** Set whenever the block is used, cleared by the clock hand of the StarBlockFactory */
+    std::atomic<bool> referenced { false };
 
   private:
     // Disallow copying and assignment. Just in case.
     StarBlock(const StarBlock &);
     StarBlock &operator=(const StarBlock &);
 
+    /** @short Copy the coordinates of the i-th star from the arrays into its StarObject */
+    void materialize(int i);
+
+    /** @short Store the catalog data of the star just added at index i into the arrays */
+    void appendToArrays(int i, const StarObject &star);
+
+    /** @short Update the i-th star through the scalar StarObject::JITupdate() and copy the results back */
+    void scalarUpdate(int i);
+
     /** Number of initialized stars in StarBlock. */
     int nStars { 0 };
     /** Array of stars. */
     QVector<StarBlockEntry> stars;
+
+    // Structure-of-arrays copy of the star data used by updateCoords(). Catalog coordinates and
+    // computed coordinates are in radians, proper motions in mas/yr.
+    QVector<double> m_RA0, m_Dec0;
+    QVector<float> m_PmRA, m_PmDec, m_Mag;
+    QVector<char> m_SpChar;
+    QVector<double> m_RA, m_Dec, m_Alt, m_Az;
+    QVector<quint8> m_Fallback;
+
+    /** Number of stars whose coordinates in the arrays are valid */
+    int m_CoordsCount { 0 };
+    /** Number of stars whose apparent (RA, Dec) are valid for m_CoordsJD */
+    int m_ApparentCount { 0 };
+    /** KStarsData::updateID() for which the arrays hold the coordinates */
+    quint64 m_CoordsUpdateID { 0 };
+    /** KStarsData::updateNumID() for which the arrays hold the coordinates */
+    quint64 m_CoordsNumID { 0 };
+    /** Julian day at which the apparent coordinates were last computed */
+    double m_CoordsJD { 0 };
 };
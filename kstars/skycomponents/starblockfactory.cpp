@@ -11,6 +11,8 @@
 
 #include <kstars_debug.h>
 
+#include <QMutexLocker>
+
 // TODO: Implement a better way of deciding this
 #define DEFAULT_NCACHE 12
 
@@ -25,284 +27,205 @@ StarBlockFactory *StarBlockFactory::Instance()
 
 StarBlockFactory::StarBlockFactory()
 {
-    first   = nullptr;
-    last    = nullptr;
-    nBlocks = 0;
-    drawID  = 0;
-    nCache  = DEFAULT_NCACHE;
+    nCache = DEFAULT_NCACHE;
+    m_Pool.reserve(nCache);
 }
 
 StarBlockFactory::~StarBlockFactory()
 {
-    deleteBlocks(nBlocks);
+    // The StarBlockLists may already be gone at this point, so the blocks are not detached from them
+    QMutexLocker lock(&m_Mutex);
+    for (auto &block : m_Pool)
+    {
+        if (block)
+            block->poolIndex = -1;
+    }
+    m_Pool.clear();
+    m_FreeSlots.clear();
+    nBlocks = 0;
+
     if (pInstance)
         pInstance = nullptr;
 }
 
 std::shared_ptr<StarBlock> StarBlockFactory::getBlock()
 {
+    QMutexLocker lock(&m_Mutex);
+
     std::shared_ptr<StarBlock> freeBlock;
 
-    if (nBlocks < nCache)
-    {
-        freeBlock.reset(new StarBlock);
-        if (freeBlock.get())
-        {
-            ++nBlocks;
-            return freeBlock;
-        }
-    }
-    if (last && (last->drawID != drawID || last->drawID == 0))
+    if (nBlocks >= nCache)
+        freeBlock = evict();
+
+    if (!freeBlock)
     {
-        //        qCDebug(KSTARS) << "Recycling block with drawID =" << last->drawID << "and current drawID =" << drawID;
-        if (last->parent->block(last->parent->getBlockCount() - 1) != last)
-            qCDebug(KSTARS) << "ERROR: Goof up here!";
-        freeBlock = last;
-        last      = last->prev;
-        if (last)
+        freeBlock = std::make_shared<StarBlock>();
+
+        if (m_FreeSlots.empty())
         {
-            last->next = nullptr;
+            freeBlock->poolIndex = static_cast<int>(m_Pool.size());
+            m_Pool.push_back(freeBlock);
         }
-        if (freeBlock == first)
+        else
         {
-            first = nullptr;
+            freeBlock->poolIndex = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+            m_Pool[freeBlock->poolIndex] = freeBlock;
         }
-        freeBlock->reset();
-        freeBlock->prev = nullptr;
-        freeBlock->next = nullptr;
-        return freeBlock;
-    }
-    freeBlock.reset(new StarBlock);
-    if (freeBlock.get())
+
         ++nBlocks;
+        m_Allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // The caller is about to fill the block for this draw cycle
+    freeBlock->drawID.store(drawID.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    freeBlock->referenced.store(true, std::memory_order_relaxed);
 
     return freeBlock;
 }
 
-bool StarBlockFactory::markFirst(std::shared_ptr<StarBlock>& block)
+void StarBlockFactory::markUsed(StarBlock *block)
 {
-    if (!block.get())
-        return false;
+    if (!block)
+        return;
 
-    //    fprintf(stderr, "markFirst()!\n");
-    if (!first)
-    {
-        //        qCDebug(KSTARS) << "INFO: Linking in first block";
-        last = first = block;
-        first->prev = first->next = nullptr;
-        first->drawID             = drawID;
-        return true;
-    }
-
-    if (block == first) // Block is already in the front
-    {
-        block->drawID = drawID;
-        return true;
-    }
-
-    if (block == last)
-        last = block->prev;
-
-    if (block->prev)
-        block->prev->next = block->next;
-
-    if (block->next)
-        block->next->prev = block->prev;
-
-    first->prev = block;
-    block->next = first;
-    block->prev = nullptr;
-    first       = block;
-
-    block->drawID = drawID;
-
-    return true;
+    const quint32 current = drawID.load(std::memory_order_relaxed);
+    if (block->drawID.exchange(current, std::memory_order_relaxed) != current)
+        m_Reuses.fetch_add(1, std::memory_order_relaxed);
+    block->referenced.store(true, std::memory_order_relaxed);
 }
 
-bool StarBlockFactory::markNext(std::shared_ptr<StarBlock>& after, std::shared_ptr<StarBlock>& block)
+bool StarBlockFactory::isRecyclable(const StarBlock *block) const
 {
-    //    fprintf(stderr, "markNext()!\n");
-    if (!block.get() || !after.get())
-    {
-        qCDebug(KSTARS) << "WARNING: markNext called with nullptr argument";
+    // Blocks gathered in this draw cycle may still be waiting to be projected
+    if (block->drawID.load(std::memory_order_relaxed) == drawID.load(std::memory_order_relaxed))
         return false;
-    }
 
-    if (!first.get())
-    {
-        qCDebug(KSTARS) << "WARNING: markNext called without an existing linked list";
-        return false;
-    }
+    // Blocks without a parent are still being filled by whoever asked for them
+    return block->parent && block->parent->lastBlock() == block;
+}
 
-    if (block == after)
-    {
-        qCDebug(KSTARS) << "ERROR: Trying to mark a block after itself!";
-        return false;
-    }
+std::shared_ptr<StarBlock> StarBlockFactory::evict()
+{
+    const int size = static_cast<int>(m_Pool.size());
+    if (size == 0)
+        return nullptr;
 
-    if (block->prev == after) // Block is already after 'after'
+    // Two revolutions are enough to clear all the referenced bits once
+    for (int step = 0; step < 2 * size; ++step)
     {
-        block->drawID = drawID;
-        return true;
-    }
+        const int index = m_Hand;
+        m_Hand          = (m_Hand + 1) % size;
 
-    if (block == first)
-    {
-        if (block->next == nullptr)
+        std::shared_ptr<StarBlock> &block = m_Pool[index];
+        if (!block || !isRecyclable(block.get()))
+            continue;
+
+        if (block->referenced.exchange(false, std::memory_order_relaxed))
         {
-            qCDebug(KSTARS) << "ERROR: Trying to mark only block after some other block";
-            return false;
+            m_SecondChances.fetch_add(1, std::memory_order_relaxed);
+            continue;
         }
-        first = block->next;
-    }
 
-    if (after->getFaintMag() > block->getFaintMag() && block->getFaintMag() != -5)
-    {
-        qCDebug(KSTARS) << "WARNING: Marking block with faint mag = " << block->getFaintMag() << " after block with faint mag "
-                 << after->getFaintMag() << "in trixel" << block->parent->getTrixel();
+        block->reset();
+        m_Evictions.fetch_add(1, std::memory_order_relaxed);
+        return block;
     }
 
-    if (block == last)
-        last = block->prev;
-
-    if (block->prev)
-        block->prev->next = block->next;
-    if (block->next)
-        block->next->prev = block->prev;
-
-    block->next = after->next;
-    if (block->next)
-        block->next->prev = block;
-    block->prev = after;
-    after->next = block;
-
-    if (after == last)
-        last = block;
-
-    block->drawID = drawID;
-
-    return true;
+    return nullptr;
 }
 
-/*
-bool StarBlockFactory::groupMove( StarBlock *start, const int nblocks ) {
-
-    StarBlock * end = nullptr;
-
-    // Check for trivial cases
-    if( !start || nblocks < 0 )
-        return false;
-
-    if( nblocks == 0 )
-        return true;
-
-    if( !first )
-        return false;
+int StarBlockFactory::deleteBlocks(bool unusedOnly)
+{
+    int freed = 0;
 
-    // Check for premature end
-    end = start;
-    for( int i = 1; i < nblocks; ++i ) {
-        if( end == nullptr )
-            return false;
-        end = end->next;
+    // Releasing the last block of a trixel makes the one before it the last, so sweep until nothing changes
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t index = 0; index < m_Pool.size(); ++index)
+        {
+            std::shared_ptr<StarBlock> &block = m_Pool[index];
+            if (!block)
+                continue;
+
+            if (unusedOnly && !isRecyclable(block.get()))
+                continue;
+            if (!unusedOnly && block->parent && block->parent->lastBlock() != block.get())
+                continue;
+
+            block->reset();
+            block->poolIndex = -1;
+            block.reset();
+            m_FreeSlots.push_back(static_cast<int>(index));
+
+            --nBlocks;
+            ++freed;
+            changed = true;
+        }
     }
-    if( end == nullptr )
-        return false;
 
-    // Update drawIDs
-    end = start;
-    for( int i = 1; i < nblocks; ++i ) {
-        end->drawID = drawID;
-        end = end->next;
-    }
-    end->drawID = drawID;
+    m_Freed.fetch_add(freed, std::memory_order_relaxed);
+    qCDebug(KSTARS) << freed << "StarBlocks freed from StarBlockFactory";
 
-    // Check if we are already in the front
-    if( !start->prev )
-        return true;
+    return freed;
+}
 
-    start->prev->next = end->next;
-    end->next->prev = start->prev;
+int StarBlockFactory::freeAll()
+{
+    QMutexLocker lock(&m_Mutex);
+    return deleteBlocks(false);
+}
 
-    first->prev = end;
-    end->next = first;
-    start->prev = nullptr;
-    first = start;
+int StarBlockFactory::freeUnused()
+{
+    QMutexLocker lock(&m_Mutex);
+    return deleteBlocks(true);
 }
-*/
 
-int StarBlockFactory::deleteBlocks(int nblocks)
+void StarBlockFactory::printStructure() const
 {
-    int i           = 0;
-    std::shared_ptr<StarBlock> temp;
+    QMutexLocker lock(&m_Mutex);
+
+    const quint32 current = drawID.load(std::memory_order_relaxed);
+    int drawn = 0, referenced = 0, recyclable = 0;
 
-    while (last != nullptr && i != nblocks)
+    for (const auto &block : m_Pool)
     {
-        temp = last->prev;
-        last.reset();
-        last = temp;
-        i++;
+        if (!block)
+            continue;
+
+        if (block->drawID.load(std::memory_order_relaxed) == current)
+            ++drawn;
+        if (block->referenced.load(std::memory_order_relaxed))
+            ++referenced;
+        if (isRecyclable(block.get()))
+            ++recyclable;
     }
-    if (last)
-        last->next = nullptr;
-    else
-        first = nullptr;
-
-    qCDebug(KSTARS) << nblocks << "StarBlocks freed from StarBlockFactory";
 
-    nBlocks -= i;
-    return i;
+    qCDebug(KSTARS) << "StarBlockFactory:" << nBlocks.load() << "blocks in" << m_Pool.size() << "slots,"
+                    << m_FreeSlots.size() << "free slots, clock hand at" << m_Hand;
+    qCDebug(KSTARS) << drawn << "blocks are drawn," << referenced << "are referenced and" << recyclable
+                    << "can be recycled";
 }
 
-void StarBlockFactory::printStructure() const
+StarBlockFactory::Statistics StarBlockFactory::statistics() const
 {
-    std::shared_ptr<StarBlock> cur;
-    Trixel curTrixel = 513; // TODO: Change if we change HTMesh level
-    int index        = 0;
-    bool draw        = false;
-
-    cur = first;
-    do
-    {
-        if (curTrixel != cur->parent->getTrixel())
-        {
-            qCDebug(KSTARS) << "Trixel" << cur->parent->getTrixel() << "starts at index" << index;
-            curTrixel = cur->parent->getTrixel();
-        }
-        if (cur->drawID == drawID && !draw)
-        {
-            qCDebug(KSTARS) << "Blocks from index" << index << "are drawn";
-            draw = true;
-        }
-        if (cur->drawID != drawID && draw)
-        {
-            qCDebug(KSTARS) << "Blocks from index" << index << "are not drawn";
-            draw = false;
-        }
-        cur = cur->next;
-        ++index;
-    } while (cur != last);
+    Statistics stats;
+    stats.allocations   = m_Allocations.load(std::memory_order_relaxed);
+    stats.evictions     = m_Evictions.load(std::memory_order_relaxed);
+    stats.reuses        = m_Reuses.load(std::memory_order_relaxed);
+    stats.secondChances = m_SecondChances.load(std::memory_order_relaxed);
+    stats.freed         = m_Freed.load(std::memory_order_relaxed);
+    return stats;
 }
 
-int StarBlockFactory::freeUnused()
+void StarBlockFactory::resetStatistics()
 {
-    int i           = 0;
-    std::shared_ptr<StarBlock> temp;
-
-    while (last != nullptr && last->drawID < drawID && i != nBlocks)
-    {
-        temp = last->prev;
-        last.reset();
-        last = temp;
-        i++;
-    }
-    if (last)
-        last->next = nullptr;
-    else
-        first = nullptr;
-
-    qCDebug(KSTARS) << i << "StarBlocks freed from StarBlockFactory";
-
-    nBlocks -= i;
-    return i;
+    m_Allocations   = 0;
+    m_Evictions     = 0;
+    m_Reuses        = 0;
+    m_SecondChances = 0;
+    m_Freed         = 0;
 }
@@ -8,69 +8,95 @@
 
 #include "typedef.h"
 
+#include <QMutex>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
 class StarBlock;
 
 /**
  * @class StarBlockFactory
  *
- * @short A factory that creates StarBlocks and recycles them in an LRU Cache
+ * @short A factory that creates StarBlocks and recycles them from a pool
+ *
+ * The blocks live in an arena of slots. Every block knows its slot through
+ * StarBlock::poolIndex, so no list has to be maintained while drawing: markUsed()
+ * only stamps the block with the current drawID and sets its referenced bit, which
+ * is lock-free and may be called from any thread.
+ *
+ * Once the pool holds as many blocks as the cache size, getBlock() recycles blocks
+ * with a clock (second-chance) sweep over the arena. A block is only recycled if it
+ * was not used in the current draw cycle, if it is the last block of its trixel (so
+ * that StarBlockList::releaseBlock() keeps the list contiguous) and if it was not
+ * referenced since the hand last passed it. If no block qualifies, the pool grows.
+ *
+ * getBlock(), freeUnused() and freeAll() take a short lock and are safe to call from
+ * worker threads. Recycling a block detaches it from its StarBlockList, so callers
+ * must not load stars into a trixel that is being read by another thread.
+ *
  * @author Akarsh Simha
- * @version 0.1
+ * @version 0.2
  */
 
 class StarBlockFactory
 {
   public:
+    /** Counters describing the use of the pool */
+    struct Statistics
+    {
+        /** Number of blocks allocated */
+        quint64 allocations { 0 };
+        /** Number of blocks taken from their trixel to be recycled by getBlock() */
+        quint64 evictions { 0 };
+        /** Number of blocks marked used in a later draw cycle than the one they were loaded in */
+        quint64 reuses { 0 };
+        /** Number of blocks spared by the clock because they had been referenced */
+        quint64 secondChances { 0 };
+        /** Number of blocks freed by freeUnused() and freeAll() */
+        quint64 freed { 0 };
+    };
+
     static StarBlockFactory *Instance();
 
     /**
      * Destructor
-     * Deletes the linked list that maintains the Cache, sets the pointer to nullptr
+     * Releases the pool, sets the pointer to nullptr
      */
     ~StarBlockFactory();
 
     /**
      * @short  Return a StarBlock available for use
      *
-     * This method first checks if there are any cached StarBlocks that are not in use.
-     * If such a StarBlock is found, it returns the same for use. Else it freshly allocates
-     * a StarBlock and returns the same. It also moves the StarBlock to the front, marking it
-     * as the most recently used. If the StarBlock had a parent StarBlockList, this method
-     * detaches the StarBlock from the StarBlockList
+     * If the pool is full, this method looks for a cached StarBlock that can be recycled,
+     * detaches it from its StarBlockList and returns it. Else it freshly allocates a
+     * StarBlock. The block returned is marked as used in the current draw cycle.
      *
      * @return A StarBlock that is available for use
      */
     std::shared_ptr<StarBlock> getBlock();
 
     /**
-     * @short  Mark a StarBlock as most recently used and sync its drawID with the current drawID
+     * @short  Mark a StarBlock as used in the current draw cycle
      *
-     * @return true on success, false if the StarBlock supplied was not on our list at all
+     * The block is protected from recycling until drawID changes. This method does not
+     * lock and may be called concurrently for different blocks.
      */
-    bool markFirst(std::shared_ptr<StarBlock>& block);
-
-    /**
-     * @short  Rank a given StarBlock after another given StarBlock in the LRU list
-     * and sync its drawID with the current drawID
-     *
-     * @param  after  The block after which 'block' should be put
-     * @param  block  The block to mark for use
-     * @return true on success, false on failure
-     */
-    bool markNext(std::shared_ptr<StarBlock>& after, std::shared_ptr<StarBlock>& block);
+    void markUsed(StarBlock *block);
 
     /**
      * @short  Returns the number of StarBlocks currently produced
      *
      * @return Number of StarBlocks currently allocated
      */
-    inline int getBlockCount() const { return nBlocks; }
+    inline int getBlockCount() const { return nBlocks.load(std::memory_order_relaxed); }
 
     /**
      * @short  Frees all StarBlocks that are in the cache
      * @return The number of StarBlocks freed
      */
-    inline int freeAll() { return deleteBlocks(nBlocks); }
+    int freeAll();
 
     /**
      * @short  Frees all StarBlocks that are not used in this draw cycle
@@ -83,26 +109,53 @@ class StarBlockFactory
      */
     void printStructure() const;
 
-    quint32 drawID; // A number identifying the current draw cycle
+    /** @return a snapshot of the pool counters */
+    Statistics statistics() const;
+
+    /** Reset the pool counters to zero */
+    void resetStatistics();
+
+    std::atomic<quint32> drawID { 0 }; // A number identifying the current draw cycle, advanced by every draw
 
   private:
     /**
      * Constructor
-     * Initializes first and last StarBlock pointers to nullptr
+     * Reserves the arena for the default cache size
      */
     StarBlockFactory();
 
     /**
-     * @short  Deletes the N least recently used blocks
+     * @short  Sweeps the clock hand over the arena for a block to recycle
      *
-     * @param  nblocks  Number of blocks to delete
-     * @return Number of blocks successfully deleted
+     * Must be called with m_Mutex held.
+     * @return The detached block, nullptr if no block can be recycled
      */
-    int deleteBlocks(int nblocks);
+    std::shared_ptr<StarBlock> evict();
 
-    std::shared_ptr<StarBlock> first, last; // Pointers to the beginning and end of the linked list
-    int nBlocks;             // Number of blocks we currently have in the cache
-    int nCache;              // Number of blocks to start recycling cached blocks at
+    /** @return true if block is neither used in this draw cycle nor followed by another block of its trixel */
+    bool isRecyclable(const StarBlock *block) const;
+
+    /**
+     * @short  Detaches and deletes blocks, the last blocks of each trixel first
+     *
+     * Must be called with m_Mutex held.
+     * @param  unusedOnly  Only delete blocks that are not used in this draw cycle
+     * @return Number of blocks deleted
+     */
+    int deleteBlocks(bool unusedOnly);
+
+    mutable QMutex m_Mutex;                       // Guards the arena, the free slots and the hand
+    std::vector<std::shared_ptr<StarBlock>> m_Pool; // The arena, empty slots are nullptr
+    std::vector<int> m_FreeSlots;                 // Indices of the empty slots in m_Pool
+    int m_Hand { 0 };                             // Position of the clock hand in m_Pool
+    std::atomic<int> nBlocks { 0 };               // Number of blocks we currently have in the cache
+    int nCache;                                   // Number of blocks to start recycling cached blocks at
+
+    std::atomic<quint64> m_Allocations { 0 };
+    std::atomic<quint64> m_Evictions { 0 };
+    std::atomic<quint64> m_Reuses { 0 };
+    std::atomic<quint64> m_SecondChances { 0 };
+    std::atomic<quint64> m_Freed { 0 };
 
     static StarBlockFactory *pInstance;
 };
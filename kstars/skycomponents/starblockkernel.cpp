@@ -0,0 +1,150 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "starblockkernel.h"
+
+#include "ksnumbers.h"
+#include "auxiliary/cachingdms.h"
+#include "auxiliary/dms.h"
+
+#include <cmath>
+
+namespace StarBlockKernel
+{
+namespace
+{
+// SkyPoint::nutate() and SkyPoint::aberrate() use approximate expressions that are only valid
+// for |Dec| < 80°. We leave a margin so that the scalar path decides for stars close to the limit.
+const double poleLimit = std::sin(79.5 * dms::DegToRad);
+}
+
+Parameters Parameters::fromNumbers(const KSNumbers *num, const CachingDms *lst, const CachingDms *lat)
+{
+    Parameters p;
+
+    p.jd      = static_cast<double>(num->getJD());
+    p.pmScale = num->julianMillenia() * (M_PI / (180.0 * 3600.0));
+    p.jm2     = num->julianMillenia() * num->julianMillenia();
+
+    const Eigen::Matrix3d &P = num->p2();
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            p.precession[i][j] = P(i, j);
+
+    num->obliquity()->SinCos(p.sinOb, p.cosOb);
+    p.dEcLong = num->dEcLong() * dms::DegToRad;
+    p.dObliq  = num->dObliq() * dms::DegToRad;
+
+    p.K = num->constAberr().radians();
+    p.e = num->earthEccentricity();
+    num->sunTrueLongitude().SinCos(p.sinL, p.cosL);
+    num->earthPerihelionLongitude().SinCos(p.sinP, p.cosP);
+
+    p.setLocation(lst, lat);
+    return p;
+}
+
+void Parameters::setLocation(const CachingDms *lst, const CachingDms *lat)
+{
+    this->lst = lst->radians();
+    lat->SinCos(sinLat, cosLat);
+}
+
+void apparentCoords(const Parameters &p, const double *ra0, const double *dec0, const float *pmRA, const float *pmDec,
+                    int n, double *ra, double *dec, quint8 *fallback)
+{
+    const double P00 = p.precession[0][0], P01 = p.precession[0][1], P02 = p.precession[0][2];
+    const double P10 = p.precession[1][0], P11 = p.precession[1][1], P12 = p.precession[1][2];
+    const double P20 = p.precession[2][0], P21 = p.precession[2][1], P22 = p.precession[2][2];
+
+    // Aberration terms that do not depend on the star, see SkyPoint::aberrate()
+    const double aL = p.e * p.cosP - p.cosL;
+    const double aS = p.e * p.sinP - p.sinL;
+
+    for (int i = 0; i < n; ++i)
+    {
+        const double sinRa0 = std::sin(ra0[i]), cosRa0 = std::cos(ra0[i]);
+        const double sinDec0 = std::sin(dec0[i]), cosDec0 = std::cos(dec0[i]);
+
+        // Proper motion, as in StarObject::getIndexCoords(). Small corrections are ignored there,
+        // so we scale them to zero instead of branching.
+        const double pmms    = double(pmRA[i]) * pmRA[i] + double(pmDec[i]) * pmDec[i];
+        const double scale   = (pmms * p.jm2 < .01) ? 0. : p.pmScale;
+        const double netPmRA = pmRA[i] * scale, netPmDec = pmDec[i] * scale;
+
+        double x = cosDec0 * cosRa0 - netPmRA * sinRa0 - netPmDec * sinDec0 * cosRa0;
+        double y = cosDec0 * sinRa0 + netPmRA * cosRa0 - netPmDec * sinDec0 * sinRa0;
+        double z = sinDec0 + netPmDec * cosDec0;
+
+        // Project back onto the unit sphere (getIndexCoords() does the same through atan2)
+        const double norm = 1.0 / std::sqrt(x * x + y * y + z * z);
+        x *= norm;
+        y *= norm;
+        z *= norm;
+
+        // Precession, see SkyPoint::precess()
+        const double vx = P00 * x + P01 * y + P02 * z;
+        const double vy = P10 * x + P11 * y + P12 * z;
+        const double vz = P20 * x + P21 * y + P22 * z;
+
+        const double rxy = std::sqrt(vx * vx + vy * vy);
+        double sinRA = vy / rxy, cosRA = vx / rxy;
+        double sinDec = vz, cosDec = rxy;
+
+        fallback[i] = std::fabs(vz) >= poleLimit;
+
+        // Nutation, Meeus Equ. 23.1, see SkyPoint::nutate()
+        const double tanDec = sinDec / cosDec;
+        const double dRA1   = p.dEcLong * (p.cosOb + p.sinOb * sinRA * tanDec) - p.dObliq * cosRA * tanDec;
+        const double dDec1  = p.dEcLong * (p.sinOb * cosRA) + p.dObliq * sinRA;
+
+        // The corrections are tiny (< 1e-4 rad), so we rotate the sines and cosines using the
+        // small angle approximation instead of calling the trigonometric functions again.
+        const double cRA1 = 1.0 - 0.5 * dRA1 * dRA1, cDec1 = 1.0 - 0.5 * dDec1 * dDec1;
+        const double sinRA1  = sinRA * cRA1 + cosRA * dRA1;
+        const double cosRA1  = cosRA * cRA1 - sinRA * dRA1;
+        const double sinDec1 = sinDec * cDec1 + cosDec * dDec1;
+        const double cosDec1 = cosDec * cDec1 - sinDec * dDec1;
+        sinRA  = sinRA1;
+        cosRA  = cosRA1;
+        sinDec = sinDec1;
+        cosDec = cosDec1;
+
+        // Aberration, Meeus Equ. 23.3, see SkyPoint::aberrate()
+        const double dRA2  = (p.K / cosDec) * (cosRA * p.cosOb * aL + sinRA * aS);
+        const double dDec2 = p.K * ((p.sinOb * cosDec - p.cosOb * sinDec * sinRA) * aL + cosRA * sinDec * aS);
+
+        double alpha = std::atan2(vy, vx) + dRA1 + dRA2;
+        alpha -= 2.0 * M_PI * std::floor(alpha / (2.0 * M_PI));
+
+        ra[i]  = alpha;
+        dec[i] = std::atan2(vz, rxy) + dDec1 + dDec2;
+    }
+}
+
+void horizontalCoords(const Parameters &p, const double *ra, const double *dec, int n, double *alt, double *az)
+{
+    const double sinLat = p.sinLat, cosLat = p.cosLat;
+
+    for (int i = 0; i < n; ++i)
+    {
+        const double hourAngle = p.lst - ra[i];
+        const double sinHA = std::sin(hourAngle), cosHA = std::cos(hourAngle);
+        const double sinDec = std::sin(dec[i]), cosDec = std::cos(dec[i]);
+
+        // Same expressions as SkyPoint::EquatorialToHorizontal()
+        const double sinAlt = sinDec * sinLat + cosDec * cosLat * cosHA;
+        double cosAlt       = std::sqrt(std::fmax(0.0, 1.0 - sinAlt * sinAlt));
+        cosAlt              = (cosAlt == 0.) ? 1e-15 : cosAlt;
+
+        const double arg = std::fmin(1.0, std::fmax(-1.0, (sinDec - sinLat * sinAlt) / (cosLat * cosAlt)));
+        const double A   = std::acos(arg);
+
+        alt[i] = std::asin(sinAlt);
+        az[i]  = (sinHA > 0.0 && A != 0.0) ? 2.0 * M_PI - A : A;
+    }
+}
+}
@@ -0,0 +1,91 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtGlobal>
+
+class CachingDms;
+class KSNumbers;
+
+/**
+ * @namespace StarBlockKernel
+ *
+ * Batch versions of the coordinate updates that StarObject::JITupdate() performs one star at a time.
+ *
+ * The kernels work on plain arrays (structure-of-arrays) so that a whole StarBlock can be updated
+ * in one tight loop. The loop bodies are free of branches and function calls other than the math
+ * library, so the compiler is able to vectorize them. They reproduce the scalar path of
+ * StarObject::updateCoords() (proper motion, precession, nutation and aberration, see SkyPoint)
+ * and SkyPoint::EquatorialToHorizontal().
+ *
+ * Stars close to the celestial poles, where SkyPoint switches to different expressions, are flagged
+ * by apparentCoords() and must be updated by the caller through the scalar path.
+ *
+ * All angles are in radians, proper motions are in milliarcseconds per year.
+ */
+namespace StarBlockKernel
+{
+/** @short The time and location dependent quantities needed by the kernels */
+struct Parameters
+{
+    /** Julian day for which the parameters were computed */
+    double jd { 0 };
+    /** Scale factor turning a proper motion in mas/yr into an angle in radians */
+    double pmScale { 0 };
+    /** Square of the number of Julian millenia since J2000, for the proper motion cut-off */
+    double jm2 { 0 };
+    /** Precession matrix, see KSNumbers::p2() */
+    double precession[3][3];
+    /** Obliquity of the ecliptic */
+    double sinOb { 0 }, cosOb { 1 };
+    /** Nutation in ecliptic longitude and obliquity, in radians */
+    double dEcLong { 0 }, dObliq { 0 };
+    /** Constant of aberration (radians) and eccentricity of Earth's orbit */
+    double K { 0 }, e { 0 };
+    /** True longitude of the Sun, and longitude of Earth's perihelion */
+    double sinL { 0 }, cosL { 1 }, sinP { 0 }, cosP { 1 };
+    /** Local sidereal time, in radians */
+    double lst { 0 };
+    /** Geographic latitude */
+    double sinLat { 0 }, cosLat { 1 };
+
+    /**
+     * @short Fill the parameters from a KSNumbers object, the sidereal time and the latitude
+     * @note Pass KStarsData::updateNum(), lst() and geo()->lat() to match StarObject::JITupdate()
+     */
+    static Parameters fromNumbers(const KSNumbers *num, const CachingDms *lst, const CachingDms *lat);
+
+    /** @short Update only the sidereal time and latitude, leaving the epoch dependent values alone */
+    void setLocation(const CachingDms *lst, const CachingDms *lat);
+};
+
+/**
+ * @short Compute apparent (RA, Dec) from catalog coordinates and proper motions
+ * @param p Parameters for the current epoch
+ * @param ra0 Catalog (J2000) right ascensions
+ * @param dec0 Catalog (J2000) declinations
+ * @param pmRA Proper motions in RA, already multiplied by cos(dec)
+ * @param pmDec Proper motions in Dec
+ * @param n Number of stars to process
+ * @param ra Output apparent right ascensions, in [0, 2π)
+ * @param dec Output apparent declinations
+ * @param fallback Output flags, set to 1 for stars that need the scalar path, 0 otherwise
+ */
+void apparentCoords(const Parameters &p, const double *ra0, const double *dec0, const float *pmRA, const float *pmDec,
+                    int n, double *ra, double *dec, quint8 *fallback);
+
+/**
+ * @short Convert apparent (RA, Dec) to horizontal (Alt, Az) coordinates
+ * @param p Parameters holding the sidereal time and latitude
+ * @param ra Apparent right ascensions
+ * @param dec Apparent declinations
+ * @param n Number of stars to process
+ * @param alt Output altitudes
+ * @param az Output azimuths, in [0, 2π)
+ */
+void horizontalCoords(const Parameters &p, const double *ra, const double *dec, int n, double *alt, double *az);
+}
@@ -92,7 +92,14 @@ bool StarBlockList::fillToMag(float maglim)
 
     Q_ASSERT(nBlocks == (unsigned int)blocks.size());
 
-    BinFileHelper::unsigned_KDE_fseek(dataFile, readOffset, SEEK_SET);
+    // If the catalog is mapped into memory, the records of this trixel are read in place instead of
+    // seeking and reading the shared FILE handle one record at a time.
+    const RecordSpan records = dSReader->getRecords(trixelId);
+    const bool mapped        = !records.isEmpty();
+    const bool byteSwap      = dSReader->getByteSwap();
+
+    if (!mapped)
+        BinFileHelper::unsigned_KDE_fseek(dataFile, readOffset, SEEK_SET);
 
     /*
     qDebug() << "Reading trixel" << trixel << ", id on disk =" << trixelId << ", currently nStars =" << nStars
@@ -114,31 +121,44 @@ bool StarBlockList::fillToMag(float maglim)
                            << ", while trying to create block #" << nBlocks + 1;
                 return false;
             }
+            // getBlock() has already marked the block as used in this draw cycle
+            newBlock->parent = this;
             blocks.append(newBlock);
-            blocks[nBlocks]->parent = this;
-            if (nBlocks == 0)
-                SBFactory->markFirst(blocks[0]);
-            else if (!SBFactory->markNext(blocks[nBlocks - 1], blocks[nBlocks]))
-                qWarning() << "ERROR: markNext() failed on block #" << nBlocks + 1 << "in trixel" << trixel;
 
             ++nBlocks;
         }
         // TODO: Make this more general
         if (dSReader->guessRecordSize() == 32)
         {
-            ret = fread(&stardata, sizeof(StarData), 1, dataFile);
-            if (dSReader->getByteSwap())
-                DeepStarComponent::byteSwap(&stardata);
+            if (mapped)
+            {
+                blocks[nBlocks - 1]->addStar(
+                    *DeepStarComponent::mappedRecord(records.record(nStars), byteSwap, stardata));
+            }
+            else
+            {
+                ret = fread(&stardata, sizeof(StarData), 1, dataFile);
+                if (byteSwap)
+                    DeepStarComponent::byteSwap(&stardata);
+                blocks[nBlocks - 1]->addStar(stardata);
+            }
             readOffset += sizeof(StarData);
-            blocks[nBlocks - 1]->addStar(stardata);
         }
         else
         {
-            ret = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
-            if (dSReader->getByteSwap())
-                DeepStarComponent::byteSwap(&deepstardata);
+            if (mapped)
+            {
+                blocks[nBlocks - 1]->addStar(
+                    *DeepStarComponent::mappedRecord(records.record(nStars), byteSwap, deepstardata));
+            }
+            else
+            {
+                ret = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
+                if (byteSwap)
+                    DeepStarComponent::byteSwap(&deepstardata);
+                blocks[nBlocks - 1]->addStar(deepstardata);
+            }
             readOffset += sizeof(DeepStarData);
-            blocks[nBlocks - 1]->addStar(deepstardata);
         }
 
         /*
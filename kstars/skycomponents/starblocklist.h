@@ -63,6 +63,12 @@ class StarBlockList
      */
     inline std::shared_ptr<StarBlock> block(unsigned int i) { return ((i < nBlocks) ? blocks[i] : std::shared_ptr<StarBlock>()); }
 
+    /**
+     * @short  Returns the last block in this StarBlockList, the only one that can be released
+     * @return The last StarBlock, nullptr if the list is empty
+     */
+    inline StarBlock *lastBlock() const { return ((nBlocks > 0) ? blocks[nBlocks - 1].get() : nullptr); }
+
     /**
      * @return a const reference to the contents of this StarBlockList
      */
@@ -30,6 +30,7 @@
 #include "skycomponents/constellationboundarylines.h"
 #include "skycomponents/skylabeler.h"
 #include "skycomponents/skymapcomposite.h"
+#include "skycomponents/catalogscomponent.h"
 #include "skyqpainter.h"
 #include "projections/projector.h"
 #include "projections/lambertprojector.h"
@@ -359,8 +360,16 @@ void SkyMapDrawAbstract::exportSkyImage(SkyQPainter *painter, bool scale)
         painter->scale(scale, scale);
     }
 
+    // The image is drawn only once, so do not leave any DSOs to the background loader
+    CatalogsComponent *catalogs = m_KStarsData->skyComposite()->catalogsComponent();
+    if (catalogs)
+        catalogs->setBlockingLoad(true);
+
     painter->drawSkyBackground();
     m_KStarsData->skyComposite()->draw(painter);
+
+    if (catalogs)
+        catalogs->setBlockingLoad(false);
     drawOverlays(*painter);
     painter->setVectorStars(vectorStarState); // Restore the state of the painter
 }
@@ -546,6 +546,18 @@ void StarObject::JITupdate()
     updateID = data->updateID();
 }
 
+void StarObject::setJITCoords(double ra, double dec, double alt, double az, quint64 updateid, quint64 updatenumid,
+                              double jd)
+{
+    setRA(CachingDms(ra));
+    setDec(CachingDms(dec));
+    setAlt(dms(alt));
+    setAz(dms(az));
+    lastPrecessJD = jd;
+    updateNumID   = updatenumid;
+    updateID      = updateid;
+}
+
 QString StarObject::sptype(void) const
 {
     return QString(QByteArray(SpType, 2));
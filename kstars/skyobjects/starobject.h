@@ -189,6 +189,21 @@ class StarObject : public SkyObject
     /** @short added for JIT updates from both StarComponent and ConstellationLines */
     void JITupdate();
 
+    /**
+     * @short Set the coordinates computed for this star by a batch update, see StarBlock::updateCoords()
+     *
+     * Leaves the star in the same state as JITupdate() would have.
+     *
+     * @param ra Apparent right ascension, in degrees
+     * @param dec Apparent declination, in degrees
+     * @param alt Altitude, in degrees
+     * @param az Azimuth, in degrees
+     * @param updateid KStarsData::updateID() the coordinates were computed for
+     * @param updatenumid KStarsData::updateNumID() the coordinates were computed for
+     * @param jd Julian day at which the apparent coordinates were computed
+     */
+    void setJITCoords(double ra, double dec, double alt, double az, quint64 updateid, quint64 updatenumid, double jd);
+
     /** @short returns the magnitude of the proper motion correction in milliarcsec/year */
     inline double pmMagnitude() const
     {
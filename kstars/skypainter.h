@@ -118,6 +118,19 @@ class SkyPainter
     virtual bool drawPointSource(const SkyPoint *loc, float mag, char sp = 'A') = 0;
 
         /**
+         * @short Draw point sources that were already projected to screen coordinates.
+         * The caller is responsible for the visibility checks done by drawPointSource().
+         * @param x screen x coordinates of the sources
+         * @param y screen y coordinates of the sources
+         * @param mag magnitudes of the sources
+         * @param sp spectral classes of the sources
+         * @param n number of sources
+         * @return the number of sources drawn
+         */
+        virtual int drawProjectedPointSources(const float *x, const float *y, const float *mag, const char *sp,
+                                              int n) = 0;
+
+        /**
      * @short Draw a deep sky object (loaded from the new implementation)
      * @param obj the object to draw
      * @param drawImage if true, try to draw the image of the object
@@ -587,6 +587,15 @@ bool SkyQPainter::drawPointSource(const SkyPoint *loc, float mag, char sp)
     }
 }
 
+int SkyQPainter::drawProjectedPointSources(const float *x, const float *y, const float *mag, const char *sp,
+                                           int n)
+{
+    for (int i = 0; i < n; ++i)
+        drawPointSource(QPointF(x[i], y[i]), starWidth(mag[i]), sp[i]);
+
+    return n;
+}
+
 void SkyQPainter::drawPointSource(const QPointF &pos, float size, char sp)
 {
     int isize = qMin(static_cast<int>(size), 14);
@@ -76,6 +76,8 @@ class SkyQPainter : public SkyPainter, public QPainter
                          LineListLabel *label = nullptr) override;
     void drawSkyPolygon(LineList *list, bool forceClip = true) override;
     bool drawPointSource(const SkyPoint *loc, float mag, char sp = 'A') override;
+    int drawProjectedPointSources(const float *x, const float *y, const float *mag, const char *sp,
+                                  int n) override;
     bool drawCatalogObject(const CatalogObject &obj) override;
     void drawCatalogObjectImage(const QPointF &pos, const CatalogObject &obj,
                                 float positionAngle);